@@ -4,41 +4,115 @@
 #endif
 
 #include "mint.h"
+#include "mint_trace.h"
+#include "mint_log.h"
+
+// Calls per callback when timing the MSC callbacks ('X')
+#define CALLBACK_BENCH_ROUNDS 64
+
+// Bytes of log records sent per Serial.write ('L')
+#define LOG_DRAIN_CHUNK 256
 
 MintDevice mint;
 
+#ifndef MINT_LOG_DISABLED
+// Send the event log: header, whole records, then a zero byte
+// (tests/log_decode.py)
+static void drainLog() {
+    uint8_t chunk[LOG_DRAIN_CHUNK];
+    Serial.write(chunk, MintLog::header(chunk));
+    size_t length;
+    while ((length = MintLog::read(chunk, sizeof(chunk))) > 0) {
+        Serial.write(chunk, length);
+    }
+    chunk[0] = 0;
+    Serial.write(chunk, 1);
+}
+#endif
+
 void setup() {
-    // Initialize serial for debugging
-    #ifdef DEBUG_ENABLED
+    // Serial carries the log drain in every build
     Serial.begin(115200);
+    #ifdef DEBUG_ENABLED
     delay(2000); // Wait for serial connection
-    Serial.println("Mint Bitcoin Bearer Device");
-    Serial.println("Initializing...");
     #endif
+    MINT_LOG("Mint booting");
     
     // Initialize the device
     if (!mint.begin()) {
-        #ifdef DEBUG_ENABLED
-        Serial.println("Initialization failed!");
-        #endif
+        MINT_LOG("initialization failed");
         
         // If initialization fails, flash LED rapidly to indicate error
         while (1) {
-            // Error state will be shown by the LED
+            // Error state will be shown by the LED; the log says why
+            #ifndef MINT_LOG_DISABLED
+            if (Serial.available() && Serial.read() == 'L') {
+                drainLog();
+            }
+            #endif
             delay(100);
         }
     }
     
-    #ifdef DEBUG_ENABLED
-    Serial.println("Initialization complete");
-    Serial.println("Device ready");
-    #endif
+    MINT_LOG("device ready");
 }
 
 void loop() {
     // Run main device loop
     mint.loop();
     
-    // Small delay to prevent CPU hogging
-    delay(10);
+    #if defined(MINT_TRACE_ENABLED) || defined(DEBUG_ENABLED) || !defined(MINT_LOG_DISABLED)
+    int command = Serial.available() ? Serial.read() : -1;
+    #endif
+    
+    #ifdef MINT_TRACE_ENABLED
+    // Drain the I/O trace over CDC when the host asks for it
+    if (command == 'T') {
+        Serial.write(MintTrace::data(), MintTrace::size());
+        MintTrace::clear();
+    }
+    #endif
+    
+    #ifndef MINT_LOG_DISABLED
+    if (command == 'L') {
+        drainLog();
+    }
+    #endif
+    
+    #ifdef DEBUG_ENABLED
+    // Task timing since the last request, one line per task, then "end"
+    // (tests/sram_bench.py)
+    if (command == 'S') {
+        const MintScheduler& scheduler = mint.getScheduler();
+        char line[128];
+        for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+            const MintScheduler::TaskStats& stats = scheduler.getTaskStats(i);
+            snprintf(line, sizeof(line), "task %s %lu %lu %lu %lu", stats.name,
+                     (unsigned long)stats.runs, (unsigned long)stats.overruns,
+                     (unsigned long)stats.max_run_us, (unsigned long)stats.max_response_us);
+            Serial.println(line);
+        }
+        Serial.println("end");
+        mint.resetTaskStats();
+    }
+    
+    // Worst-case MSC callback cycles with a cold XIP cache, then "end"
+    // (tests/sram_bench.py)
+    if (command == 'X') {
+        CallbackLatency latency;
+        if (mint.measureCallbackLatency(CALLBACK_BENCH_ROUNDS, latency)) {
+            char line[96];
+            snprintf(line, sizeof(line), "callbacks %lu %lu %lu %lu %lu",
+                     (unsigned long)latency.rounds, (unsigned long)latency.read_max_cycles,
+                     (unsigned long)latency.read_mean_cycles,
+                     (unsigned long)latency.write_max_cycles,
+                     (unsigned long)latency.write_mean_cycles);
+            Serial.println(line);
+        }
+        Serial.println("end");
+    }
+    #endif
+    
+    // Sleep until the scheduler has a task to release
+    delay(mint.getIdleTime());
 }
\ No newline at end of file
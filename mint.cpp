@@ -1,19 +1,73 @@
 #include "mint.h"
+#include "mint_trace.h"
+#include "mint_log.h"
+#include "mint_memory.h"
 
-// Additional hardware entropy sources
-#define ANALOG_NOISE_PIN A0  // Analog pin for noise sampling
-#define SAMPLE_COUNT 32      // Number of samples to collect
+// Task priorities, lower runs first
+#define TASK_PRIORITY_USB 0
+#define TASK_PRIORITY_CIRCUIT 1
+#define TASK_PRIORITY_CRYPTO 2
+#define TASK_PRIORITY_STORAGE 3
+#define TASK_PRIORITY_DISPLAY 4
+#define TASK_PRIORITY_ENTROPY 5
+#define TASK_PRIORITY_SELFTEST 6
 
-MintDevice::MintDevice() : 
+// Task periods and deadlines (microseconds from release to completion)
+#define TASK_USB_PERIOD_US 1000
+#define TASK_USB_DEADLINE_US 2000
+#define TASK_CIRCUIT_PERIOD_US 10000
+#define TASK_CIRCUIT_DEADLINE_US 16000      // One tamper sample window
+#define TASK_CRYPTO_PERIOD_US 5000
+#define TASK_CRYPTO_DEADLINE_US 100000      // Longest SE050 command (key generation)
+#ifdef MINT_STORAGE_FLASH
+#define TASK_STORAGE_PERIOD_US 1000         // Steps flash write-back
+#else
+#define TASK_STORAGE_PERIOD_US 10000
+#endif
+#define TASK_STORAGE_DEADLINE_US 20000
+#define TASK_DISPLAY_PERIOD_US 100000
+#define TASK_DISPLAY_DEADLINE_US 100000
+#define TASK_ENTROPY_PERIOD_US 10000
+#define TASK_ENTROPY_DEADLINE_US 50000      // Half the entropy sample rings
+#define TASK_SELFTEST_PERIOD_US 50000
+#define TASK_SELFTEST_DEADLINE_US 100000
+
+// Longest the main loop sleeps between scheduler passes
+#define MINT_MAX_IDLE_MS 10
+
+// Wait before staging SE050 entropy again after a failed draw
+#define STAGE_RETRY_US 1000000UL
+
+template <class Board>
+MintDeviceT<Board>::MintDeviceT() : 
     device_state(MINT_STATE_INITIALIZING),
-    circuit(CIRCUIT_PIN),
+    traced_state(MINT_STATE_INITIALIZING),
+    led(Board::LED_PIN),
+    circuit(Board::CIRCUIT_SENSE),
+    entropy(Board::NOISE_PIN),
     wallet(secure),
+    self_test(secure, entropy),
     processing_file(false),
-    entropy_collected(0) {
-    memset(entropy_buffer, 0, sizeof(entropy_buffer));
+    pending_file_size(0),
+    staged_secure_valid(false),
+    staged_pool_valid(false),
+    staged_us(0),
+    stage_retry_us(0),
+    proof_challenge_count(0),
+    proving(false),
+    readme_length(0),
+    readme_state(MINT_STATE_INITIALIZING),
+    readme_valid(false) {
+    memset(pending_file, 0, sizeof(pending_file));
+    memset(&file_estimate, 0, sizeof(file_estimate));
+    memset(staged_secure, 0, sizeof(staged_secure));
+    memset(staged_pool, 0, sizeof(staged_pool));
+    memset(proof_challenges, 0, sizeof(proof_challenges));
+    memset(readme_text, 0, sizeof(readme_text));
 }
 
-bool MintDevice::begin() {
+template <class Board>
+bool MintDeviceT<Board>::begin() {
     // Initialize all subsystems
     led.begin();
     led.setInitializing(); // Blue during initialization
@@ -21,6 +75,7 @@ bool MintDevice::begin() {
     // Initialize secure element
     if (!secure.begin()) {
         // Failed to initialize secure element
+        MINT_LOG("boot: secure element failed");
         led.setError();
         return false;
     }
@@ -28,163 +83,448 @@ bool MintDevice::begin() {
     // Initialize circuit monitoring
     if (!circuit.begin()) {
         // Failed to initialize circuit monitoring
+        MINT_LOG("boot: circuit monitor failed");
         led.setError();
         return false;
     }
+    secure.attachCircuit(circuit);
+    
+    // Start collecting MCU entropy so the pool is full before a file
+    // arrives; the SE050 alone is enough if no source starts
+    entropy.begin();
     
     // Initialize wallet
     if (!wallet.begin()) {
         // Non-critical failure
         // We'll continue without a wallet
+        MINT_LOG("boot: wallet unavailable");
     }
     
     // Initialize storage last
     if (!storage.begin()) {
         // Failed to initialize storage
+        MINT_LOG("boot: storage failed");
         led.setError();
         return false;
     }
     
-    // Register file changed callback
+    // Register file changed callback: a sealed device answers ownership
+    // challenges, a blank one takes the file as entropy
     storage.setFileChangedCallback([this](uint8_t* buffer, size_t size) {
-        this->processNewEntropyFile(buffer, size);
+        if (device_state == MINT_STATE_READY_WITH_WALLET) {
+            this->processChallengeFile(buffer, size);
+        } else {
+            this->processNewEntropyFile(buffer, size);
+        }
     });
     
-    // Determine initial state
-    if (circuit.isIntact()) {
-        // Circuit intact - normal operation
-        if (wallet.isGenerated()) {
-            device_state = MINT_STATE_READY_WITH_WALLET;
-        } else {
-            device_state = MINT_STATE_READY_NO_WALLET;
+    // React to confirmed circuit transitions only. A partial loop (raised
+    // resistance, intermittent contact) keeps the device in service but
+    // is logged, so a loop being worked on shows up before it opens.
+    typedef typename Board::Circuit Circuit;
+    circuit.setStateChangedCallback([this](typename Circuit::CircuitState state) {
+        MINT_TRACE(TRACE_EVENT_CIRCUIT_STATE, state, nullptr, 0);
+        if (state == Circuit::CIRCUIT_PARTIAL) {
+            MINT_LOG("circuit partial");
+        } else if (state == Circuit::CIRCUIT_INTACT) {
+            MINT_LOG("circuit intact");
+        } else if (device_state != MINT_STATE_TAMPERED) {
+            this->handleCircuitBreak();
         }
-    } else {
-        // Circuit broken - tampered state
-        device_state = MINT_STATE_TAMPERED;
+    });
+    if (circuit.getState() == Circuit::CIRCUIT_PARTIAL) {
+        MINT_LOG("boot: circuit partial");
+    }
+    
+    // Determine initial state; an unread tamper record keeps an intact
+    // device degraded until the crypto task gets it read
+    device_state = readyState();
+    if (device_state == MINT_STATE_TAMPERED) {
         secure.recordPermanentTamperState();
+    } else if (secure.isDegraded()) {
+        device_state = MINT_STATE_DEGRADED;
     }
     
     // Update LED to match initial state
     updateLEDFromState();
+    traceStateChange();
+    
+    registerTasks();
     
     return true;
 }
 
-void MintDevice::loop() {
-    // Check for circuit state changes
-    if (!circuit.isIntact() && device_state != MINT_STATE_TAMPERED) {
-        // Circuit just broken
-        handleCircuitBreak();
+template <class Board>
+void MintDeviceT<Board>::registerTasks() {
+    // USB servicing first: a host waiting on a sector must not stall
+    scheduler.addTask("usb", TASK_PRIORITY_USB, TASK_USB_PERIOD_US, TASK_USB_DEADLINE_US, []() {
+#if defined(ARDUINO_ARCH_RP2040)
+        TinyUSB_Device_Task();
+#endif
+    });
+    
+    // Drain tamper loop samples; a confirmed break fires handleCircuitBreak()
+    scheduler.addTask("circuit", TASK_PRIORITY_CIRCUIT, TASK_CIRCUIT_PERIOD_US,
+                      TASK_CIRCUIT_DEADLINE_US, [this]() {
+        circuit.task();
+    });
+    
+    scheduler.addTask("crypto", TASK_PRIORITY_CRYPTO, TASK_CRYPTO_PERIOD_US,
+                      TASK_CRYPTO_DEADLINE_US, [this]() {
+        cryptoTask();
+    });
+    
+    // Hands a settled host write to processNewEntropyFile()
+    scheduler.addTask("storage", TASK_PRIORITY_STORAGE, TASK_STORAGE_PERIOD_US,
+                      TASK_STORAGE_DEADLINE_US, [this]() {
+        storage.task();
+    });
+    
+    scheduler.addTask("display", TASK_PRIORITY_DISPLAY, TASK_DISPLAY_PERIOD_US,
+                      TASK_DISPLAY_DEADLINE_US, [this]() {
+        displayTask();
+    });
+    
+    // Health-test and pool MCU entropy samples gathered by DMA
+    scheduler.addTask("entropy", TASK_PRIORITY_ENTROPY, TASK_ENTROPY_PERIOD_US,
+                      TASK_ENTROPY_DEADLINE_US, [this]() {
+        entropy.task();
+    });
+    
+    // Known-answer and consistency checks in slices of bounded time,
+    // behind every other task
+    scheduler.addTask("selftest", TASK_PRIORITY_SELFTEST, TASK_SELFTEST_PERIOD_US,
+                      TASK_SELFTEST_DEADLINE_US, [this]() {
+        selfTestTask();
+    });
+}
+
+template <class Board>
+MINT_RAM_FUNC(device_loop)
+void MintDeviceT<Board>::loop() {
+    scheduler.run();
+    traceStateChange();
+}
+
+template <class Board>
+MINT_RAM_FUNC(device_idle_time)
+unsigned long MintDeviceT<Board>::getIdleTime() const {
+    // Round up so the next pass finds its task released
+    unsigned long idle_ms = (scheduler.getIdleTime() + 999UL) / 1000UL;
+    return min(idle_ms, (unsigned long)MINT_MAX_IDLE_MS);
+}
+
+template <class Board>
+const MintScheduler& MintDeviceT<Board>::getScheduler() const {
+    return scheduler;
+}
+
+template <class Board>
+void MintDeviceT<Board>::resetTaskStats() {
+    scheduler.resetStats();
+}
+
+template <class Board>
+bool MintDeviceT<Board>::measureCallbackLatency(uint32_t rounds, CallbackLatency& latency) {
+    return storage.measureCallbackLatency(rounds, latency);
+}
+
+template <class Board>
+void MintDeviceT<Board>::cryptoTask() {
+    // Opened: keep trying to burn the tamper record until it takes; the
+    // key can only be read once it has, so render the README again then
+    if (device_state == MINT_STATE_TAMPERED) {
+        if (!secure.isTampered()) {
+            secure.recordPermanentTamperState();
+            if (secure.isTampered()) {
+                readme_valid = false;
+            }
+        }
+        return;
     }
     
-    // Handle storage operations
-    storage.task();
+    // An SE050 that stopped answering parks an idle device until a probe
+    // gets through; a job in flight fails on its own first
+    if (device_state == MINT_STATE_DEGRADED) {
+        if (secure.probe()) {
+            // A wallet whose chain code was unread at boot loads now
+            wallet.begin();
+            device_state = readyState();
+            MINT_LOG("SE050 back in service");
+            updateLEDFromState();
+        }
+        return;
+    }
+    if (device_state != MINT_STATE_GENERATING_WALLET && !secure.isBusy() &&
+        secure.isDegraded()) {
+        device_state = MINT_STATE_DEGRADED;
+        clearStagedGeneration();
+        MINT_LOG("SE050 out of service");
+        updateLEDFromState();
+        return;
+    }
+    
+    // Sealed: sign staged challenges, one SE050 signature per release
+    if (device_state == MINT_STATE_READY_WITH_WALLET) {
+        if (proving) {
+            pollOwnershipProof();
+        } else if (proof_challenge_count) {
+            startOwnershipProof();
+        }
+        return;
+    }
+    
+    // Waiting for a file: draw the hardware entropy it will be mixed with
+    if (device_state == MINT_STATE_READY_NO_WALLET) {
+        stageGeneration();
+        return;
+    }
+    
+    if (device_state != MINT_STATE_GENERATING_WALLET) {
+        return;
+    }
     
-    // Update LED if needed
-    static unsigned long last_led_update = 0;
-    if (millis() - last_led_update > 100) {
+    // First step mixes the staged file; later steps advance key creation
+    // by one SE050 command each
+    if (pending_file_size) {
+        startWalletGeneration();
+    } else {
+        pollWalletGeneration();
+    }
+}
+
+template <class Board>
+void MintDeviceT<Board>::selfTestTask() {
+    const bool had_failed = self_test.hasFailed();
+    self_test.tick(!secure.isBusy() && !secure.isDegraded() && !processing_file && !proving &&
+                   !proof_challenge_count);
+    if (self_test.hasFailed() && !had_failed) {
+        clearStagedGeneration();
         updateLEDFromState();
-        last_led_update = millis();
     }
+}
+
+template <class Board>
+void MintDeviceT<Board>::displayTask() {
+    updateLEDFromState();
     
-    // Handle state-specific actions
+    // Rendering may read keys from the SE050, so only do it on a state
+    // change; the cached text is rewritten in case the host overwrote it
+    if (!readme_valid || readme_state != device_state) {
+        readme_state = device_state;
+        readme_valid = renderReadme();
+    }
+    if (readme_valid) {
+        storage.writeFile(readme_text, readme_length);
+    }
+}
+
+template <class Board>
+bool MintDeviceT<Board>::renderReadme() {
     switch (device_state) {
-        case MINT_STATE_GENERATING_WALLET:
-            // Collecting entropy or processing wallet
-            // This is handled by the file callback
-            break;
-            
         case MINT_STATE_TAMPERED:
-            // In tampered state, ensure storage shows private key
+            // In tampered state, storage shows the private key
             if (wallet.isGenerated()) {
                 String private_key = wallet.getPrivateKey();
-                
-                // Update readme file with private key
-                char readme[512];
-                snprintf(readme, sizeof(readme),
-                    "MINT DEVICE - TAMPERED STATE\n\n"
-                    "This device has been opened and the private key is exposed.\n\n"
-                    "Bitcoin Private Key (WIF format):\n%s\n\n"
-                    "Bitcoin Address:\n%s\n\n"
-                    "CAUTION: Anyone with access to the private key can spend the funds.",
-                    private_key.c_str(), wallet.getPublicAddress().c_str());
-                
-                storage.updateReadmeFile(readme);
+                readme_length = MintReadme::render(MINT_README_TAMPERED,
+                                                   wallet.getPublicAddress().c_str(),
+                                                   private_key.c_str(), readme_text);
+                return true;
             }
-            break;
+            return false;
             
         case MINT_STATE_READY_WITH_WALLET:
-            // In sealed state, ensure storage shows only public address
-            {
-                String public_address = wallet.getPublicAddress();
-                
-                // Update readme with public address only
-                char readme[512];
-                snprintf(readme, sizeof(readme),
-                    "MINT DEVICE - SEALED STATE\n\n"
-                    "This device is securely sealed. To access the private key,\n"
-                    "you must physically break the security circuit.\n\n"
-                    "Bitcoin Address:\n%s\n\n"
-                    "WARNING: Breaking the circuit is IRREVERSIBLE and will\n"
-                    "permanently expose the private key.",
-                    public_address.c_str());
-                
-                storage.updateReadmeFile(readme);
-            }
-            break;
+            // In sealed state, storage shows only the public address, and
+            // a warning if the file it was made from added next to nothing
+            readme_length = MintReadme::render(isWeakFile() ? MINT_README_SEALED_WEAK_FILE :
+                                               MINT_README_SEALED,
+                                               wallet.getPublicAddress().c_str(), nullptr,
+                                               readme_text);
+            return true;
             
         default:
-            // Other states don't need special handling here
-            break;
+            // Other states keep the README written by storage
+            return false;
     }
 }
 
-bool MintDevice::processNewEntropyFile(const uint8_t* buffer, size_t buffer_size) {
-    // Only process if we don't have a wallet and circuit is intact
+template <class Board>
+bool MintDeviceT<Board>::processNewEntropyFile(const uint8_t* buffer, size_t buffer_size) {
+    // Only process if we don't have a wallet, circuit is intact and the
+    // SE050 is answering
     if (processing_file || device_state == MINT_STATE_TAMPERED || 
-        device_state == MINT_STATE_READY_WITH_WALLET) {
+        device_state == MINT_STATE_READY_WITH_WALLET || device_state == MINT_STATE_DEGRADED) {
         return false;
     }
     
+    if (!buffer || buffer_size == 0) {
+        return false;
+    }
+    
+    // Stage the file; the crypto task does the SE050 work so the storage
+    // task returns at once
+    pending_file_size = min(buffer_size, sizeof(pending_file));
+    memcpy(pending_file, buffer, pending_file_size);
+    
+    // Estimate what the file adds; a weak file is still used, the
+    // hardware entropy mixed in carries the wallet either way
+    file_estimator.reset();
+    file_estimator.update(pending_file, pending_file_size);
+    file_estimator.finish(file_estimate);
+    recordFileEstimate();
+    MINT_LOG("entropy file taken, %u bytes, weak %u", pending_file_size, isWeakFile());
+    
     // Set processing flag and update state
     processing_file = true;
     device_state = MINT_STATE_GENERATING_WALLET;
     updateLEDFromState();
     
+    return true;
+}
+
+template <class Board>
+bool MintDeviceT<Board>::processChallengeFile(const uint8_t* buffer, size_t buffer_size) {
+    // One batch at a time, in the challenge file format (mint_wallet.h)
+    if (proving || proof_challenge_count || !buffer ||
+        buffer_size <= MINT_CHALLENGE_HEADER_SIZE ||
+        memcmp(buffer, MINT_CHALLENGE_MAGIC, MINT_CHALLENGE_HEADER_SIZE) != 0) {
+        return false;
+    }
+    
+    const size_t payload = buffer_size - MINT_CHALLENGE_HEADER_SIZE;
+    if (payload % MINT_PROOF_CHALLENGE_SIZE != 0 ||
+        payload / MINT_PROOF_CHALLENGE_SIZE > MINT_PROOF_MAX_CHALLENGES) {
+        return false;
+    }
+    
+    memcpy(proof_challenges, buffer + MINT_CHALLENGE_HEADER_SIZE, payload);
+    proof_challenge_count = payload / MINT_PROOF_CHALLENGE_SIZE;
+    MINT_LOG("challenge file taken, %u challenges", proof_challenge_count);
+    return true;
+}
+
+template <class Board>
+void MintDeviceT<Board>::startOwnershipProof() {
+    // No signatures from a device that failed its self-test
+    proving = !self_test.hasFailed() &&
+              wallet.startOwnershipProof(proof_challenges, proof_challenge_count);
+    proof_challenge_count = 0;
+}
+
+template <class Board>
+void MintDeviceT<Board>::pollOwnershipProof() {
+    uint8_t proof[MINT_PROOF_MAX_SIZE];
+    size_t proof_len = 0;
+    MintSecureTypes::JobStatus status = wallet.pollOwnershipProof(proof, sizeof(proof), proof_len);
+    if (status == MintSecureTypes::JOB_PENDING) {
+        return;
+    }
+    
+    // All signatures go back in one file; a failed batch writes nothing
+    // and the host drops the challenge again
+    proving = false;
+    if (status == MintSecureTypes::JOB_DONE) {
+        const bool written = storage.writeProof(proof, proof_len);
+        MINT_LOG("ownership proof, %u bytes, written %u", proof_len, written);
+    } else {
+        MINT_LOG("ownership proof failed");
+    }
+}
+
+template <class Board>
+void MintDeviceT<Board>::stageGeneration() {
+    // Staged entropy waits for a file only so long
+    if ((staged_secure_valid || staged_pool_valid) &&
+        micros() - staged_us >= MINT_PRESTAGE_LIFETIME_US) {
+        clearStagedGeneration();
+        MINT_LOG("staged entropy expired");
+    }
+    
+    // A device that failed its self-test makes no keys
+    if (self_test.hasFailed() || (staged_secure_valid && staged_pool_valid)) {
+        return;
+    }
+    
+    // The TRNG draw also keeps the SE050 exercised, so a dead bus shows
+    // as degraded before a file arrives rather than after
+    const bool was_empty = !staged_secure_valid && !staged_pool_valid;
+    if (!staged_secure_valid && (long)(micros() - stage_retry_us) >= 0) {
+        staged_secure_valid = generateSecureEntropy(staged_secure, sizeof(staged_secure));
+        if (!staged_secure_valid) {
+            stage_retry_us = micros() + STAGE_RETRY_US;
+        }
+    }
+    if (!staged_pool_valid && entropy.isReady()) {
+        staged_pool_valid = entropy.draw(staged_pool, sizeof(staged_pool));
+    }
+    
+    if (was_empty && (staged_secure_valid || staged_pool_valid)) {
+        staged_us = micros();
+    }
+    if (staged_secure_valid && staged_pool_valid) {
+        MINT_LOG("entropy staged for the next wallet");
+    }
+}
+
+template <class Board>
+void MintDeviceT<Board>::clearStagedGeneration() {
+    memset(staged_secure, 0, sizeof(staged_secure));
+    memset(staged_pool, 0, sizeof(staged_pool));
+    staged_secure_valid = false;
+    staged_pool_valid = false;
+}
+
+template <class Board>
+void MintDeviceT<Board>::startWalletGeneration() {
     // Generate secure entropy by mixing user-provided data with hardware entropy
+    // A device that failed its self-test makes no keys
     uint8_t final_entropy[32]; // 256 bits of entropy
-    if (!mixEntropySources(buffer, buffer_size, final_entropy, sizeof(final_entropy))) {
-        // Failed to generate secure entropy
-        device_state = MINT_STATE_READY_NO_WALLET;
-        processing_file = false;
-        updateLEDFromState();
-        return false;
+    bool started = !self_test.hasFailed() &&
+                   mixEntropySources(pending_file, pending_file_size,
+                                     final_entropy, sizeof(final_entropy));
+    
+    // The file and the staged entropy are consumed either way
+    memset(pending_file, 0, sizeof(pending_file));
+    pending_file_size = 0;
+    clearStagedGeneration();
+    
+    // Start wallet generation; later releases poll it
+    if (started) {
+        started = wallet.startGeneration(final_entropy, sizeof(final_entropy));
     }
     
-    // Generate wallet from entropy
-    if (!wallet.generateFromEntropy(final_entropy, sizeof(final_entropy))) {
+    // Zero out sensitive data (the job keeps its own copy)
+    memset(final_entropy, 0, sizeof(final_entropy));
+    
+    if (!started) {
         // Failed to generate wallet
+        MINT_LOG("wallet generation did not start");
         device_state = MINT_STATE_READY_NO_WALLET;
         processing_file = false;
         updateLEDFromState();
-        
-        // Zero out sensitive data
-        memset(final_entropy, 0, sizeof(final_entropy));
-        return false;
     }
-    
-    // Zero out sensitive data
-    memset(final_entropy, 0, sizeof(final_entropy));
+}
+
+template <class Board>
+void MintDeviceT<Board>::pollWalletGeneration() {
+    MintSecureTypes::JobStatus status = wallet.pollGeneration();
+    if (status == MintSecureTypes::JOB_PENDING) {
+        return;
+    }
     
     // Update state
-    device_state = MINT_STATE_READY_WITH_WALLET;
+    if (status == MintSecureTypes::JOB_DONE) {
+        device_state = MINT_STATE_READY_WITH_WALLET;
+    } else {
+        MINT_LOG("wallet generation failed");
+        device_state = MINT_STATE_READY_NO_WALLET;
+    }
     processing_file = false;
     updateLEDFromState();
-    
-    return true;
 }
 
-bool MintDevice::generateSecureEntropy(uint8_t* output_buffer, size_t buffer_size) {
+template <class Board>
+bool MintDeviceT<Board>::generateSecureEntropy(uint8_t* output_buffer, size_t buffer_size) {
     // Validate parameters
     if (!output_buffer || buffer_size < 32) {
         return false;
@@ -194,16 +534,32 @@ bool MintDevice::generateSecureEntropy(uint8_t* output_buffer, size_t buffer_siz
     return secure.generateEntropy(output_buffer, buffer_size);
 }
 
-bool MintDevice::mixEntropySources(const uint8_t* external_data, size_t external_size,
+template <class Board>
+bool MintDeviceT<Board>::mixEntropySources(const uint8_t* external_data, size_t external_size,
                                   uint8_t* output_buffer, size_t buffer_size) {
     // Validate parameters
     if (!external_data || external_size == 0 || !output_buffer || buffer_size < 32) {
         return false;
     }
     
-    // Generate hardware entropy
+    // Hardware entropy from the SE050 TRNG and the MCU pool; either one
+    // is enough, so neither source holds up generation. Sources staged
+    // while the device waited for the file are used as they are.
     uint8_t hardware_entropy[32];
-    if (!generateSecureEntropy(hardware_entropy, sizeof(hardware_entropy))) {
+    uint8_t pool_entropy[ENTROPY_OUTPUT_SIZE];
+    bool have_secure = staged_secure_valid;
+    bool have_pool = staged_pool_valid;
+    if (have_secure) {
+        memcpy(hardware_entropy, staged_secure, sizeof(hardware_entropy));
+    } else {
+        have_secure = generateSecureEntropy(hardware_entropy, sizeof(hardware_entropy));
+    }
+    if (have_pool) {
+        memcpy(pool_entropy, staged_pool, sizeof(pool_entropy));
+    } else {
+        have_pool = entropy.draw(pool_entropy, sizeof(pool_entropy));
+    }
+    if (!have_secure && !have_pool) {
         return false;
     }
     
@@ -212,19 +568,31 @@ bool MintDevice::mixEntropySources(const uint8_t* external_data, size_t external
     // For now, use secure element to calculate SHA-256 of combined data
     
     // Create a buffer to hold hardware entropy and external data
-    const size_t combined_size = sizeof(hardware_entropy) + external_size;
+    const size_t combined_size = sizeof(hardware_entropy) + sizeof(pool_entropy) + external_size;
     uint8_t* combined_data = (uint8_t*)malloc(combined_size);
     
     if (!combined_data) {
+        memset(hardware_entropy, 0, sizeof(hardware_entropy));
+        memset(pool_entropy, 0, sizeof(pool_entropy));
         return false;
     }
     
-    // Copy data to combined buffer
-    memcpy(combined_data, hardware_entropy, sizeof(hardware_entropy));
-    memcpy(combined_data + sizeof(hardware_entropy), external_data, external_size);
+    // Copy data to combined buffer; a source that failed contributes zeros
+    size_t offset = 0;
+    if (!have_secure) {
+        memset(hardware_entropy, 0, sizeof(hardware_entropy));
+    }
+    if (!have_pool) {
+        memset(pool_entropy, 0, sizeof(pool_entropy));
+    }
+    memcpy(combined_data + offset, hardware_entropy, sizeof(hardware_entropy));
+    offset += sizeof(hardware_entropy);
+    memcpy(combined_data + offset, pool_entropy, sizeof(pool_entropy));
+    offset += sizeof(pool_entropy);
+    memcpy(combined_data + offset, external_data, external_size);
     
     // Hash combined data using secure element
-    bool result = secure.se050.calculateSHA256(combined_data, combined_size, output_buffer);
+    bool result = secure.sha256(combined_data, combined_size, output_buffer);
     
     // Zero out and free the combined buffer
     memset(combined_data, 0, combined_size);
@@ -232,14 +600,27 @@ bool MintDevice::mixEntropySources(const uint8_t* external_data, size_t external
     
     // Zero out hardware entropy
     memset(hardware_entropy, 0, sizeof(hardware_entropy));
+    memset(pool_entropy, 0, sizeof(pool_entropy));
     
     return result;
 }
 
-void MintDevice::handleCircuitBreak() {
+template <class Board>
+void MintDeviceT<Board>::handleCircuitBreak() {
     // Update state
     device_state = MINT_STATE_TAMPERED;
     
+    // Drop any half-finished wallet generation and its key material, and
+    // any ownership proof: an opened device has nothing left to prove
+    secure.cancelJob();
+    memset(pending_file, 0, sizeof(pending_file));
+    pending_file_size = 0;
+    clearStagedGeneration();
+    processing_file = false;
+    proof_challenge_count = 0;
+    proving = false;
+    MINT_LOG("circuit broken");
+    
     // Record permanent tamper state in OTP memory
     secure.recordPermanentTamperState();
     
@@ -247,7 +628,54 @@ void MintDevice::handleCircuitBreak() {
     updateLEDFromState();
 }
 
-void MintDevice::updateLEDFromState() {
+template <class Board>
+typename MintDeviceT<Board>::MintState MintDeviceT<Board>::readyState() const {
+    if (!circuit.isIntact() || secure.isTampered()) {
+        return MINT_STATE_TAMPERED;
+    }
+    return wallet.isGenerated() ? MINT_STATE_READY_WITH_WALLET : MINT_STATE_READY_NO_WALLET;
+}
+
+template <class Board>
+void MintDeviceT<Board>::traceStateChange() {
+    if (device_state != traced_state) {
+        MINT_TRACE(TRACE_EVENT_STATE, device_state, nullptr, 0);
+        MINT_LOG("state %u -> %u", traced_state, device_state);
+        traced_state = device_state;
+    }
+}
+
+template <class Board>
+void MintDeviceT<Board>::recordFileEstimate() {
+#ifdef MINT_TRACE_ENABLED
+    const uint16_t millibits[3] = {
+        file_estimate.mcv_millibits, file_estimate.markov_millibits,
+        file_estimate.compression_millibits
+    };
+    uint8_t data[sizeof(millibits)];
+    for (size_t i = 0; i < 3; i++) {
+        data[i * 2] = (uint8_t)millibits[i];
+        data[i * 2 + 1] = (uint8_t)(millibits[i] >> 8);
+    }
+    MINT_TRACE(TRACE_EVENT_ENTROPY_FILE, file_estimate.credited_bits, data, sizeof(data));
+#endif
+}
+
+template <class Board>
+bool MintDeviceT<Board>::isWeakFile() const {
+    return file_estimate.bytes && file_estimate.credited_bits < ESTIMATOR_WEAK_FILE_BITS;
+}
+
+template <class Board>
+MINT_RAM_FUNC(device_update_led)
+void MintDeviceT<Board>::updateLEDFromState() {
+    // A failed self-test shows until reboot; the tamper indication wins,
+    // since the key must still be revealed
+    if (self_test.hasFailed() && device_state != MINT_STATE_TAMPERED) {
+        led.setError();
+        return;
+    }
+    
     switch (device_state) {
         case MINT_STATE_INITIALIZING:
             led.setInitializing(); // Blue
@@ -269,29 +697,56 @@ void MintDevice::updateLEDFromState() {
             led.setTampered(); // Green
             break;
             
+        case MINT_STATE_DEGRADED:
+            led.setError(); // SE050 out of service
+            break;
+            
         default:
             led.setError(); // Rapid flashing red
             break;
     }
 }
 
-MintDevice::MintState MintDevice::getState() const {
+template <class Board>
+typename MintDeviceT<Board>::MintState MintDeviceT<Board>::getState() const {
     return device_state;
 }
 
-bool MintDevice::hasWallet() const {
+template <class Board>
+bool MintDeviceT<Board>::hasWallet() const {
     return wallet.isGenerated();
 }
 
-String MintDevice::getPublicAddress() {
+template <class Board>
+String MintDeviceT<Board>::getPublicAddress() {
     return wallet.getPublicAddress();
 }
 
-String MintDevice::getPrivateKey() {
+template <class Board>
+String MintDeviceT<Board>::getPrivateKey() {
     // Only allow access to private key in tampered state
     if (device_state != MINT_STATE_TAMPERED) {
         return "Error: Device not in tampered state";
     }
     
     return wallet.getPrivateKey();
-}
\ No newline at end of file
+}
+
+template <class Board>
+const MintEntropyEstimator::Estimate& MintDeviceT<Board>::getFileEstimate() const {
+    return file_estimate;
+}
+
+template <class Board>
+bool MintDeviceT<Board>::isGenerationStaged() const {
+    return staged_secure_valid && staged_pool_valid;
+}
+
+template <class Board>
+const MintSelfTestT<typename Board::Secure, typename Board::Entropy>&
+MintDeviceT<Board>::getSelfTest() const {
+    return self_test;
+}
+
+// Board profile selected for this build (mint_board.h)
+template class MintDeviceT<MintBoard>;
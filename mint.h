@@ -3,20 +3,32 @@
 #define MINT_H
 
 #include <Arduino.h>
-#include "mint_storage.h"
-#include "mint_led.h"
-#include "mint_secure.h"
+#include "mint_board.h"
 #include "mint_wallet.h"
-#include "mint_circuit.h"
+#include "mint_scheduler.h"
+#include "mint_readme.h"
+#include "mint_estimator.h"
+#include "mint_selftest.h"
 
-// Global definitions
-#define CIRCUIT_PIN 14
+// Largest entropy file staged for wallet generation (one disk block)
+#define MINT_ENTROPY_FILE_SIZE 512
+
+// Longest hardware entropy staged for the next wallet is kept waiting for
+// a file before it is zeroed and fetched again
+#ifndef MINT_PRESTAGE_LIFETIME_US
+#define MINT_PRESTAGE_LIFETIME_US 300000000UL
+#endif
 
 /**
  * Main device class coordinating all subsystems.
  * Handles state management, circuit monitoring, and user interactions.
+ *
+ * Templated on a board profile (mint_board.h) that supplies the secure
+ * element, storage, LED and circuit backends; mint.cpp instantiates the
+ * profile selected for the build.
  */
-class MintDevice {
+template <class Board>
+class MintDeviceT {
 public:
     /**
      * Device states as a state machine
@@ -26,13 +38,14 @@ public:
         MINT_STATE_READY_NO_WALLET,  // Ready but no wallet generated yet
         MINT_STATE_GENERATING_WALLET, // Processing entropy and generating wallet
         MINT_STATE_READY_WITH_WALLET, // Wallet ready, device sealed
-        MINT_STATE_TAMPERED          // Circuit broken, device reveals private key
+        MINT_STATE_TAMPERED,         // Circuit broken, device reveals private key
+        MINT_STATE_DEGRADED          // SE050 not answering or tamper record unread
     } MintState;
 
     /**
      * Constructor initializes all subsystems
      */
-    MintDevice();
+    MintDeviceT();
     
     /**
      * Initialize the device and all subsystems
@@ -41,11 +54,36 @@ public:
     bool begin();
     
     /**
-     * Main loop function, handles state updates
+     * Main loop function, runs one scheduler pass
      * Should be called frequently from Arduino loop()
      */
     void loop();
     
+    /**
+     * Get time until the next task is released, for sleeping between passes
+     * @return Milliseconds until loop() has work to do
+     */
+    unsigned long getIdleTime() const;
+    
+    /**
+     * Get the task scheduler, for reading task timing counters
+     * @return Scheduler driving loop()
+     */
+    const MintScheduler& getScheduler() const;
+    
+    /**
+     * Clear the scheduler's task timing counters, to time a fresh window
+     */
+    void resetTaskStats();
+    
+    /**
+     * Time the USB mass storage callbacks with a cold XIP cache
+     * @param rounds Calls per callback
+     * @param latency Output cycle counts
+     * @return true if measured, false on builds without an XIP cache
+     */
+    bool measureCallbackLatency(uint32_t rounds, CallbackLatency& latency);
+    
     /**
      * Get current device state
      * @return Current state enum
@@ -70,19 +108,115 @@ public:
      */
     String getPrivateKey();
     
+    /**
+     * Get the entropy estimates for the last file taken for a wallet
+     * @return Estimates, all zero if no file was taken since boot
+     */
+    const MintEntropyEstimator::Estimate& getFileEstimate() const;
+    
+    /**
+     * Check whether the hardware entropy for the next wallet is staged
+     * @return true if a file dropped now is mixed without drawing any
+     */
+    bool isGenerationStaged() const;
+    
+    /**
+     * Get the background self-test, for reading its results
+     * @return Self-test run by the device's lowest priority task
+     */
+    const MintSelfTestT<typename Board::Secure, typename Board::Entropy>& getSelfTest() const;
+    
 private:
+    // Host microbenchmark (tests/host/micro_bench.cpp)
+    friend class MintTimingProbe;
+    
     MintState device_state;          // Current device state
-    MintSecure secure;               // Secure element interface
-    MintStorage storage;             // USB mass storage
-    MintLED led;                     // Status LED
-    MintCircuit circuit;             // Tamper circuit monitor
-    MintWallet wallet;               // Bitcoin wallet
+    MintState traced_state;          // Last state written to the I/O trace
+    typename Board::Secure secure;   // Secure element interface
+    typename Board::Storage storage; // USB mass storage
+    typename Board::Led led;         // Status LED
+    typename Board::Circuit circuit; // Tamper circuit monitor
+    typename Board::Entropy entropy; // MCU entropy collector
+    MintWalletT<typename Board::Secure> wallet; // Bitcoin wallet
+    MintSelfTestT<typename Board::Secure, typename Board::Entropy> self_test; // Background self-test
+    MintScheduler scheduler;         // Cooperative task scheduler
     
     bool processing_file;            // Flag for file processing state
     
-    // Buffer for entropy collection
-    uint8_t entropy_buffer[32];      // Full 32 bytes for maximum entropy
-    size_t entropy_collected;        // Amount collected so far
+    // Entropy file handed over by storage, consumed by the crypto task
+    uint8_t pending_file[MINT_ENTROPY_FILE_SIZE];
+    size_t pending_file_size;
+    
+    // Entropy the staged file is estimated to add; a weak file is
+    // flagged in the sealed README
+    MintEntropyEstimator file_estimator;
+    MintEntropyEstimator::Estimate file_estimate;
+    
+    // SE050 and MCU entropy drawn and health-tested while waiting for a
+    // file, so only the mix and key creation follow it; zeroed once used,
+    // when it expires, on a circuit break or when the SE050 degrades
+    uint8_t staged_secure[32];
+    uint8_t staged_pool[ENTROPY_OUTPUT_SIZE];
+    bool staged_secure_valid;
+    bool staged_pool_valid;
+    unsigned long staged_us;         // When the first source was staged
+    unsigned long stage_retry_us;    // Next SE050 draw after a failed one
+    
+    // Ownership challenges handed over by storage, signed by the crypto task
+    uint8_t proof_challenges[MINT_PROOF_MAX_CHALLENGES * MINT_PROOF_CHALLENGE_SIZE];
+    size_t proof_challenge_count;
+    bool proving;                    // Ownership proof job in flight
+    
+    // README sector, re-rendered only when the state changes
+    char readme_text[MINT_README_SIZE];
+    size_t readme_length;
+    MintState readme_state;
+    bool readme_valid;
+    
+    /**
+     * Register the device tasks with the scheduler
+     */
+    void registerTasks();
+    
+    /**
+     * Crypto task: start or advance wallet generation, one step per release
+     */
+    void cryptoTask();
+    
+    /**
+     * Display task: refresh the LED and the README for the current state
+     */
+    void displayTask();
+    
+    /**
+     * Self-test task: run self-test slices, the SE050 checks only while
+     * no wallet generation or ownership proof needs the secure element
+     */
+    void selfTestTask();
+    
+    /**
+     * Render the README for the current state into readme_text from
+     * its compile-time template (mint_readme.h)
+     * @return true if the state has a README to show, false otherwise
+     */
+    bool renderReadme();
+    
+    /**
+     * Record a state transition in the I/O trace
+     */
+    void traceStateChange();
+    
+    /**
+     * Record the staged file's entropy estimate in the I/O trace
+     */
+    void recordFileEstimate();
+    
+    /**
+     * Check whether the file the wallet was made from added next to no
+     * entropy (less than ESTIMATOR_WEAK_FILE_BITS)
+     * @return true if the last file taken was weak, false otherwise
+     */
+    bool isWeakFile() const;
     
     /**
      * Update LED based on current device state
@@ -95,13 +229,64 @@ private:
     void handleCircuitBreak();
     
     /**
-     * Process a file to extract entropy for wallet generation
+     * State for a device with a working SE050: tampered if the circuit is
+     * broken or the OTP record says so, otherwise ready with or without
+     * a wallet
+     */
+    MintState readyState() const;
+    
+    /**
+     * Stage a file for wallet generation and estimate its entropy; the
+     * crypto task consumes it
      * @param buffer File contents
      * @param buffer_size Size of buffer
-     * @return true if processing successful, false otherwise
+     * @return true if the file was accepted, false otherwise
      */
     bool processNewEntropyFile(const uint8_t* buffer, size_t buffer_size);
     
+    /**
+     * Stage an ownership challenge file on a sealed device; the crypto
+     * task signs it and writes the proof
+     * @param buffer File contents (MINT_CHALLENGE_MAGIC, then challenges)
+     * @param buffer_size Size of buffer
+     * @return true if the challenges were accepted, false otherwise
+     */
+    bool processChallengeFile(const uint8_t* buffer, size_t buffer_size);
+    
+    /**
+     * Start signing the staged challenges
+     */
+    void startOwnershipProof();
+    
+    /**
+     * Advance an in-flight ownership proof and write the proof file
+     * once every challenge is signed
+     */
+    void pollOwnershipProof();
+    
+    /**
+     * Draw the hardware entropy the next wallet will mix, replacing it
+     * once it is MINT_PRESTAGE_LIFETIME_US old
+     */
+    void stageGeneration();
+    
+    /**
+     * Zero staged hardware entropy
+     */
+    void clearStagedGeneration();
+    
+    /**
+     * Mix the staged entropy file with hardware entropy and start the
+     * wallet generation job
+     */
+    void startWalletGeneration();
+    
+    /**
+     * Advance an in-flight wallet generation job and settle the state
+     * once it finishes
+     */
+    void pollWalletGeneration();
+    
     /**
      * Generate high-quality entropy from various sources
      * @param output_buffer Buffer to store entropy
@@ -111,7 +296,9 @@ private:
     bool generateSecureEntropy(uint8_t* output_buffer, size_t buffer_size);
     
     /**
-     * Mix external entropy with hardware-generated entropy
+     * Mix external entropy with hardware-generated entropy from the SE050
+     * and the MCU entropy pool, staged or drawn now; fails only if
+     * neither is available
      * @param external_data External data to mix
      * @param external_size Size of external data
      * @param output_buffer Buffer to store mixed entropy
@@ -122,4 +309,7 @@ private:
                            uint8_t* output_buffer, size_t buffer_size);
 };
 
+// Device built for the selected board profile
+typedef MintDeviceT<MintBoard> MintDevice;
+
 #endif // MINT_H
\ No newline at end of file
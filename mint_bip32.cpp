@@ -0,0 +1,187 @@
+#include "mint_bip32.h"
+#include "mint_memory.h"
+#include "mint_hash.h"
+#include "mint_secp256k1.h"
+#include <string.h>
+
+// Bech32 character set (BIP173)
+MINT_RAM_DATA(bech32_chars)
+static const char BECH32_CHARS[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+
+// Mainnet human-readable part
+static const char SEGWIT_HRP[] = "bc";
+
+// Witness version 0, 20-byte key hash program
+#define SEGWIT_V0_PROGRAM_LENGTH 20
+#define SEGWIT_V0_DATA_CHARS 33     // Version + 160 bits in 5-bit groups
+#define BECH32_CHECKSUM_CHARS 6
+
+static void writeIndex(uint8_t* out, uint32_t index) {
+    out[0] = (uint8_t)(index >> 24);
+    out[1] = (uint8_t)(index >> 16);
+    out[2] = (uint8_t)(index >> 8);
+    out[3] = (uint8_t)index;
+}
+
+bool MintBIP32::deriveChildPublic(const ExtendedPublicKey& parent, uint32_t index,
+                                  ExtendedPublicKey& child) {
+    if (index & BIP32_HARDENED) {
+        return false;
+    }
+
+    // I = HMAC-SHA512(c_par, serP(K_par) || ser32(i))
+    uint8_t data[37];
+    uint8_t mac[64];
+    MintSecp256k1::compress(parent.public_key, data);
+    writeIndex(data + 33, index);
+    MintHash::hmacSha512(parent.chain_code, sizeof(parent.chain_code), data, sizeof(data), mac);
+
+    // K_i = I_L * G + K_par; I_L >= n or infinity means skip to the next index
+    if (!MintSecp256k1::isBelowOrder(mac) ||
+        !MintSecp256k1::tweakAddPublic(parent.public_key, mac, child.public_key)) {
+        return false;
+    }
+    memcpy(child.chain_code, mac + 32, sizeof(child.chain_code));
+
+    return true;
+}
+
+bool MintBIP32::deriveChildPrivate(const uint8_t* key, const uint8_t* chain_code, uint32_t index,
+                                   uint8_t* key_out, uint8_t* chain_code_out) {
+    uint8_t data[37];
+    uint8_t mac[64];
+
+    if (index & BIP32_HARDENED) {
+        data[0] = 0x00;
+        memcpy(data + 1, key, 32);
+    } else {
+        uint8_t public_key[65];
+        if (!MintSecp256k1::baseMultiply(key, public_key)) {
+            return false;
+        }
+        MintSecp256k1::compress(public_key, data);
+    }
+    writeIndex(data + 33, index);
+    MintHash::hmacSha512(chain_code, 32, data, sizeof(data), mac);
+
+    // k_i = I_L + k_par (mod n)
+    bool ok = MintSecp256k1::isBelowOrder(mac) &&
+              MintSecp256k1::tweakAddPrivate(key, mac, key_out);
+    if (ok) {
+        memcpy(chain_code_out, mac + 32, 32);
+    }
+
+    // Zero out key material
+    memset(data, 0, sizeof(data));
+    memset(mac, 0, sizeof(mac));
+    return ok;
+}
+
+bool MintBIP32::parsePath(const char* path, uint32_t* indices, size_t max_depth, size_t& depth) {
+    depth = 0;
+    if (!path || path[0] != 'm') {
+        return false;
+    }
+
+    const char* ptr = path + 1;
+    while (*ptr) {
+        if (*ptr++ != '/' || *ptr < '0' || *ptr > '9' || depth >= max_depth) {
+            return false;
+        }
+
+        uint64_t index = 0;
+        while (*ptr >= '0' && *ptr <= '9') {
+            index = index * 10 + (*ptr - '0');
+            if (index >= BIP32_HARDENED) {
+                return false; // Component out of range
+            }
+            ptr++;
+        }
+
+        if (*ptr == '\'' || *ptr == 'h') {
+            index |= BIP32_HARDENED;
+            ptr++;
+        }
+
+        indices[depth++] = (uint32_t)index;
+    }
+
+    return true;
+}
+
+// BIP173 checksum polynomial
+static uint32_t bech32Polymod(uint32_t chk, uint8_t value) {
+    MINT_RAM_DATA(bech32_generator)
+    static const uint32_t GENERATOR[5] = {
+        0x3b6a57b2, 0x26508e6d, 0x1ea119fa, 0x3d4233dd, 0x2a1462b3
+    };
+
+    uint8_t top = chk >> 25;
+    chk = ((chk & 0x1ffffff) << 5) ^ value;
+    for (int i = 0; i < 5; i++) {
+        if ((top >> i) & 1) {
+            chk ^= GENERATOR[i];
+        }
+    }
+    return chk;
+}
+
+bool MintBIP32::encodeP2WPKH(const uint8_t* public_key, char* address, size_t address_len) {
+    const size_t hrp_len = sizeof(SEGWIT_HRP) - 1;
+    if (!public_key || !address ||
+        address_len < hrp_len + 1 + SEGWIT_V0_DATA_CHARS + BECH32_CHECKSUM_CHARS + 1) {
+        return false;
+    }
+
+    // Witness program is HASH160 of the compressed key
+    uint8_t compressed[33];
+    uint8_t program[SEGWIT_V0_PROGRAM_LENGTH];
+    MintSecp256k1::compress(public_key, compressed);
+    MintHash::hash160(compressed, sizeof(compressed), program);
+
+    // Witness version followed by the program regrouped into 5-bit values
+    uint8_t values[SEGWIT_V0_DATA_CHARS];
+    size_t count = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    values[count++] = 0;
+    for (size_t i = 0; i < sizeof(program); i++) {
+        acc = (acc << 8) | program[i];
+        bits += 8;
+        while (bits >= 5) {
+            bits -= 5;
+            values[count++] = (acc >> bits) & 0x1f;
+        }
+    }
+
+    // Checksum covers the expanded HRP, the data and six zero values
+    uint32_t chk = 1;
+    for (size_t i = 0; i < hrp_len; i++) {
+        chk = bech32Polymod(chk, SEGWIT_HRP[i] >> 5);
+    }
+    chk = bech32Polymod(chk, 0);
+    for (size_t i = 0; i < hrp_len; i++) {
+        chk = bech32Polymod(chk, SEGWIT_HRP[i] & 0x1f);
+    }
+    for (size_t i = 0; i < count; i++) {
+        chk = bech32Polymod(chk, values[i]);
+    }
+    for (int i = 0; i < BECH32_CHECKSUM_CHARS; i++) {
+        chk = bech32Polymod(chk, 0);
+    }
+    chk ^= 1;
+
+    size_t pos = 0;
+    memcpy(address, SEGWIT_HRP, hrp_len);
+    pos += hrp_len;
+    address[pos++] = '1';
+    for (size_t i = 0; i < count; i++) {
+        address[pos++] = BECH32_CHARS[values[i]];
+    }
+    for (int i = 0; i < BECH32_CHECKSUM_CHARS; i++) {
+        address[pos++] = BECH32_CHARS[(chk >> (5 * (5 - i))) & 0x1f];
+    }
+    address[pos] = '\0';
+
+    return true;
+}
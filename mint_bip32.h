@@ -0,0 +1,82 @@
+#ifndef MINT_BIP32_H
+#define MINT_BIP32_H
+
+#include <Arduino.h>
+
+// Hardened child index flag
+#define BIP32_HARDENED 0x80000000
+
+// Deepest path accepted by parsePath()
+#define BIP32_MAX_DEPTH 8
+
+// The SE050 master key is the BIP84 account key m/84'/0'/0'
+#define MINT_ACCOUNT_PATH "m/84'/0'/0'"
+#define MINT_ACCOUNT_DEPTH 3
+
+// First receive address
+#define MINT_DEFAULT_ADDRESS_PATH "m/84'/0'/0'/0/0"
+
+// "bc1q" + 32 data chars + 6 checksum chars + NUL
+#define MINT_ADDRESS_BUFFER_SIZE 43
+
+/**
+ * BIP32 child key derivation and BIP173 address encoding.
+ *
+ * Public derivation (CKDpub) runs entirely on the MCU from the account
+ * extended public key, so receive addresses never touch the secure
+ * element. Private derivation is only used on the tamper path.
+ */
+class MintBIP32 {
+public:
+    /**
+     * Extended public key: point plus chain code.
+     */
+    typedef struct {
+        uint8_t public_key[65];      // Uncompressed secp256k1 point
+        uint8_t chain_code[32];
+    } ExtendedPublicKey;
+
+    /**
+     * Derive a non-hardened child public key (CKDpub).
+     * @param parent Parent extended public key
+     * @param index Child index, must be below BIP32_HARDENED
+     * @param child Output extended public key (may alias parent)
+     * @return true if successful, false if hardened or the index is invalid
+     */
+    static bool deriveChildPublic(const ExtendedPublicKey& parent, uint32_t index,
+                                  ExtendedPublicKey& child);
+
+    /**
+     * Derive a child private key (CKDpriv), hardened or not.
+     * @param key Parent private key (32 bytes)
+     * @param chain_code Parent chain code (32 bytes)
+     * @param index Child index
+     * @param key_out Output child private key (32 bytes, may alias key)
+     * @param chain_code_out Output child chain code (32 bytes, may alias chain_code)
+     * @return true if successful, false if the index is invalid
+     */
+    static bool deriveChildPrivate(const uint8_t* key, const uint8_t* chain_code, uint32_t index,
+                                   uint8_t* key_out, uint8_t* chain_code_out);
+
+    /**
+     * Parse a derivation path such as "m/84'/0'/0'/0/5".
+     * Both ' and h mark hardened components.
+     * @param path Path string
+     * @param indices Output child indices
+     * @param max_depth Capacity of indices
+     * @param depth Output number of components
+     * @return true if successful, false if malformed or too deep
+     */
+    static bool parsePath(const char* path, uint32_t* indices, size_t max_depth, size_t& depth);
+
+    /**
+     * Encode a native SegWit v0 (P2WPKH) mainnet address.
+     * @param public_key Public key (65 bytes, uncompressed)
+     * @param address Output string buffer
+     * @param address_len Size of output buffer (>= MINT_ADDRESS_BUFFER_SIZE)
+     * @return true if successful, false otherwise
+     */
+    static bool encodeP2WPKH(const uint8_t* public_key, char* address, size_t address_len);
+};
+
+#endif // MINT_BIP32_H
@@ -0,0 +1,52 @@
+#ifndef MINT_BOARD_H
+#define MINT_BOARD_H
+
+#include <Arduino.h>
+#include "mint_secure.h"
+#include "mint_storage.h"
+#include "mint_led.h"
+#include "mint_circuit.h"
+#include "mint_entropy.h"
+
+/**
+ * Board profiles.
+ *
+ * A profile names the backend types a MintDevice is built from, and the
+ * pins they use. MintDeviceT and MintWalletT are templated on these types,
+ * so every backend call is resolved at compile time with no virtual
+ * dispatch. Exactly one profile is built per target: RP2040 builds use
+ * the first revision and host builds the host profile. The disk medium
+ * is not a profile type: MINT_STORAGE_FLASH selects the flash disk over
+ * the RAM disk in MintStorage for any profile.
+ */
+
+/**
+ * First board revision: SE050, RAM disk, NeoPixel, GPIO14 tamper loop,
+ * ROSC and A0 noise.
+ */
+struct MintBoardRev1 {
+    typedef MintSecureT<SE05x, MintCircuit> Secure;
+    typedef MintStorage Storage;
+    typedef MintLED Led;
+    typedef MintCircuit Circuit;
+    typedef MintEntropy Entropy;
+
+    static const uint8_t LED_PIN = 16;
+    static const uint8_t CIRCUIT_SENSE = CIRCUIT_SENSE_PIN;
+    static const uint8_t NOISE_PIN = ANALOG_NOISE_PIN;
+};
+
+/**
+ * Host builds: first revision backends against the tests/host shims
+ * (simulated SE050, virtual clock, in-process USB host).
+ */
+struct MintBoardHost : MintBoardRev1 {
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef MintBoardRev1 MintBoard;
+#else
+typedef MintBoardHost MintBoard;
+#endif
+
+#endif // MINT_BOARD_H
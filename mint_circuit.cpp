@@ -1,48 +1,276 @@
 #include "mint_circuit.h"
+#include "mint_trace.h"
+#include "mint_memory.h"
+
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/adc.h>
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/structs/iobank0.h>
+#endif
 
 // Circuit definitions
-#define CIRCUIT_DEBOUNCE_MS 50  // Debounce time in milliseconds
 #define CIRCUIT_INTACT_VALUE LOW // Circuit intact = LOW, broken = HIGH
 
-MintCircuit::MintCircuit(uint8_t circuit_pin) : 
+// Sampling: 4 kHz, 64-sample windows (16 ms), 3 agreeing windows to confirm
+#define CIRCUIT_SAMPLE_RATE_HZ 4000
+#define CIRCUIT_WINDOW_SAMPLES 64
+#define CIRCUIT_CONFIRM_WINDOWS 3
+
+// Votes a window needs to be called intact or broken (3/4); anything less
+// is intermittent contact
+#define CIRCUIT_MAJORITY_VOTES (CIRCUIT_WINDOW_SAMPLES * 3 / 4)
+
+// Longest begin() waits for the initial state to confirm
+#define CIRCUIT_BOOT_TIMEOUT_MS 250
+
+// Analog thresholds (12-bit) for the loop against the internal pull-up
+#define CIRCUIT_INTACT_MAX 1024  // Below: loop closed
+#define CIRCUIT_BROKEN_MIN 3072  // Above: loop open; between: partial cut
+
+// GPIO STATUS register bit holding the pad input level
+#define CIRCUIT_STATUS_INFROMPAD (1u << 17)
+
+// Full DMA run; re-armed from task() when it ends (~12 days at 4 kHz)
+#define CIRCUIT_DMA_RUN_SAMPLES 0xFFFFFFFFu
+
+// ADC conversion clock
+#define CIRCUIT_ADC_CLOCK_HZ 48000000
+
+#ifdef ARDUINO_ARCH_RP2040
+// Sample ring, aligned to its size for DMA write address wrapping
+static volatile uint32_t circuit_ring[CIRCUIT_RING_SAMPLES]
+    __attribute__((aligned(CIRCUIT_RING_SAMPLES * sizeof(uint32_t))));
+
+// log2 of the ring size in bytes, for channel_config_set_ring()
+static uint8_t ringWrapBits() {
+    uint8_t bits = 0;
+    while ((1u << bits) < sizeof(circuit_ring)) {
+        bits++;
+    }
+    return bits;
+}
+#endif
+
+MintCircuit::MintCircuit(uint8_t circuit_pin) :
     pin(circuit_pin),
-    current_state(true),       // Default to intact
-    previous_state(true),
+    current_state(CIRCUIT_INTACT), // Default to intact
     state_changed(false),
-    last_debounce_time(0),
-    debounce_delay(CIRCUIT_DEBOUNCE_MS) {
+    state_changed_callback(nullptr),
+#ifdef ARDUINO_ARCH_RP2040
+    ring(circuit_ring),
+#else
+    ring(emulated_ring),
+#endif
+    samples_read(0),
+    written_base(0),
+    dma_channel(-1),
+    last_sample_us(0),
+    window_fill(0),
+    candidate_state(CIRCUIT_INTACT),
+    candidate_windows(0),
+    last_vote(0xFF) {
+    memset(&stats, 0, sizeof(stats));
+    memset(window_votes, 0, sizeof(window_votes));
 }
 
 bool MintCircuit::begin() {
     // Configure the circuit pin as input with pullup
     pinMode(pin, INPUT_PULLUP);
-    
-    // Initialize state
-    current_state = readRawState();
-    previous_state = current_state;
-    
+
+    if (!startSampling()) {
+        return false;
+    }
+
+    // Boot state is whatever confirms first; an undecided loop is partial
+    current_state = CIRCUIT_PARTIAL;
+    candidate_state = CIRCUIT_PARTIAL;
+    unsigned long start = millis();
+    while (!state_changed && millis() - start < CIRCUIT_BOOT_TIMEOUT_MS) {
+        delay(1);
+        task();
+    }
+
+    // The boot state is not a transition
+    state_changed = false;
+
     return true;
 }
 
-bool MintCircuit::isIntact() {
-    // Update state with debouncing
-    bool raw_state = readRawState();
-    
-    // Reset debounce timer if state changed
-    if (raw_state != current_state) {
-        last_debounce_time = millis();
-    }
-    
-    // Update current state if debounce period passed
-    if ((millis() - last_debounce_time) > debounce_delay) {
-        // Only update if state is stable
-        if (raw_state != current_state) {
-            previous_state = current_state;
-            current_state = raw_state;
-            state_changed = true;
+bool MintCircuit::startSampling() {
+#ifdef ARDUINO_ARCH_RP2040
+    dma_channel = dma_claim_unused_channel(false);
+    if (dma_channel < 0) {
+        return false;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, ringWrapBits());
+
+    const volatile void* source;
+#ifdef MINT_CIRCUIT_ANALOG
+    // Free-running ADC; the loop resistance forms a divider with the pull-up
+    adc_init();
+    adc_gpio_init(pin);
+    gpio_pull_up(pin);
+    adc_select_input(pin - A0);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(CIRCUIT_ADC_CLOCK_HZ / CIRCUIT_SAMPLE_RATE_HZ - 1);
+    channel_config_set_dreq(&config, DREQ_ADC);
+    source = &adc_hw->fifo;
+#else
+    // The DMA can't reach SIO, so sample the pad level from IO_BANK0,
+    // paced by a DMA timer
+    int timer = dma_claim_unused_timer(false);
+    if (timer < 0) {
+        dma_channel_unclaim(dma_channel);
+        dma_channel = -1;
+        return false;
+    }
+    dma_timer_set_fraction(timer, 1, clock_get_hz(clk_sys) / CIRCUIT_SAMPLE_RATE_HZ);
+    channel_config_set_dreq(&config, dma_get_timer_dreq(timer));
+    source = &iobank0_hw->io[pin].status;
+#endif
+
+    dma_channel_configure(dma_channel, &config, (void*)ring, source,
+                          CIRCUIT_DMA_RUN_SAMPLES, true);
+#ifdef MINT_CIRCUIT_ANALOG
+    adc_run(true);
+#endif
+#else
+    // Host builds emulate the DMA from the virtual clock in samplesWritten()
+    dma_channel = 0;
+    last_sample_us = micros();
+#endif
+
+    return true;
+}
+
+uint32_t MintCircuit::samplesWritten() {
+#ifdef ARDUINO_ARCH_RP2040
+    // Re-arm a finished run; samples written by it are already counted
+    if (!dma_channel_is_busy(dma_channel)) {
+        written_base += CIRCUIT_DMA_RUN_SAMPLES;
+        dma_channel_set_trans_count(dma_channel, CIRCUIT_DMA_RUN_SAMPLES, true);
+    }
+    return written_base + (CIRCUIT_DMA_RUN_SAMPLES - dma_channel_hw_addr(dma_channel)->transfer_count);
+#else
+    // Take every sample that came due since the last call, at the level
+    // the pin had at each sample time
+    const unsigned long period_us = 1000000 / CIRCUIT_SAMPLE_RATE_HZ;
+    unsigned long due = (micros() - last_sample_us) / period_us;
+
+    for (unsigned long i = 0; i < due; i++) {
+        last_sample_us += period_us;
+#ifdef MINT_CIRCUIT_ANALOG
+        uint32_t raw = (uint32_t)MintHost::analogValueAt(pin, last_sample_us);
+#else
+        uint32_t raw = MintHost::pinLevelAt(pin, last_sample_us) == HIGH ?
+                       CIRCUIT_STATUS_INFROMPAD : 0;
+#endif
+        ring[written_base++ % CIRCUIT_RING_SAMPLES] = raw;
+    }
+    return written_base;
+#endif
+}
+
+MINT_RAM_FUNC(circuit_task)
+void MintCircuit::task() {
+    if (dma_channel < 0) {
+        return;
+    }
+
+    uint32_t pending = samplesWritten() - samples_read;
+
+    // Fell a full ring behind: skip to the newest samples, leaving the
+    // slot the DMA writes next alone
+    if (pending >= CIRCUIT_RING_SAMPLES) {
+        uint32_t skipped = pending - (CIRCUIT_RING_SAMPLES - 1);
+        stats.overruns += skipped;
+        samples_read += skipped;
+        pending -= skipped;
+    }
+
+    while (pending--) {
+        uint32_t raw = ring[samples_read++ % CIRCUIT_RING_SAMPLES];
+        processVote(classifySample(raw));
+    }
+}
+
+MINT_RAM_FUNC(circuit_classify_sample)
+uint8_t MintCircuit::classifySample(uint32_t raw) {
+#ifdef MINT_CIRCUIT_ANALOG
+    uint16_t level = raw & 0x0FFF;
+    uint8_t vote = level < CIRCUIT_INTACT_MAX ? CIRCUIT_INTACT :
+                   level > CIRCUIT_BROKEN_MIN ? CIRCUIT_BROKEN : CIRCUIT_PARTIAL;
+    uint32_t traced_level = level;
+#else
+    int level = (raw & CIRCUIT_STATUS_INFROMPAD) ? HIGH : LOW;
+    uint8_t vote = level == CIRCUIT_INTACT_VALUE ? CIRCUIT_INTACT : CIRCUIT_BROKEN;
+    uint32_t traced_level = level;
+#endif
+
+    // Record raw transitions, including bounces the filter rejects
+    if (vote != last_vote) {
+        MINT_TRACE(TRACE_EVENT_CIRCUIT, traced_level, nullptr, 0);
+        last_vote = vote;
+    }
+    (void)traced_level;
+
+    return vote;
+}
+
+MINT_RAM_FUNC(circuit_process_vote)
+void MintCircuit::processVote(uint8_t vote) {
+    stats.samples++;
+    window_votes[vote]++;
+    if (++window_fill < CIRCUIT_WINDOW_SAMPLES) {
+        return;
+    }
+
+    // A state needs a clear majority; a split window means intermittent contact
+    CircuitState window_state = CIRCUIT_PARTIAL;
+    if (window_votes[CIRCUIT_INTACT] >= CIRCUIT_MAJORITY_VOTES) {
+        window_state = CIRCUIT_INTACT;
+    } else if (window_votes[CIRCUIT_BROKEN] >= CIRCUIT_MAJORITY_VOTES) {
+        window_state = CIRCUIT_BROKEN;
+    }
+    memset(window_votes, 0, sizeof(window_votes));
+    window_fill = 0;
+    stats.windows++;
+
+    // Only a run of agreeing windows moves the confirmed state
+    if (window_state == candidate_state) {
+        if (candidate_windows < CIRCUIT_CONFIRM_WINDOWS) {
+            candidate_windows++;
+        }
+    } else {
+        if (candidate_state != current_state) {
+            stats.rejected_windows++;
+        }
+        candidate_state = window_state;
+        candidate_windows = 1;
+    }
+
+    if (candidate_windows >= CIRCUIT_CONFIRM_WINDOWS && candidate_state != current_state) {
+        current_state = candidate_state;
+        state_changed = true;
+        if (state_changed_callback) {
+            state_changed_callback(current_state);
         }
     }
-    
+}
+
+MINT_RAM_FUNC(circuit_is_intact)
+bool MintCircuit::isIntact() const {
+    return current_state != CIRCUIT_BROKEN;
+}
+
+MintCircuit::CircuitState MintCircuit::getState() const {
     return current_state;
 }
 
@@ -54,8 +282,10 @@ void MintCircuit::acknowledgeStateChange() {
     state_changed = false;
 }
 
-bool MintCircuit::readRawState() {
-    // Read the circuit pin
-    // LOW = intact, HIGH = broken
-    return (digitalRead(pin) == CIRCUIT_INTACT_VALUE);
-}
\ No newline at end of file
+void MintCircuit::setStateChangedCallback(StateChangedCallback callback) {
+    state_changed_callback = callback;
+}
+
+const MintCircuit::SampleStats& MintCircuit::getStats() const {
+    return stats;
+}
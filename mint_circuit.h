@@ -2,55 +2,149 @@
 #define MINT_CIRCUIT_H
 
 #include <Arduino.h>
+#include <functional>
+
+// GPIO pin connected to the tamper circuit trace
+#define CIRCUIT_PIN 14
+
+// Boards with the trace routed to an ADC input (GPIO26-29) define
+// MINT_CIRCUIT_ANALOG to measure the loop against the pin's pull-up and
+// tell partial cuts apart; otherwise the digital level is sampled and a
+// loop only reads partial when its windows split (intermittent contact)
+#ifdef MINT_CIRCUIT_ANALOG
+#define CIRCUIT_SENSE_PIN A1
+#else
+#define CIRCUIT_SENSE_PIN CIRCUIT_PIN
+#endif
+
+// Sample ring, a power of two so the DMA write address can wrap in hardware
+#define CIRCUIT_RING_SAMPLES 512
 
 /**
  * Class for managing the tamper-evident circuit.
- * Handles circuit monitoring, state management, and debouncing.
+ *
+ * The tamper trace is sampled continuously by DMA into a ring buffer
+ * (ADC FIFO in analog builds, the GPIO input register paced by a DMA
+ * timer otherwise), so acquisition costs no CPU. task() drains the ring:
+ * each sample votes intact, partial or broken, each window of samples is
+ * decided by majority, and the reported state only moves after several
+ * consecutive windows agree.
  */
 class MintCircuit {
 public:
+    /**
+     * Confirmed tamper loop state
+     */
+    typedef enum {
+        CIRCUIT_INTACT,   // Loop closed
+        CIRCUIT_PARTIAL,  // Raised resistance or intermittent contact
+        CIRCUIT_BROKEN    // Loop open
+    } CircuitState;
+
+    /**
+     * Sampling counters, for measuring filter behaviour.
+     */
+    typedef struct {
+        uint32_t samples;            // Samples processed
+        uint32_t windows;            // Windows voted
+        uint32_t rejected_windows;   // Transitions abandoned before confirming
+        uint32_t overruns;           // Samples lost because task() ran too late
+    } SampleStats;
+
+    // Callback for confirmed state transitions
+    typedef std::function<void(CircuitState)> StateChangedCallback;
+
     /**
      * Constructor for the circuit monitor.
-     * @param circuit_pin GPIO pin connected to tamper circuit
+     * @param circuit_pin Pin connected to tamper circuit (CIRCUIT_SENSE_PIN)
      */
     MintCircuit(uint8_t circuit_pin);
-    
+
     /**
-     * Initialize the circuit monitor.
+     * Initialize the circuit monitor and start sampling.
+     * Blocks until the initial state is confirmed or the boot window ends.
      * @return true if initialization successful, false otherwise
      */
     bool begin();
-    
+
+    /**
+     * Process samples gathered since the last call.
+     * Call from the main loop; fires the callback on a confirmed transition.
+     */
+    void task();
+
     /**
      * Check if the circuit is intact (not broken).
-     * Uses debouncing to avoid false detections.
+     * A partially cut loop still counts as intact.
      * @return true if circuit intact, false if broken
      */
-    bool isIntact();
-    
+    bool isIntact() const;
+
+    /**
+     * Get the confirmed circuit state.
+     * @return Current confirmed state
+     */
+    CircuitState getState() const;
+
     /**
      * Check if circuit state has changed since last check.
      * Useful for detecting tampering events.
      * @return true if state changed, false otherwise
      */
     bool hasStateChanged();
-    
+
     /**
      * Reset the state change detection.
      */
     void acknowledgeStateChange();
-    
+
+    /**
+     * Set callback for confirmed state transitions.
+     * @param callback Function to call with the new state
+     */
+    void setStateChangedCallback(StateChangedCallback callback);
+
+    /**
+     * Get sampling counters.
+     * @return Reference to the sampling statistics
+     */
+    const SampleStats& getStats() const;
+
 private:
-    const uint8_t pin;           // GPIO pin connected to circuit
-    bool current_state;          // Current debounced state
-    bool previous_state;         // Previous debounced state
+    const uint8_t pin;           // Pin connected to circuit
+    CircuitState current_state;  // Current confirmed state
     bool state_changed;          // Flag for state change detection
-    
-    unsigned long last_debounce_time; // Last time the circuit was checked
-    unsigned long debounce_delay;     // Debounce time in milliseconds
-    
-    // Read raw circuit state (without debouncing)
-    bool readRawState();
+    StateChangedCallback state_changed_callback;
+    SampleStats stats;
+
+    // Sample ring filled by DMA, drained by task()
+    volatile uint32_t* ring;
+#ifndef ARDUINO_ARCH_RP2040
+    uint32_t emulated_ring[CIRCUIT_RING_SAMPLES]; // Host builds: one ring per device
+#endif
+    uint32_t samples_read;       // Samples taken out of the ring, wraps
+    uint32_t written_base;       // Samples from finished DMA runs (host: emulated samples)
+    int dma_channel;
+    unsigned long last_sample_us; // Host builds: time of the last emulated sample
+
+    // Window being voted and run of agreeing windows
+    uint8_t window_votes[3];
+    uint8_t window_fill;
+    CircuitState candidate_state;
+    uint8_t candidate_windows;
+    uint8_t last_vote;           // Last sample vote, for tracing
+
+    // Start DMA sampling into the ring
+    bool startSampling();
+
+    // Total samples the DMA has written, wraps
+    uint32_t samplesWritten();
+
+    // Classify one raw sample into a vote
+    uint8_t classifySample(uint32_t raw);
+
+    // Feed one vote into the window and confirmation filter
+    void processVote(uint8_t vote);
 };
 
-#endif // MINT_CIRCUIT_H
\ No newline at end of file
+#endif // MINT_CIRCUIT_H
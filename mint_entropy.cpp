@@ -0,0 +1,354 @@
+#include "mint_entropy.h"
+#include "mint_memory.h"
+
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/adc.h>
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/structs/rosc.h>
+#endif
+
+// Sample rates: the ring oscillator is read slower than it runs so
+// consecutive bits are less correlated
+#define ENTROPY_ROSC_RATE_HZ 20000
+#define ENTROPY_ADC_RATE_HZ 10000
+
+// Pool is ready at twice the output size in credited entropy
+#define ENTROPY_POOL_BITS (2 * 8 * ENTROPY_OUTPUT_SIZE)
+
+// A source that fails this many times without passing a full adaptive
+// proportion window in between is taken out of the pool
+#define ENTROPY_MAX_FAILED_RUNS 4
+
+// Full DMA run; re-armed from task() when it ends
+#define ENTROPY_DMA_RUN_SAMPLES 0xFFFFFFFFu
+
+// ADC conversion clock
+#define ENTROPY_ADC_CLOCK_HZ 48000000
+
+/**
+ * Health test cutoffs (SP 800-90B 4.4, false positive rate 2^-20) and
+ * entropy credit, from the min-entropy claimed per sample: 1/8 bit for a
+ * ring oscillator bit, 1 bit for the four ADC LSBs. Samples are credited
+ * a whole adaptive proportion window at a time, once it has passed.
+ */
+typedef struct {
+    uint16_t rct_cutoff;             // Repetition count: 1 + ceil(20 / H)
+    uint16_t apt_window;             // Adaptive proportion window W
+    uint16_t apt_cutoff;             // 1 + CRITBINOM(W, 2^-H, 1 - 2^-20)
+    uint8_t sample_bits;             // Raw bits kept per sample
+    uint16_t window_credit;          // Bits credited per passing window, W * H
+    uint32_t rate_hz;
+} SourceParams;
+
+static const SourceParams SOURCE_PARAMS[MintEntropy::SOURCE_COUNT] = {
+    { 161, 1024, 979, 1, 1024 / 8, ENTROPY_ROSC_RATE_HZ },
+    { 21, 512, 311, 4, 512, ENTROPY_ADC_RATE_HZ }
+};
+
+#ifdef ARDUINO_ARCH_RP2040
+// Sample rings, aligned to their size for DMA write address wrapping and
+// kept off the striped banks in MINT_SRAM_PLACEMENT builds (mint_memory.h).
+// Host builds emulate them in each instance.
+static volatile uint8_t rosc_ring[ENTROPY_ROSC_RING_SAMPLES] MINT_SRAM4
+    __attribute__((aligned(ENTROPY_ROSC_RING_SAMPLES * sizeof(uint8_t))));
+static volatile uint16_t adc_ring[ENTROPY_ADC_RING_SAMPLES] MINT_SRAM5
+    __attribute__((aligned(ENTROPY_ADC_RING_SAMPLES * sizeof(uint16_t))));
+
+static_assert(sizeof(rosc_ring) <= MINT_SRAM_SCRATCH_BUDGET &&
+              sizeof(adc_ring) <= MINT_SRAM_SCRATCH_BUDGET,
+              "sample rings must leave room for the core stacks");
+
+// log2 of a ring size in bytes, for channel_config_set_ring()
+static uint8_t ringWrapBits(size_t bytes) {
+    uint8_t bits = 0;
+    while ((1u << bits) < bytes) {
+        bits++;
+    }
+    return bits;
+}
+#endif
+
+MintEntropy::MintEntropy(uint8_t noise_pin) :
+    pin(noise_pin),
+    pool_bits(0) {
+    memset(sources, 0, sizeof(sources));
+    memset(stats, 0, sizeof(stats));
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        sources[i].dma_channel = -1;
+        discardStaged((Source)i);
+    }
+    MintHash::sha256Init(pool);
+}
+
+bool MintEntropy::begin() {
+    bool any = false;
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        stats[i].enabled = startSampling((Source)i);
+        any = any || stats[i].enabled;
+    }
+    return any;
+}
+
+bool MintEntropy::startSampling(Source source) {
+#ifdef MINT_CIRCUIT_ANALOG
+    // The tamper loop owns the ADC
+    if (source == SOURCE_ADC) {
+        return false;
+    }
+#endif
+    SourceState& state = sources[source];
+#ifdef ARDUINO_ARCH_RP2040
+    state.dma_channel = dma_claim_unused_channel(false);
+    if (state.dma_channel < 0) {
+        return false;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(state.dma_channel);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+
+    volatile void* ring;
+    const volatile void* source_reg;
+    if (source == SOURCE_ROSC) {
+        // RANDOMBIT paced by a DMA timer
+        int timer = dma_claim_unused_timer(false);
+        if (timer < 0) {
+            dma_channel_unclaim(state.dma_channel);
+            state.dma_channel = -1;
+            return false;
+        }
+        dma_timer_set_fraction(timer, 1, clock_get_hz(clk_sys) / ENTROPY_ROSC_RATE_HZ);
+        channel_config_set_dreq(&config, dma_get_timer_dreq(timer));
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_ring(&config, true, ringWrapBits(sizeof(rosc_ring)));
+        ring = rosc_ring;
+        source_reg = &rosc_hw->randombit;
+    } else {
+        // Free-running ADC on the floating pin
+        adc_init();
+        adc_gpio_init(pin);
+        adc_select_input(pin - A0);
+        adc_fifo_setup(true, true, 1, false, false);
+        adc_set_clkdiv(ENTROPY_ADC_CLOCK_HZ / ENTROPY_ADC_RATE_HZ - 1);
+        channel_config_set_dreq(&config, DREQ_ADC);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_ring(&config, true, ringWrapBits(sizeof(adc_ring)));
+        ring = adc_ring;
+        source_reg = &adc_hw->fifo;
+    }
+
+    dma_channel_configure(state.dma_channel, &config, (void*)ring, source_reg,
+                          ENTROPY_DMA_RUN_SAMPLES, true);
+    if (source == SOURCE_ADC) {
+        adc_run(true);
+    }
+#else
+    // Host builds emulate the DMA from the virtual clock in samplesWritten()
+    state.dma_channel = source;
+    state.last_sample_us = micros();
+#endif
+    return true;
+}
+
+uint32_t MintEntropy::samplesWritten(Source source) {
+    SourceState& state = sources[source];
+#ifdef ARDUINO_ARCH_RP2040
+    // Re-arm a finished run; samples written by it are already counted
+    if (!dma_channel_is_busy(state.dma_channel)) {
+        state.written_base += ENTROPY_DMA_RUN_SAMPLES;
+        dma_channel_set_trans_count(state.dma_channel, ENTROPY_DMA_RUN_SAMPLES, true);
+    }
+    return state.written_base +
+           (ENTROPY_DMA_RUN_SAMPLES - dma_channel_hw_addr(state.dma_channel)->transfer_count);
+#else
+    // Take every sample that came due since the last call
+    const unsigned long period_us = 1000000 / SOURCE_PARAMS[source].rate_hz;
+    unsigned long due = (micros() - state.last_sample_us) / period_us;
+
+    // Older samples would be overwritten in the ring anyway
+    const uint32_t ring_samples = source == SOURCE_ROSC ? ENTROPY_ROSC_RING_SAMPLES :
+                                                          ENTROPY_ADC_RING_SAMPLES;
+    if (due > ring_samples) {
+        state.written_base += due - ring_samples;
+        state.last_sample_us += (due - ring_samples) * period_us;
+        due = ring_samples;
+    }
+
+    for (unsigned long i = 0; i < due; i++) {
+        state.last_sample_us += period_us;
+        if (source == SOURCE_ROSC) {
+            rosc_ring[state.written_base++ % ENTROPY_ROSC_RING_SAMPLES] =
+                (uint8_t)MintHost::roscBitAt(state.last_sample_us);
+        } else {
+            adc_ring[state.written_base++ % ENTROPY_ADC_RING_SAMPLES] =
+                (uint16_t)MintHost::analogNoiseAt(pin, state.last_sample_us);
+        }
+    }
+    return state.written_base;
+#endif
+}
+
+uint16_t MintEntropy::ringSample(Source source, uint32_t index) const {
+    if (source == SOURCE_ROSC) {
+        return rosc_ring[index % ENTROPY_ROSC_RING_SAMPLES] & 0x01;
+    }
+    return adc_ring[index % ENTROPY_ADC_RING_SAMPLES] & 0x0F;
+}
+
+void MintEntropy::task() {
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        const Source source = (Source)i;
+        SourceState& state = sources[source];
+        if (!stats[source].enabled) {
+            continue;
+        }
+
+        const uint32_t ring_samples = source == SOURCE_ROSC ? ENTROPY_ROSC_RING_SAMPLES :
+                                                              ENTROPY_ADC_RING_SAMPLES;
+        uint32_t pending = samplesWritten(source) - state.samples_read;
+
+        // Fell a full ring behind: skip to the newest samples, leaving the
+        // slot the DMA writes next alone. The skipped samples break the
+        // runs the health tests count, so the tests and window restart.
+        if (pending >= ring_samples) {
+            uint32_t skipped = pending - (ring_samples - 1);
+            stats[source].overruns += skipped;
+            state.samples_read += skipped;
+            pending -= skipped;
+            state.repeat_count = 0;
+            state.window_fill = 0;
+            discardStaged(source);
+        }
+
+        while (pending-- && stats[source].enabled) {
+            uint16_t sample = ringSample(source, state.samples_read++);
+            stats[source].samples++;
+            if (healthTest(source, sample)) {
+                stage(source, sample);
+                if (state.window_fill == 0) {
+                    commit(source);
+                }
+            }
+        }
+    }
+}
+
+bool MintEntropy::healthTest(Source source, uint16_t sample) {
+    const SourceParams& params = SOURCE_PARAMS[source];
+    SourceState& state = sources[source];
+    bool failed = false;
+
+    // Repetition count test: a stuck source
+    if (state.repeat_count && sample == state.last_sample) {
+        failed = ++state.repeat_count >= params.rct_cutoff;
+    } else {
+        state.last_sample = sample;
+        state.repeat_count = 1;
+    }
+
+    // Adaptive proportion test: one value too common in a window
+    if (state.window_fill == 0) {
+        state.window_first = sample;
+        state.window_matches = 0;
+    }
+    if (sample == state.window_first) {
+        failed = failed || ++state.window_matches >= params.apt_cutoff;
+    }
+    if (++state.window_fill == params.apt_window) {
+        state.window_fill = 0;
+        state.failed_runs = 0;
+    }
+
+    if (!failed) {
+        return true;
+    }
+
+    // Nothing staged in this window can be trusted
+    stats[source].failures++;
+    state.repeat_count = 0;
+    state.window_fill = 0;
+    discardStaged(source);
+    if (++state.failed_runs >= ENTROPY_MAX_FAILED_RUNS) {
+        stats[source].enabled = false;
+#ifdef ARDUINO_ARCH_RP2040
+        dma_channel_abort(state.dma_channel);
+#endif
+    }
+    return false;
+}
+
+void MintEntropy::stage(Source source, uint16_t sample) {
+    SourceState& state = sources[source];
+    state.packed |= (uint8_t)(sample << state.packed_bits);
+    state.packed_bits += SOURCE_PARAMS[source].sample_bits;
+    if (state.packed_bits == 8) {
+        MintHash::sha256Update(state.staged, &state.packed, 1);
+        state.packed = 0;
+        state.packed_bits = 0;
+    }
+}
+
+void MintEntropy::commit(Source source) {
+    SourceState& state = sources[source];
+    uint8_t digest[32];
+    MintHash::sha256Final(state.staged, digest);
+
+    // Tag each window with its source
+    const uint8_t tag = (uint8_t)source;
+    MintHash::sha256Update(pool, &tag, 1);
+    MintHash::sha256Update(pool, digest, sizeof(digest));
+    pool_bits += SOURCE_PARAMS[source].window_credit;
+    stats[source].credited_bits += SOURCE_PARAMS[source].window_credit;
+
+    memset(digest, 0, sizeof(digest));
+    discardStaged(source);
+}
+
+void MintEntropy::discardStaged(Source source) {
+    SourceState& state = sources[source];
+    MintHash::sha256Init(state.staged);
+    state.packed = 0;
+    state.packed_bits = 0;
+}
+
+bool MintEntropy::isReady() const {
+    return pool_bits >= ENTROPY_POOL_BITS;
+}
+
+bool MintEntropy::draw(uint8_t* output, size_t length) {
+    if (!output || length > ENTROPY_OUTPUT_SIZE || !isReady()) {
+        return false;
+    }
+
+    // Output and the next pool's seed are separate hashes of the pool, so
+    // one never reveals the other
+    uint8_t digest[32];
+    uint8_t block[33];
+    MintHash::sha256Final(pool, digest);
+    memcpy(block, digest, sizeof(digest));
+
+    block[32] = 0x01;
+    uint8_t out[32];
+    MintHash::sha256(block, sizeof(block), out);
+    memcpy(output, out, length);
+
+    block[32] = 0x02;
+    MintHash::sha256(block, sizeof(block), digest);
+    MintHash::sha256Init(pool);
+    MintHash::sha256Update(pool, digest, sizeof(digest));
+    pool_bits = 0;
+
+    memset(digest, 0, sizeof(digest));
+    memset(block, 0, sizeof(block));
+    memset(out, 0, sizeof(out));
+    return true;
+}
+
+uint32_t MintEntropy::getPoolBits() const {
+    return pool_bits;
+}
+
+const MintEntropy::SourceStats& MintEntropy::getStats(Source source) const {
+    return stats[source];
+}
@@ -0,0 +1,152 @@
+#ifndef MINT_ENTROPY_H
+#define MINT_ENTROPY_H
+
+#include <Arduino.h>
+#include "mint_hash.h"
+
+// Analog pin left floating for noise sampling
+#define ANALOG_NOISE_PIN A0
+
+// Sample rings, powers of two so the DMA write address can wrap in
+// hardware, each two health test windows (~100 ms) long
+#define ENTROPY_ROSC_RING_SAMPLES 2048
+#define ENTROPY_ADC_RING_SAMPLES 1024
+
+// Conditioned bytes one draw() returns at most
+#define ENTROPY_OUTPUT_SIZE 32
+
+/**
+ * Class for collecting hardware entropy on the MCU.
+ *
+ * Two sources are sampled continuously by DMA, so acquisition costs no
+ * CPU: the RP2040 ring oscillator's RANDOMBIT and the ADC reading of a
+ * floating analog pin. task() drains both rings and runs the SP 800-90B
+ * repetition count and adaptive proportion tests on each source's raw
+ * samples. Each adaptive proportion window that passes is hashed into a
+ * SHA-256 pool and credited at a conservative min-entropy per sample; a
+ * window with a failure is dropped. The pool is ready once the credited
+ * entropy is twice the output size, whichever sources it came from, so
+ * one failed or slow source never holds up a draw.
+ *
+ * Builds with MINT_CIRCUIT_ANALOG leave the ADC to the tamper loop and
+ * collect from the ring oscillator only.
+ */
+class MintEntropy {
+public:
+    /**
+     * Entropy sources
+     */
+    typedef enum {
+        SOURCE_ROSC,      // Ring oscillator RANDOMBIT, one bit per sample
+        SOURCE_ADC,       // Floating ADC input, low four bits per sample
+        SOURCE_COUNT
+    } Source;
+
+    /**
+     * Per-source counters, for measuring collection and health tests.
+     */
+    typedef struct {
+        uint32_t samples;            // Raw samples tested
+        uint32_t failures;           // Health test failures
+        uint32_t credited_bits;      // Entropy credited to the pool
+        uint32_t overruns;           // Samples lost because task() ran too late
+        bool enabled;                // Still sampled and credited
+    } SourceStats;
+
+    /**
+     * Constructor for the collector.
+     * @param noise_pin Floating analog pin (ANALOG_NOISE_PIN)
+     */
+    MintEntropy(uint8_t noise_pin);
+
+    /**
+     * Start DMA sampling of every available source.
+     * @return true if at least one source is sampling, false otherwise
+     */
+    bool begin();
+
+    /**
+     * Test and pool samples gathered since the last call.
+     * Call from the main loop.
+     */
+    void task();
+
+    /**
+     * Check whether the pool holds enough credited entropy for a draw.
+     * @return true if draw() will succeed
+     */
+    bool isReady() const;
+
+    /**
+     * Take conditioned output from the pool and start refilling it.
+     * @param output Output buffer
+     * @param length Bytes to draw (up to ENTROPY_OUTPUT_SIZE)
+     * @return true if successful, false if the pool is not ready
+     */
+    bool draw(uint8_t* output, size_t length);
+
+    /**
+     * Get entropy credited to the pool since the last draw.
+     * @return Credited bits
+     */
+    uint32_t getPoolBits() const;
+
+    /**
+     * Get counters for one source.
+     * @param source Source to query
+     * @return Reference to the source's statistics
+     */
+    const SourceStats& getStats(Source source) const;
+
+private:
+    // Health test and staging state for one source
+    typedef struct {
+        uint16_t last_sample;        // Repetition count test
+        uint16_t repeat_count;
+        uint16_t window_first;       // Adaptive proportion test
+        uint16_t window_matches;
+        uint16_t window_fill;
+        uint8_t failed_runs;         // Failures without a passing window since
+        MintHash::SHA256Context staged; // Samples of the window being tested
+        uint8_t packed;              // Samples not yet hashed into staged
+        uint8_t packed_bits;
+        int dma_channel;
+        uint32_t samples_read;       // Samples taken out of the ring, wraps
+        uint32_t written_base;       // Samples from finished DMA runs (host: emulated samples)
+        unsigned long last_sample_us; // Host builds: time of the last emulated sample
+    } SourceState;
+
+    const uint8_t pin;
+    MintHash::SHA256Context pool;
+    uint32_t pool_bits;
+    SourceState sources[SOURCE_COUNT];
+    SourceStats stats[SOURCE_COUNT];
+#ifndef ARDUINO_ARCH_RP2040
+    // Host builds: emulated DMA rings, one pair per device
+    uint8_t rosc_ring[ENTROPY_ROSC_RING_SAMPLES];
+    uint16_t adc_ring[ENTROPY_ADC_RING_SAMPLES];
+#endif
+
+    // Start DMA sampling of one source
+    bool startSampling(Source source);
+
+    // Total samples the DMA has written for a source, wraps
+    uint32_t samplesWritten(Source source);
+
+    // Sample at a ring position, reduced to the bits the source credits
+    uint16_t ringSample(Source source, uint32_t index) const;
+
+    // Run the health tests on one sample; false on a failure
+    bool healthTest(Source source, uint16_t sample);
+
+    // Hash one sample into the window being tested
+    void stage(Source source, uint16_t sample);
+
+    // Pool a window that passed and credit its entropy
+    void commit(Source source);
+
+    // Drop a source's staged window after a health test failure
+    void discardStaged(Source source);
+};
+
+#endif // MINT_ENTROPY_H
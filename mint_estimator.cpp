@@ -0,0 +1,134 @@
+#include "mint_estimator.h"
+#include <math.h>
+
+// 99% confidence bound used by SP 800-90B
+#define ESTIMATOR_Z_99 2.576
+
+// Markov estimate: length of the most likely sequence, in bits
+#define ESTIMATOR_MARKOV_BITS 128
+
+#define ESTIMATOR_MAX_MILLIBITS 8000
+
+MintEntropyEstimator::MintEntropyEstimator() {
+    reset();
+}
+
+void MintEntropyEstimator::reset() {
+    memset(byte_counts, 0, sizeof(byte_counts));
+    bytes = 0;
+    memset(transitions, 0, sizeof(transitions));
+    zero_bits = 0;
+    last_bit = 0;
+    memset(predictions, 0, sizeof(predictions));
+    memset(predicted, 0, sizeof(predicted));
+    memset(history, 0, sizeof(history));
+    hits = 0;
+}
+
+void MintEntropyEstimator::update(const uint8_t* data, size_t length) {
+    if (!data) {
+        return;
+    }
+    length = min(length, (size_t)(ESTIMATOR_MAX_BYTES - bytes));
+
+    for (size_t i = 0; i < length; i++) {
+        const uint8_t value = data[i];
+        byte_counts[value]++;
+
+        // Bits most significant first; the first bit of the file has no
+        // predecessor
+        for (int b = 7; b >= 0; b--) {
+            const uint8_t bit = (value >> b) & 1;
+            if (bytes || b != 7) {
+                transitions[last_bit][bit]++;
+            }
+            zero_bits += bit ^ 1;
+            last_bit = bit;
+        }
+
+        // Guess from what followed the same two bytes last time; a
+        // context not seen yet is a miss
+        if (bytes >= 2) {
+            const uint8_t context = (uint8_t)(history[0] * 167 + history[1]);
+            const uint8_t mask = 1 << (context & 7);
+            if ((predicted[context >> 3] & mask) && predictions[context] == value) {
+                hits++;
+            }
+            predictions[context] = value;
+            predicted[context >> 3] |= mask;
+        }
+        history[0] = history[1];
+        history[1] = value;
+        bytes++;
+    }
+}
+
+void MintEntropyEstimator::finish(Estimate& estimate) const {
+    estimate.bytes = bytes;
+    estimate.mcv_millibits = mcvEstimate();
+    estimate.markov_millibits = markovEstimate();
+    estimate.compression_millibits = compressionEstimate();
+
+    const uint32_t lowest = min(min(estimate.mcv_millibits, estimate.markov_millibits),
+                                estimate.compression_millibits);
+    estimate.credited_bits = (uint16_t)min((uint32_t)((uint64_t)lowest * bytes / 1000),
+                                           (uint32_t)ESTIMATOR_MAX_CREDIT_BITS);
+}
+
+uint16_t MintEntropyEstimator::mcvEstimate() const {
+    if (bytes < 2) {
+        return 0;
+    }
+    uint16_t most = 0;
+    for (size_t i = 0; i < 256; i++) {
+        most = max(most, byte_counts[i]);
+    }
+    return boundEstimate(most, bytes);
+}
+
+uint16_t MintEntropyEstimator::markovEstimate() const {
+    if (bytes < 2) {
+        return 0;
+    }
+    // Log probabilities of the first bit and of each transition; a
+    // transition never seen has probability zero
+    const uint32_t total_bits = bytes * 8;
+    double first[2] = {
+        (double)zero_bits / total_bits, (double)(total_bits - zero_bits) / total_bits
+    };
+    double step[2][2];
+    for (int from = 0; from < 2; from++) {
+        first[from] = first[from] > 0 ? log2(first[from]) : -INFINITY;
+        const uint32_t row = transitions[from][0] + transitions[from][1];
+        for (int to = 0; to < 2; to++) {
+            step[from][to] = transitions[from][to] ? log2((double)transitions[from][to] / row)
+                                                   : -INFINITY;
+        }
+    }
+
+    // Most likely sequence ending in each bit, one bit at a time
+    double ending[2] = { first[0], first[1] };
+    for (int i = 1; i < ESTIMATOR_MARKOV_BITS; i++) {
+        const double zero = max(ending[0] + step[0][0], ending[1] + step[1][0]);
+        const double one = max(ending[0] + step[0][1], ending[1] + step[1][1]);
+        ending[0] = zero;
+        ending[1] = one;
+    }
+    const double per_bit = -max(ending[0], ending[1]) / ESTIMATOR_MARKOV_BITS;
+    return (uint16_t)min(per_bit * 8000.0, (double)ESTIMATOR_MAX_MILLIBITS);
+}
+
+uint16_t MintEntropyEstimator::compressionEstimate() const {
+    // Every byte after the first two was a prediction
+    return bytes < 4 ? 0 : boundEstimate(hits, bytes - 2);
+}
+
+uint16_t MintEntropyEstimator::boundEstimate(uint32_t successes, uint32_t trials) {
+    // Upper 99% bound on the probability of a success, as min-entropy;
+    // with no successes the bound comes from the number of trials alone
+    const double p = (double)successes / trials;
+    const double bound = successes ?
+        min(1.0, p + ESTIMATOR_Z_99 * sqrt(p * (1.0 - p) / (trials - 1))) :
+        1.0 - pow(0.01, 1.0 / trials);
+    return (uint16_t)min(-log2(bound) * 1000.0, (double)ESTIMATOR_MAX_MILLIBITS);
+}
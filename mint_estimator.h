@@ -0,0 +1,97 @@
+#ifndef MINT_ESTIMATOR_H
+#define MINT_ESTIMATOR_H
+
+#include <Arduino.h>
+
+// Entropy a file is credited with at most: the seed is 256 bits
+#define ESTIMATOR_MAX_CREDIT_BITS 256
+
+// Files credited with less than this get a warning in the README
+#define ESTIMATOR_WEAK_FILE_BITS 64
+
+// Bytes estimated; anything past this is ignored (the histogram is 16-bit)
+#define ESTIMATOR_MAX_BYTES 65535
+
+// Compression estimate: contexts (hashed pairs of preceding bytes) the
+// predictor remembers a next byte for
+#define ESTIMATOR_CONTEXTS 256
+
+/**
+ * Streaming min-entropy estimator for the user's entropy file.
+ *
+ * Fed the file as it arrives, in pieces of any size, and keeps only
+ * counters (about 830 bytes whatever the file size). finish() turns them
+ * into three per-byte estimates after NIST SP 800-90B, and credits the
+ * file with the lowest of them over its length:
+ *
+ *   Most common value  byte histogram, upper 99% bound on the commonest
+ *                      byte's probability (90B 6.3.1)
+ *   Markov             first-order model of the bit stream, most likely
+ *                      128-bit sequence (90B 6.3.3)
+ *   Compression        LZP-style predictor: each byte is guessed from a
+ *                      table of what followed its two preceding bytes
+ *                      last time; the share guessed right, which an LZP
+ *                      coder would send as a flag bit, bounds the
+ *                      per-byte probability (after 90B 6.3.7)
+ *
+ * Each estimator catches what the others miss: a repeated byte, a text
+ * file's fixed top bit, a short pattern repeated. The estimates are an
+ * upper bound on what a file holds, not a measurement; the SE050 and MCU
+ * entropy mixed with the file carry the wallet's security either way.
+ *
+ * Updates cost a few operations per byte and finish() a fixed ~130-step
+ * loop, so the estimator runs in the storage task, never in the MSC
+ * callbacks.
+ */
+class MintEntropyEstimator {
+public:
+    /**
+     * Estimates for one file, in millibits of min-entropy per byte.
+     */
+    typedef struct {
+        uint32_t bytes;              // File size
+        uint16_t mcv_millibits;      // Most common value estimate
+        uint16_t markov_millibits;   // Markov estimate
+        uint16_t compression_millibits; // Compression estimate
+        uint16_t credited_bits;      // Lowest estimate over the file, capped
+    } Estimate;
+
+    MintEntropyEstimator();
+
+    /**
+     * Start a new file.
+     */
+    void reset();
+
+    /**
+     * Add the next piece of the file. Bytes past ESTIMATOR_MAX_BYTES
+     * are ignored.
+     * @param data File bytes
+     * @param length Number of bytes
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * Estimate the entropy of everything added since reset().
+     * @param estimate Output estimates
+     */
+    void finish(Estimate& estimate) const;
+
+private:
+    uint16_t byte_counts[256];       // Most common value
+    uint32_t bytes;
+    uint32_t transitions[2][2];      // Markov: [previous bit][bit]
+    uint32_t zero_bits;
+    uint8_t last_bit;
+    uint8_t predictions[ESTIMATOR_CONTEXTS]; // Compression: next byte per context
+    uint8_t predicted[ESTIMATOR_CONTEXTS / 8]; // Contexts seen, one bit each
+    uint8_t history[2];              // Two bytes before the next
+    uint32_t hits;                   // Bytes predicted right
+
+    static uint16_t boundEstimate(uint32_t successes, uint32_t trials);
+    uint16_t mcvEstimate() const;
+    uint16_t markovEstimate() const;
+    uint16_t compressionEstimate() const;
+};
+
+#endif // MINT_ESTIMATOR_H
@@ -0,0 +1,187 @@
+#include "mint_fat.h"
+#include "mint_memory.h"
+
+// FAT12 holds at most this many clusters
+#define FAT12_MAX_CLUSTERS 4084
+
+// Tilde names hosts give their dot files and folders (first six characters)
+static const char* const METADATA_ALIASES[] = {
+    "DS_STO",   // .DS_Store
+    "FSEVEN",   // .fseventsd
+    "SPOTLI",   // .Spotlight-V100
+    "TRASHE",   // .Trashes
+    "TEMPOR",   // .TemporaryItems
+    "SYSTEM",   // System Volume Information
+    "INDEXE"    // IndexerVolumeGuid
+};
+
+// Exact 8.3 names
+static const char* const METADATA_NAMES[] = {
+    "README  TXT",  // Written by the device
+    "PROOF   BIN",
+    "DESKTOP INI",
+    "THUMBS  DB "
+};
+
+static uint16_t readLE16(const uint8_t* data) {
+    return (uint16_t)(data[0] | data[1] << 8);
+}
+
+static uint32_t readLE32(const uint8_t* data) {
+    return (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 |
+           (uint32_t)data[3] << 24;
+}
+
+MintFatVolume::MintFatVolume(SectorReader reader) :
+    read_sector(reader), cached_lba(0), cache_valid(false) {
+    memset(&geometry, 0, sizeof(geometry));
+}
+
+bool MintFatVolume::parseBootSector(const uint8_t* sector, MintFatGeometry& geometry) {
+    if (readLE16(&sector[11]) != FAT_SECTOR_SIZE) {
+        return false;
+    }
+
+    geometry.sectors_per_cluster = sector[13];
+    geometry.reserved_sectors = readLE16(&sector[14]);
+    geometry.fat_count = sector[16];
+    geometry.root_entries = readLE16(&sector[17]);
+    geometry.total_sectors = readLE16(&sector[19]);
+    if (geometry.total_sectors == 0) {
+        geometry.total_sectors = readLE32(&sector[32]);
+    }
+    geometry.fat_sectors = readLE16(&sector[22]);
+
+    if (geometry.sectors_per_cluster == 0 || geometry.fat_count == 0 ||
+        geometry.fat_sectors == 0 || geometry.root_entries == 0) {
+        return false;
+    }
+
+    geometry.fat_start = geometry.reserved_sectors;
+    geometry.root_start = geometry.fat_start + (uint32_t)geometry.fat_count * geometry.fat_sectors;
+    geometry.root_sectors = ((uint32_t)geometry.root_entries * FAT_DIR_ENTRY_SIZE +
+                             FAT_SECTOR_SIZE - 1) / FAT_SECTOR_SIZE;
+    geometry.data_start = geometry.root_start + geometry.root_sectors;
+    if (geometry.data_start >= geometry.total_sectors) {
+        return false;
+    }
+    geometry.cluster_count = (geometry.total_sectors - geometry.data_start) /
+                             geometry.sectors_per_cluster;
+
+    // FAT12 only, and the FAT must cover every cluster
+    return geometry.cluster_count <= FAT12_MAX_CLUSTERS &&
+           (geometry.cluster_count + FAT_FIRST_CLUSTER) * 3 / 2 <=
+               (uint32_t)geometry.fat_sectors * FAT_SECTOR_SIZE;
+}
+
+bool MintFatVolume::mount() {
+    uint8_t sector[FAT_SECTOR_SIZE];
+    invalidate();
+    return read_sector(0, sector) && parseBootSector(sector, geometry);
+}
+
+MintFatVolume::EntryKind MintFatVolume::parseDirEntry(const uint8_t* sector, size_t index,
+                                                      MintFatEntry& entry) {
+    const uint8_t* raw = &sector[index * FAT_DIR_ENTRY_SIZE];
+    if (raw[0] == FAT_DIR_END) {
+        return ENTRY_END;
+    }
+    if (raw[0] == FAT_DIR_DELETED || (raw[11] & FAT_ATTR_LONG_NAME) == FAT_ATTR_LONG_NAME) {
+        return ENTRY_UNUSED;
+    }
+
+    memcpy(entry.name, raw, sizeof(entry.name));
+    entry.attributes = raw[11];
+    entry.start_cluster = readLE16(&raw[26]);
+    entry.size = readLE32(&raw[28]);
+
+    // The long name part holding the first characters comes right before
+    entry.dot_name = false;
+    if (index > 0) {
+        const uint8_t* lfn = raw - FAT_DIR_ENTRY_SIZE;
+        if ((lfn[11] & FAT_ATTR_LONG_NAME) == FAT_ATTR_LONG_NAME && (lfn[0] & 0x1F) == 1) {
+            entry.dot_name = lfn[1] == '.' && lfn[2] == 0;
+        }
+    }
+    return ENTRY_VALID;
+}
+
+bool MintFatVolume::isMetadata(const MintFatEntry& entry) {
+    if (entry.attributes & (FAT_ATTR_VOLUME_ID | FAT_ATTR_DIRECTORY |
+                            FAT_ATTR_HIDDEN | FAT_ATTR_SYSTEM)) {
+        return true;
+    }
+    // Dot files, and the "_NAME~1" alias of a "._name" AppleDouble file
+    if (entry.dot_name || entry.name[0] == '.' || entry.name[0] == '_') {
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(METADATA_ALIASES) / sizeof(METADATA_ALIASES[0]); i++) {
+        if (memcmp(entry.name, METADATA_ALIASES[i], 6) == 0 && entry.name[6] == '~') {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < sizeof(METADATA_NAMES) / sizeof(METADATA_NAMES[0]); i++) {
+        if (memcmp(entry.name, METADATA_NAMES[i], sizeof(entry.name)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t MintFatVolume::getFat12(const uint8_t* fat, uint16_t cluster, uint32_t fat_offset) {
+    uint32_t offset = cluster + cluster / 2 - fat_offset;
+    uint16_t pair = readLE16(&fat[offset]);
+    return (cluster & 1) ? pair >> 4 : pair & 0x0FFF;
+}
+
+void MintFatVolume::setFat12(uint8_t* fat, uint16_t cluster, uint16_t value,
+                             uint32_t fat_offset) {
+    uint32_t offset = cluster + cluster / 2 - fat_offset;
+    value &= 0x0FFF;
+    if (cluster & 1) {
+        fat[offset] = (fat[offset] & 0x0F) | (uint8_t)(value << 4);
+        fat[offset + 1] = (uint8_t)(value >> 4);
+    } else {
+        fat[offset] = (uint8_t)value;
+        fat[offset + 1] = (fat[offset + 1] & 0xF0) | (uint8_t)(value >> 8);
+    }
+}
+
+bool MintFatVolume::readFatByte(uint32_t offset, uint8_t& value) {
+    uint32_t lba = geometry.fat_start + offset / FAT_SECTOR_SIZE;
+    if (!cache_valid || cached_lba != lba) {
+        if (!read_sector(lba, cache)) {
+            cache_valid = false;
+            return false;
+        }
+        cached_lba = lba;
+        cache_valid = true;
+    }
+    value = cache[offset % FAT_SECTOR_SIZE];
+    return true;
+}
+
+bool MintFatVolume::readFatEntry(uint16_t cluster, uint16_t& value) {
+    // An entry can straddle two FAT sectors
+    uint32_t offset = cluster + cluster / 2;
+    uint8_t bytes[2];
+    if (!readFatByte(offset, bytes[0]) || !readFatByte(offset + 1, bytes[1])) {
+        return false;
+    }
+    uint16_t pair = (uint16_t)(bytes[0] | bytes[1] << 8);
+    value = (cluster & 1) ? pair >> 4 : pair & 0x0FFF;
+    return true;
+}
+
+void MintFatVolume::invalidate() {
+    cache_valid = false;
+}
+
+MINT_RAM_FUNC(fat_cluster_to_sector)
+uint32_t MintFatVolume::clusterToSector(uint16_t cluster) const {
+    return geometry.data_start + (uint32_t)(cluster - FAT_FIRST_CLUSTER) * geometry.sectors_per_cluster;
+}
+
+bool MintFatVolume::isValidCluster(uint16_t cluster) const {
+    return cluster >= FAT_FIRST_CLUSTER && cluster < geometry.cluster_count + FAT_FIRST_CLUSTER;
+}
@@ -0,0 +1,175 @@
+#ifndef MINT_FAT_H
+#define MINT_FAT_H
+
+#include <Arduino.h>
+#include <functional>
+
+#define FAT_SECTOR_SIZE 512
+#define FAT_DIR_ENTRY_SIZE 32
+#define FAT_DIR_ENTRIES_PER_SECTOR (FAT_SECTOR_SIZE / FAT_DIR_ENTRY_SIZE)
+
+// Directory entry attributes
+#define FAT_ATTR_READ_ONLY 0x01
+#define FAT_ATTR_HIDDEN 0x02
+#define FAT_ATTR_SYSTEM 0x04
+#define FAT_ATTR_VOLUME_ID 0x08
+#define FAT_ATTR_DIRECTORY 0x10
+#define FAT_ATTR_ARCHIVE 0x20
+#define FAT_ATTR_LONG_NAME 0x0F
+
+// Directory entry name markers
+#define FAT_DIR_END 0x00
+#define FAT_DIR_DELETED 0xE5
+
+// FAT12 cluster values
+#define FAT12_FREE 0x000
+#define FAT12_EOC_MIN 0xFF8
+#define FAT12_EOC 0xFFF
+#define FAT_FIRST_CLUSTER 2
+
+/**
+ * Volume layout from a FAT12 boot sector.
+ */
+typedef struct {
+    uint8_t sectors_per_cluster;
+    uint16_t reserved_sectors;
+    uint8_t fat_count;
+    uint16_t fat_sectors;           // Per FAT
+    uint16_t root_entries;
+    uint32_t total_sectors;
+
+    // Derived
+    uint32_t fat_start;             // First sector of the first FAT
+    uint32_t root_start;            // First root directory sector
+    uint32_t root_sectors;
+    uint32_t data_start;            // First sector of cluster 2
+    uint32_t cluster_count;
+} MintFatGeometry;
+
+/**
+ * A parsed short-name directory entry.
+ */
+typedef struct {
+    char name[11];                  // 8.3 name, space padded, no dot
+    uint8_t attributes;
+    uint16_t start_cluster;
+    uint32_t size;
+    bool dot_name;                  // Long name starts with '.' (host metadata)
+} MintFatEntry;
+
+/**
+ * Read-only view of a FAT12 volume through a sector reader.
+ *
+ * Shared by MintStorage, which follows files as the host writes them, and
+ * host tools that inspect device images. The reader may fail (for example
+ * while the flash disk is busy); every call that reads reports it, so a
+ * caller can try again later.
+ */
+class MintFatVolume {
+public:
+    typedef std::function<bool(uint32_t lba, uint8_t* buffer)> SectorReader;
+
+    typedef enum {
+        ENTRY_END,          // No entries follow
+        ENTRY_UNUSED,       // Free, deleted or long-name entry
+        ENTRY_VALID         // Short-name entry parsed
+    } EntryKind;
+
+    /**
+     * Constructor for the volume view.
+     * @param reader Reads one 512-byte sector
+     */
+    MintFatVolume(SectorReader reader);
+
+    /**
+     * Read and check the boot sector.
+     * @return true if it describes a FAT12 volume, false otherwise
+     */
+    bool mount();
+
+    /**
+     * Parse a FAT12 boot sector.
+     * @param sector Boot sector
+     * @param geometry Output layout
+     * @return true if it describes a FAT12 volume of 512-byte sectors
+     */
+    static bool parseBootSector(const uint8_t* sector, MintFatGeometry& geometry);
+
+    /**
+     * Parse one entry of a directory sector. A long name is only seen
+     * if its first part sits just before the entry in the same sector.
+     * @param sector Directory sector
+     * @param index Entry index in the sector
+     * @param entry Output entry, filled for ENTRY_VALID
+     * @return Kind of entry
+     */
+    static EntryKind parseDirEntry(const uint8_t* sector, size_t index, MintFatEntry& entry);
+
+    /**
+     * Check whether an entry is something hosts create on their own
+     * (directories, hidden files, .DS_Store, ._ files, Spotlight and
+     * fseventsd data, desktop.ini, Thumbs.db) or the device's own files
+     * (README.TXT, PROOF.BIN).
+     * @param entry Parsed entry
+     * @return true if the entry is not a user file
+     */
+    static bool isMetadata(const MintFatEntry& entry);
+
+    /**
+     * Read a FAT12 entry from a FAT held in memory.
+     * @param fat First FAT, or the part of it holding the entry
+     * @param cluster Cluster number
+     * @param fat_offset Byte offset of fat[0] within the FAT
+     * @return Entry value
+     */
+    static uint16_t getFat12(const uint8_t* fat, uint16_t cluster, uint32_t fat_offset = 0);
+
+    /**
+     * Set a FAT12 entry in a FAT held in memory.
+     * @param fat First FAT, or the part of it holding the entry
+     * @param cluster Cluster number
+     * @param value Entry value
+     * @param fat_offset Byte offset of fat[0] within the FAT
+     */
+    static void setFat12(uint8_t* fat, uint16_t cluster, uint16_t value, uint32_t fat_offset = 0);
+
+    /**
+     * Read a FAT12 entry through the sector reader.
+     * @param cluster Cluster number
+     * @param value Output entry value
+     * @return true if successful, false if a read failed
+     */
+    bool readFatEntry(uint16_t cluster, uint16_t& value);
+
+    /**
+     * Forget the cached FAT sector, after the host may have changed it.
+     */
+    void invalidate();
+
+    /**
+     * Get the first sector of a cluster.
+     * @param cluster Cluster number (>= 2)
+     * @return Sector number
+     */
+    uint32_t clusterToSector(uint16_t cluster) const;
+
+    /**
+     * Check that a cluster number is inside the data region.
+     * @param cluster Cluster number
+     * @return true if valid
+     */
+    bool isValidCluster(uint16_t cluster) const;
+
+    const MintFatGeometry& getGeometry() const { return geometry; }
+
+private:
+    SectorReader read_sector;
+    MintFatGeometry geometry;
+    uint32_t cached_lba;
+    bool cache_valid;
+    uint8_t cache[FAT_SECTOR_SIZE];
+
+    bool readFatByte(uint32_t offset, uint8_t& value);
+};
+
+#endif // MINT_FAT_H
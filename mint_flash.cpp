@@ -0,0 +1,651 @@
+#include "mint_flash.h"
+#include "mint_memory.h"
+
+// Opcodes
+#define FLASH_CMD_WRITE_ENABLE 0x06
+#define FLASH_CMD_READ_STATUS_1 0x05
+#define FLASH_CMD_READ_DATA 0x03
+#define FLASH_CMD_PAGE_PROGRAM 0x02
+#define FLASH_CMD_SECTOR_ERASE 0x20
+#define FLASH_CMD_JEDEC_ID 0x9F
+#define FLASH_CMD_ENABLE_RESET 0x66
+#define FLASH_CMD_RESET 0x99
+
+// Status register 1
+#define FLASH_STATUS_BUSY 0x01
+
+// Manufacturer, memory type and capacity bytes of a W25Q128JV
+#define FLASH_JEDEC_W25Q128JV 0xEF4018UL
+
+// Longest a read waits for a program or erase (tSE max is 400 ms)
+#define FLASH_READ_WAIT_MS 500
+
+// Reset recovery time (tRST)
+#define FLASH_RESET_US 30
+
+#define FLASH_SPI SPI1
+
+MintFlash::MintFlash(uint8_t cs_pin) : cs(cs_pin), present(false) {
+}
+
+bool MintFlash::begin() {
+    pinMode(cs, OUTPUT);
+    digitalWrite(cs, HIGH);
+
+    FLASH_SPI.setRX(FLASH_MISO_PIN);
+    FLASH_SPI.setTX(FLASH_MOSI_PIN);
+    FLASH_SPI.setSCK(FLASH_SCK_PIN);
+    FLASH_SPI.begin();
+
+    // Software reset in case a program or erase was cut off by a reboot
+    command(FLASH_CMD_ENABLE_RESET);
+    command(FLASH_CMD_RESET);
+    delayMicroseconds(FLASH_RESET_US);
+
+    uint8_t id[4] = { FLASH_CMD_JEDEC_ID, 0, 0, 0 };
+    select();
+    FLASH_SPI.transfer(id, sizeof(id));
+    deselect();
+
+    uint32_t jedec = (uint32_t)id[1] << 16 | (uint32_t)id[2] << 8 | id[3];
+    present = jedec == FLASH_JEDEC_W25Q128JV;
+    return present;
+}
+
+void MintFlash::select() {
+    FLASH_SPI.beginTransaction(SPISettings(FLASH_SPI_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(cs, LOW);
+}
+
+void MintFlash::deselect() {
+    digitalWrite(cs, HIGH);
+    FLASH_SPI.endTransaction();
+}
+
+void MintFlash::command(uint8_t opcode) {
+    select();
+    FLASH_SPI.transfer(opcode);
+    deselect();
+}
+
+void MintFlash::commandWithAddress(uint8_t opcode, uint32_t address) {
+    uint8_t header[4] = {
+        opcode, (uint8_t)(address >> 16), (uint8_t)(address >> 8), (uint8_t)address
+    };
+    FLASH_SPI.transfer(header, sizeof(header));
+}
+
+uint8_t MintFlash::readStatus() {
+    uint8_t frame[2] = { FLASH_CMD_READ_STATUS_1, 0 };
+    select();
+    FLASH_SPI.transfer(frame, sizeof(frame));
+    deselect();
+    return frame[1];
+}
+
+bool MintFlash::isBusy() {
+    return (readStatus() & FLASH_STATUS_BUSY) != 0;
+}
+
+bool MintFlash::waitReady(uint32_t timeout_ms) {
+    unsigned long start = millis();
+    while (isBusy()) {
+        if (millis() - start > timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MintFlash::read(uint32_t address, uint8_t* buffer, size_t length) {
+    if (!present || !buffer || address + length > FLASH_CAPACITY) {
+        return false;
+    }
+    if (!waitReady(FLASH_READ_WAIT_MS)) {
+        return false;
+    }
+
+    select();
+    commandWithAddress(FLASH_CMD_READ_DATA, address);
+    memset(buffer, 0, length);
+    FLASH_SPI.transfer(buffer, length);
+    deselect();
+    return true;
+}
+
+bool MintFlash::startProgram(uint32_t address, const uint8_t* data, size_t length) {
+    if (!present || !data || length == 0 || length > FLASH_PAGE_SIZE ||
+        (address % FLASH_PAGE_SIZE) + length > FLASH_PAGE_SIZE || isBusy()) {
+        return false;
+    }
+
+    command(FLASH_CMD_WRITE_ENABLE);
+
+    // SPI transfers are in place, so clock the page out of a copy
+    uint8_t page[FLASH_PAGE_SIZE];
+    memcpy(page, data, length);
+    select();
+    commandWithAddress(FLASH_CMD_PAGE_PROGRAM, address);
+    FLASH_SPI.transfer(page, length);
+    deselect();
+    return true;
+}
+
+bool MintFlash::startErase(uint32_t address) {
+    if (!present || address >= FLASH_CAPACITY || isBusy()) {
+        return false;
+    }
+
+    command(FLASH_CMD_WRITE_ENABLE);
+    select();
+    commandWithAddress(FLASH_CMD_SECTOR_ERASE, address);
+    deselect();
+    return true;
+}
+
+uint32_t MintFlash::getCapacity() const {
+    return FLASH_CAPACITY;
+}
+
+// Blocks on the disk
+#define FLASH_DISK_BLOCKS (FLASH_CAPACITY / FLASH_DISK_BLOCK_SIZE)
+
+// Pages per erase sector
+#define FLASH_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+
+// Write-back starts when this many lines are dirty and keeps going down
+// to the low mark, so a burst of scattered writes drains in one task run...
+#define FLASH_DISK_DIRTY_HIGH (FLASH_DISK_CACHE_LINES / 2)
+#define FLASH_DISK_DIRTY_LOW (FLASH_DISK_CACHE_LINES / 4)
+
+// ...or when the host has not written for this long
+#define FLASH_DISK_FLUSH_DELAY_MS 250
+
+// Time one task() call may spend; a page program (tPP) fits, and the
+// storage task must not hold up USB for more than a millisecond
+#define FLASH_DISK_TASK_BUDGET_US 500
+
+// Pause between retries in the blocking helpers
+#define FLASH_DISK_POLL_US 100
+
+// Longest the blocking helpers wait
+#define FLASH_DISK_TIMEOUT_MS 2000
+
+#define FLASH_DISK_NO_SECTOR 0xFFFFFFFFUL
+
+MintFlashDisk::MintFlashDisk(uint8_t cs_pin) :
+    flash(cs_pin),
+    use_counter(0),
+    next_sequential_lba(0),
+    last_write_ms(0),
+    flush_requested(false),
+    write_stalled(false),
+    draining(false),
+    flush_state(FLUSH_IDLE),
+    stage_sector(FLASH_DISK_NO_SECTOR),
+    stage_loaded(0),
+    stage_pages(0) {
+    memset(lines, 0, sizeof(lines));
+    resetStats();
+}
+
+bool MintFlashDisk::begin() {
+    memset(lines, 0, sizeof(lines));
+    use_counter = 0;
+    flush_requested = false;
+    write_stalled = false;
+    draining = false;
+    flush_state = FLUSH_IDLE;
+    stage_sector = FLASH_DISK_NO_SECTOR;
+    return flash.begin();
+}
+
+uint32_t MintFlashDisk::getBlockCount() const {
+    return FLASH_DISK_BLOCKS;
+}
+
+uint8_t MintFlashDisk::getDirtyCount() const {
+    uint8_t count = 0;
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        if (lines[i].valid && lines[i].dirty) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void MintFlashDisk::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+MINT_RAM_FUNC(flash_disk_find_line)
+MintFlashDisk::CacheLine* MintFlashDisk::findLine(uint32_t lba) {
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        if (lines[i].valid && lines[i].lba == lba) {
+            return &lines[i];
+        }
+    }
+    return nullptr;
+}
+
+MintFlashDisk::CacheLine* MintFlashDisk::cleanLine() {
+    // An empty line, else the least recently used clean one
+    CacheLine* victim = nullptr;
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        if (!lines[i].valid) {
+            return &lines[i];
+        }
+        if (!lines[i].dirty && (!victim || lines[i].last_used < victim->last_used)) {
+            victim = &lines[i];
+        }
+    }
+    return victim;
+}
+
+MINT_RAM_FUNC(flash_disk_touch)
+void MintFlashDisk::touch(CacheLine* line) {
+    line->last_used = ++use_counter;
+}
+
+MINT_RAM_FUNC(flash_disk_is_staged)
+bool MintFlashDisk::isStaged(uint32_t lba) const {
+    // While the sector is still being read, flash holds its data
+    return (flush_state == FLUSH_ERASING || flush_state == FLUSH_PROGRAMMING) &&
+           lba / FLASH_DISK_BLOCKS_PER_SECTOR == stage_sector;
+}
+
+bool MintFlashDisk::flashReady() {
+    // Only write-back issues program and erase commands
+    return flush_state == FLUSH_IDLE || flush_state == FLUSH_READING || !flash.isBusy();
+}
+
+bool MintFlashDisk::fetch(uint32_t lba, uint8_t* buffer) {
+    // The staged sector is mid-erase or mid-program; its data is in RAM
+    if (isStaged(lba)) {
+        memcpy(buffer, &stage[(lba % FLASH_DISK_BLOCKS_PER_SECTOR) * FLASH_DISK_BLOCK_SIZE],
+               FLASH_DISK_BLOCK_SIZE);
+        return true;
+    }
+    return flash.read(lba * FLASH_DISK_BLOCK_SIZE, buffer, FLASH_DISK_BLOCK_SIZE);
+}
+
+void MintFlashDisk::prefetch(uint32_t lba) {
+    for (uint32_t i = 0; i < FLASH_DISK_READ_AHEAD; i++) {
+        uint32_t block = lba + i;
+        if (block >= FLASH_DISK_BLOCKS || !flashReady()) {
+            return;
+        }
+        if (findLine(block)) {
+            continue;
+        }
+        CacheLine* line = cleanLine();
+        if (!line || !fetch(block, line->data)) {
+            return;
+        }
+        line->lba = block;
+        line->valid = true;
+        line->dirty = false;
+        touch(line);
+        stats.read_ahead++;
+    }
+}
+
+MINT_RAM_FUNC(flash_disk_read)
+int32_t MintFlashDisk::read(uint32_t lba, void* buffer, uint32_t bufsize) {
+    uint32_t count = bufsize / FLASH_DISK_BLOCK_SIZE;
+    if (!buffer || bufsize % FLASH_DISK_BLOCK_SIZE || lba + count > FLASH_DISK_BLOCKS) {
+        return -1;
+    }
+
+    uint8_t* out = (uint8_t*)buffer;
+    uint32_t done = 0;
+    for (; done < count; done++) {
+        uint32_t block = lba + done;
+        uint8_t* dst = out + done * FLASH_DISK_BLOCK_SIZE;
+
+        CacheLine* line = findLine(block);
+        if (line || isStaged(block)) {
+            if (line) {
+                memcpy(dst, line->data, FLASH_DISK_BLOCK_SIZE);
+                touch(line);
+            } else {
+                fetch(block, dst);
+            }
+            stats.read_hits++;
+            continue;
+        }
+
+        // Other sectors wait while write-back has the flash busy
+        if (!flashReady()) {
+            break;
+        }
+
+        line = cleanLine();
+        if (line) {
+            if (!fetch(block, line->data)) {
+                return -1;
+            }
+            line->lba = block;
+            line->valid = true;
+            line->dirty = false;
+            touch(line);
+            memcpy(dst, line->data, FLASH_DISK_BLOCK_SIZE);
+        } else if (!fetch(block, dst)) {
+            return -1;
+        }
+        stats.read_misses++;
+    }
+
+    if (done < count) {
+        stats.stalls++;
+    } else if (lba == next_sequential_lba) {
+        prefetch(lba + count);
+    }
+    next_sequential_lba = lba + done;
+    return done * FLASH_DISK_BLOCK_SIZE;
+}
+
+MINT_RAM_FUNC(flash_disk_write)
+int32_t MintFlashDisk::write(uint32_t lba, const uint8_t* buffer, uint32_t bufsize) {
+    uint32_t count = bufsize / FLASH_DISK_BLOCK_SIZE;
+    if (!buffer || bufsize % FLASH_DISK_BLOCK_SIZE || lba + count > FLASH_DISK_BLOCKS) {
+        return -1;
+    }
+
+    uint32_t done = 0;
+    for (; done < count; done++) {
+        uint32_t block = lba + done;
+        CacheLine* line = findLine(block);
+        if (line) {
+            stats.write_hits++;
+        } else {
+            // Whole-block writes need no fill from flash
+            line = cleanLine();
+            if (!line) {
+                write_stalled = true;
+                break;
+            }
+            line->lba = block;
+            line->valid = true;
+            stats.write_misses++;
+        }
+        memcpy(line->data, buffer + done * FLASH_DISK_BLOCK_SIZE, FLASH_DISK_BLOCK_SIZE);
+        line->dirty = true;
+        touch(line);
+    }
+
+    if (done > 0) {
+        last_write_ms = millis();
+    }
+    if (done < count) {
+        stats.stalls++;
+    }
+    return done * FLASH_DISK_BLOCK_SIZE;
+}
+
+bool MintFlashDisk::shouldFlush() {
+    uint8_t dirty = getDirtyCount();
+    if (dirty >= FLASH_DISK_DIRTY_HIGH) {
+        draining = true;
+    } else if (dirty <= FLASH_DISK_DIRTY_LOW) {
+        draining = false;
+    }
+    if (dirty == 0) {
+        return false;
+    }
+    return flush_requested || write_stalled || draining ||
+           millis() - last_write_ms >= FLASH_DISK_FLUSH_DELAY_MS;
+}
+
+bool MintFlashDisk::stageSector() {
+    // Write back the sector holding the oldest dirty line
+    CacheLine* oldest = nullptr;
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        if (lines[i].valid && lines[i].dirty &&
+            (!oldest || lines[i].last_used < oldest->last_used)) {
+            oldest = &lines[i];
+        }
+    }
+    if (!oldest) {
+        return false;
+    }
+
+    stage_sector = oldest->lba / FLASH_DISK_BLOCKS_PER_SECTOR;
+    stage_loaded = 0;
+    flush_state = FLUSH_READING;
+    return true;
+}
+
+MintFlashDisk::CacheLine* MintFlashDisk::stagedLine(int index) {
+    // Dirty line of the staged sector whose old data has been read
+    CacheLine* line = &lines[index];
+    if (!line->valid || !line->dirty ||
+        line->lba / FLASH_DISK_BLOCKS_PER_SECTOR != stage_sector) {
+        return nullptr;
+    }
+    uint8_t block = line->lba % FLASH_DISK_BLOCKS_PER_SECTOR;
+    return (stage_loaded & (1 << block)) ? line : nullptr;
+}
+
+uint8_t MintFlashDisk::dirtyBlocks() const {
+    uint8_t blocks = 0;
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        const CacheLine* line = &lines[i];
+        if (line->valid && line->dirty &&
+            line->lba / FLASH_DISK_BLOCKS_PER_SECTOR == stage_sector) {
+            blocks |= 1 << (line->lba % FLASH_DISK_BLOCKS_PER_SECTOR);
+        }
+    }
+    return blocks;
+}
+
+bool MintFlashDisk::needsErase() {
+    // Some bit has to go from 0 back to 1
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        CacheLine* line = stagedLine(i);
+        if (!line) {
+            continue;
+        }
+        const uint8_t* old_data =
+            &stage[(line->lba % FLASH_DISK_BLOCKS_PER_SECTOR) * FLASH_DISK_BLOCK_SIZE];
+        for (uint32_t j = 0; j < FLASH_DISK_BLOCK_SIZE; j++) {
+            if (line->data[j] & ~old_data[j]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool MintFlashDisk::mergeSector() {
+    // Merge the dirty lines whose old data was read, noting changed pages.
+    // Without an erase only those blocks were read, and lines written
+    // since staging began wait for the next write-back.
+    bool needs_erase = needsErase();
+    uint16_t changed_pages = 0;
+    for (int i = 0; i < FLASH_DISK_CACHE_LINES; i++) {
+        CacheLine* line = stagedLine(i);
+        if (!line) {
+            continue;
+        }
+        uint32_t offset = (line->lba % FLASH_DISK_BLOCKS_PER_SECTOR) * FLASH_DISK_BLOCK_SIZE;
+        for (uint32_t j = 0; j < FLASH_DISK_BLOCK_SIZE; j++) {
+            if (line->data[j] != stage[offset + j]) {
+                changed_pages |= 1 << ((offset + j) / FLASH_PAGE_SIZE);
+            }
+        }
+        memcpy(&stage[offset], line->data, FLASH_DISK_BLOCK_SIZE);
+        line->dirty = false;
+    }
+    write_stalled = false;
+    stats.sector_flushes++;
+
+    if (changed_pages == 0) {
+        flush_state = FLUSH_IDLE;
+        stage_sector = FLASH_DISK_NO_SECTOR;
+        return true;
+    }
+
+    if (needs_erase) {
+        // Erased pages that stay blank need no program
+        stage_pages = 0;
+        for (int p = 0; p < FLASH_PAGES_PER_SECTOR; p++) {
+            const uint8_t* page = &stage[p * FLASH_PAGE_SIZE];
+            for (int j = 0; j < FLASH_PAGE_SIZE; j++) {
+                if (page[j] != 0xFF) {
+                    stage_pages |= 1 << p;
+                    break;
+                }
+            }
+        }
+        if (!flash.startErase(stage_sector * FLASH_SECTOR_SIZE)) {
+            flush_state = FLUSH_IDLE;
+            stage_sector = FLASH_DISK_NO_SECTOR;
+            return false;
+        }
+        flush_state = FLUSH_ERASING;
+        stats.erases++;
+    } else {
+        stage_pages = changed_pages;
+        flush_state = FLUSH_PROGRAMMING;
+        stats.erases_skipped++;
+    }
+    return true;
+}
+
+bool MintFlashDisk::stepFlush() {
+    switch (flush_state) {
+        case FLUSH_IDLE:
+            return shouldFlush() && stageSector();
+
+        case FLUSH_READING: {
+            // Read the old data of the dirty blocks first; the rest of the
+            // sector is only needed if it has to be erased. One block per
+            // step keeps each step short.
+            const uint8_t all_blocks = (1 << FLASH_DISK_BLOCKS_PER_SECTOR) - 1;
+            uint8_t missing = dirtyBlocks() & ~stage_loaded;
+            if (!missing && stage_loaded != all_blocks && needsErase()) {
+                missing = all_blocks & ~stage_loaded;
+            }
+            if (!missing) {
+                return mergeSector();
+            }
+            int block = 0;
+            while (!(missing & (1 << block))) {
+                block++;
+            }
+            uint32_t offset = block * FLASH_DISK_BLOCK_SIZE;
+            if (!flash.read(stage_sector * FLASH_SECTOR_SIZE + offset, &stage[offset],
+                            FLASH_DISK_BLOCK_SIZE)) {
+                flush_state = FLUSH_IDLE;
+                stage_sector = FLASH_DISK_NO_SECTOR;
+                return false;
+            }
+            stage_loaded |= 1 << block;
+            return true;
+        }
+
+        case FLUSH_ERASING:
+            // Yield for the erase; task() checks back next period
+            if (flash.isBusy()) {
+                return false;
+            }
+            flush_state = FLUSH_PROGRAMMING;
+            return true;
+
+        case FLUSH_PROGRAMMING: {
+            // Page programs are short enough to poll within the budget
+            if (flash.isBusy()) {
+                return true;
+            }
+            if (stage_pages == 0) {
+                flush_state = FLUSH_IDLE;
+                stage_sector = FLASH_DISK_NO_SECTOR;
+                return true;
+            }
+            int page = 0;
+            while (!(stage_pages & (1 << page))) {
+                page++;
+            }
+            if (!flash.startProgram(stage_sector * FLASH_SECTOR_SIZE + page * FLASH_PAGE_SIZE,
+                                    &stage[page * FLASH_PAGE_SIZE], FLASH_PAGE_SIZE)) {
+                return false;
+            }
+            stage_pages &= ~(1 << page);
+            stats.pages_programmed++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MintFlashDisk::task() {
+    unsigned long start = micros();
+    while (micros() - start < FLASH_DISK_TASK_BUDGET_US && stepFlush()) {
+    }
+    if (flush_state == FLUSH_IDLE && getDirtyCount() == 0) {
+        flush_requested = false;
+    }
+}
+
+void MintFlashDisk::requestFlush() {
+    flush_requested = true;
+}
+
+bool MintFlashDisk::flush() {
+    unsigned long start = millis();
+    flush_requested = true;
+    while (getDirtyCount() > 0 || flush_state != FLUSH_IDLE) {
+        task();
+        if (millis() - start > FLASH_DISK_TIMEOUT_MS) {
+            return false;
+        }
+        if (flush_state == FLUSH_ERASING) {
+            delayMicroseconds(FLASH_DISK_POLL_US);
+        }
+    }
+    flush_requested = false;
+    return true;
+}
+
+bool MintFlashDisk::readBlocks(uint32_t lba, uint8_t* buffer, uint32_t count) {
+    unsigned long start = millis();
+    uint32_t done = 0;
+    while (done < count) {
+        int32_t result = read(lba + done, buffer + done * FLASH_DISK_BLOCK_SIZE,
+                              (count - done) * FLASH_DISK_BLOCK_SIZE);
+        if (result < 0) {
+            return false;
+        }
+        done += result / FLASH_DISK_BLOCK_SIZE;
+        if (done < count) {
+            task();
+            if (millis() - start > FLASH_DISK_TIMEOUT_MS) {
+                return false;
+            }
+            delayMicroseconds(FLASH_DISK_POLL_US);
+        }
+    }
+    return true;
+}
+
+bool MintFlashDisk::writeBlocks(uint32_t lba, const uint8_t* buffer, uint32_t count) {
+    unsigned long start = millis();
+    uint32_t done = 0;
+    while (done < count) {
+        int32_t result = write(lba + done, buffer + done * FLASH_DISK_BLOCK_SIZE,
+                               (count - done) * FLASH_DISK_BLOCK_SIZE);
+        if (result < 0) {
+            return false;
+        }
+        done += result / FLASH_DISK_BLOCK_SIZE;
+        if (done < count) {
+            task();
+            if (millis() - start > FLASH_DISK_TIMEOUT_MS) {
+                return false;
+            }
+            delayMicroseconds(FLASH_DISK_POLL_US);
+        }
+    }
+    return true;
+}
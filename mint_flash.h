@@ -0,0 +1,273 @@
+#ifndef MINT_FLASH_H
+#define MINT_FLASH_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// W25Q128JV wiring (SPI1)
+#define FLASH_CS_PIN 13
+#define FLASH_SCK_PIN 10
+#define FLASH_MOSI_PIN 11
+#define FLASH_MISO_PIN 12
+
+// SPI clock; READ DATA (0x03) is specified up to 50 MHz
+#define FLASH_SPI_HZ 30000000
+
+// Geometry
+#define FLASH_PAGE_SIZE 256
+#define FLASH_SECTOR_SIZE 4096
+#define FLASH_CAPACITY (16UL * 1024 * 1024)
+
+/**
+ * Driver for the on-board Winbond W25Q128JV 16 MB SPI NOR flash.
+ *
+ * Program and erase are split-phase: start*() issues the command and
+ * returns while the part works, and isBusy() reports when it is done, so
+ * callers can service other tasks during a 45 ms sector erase instead of
+ * spinning on the status register.
+ */
+class MintFlash {
+public:
+    /**
+     * Constructor for the flash driver.
+     * @param cs_pin Chip select pin
+     */
+    MintFlash(uint8_t cs_pin = FLASH_CS_PIN);
+
+    /**
+     * Initialize SPI and check the JEDEC ID.
+     * @return true if a W25Q128JV answered, false otherwise
+     */
+    bool begin();
+
+    /**
+     * Read from the array. Waits for a program or erase in progress.
+     * @param address Byte address
+     * @param buffer Output buffer
+     * @param length Bytes to read
+     * @return true if successful, false otherwise
+     */
+    bool read(uint32_t address, uint8_t* buffer, size_t length);
+
+    /**
+     * Start programming up to one page. Bytes can only be cleared; the
+     * range must not cross a page boundary.
+     * @param address Byte address
+     * @param data Data to program
+     * @param length Bytes to program (<= FLASH_PAGE_SIZE)
+     * @return true if the program was started, false if busy or invalid
+     */
+    bool startProgram(uint32_t address, const uint8_t* data, size_t length);
+
+    /**
+     * Start erasing the 4 KB sector containing an address.
+     * @param address Any byte address in the sector
+     * @return true if the erase was started, false if busy
+     */
+    bool startErase(uint32_t address);
+
+    /**
+     * Check whether a program or erase is still in progress.
+     * @return true while busy
+     */
+    bool isBusy();
+
+    /**
+     * Wait for a program or erase to finish.
+     * @param timeout_ms Longest wait
+     * @return true if the part is ready, false on timeout
+     */
+    bool waitReady(uint32_t timeout_ms);
+
+    /**
+     * Get the array size.
+     * @return Capacity in bytes
+     */
+    uint32_t getCapacity() const;
+
+private:
+    uint8_t cs;
+    bool present;
+
+    void select();
+    void deselect();
+    void command(uint8_t opcode);
+    void commandWithAddress(uint8_t opcode, uint32_t address);
+    uint8_t readStatus();
+};
+
+// Disk block size seen by the host
+#define FLASH_DISK_BLOCK_SIZE 512
+
+// Blocks per 4 KB erase sector
+#define FLASH_DISK_BLOCKS_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_DISK_BLOCK_SIZE)
+
+// RAM cache lines (one block each) and read-ahead depth
+#define FLASH_DISK_CACHE_LINES 16
+#define FLASH_DISK_READ_AHEAD 4
+
+/**
+ * Counters for the cached flash disk.
+ */
+typedef struct {
+    uint32_t read_hits;         // Blocks served from the cache or staging buffer
+    uint32_t read_misses;       // Blocks read from flash on demand
+    uint32_t read_ahead;        // Blocks prefetched behind a sequential read
+    uint32_t write_hits;        // Writes to a block already cached
+    uint32_t write_misses;      // Writes that took a new cache line
+    uint32_t stalls;            // Host requests answered busy
+    uint32_t sector_flushes;    // 4 KB sectors written back
+    uint32_t erases;            // Sectors erased before programming
+    uint32_t erases_skipped;    // Write-backs that only cleared bits
+    uint32_t pages_programmed;  // 256-byte page programs issued
+} FlashDiskStats;
+
+/**
+ * 512-byte block device on the W25Q128JV with a RAM write-back cache.
+ *
+ * Host writes land in cache lines and return at once. Dirty lines are
+ * written back a whole erase sector at a time: their old data is read and
+ * compared, the sector is erased only if some bit has to go from 0 to 1
+ * (and only then read in full into a staging buffer), and only the pages
+ * that changed are programmed. Write-back runs as a state machine stepped by
+ * task(), so a 45 ms erase never blocks USB or the other device tasks.
+ * Clean lines are evicted least recently used first, and sequential reads
+ * prefetch the following blocks.
+ *
+ * read() and write() follow the TinyUSB MSC callback convention: they
+ * return the bytes handled, which may be fewer than asked for, 0 when the
+ * host should retry later, or -1 on error.
+ */
+class MintFlashDisk {
+public:
+    /**
+     * Constructor for the cached flash disk.
+     * @param cs_pin Chip select pin of the flash
+     */
+    MintFlashDisk(uint8_t cs_pin = FLASH_CS_PIN);
+
+    /**
+     * Initialize the flash and empty the cache.
+     * @return true if the flash answered, false otherwise
+     */
+    bool begin();
+
+    /**
+     * Read blocks for the host.
+     * @param lba First block
+     * @param buffer Output buffer
+     * @param bufsize Bytes to read (a multiple of the block size)
+     * @return Bytes read, 0 if busy, -1 on error
+     */
+    int32_t read(uint32_t lba, void* buffer, uint32_t bufsize);
+
+    /**
+     * Write blocks for the host into the cache.
+     * @param lba First block
+     * @param buffer Data to write
+     * @param bufsize Bytes to write (a multiple of the block size)
+     * @return Bytes accepted, 0 if busy, -1 on error
+     */
+    int32_t write(uint32_t lba, const uint8_t* buffer, uint32_t bufsize);
+
+    /**
+     * Read blocks, stepping write-back until they are available.
+     * @param lba First block
+     * @param buffer Output buffer
+     * @param count Blocks to read
+     * @return true if successful, false on error or timeout
+     */
+    bool readBlocks(uint32_t lba, uint8_t* buffer, uint32_t count);
+
+    /**
+     * Write blocks, stepping write-back until the cache accepts them.
+     * @param lba First block
+     * @param buffer Data to write
+     * @param count Blocks to write
+     * @return true if successful, false on error or timeout
+     */
+    bool writeBlocks(uint32_t lba, const uint8_t* buffer, uint32_t count);
+
+    /**
+     * Step write-back. Call about every millisecond; each call returns
+     * after roughly half a millisecond of flash work.
+     */
+    void task();
+
+    /**
+     * Ask task() to write back every dirty line (host SYNCHRONIZE CACHE).
+     */
+    void requestFlush();
+
+    /**
+     * Write back every dirty line and wait for the flash.
+     * @return true if the cache is clean, false on error or timeout
+     */
+    bool flush();
+
+    /**
+     * Get the number of blocks.
+     * @return Block count
+     */
+    uint32_t getBlockCount() const;
+
+    /**
+     * Get the number of dirty cache lines.
+     * @return Dirty lines
+     */
+    uint8_t getDirtyCount() const;
+
+    const FlashDiskStats& getStats() const { return stats; }
+    void resetStats();
+
+private:
+    typedef enum {
+        FLUSH_IDLE,         // Nothing staged; the flash is idle
+        FLUSH_READING,      // Sector is being read into the staging buffer
+        FLUSH_ERASING,      // Staged sector is being erased
+        FLUSH_PROGRAMMING   // Staged pages are being programmed
+    } FlushState;
+
+    typedef struct {
+        uint32_t lba;
+        uint32_t last_used;
+        bool valid;
+        bool dirty;
+        uint8_t data[FLASH_DISK_BLOCK_SIZE];
+    } CacheLine;
+
+    MintFlash flash;
+    CacheLine lines[FLASH_DISK_CACHE_LINES];
+    uint32_t use_counter;
+    uint32_t next_sequential_lba;
+    unsigned long last_write_ms;
+    bool flush_requested;
+    bool write_stalled;
+    bool draining;                  // Between the high and low dirty marks
+
+    // Write-back of one erase sector
+    FlushState flush_state;
+    uint32_t stage_sector;
+    uint8_t stage_loaded;           // Blocks read into the staging buffer
+    uint16_t stage_pages;           // Pages still to program, one bit each
+    uint8_t stage[FLASH_SECTOR_SIZE];
+
+    FlashDiskStats stats;
+
+    CacheLine* findLine(uint32_t lba);
+    CacheLine* cleanLine();
+    void touch(CacheLine* line);
+    bool isStaged(uint32_t lba) const;
+    bool flashReady();
+    bool fetch(uint32_t lba, uint8_t* buffer);
+    void prefetch(uint32_t lba);
+    bool shouldFlush();
+    bool stageSector();
+    CacheLine* stagedLine(int index);
+    uint8_t dirtyBlocks() const;
+    bool needsErase();
+    bool mergeSector();
+    bool stepFlush();
+};
+
+#endif // MINT_FLASH_H
@@ -0,0 +1,77 @@
+#ifndef MINT_HASH_H
+#define MINT_HASH_H
+
+#include <Arduino.h>
+
+/**
+ * Hash functions computed on the MCU.
+ * Used where a round trip to the secure element would cost more than the
+ * hash itself (public key derivation, address encoding).
+ */
+class MintHash {
+public:
+    /**
+     * Streaming SHA-256 state
+     */
+    typedef struct {
+        uint32_t state[8];
+        uint64_t length;             // Total bytes hashed
+        uint8_t block[64];
+        size_t used;                 // Bytes buffered in block
+    } SHA256Context;
+
+    /**
+     * Streaming SHA-512 state
+     */
+    typedef struct {
+        uint64_t state[8];
+        uint64_t length;             // Total bytes hashed
+        uint8_t block[128];
+        size_t used;                 // Bytes buffered in block
+    } SHA512Context;
+
+    static void sha256Init(SHA256Context& ctx);
+    static void sha256Update(SHA256Context& ctx, const uint8_t* data, size_t length);
+    static void sha256Final(SHA256Context& ctx, uint8_t* digest);
+
+    /**
+     * Calculate SHA-256 in one call.
+     * @param data Data to hash
+     * @param length Length of data
+     * @param digest Output buffer (32 bytes)
+     */
+    static void sha256(const uint8_t* data, size_t length, uint8_t* digest);
+
+    static void sha512Init(SHA512Context& ctx);
+    static void sha512Update(SHA512Context& ctx, const uint8_t* data, size_t length);
+    static void sha512Final(SHA512Context& ctx, uint8_t* digest);
+
+    /**
+     * Calculate HMAC-SHA512 (RFC 2104).
+     * @param key HMAC key
+     * @param key_len Length of key
+     * @param data Message
+     * @param length Length of message
+     * @param mac Output buffer (64 bytes)
+     */
+    static void hmacSha512(const uint8_t* key, size_t key_len,
+                           const uint8_t* data, size_t length, uint8_t* mac);
+
+    /**
+     * Calculate RIPEMD-160.
+     * @param data Data to hash
+     * @param length Length of data
+     * @param digest Output buffer (20 bytes)
+     */
+    static void ripemd160(const uint8_t* data, size_t length, uint8_t* digest);
+
+    /**
+     * Calculate RIPEMD-160(SHA-256(data)), the Bitcoin key hash.
+     * @param data Data to hash
+     * @param length Length of data
+     * @param digest Output buffer (20 bytes)
+     */
+    static void hash160(const uint8_t* data, size_t length, uint8_t* digest);
+};
+
+#endif // MINT_HASH_H
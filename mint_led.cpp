@@ -1,4 +1,5 @@
 #include "mint_led.h"
+#include "mint_memory.h"
 
 MintLED::MintLED(uint8_t pin) : pixels(NUM_PIXELS, pin, NEO_GRB + NEO_KHZ800) {
 }
@@ -9,6 +10,7 @@ void MintLED::begin() {
     setInitializing();
 }
 
+MINT_RAM_FUNC(led_initializing)
 void MintLED::setInitializing() {
     pixels.setPixelColor(0, COLOR_INIT);
     pixels.show();
@@ -24,7 +26,36 @@ void MintLED::setBroken() {
     pixels.show();
 }
 
+MINT_RAM_FUNC(led_generating)
 void MintLED::setGenerating() {
     pixels.setPixelColor(0, COLOR_GENERATING);
     pixels.show();
+}
+
+MINT_RAM_FUNC(led_no_wallet)
+void MintLED::setNoWallet() {
+    pixels.setPixelColor(0, COLOR_NO_WALLET);
+    pixels.show();
+}
+
+MINT_RAM_FUNC(led_generating_wallet)
+void MintLED::setGeneratingWallet() {
+    setGenerating();
+}
+
+MINT_RAM_FUNC(led_secure)
+void MintLED::setSecure() {
+    pixels.setPixelColor(0, COLOR_SECURE);
+    pixels.show();
+}
+
+MINT_RAM_FUNC(led_tampered)
+void MintLED::setTampered() {
+    pixels.setPixelColor(0, COLOR_TAMPERED);
+    pixels.show();
+}
+
+void MintLED::setError() {
+    pixels.setPixelColor(0, COLOR_ERROR);
+    pixels.show();
 }
\ No newline at end of file
@@ -13,6 +13,11 @@ public:
     void setIntact();
     void setBroken();
     void setGenerating();
+    void setNoWallet();
+    void setGeneratingWallet();
+    void setSecure();
+    void setTampered();
+    void setError();
     
 private:
     static const uint8_t NUM_PIXELS = 1;
@@ -21,6 +26,10 @@ private:
     const uint32_t COLOR_BROKEN = 0x200000;     // Red for broken
     const uint32_t COLOR_INIT = 0x000020;       // Blue
     const uint32_t COLOR_GENERATING = 0x202000; // Yellow
+    const uint32_t COLOR_NO_WALLET = 0x202020;  // White
+    const uint32_t COLOR_SECURE = 0x200000;     // Red for sealed
+    const uint32_t COLOR_TAMPERED = 0x002000;   // Green for spent
+    const uint32_t COLOR_ERROR = 0x400000;      // Bright red
 };
 
 #endif
@@ -0,0 +1,151 @@
+#include "mint_log.h"
+
+#ifndef MINT_LOG_DISABLED
+
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/sync.h>
+#endif
+
+// Length byte, token and delta varint
+#define LOG_RECORD_HEADER_MAX 10
+
+static_assert((MINT_LOG_BUFFER_SIZE & (MINT_LOG_BUFFER_SIZE - 1)) == 0,
+              "MINT_LOG_BUFFER_SIZE must be a power of two");
+static_assert(LOG_RECORD_HEADER_MAX + MINT_LOG_MAX_ARGUMENTS <= 256,
+              "a record's length must fit its length byte");
+
+typedef struct {
+    uint8_t buffer[MINT_LOG_BUFFER_SIZE];
+    volatile uint32_t head;         // Bytes ever written; only writers move it
+    volatile uint32_t tail;         // Bytes ever drained; only the drain moves it
+    uint32_t dropped;
+    unsigned long last_us;          // Time of the newest record
+    unsigned long drained_us;       // Time of the newest drained record
+} LogRing;
+
+#ifdef ARDUINO_ARCH_RP2040
+static LogRing ring;
+
+static inline uint32_t enterWriter() {
+    return save_and_disable_interrupts();
+}
+
+static inline void leaveWriter(uint32_t saved) {
+    restore_interrupts(saved);
+}
+#else
+// One log per simulated board
+static thread_local LogRing ring;
+
+static inline uint32_t enterWriter() {
+    return 0;
+}
+
+static inline void leaveWriter(uint32_t saved) {
+}
+#endif
+
+void MintLog::write(uint32_t token, const uint8_t* args, size_t length) {
+    uint8_t header[LOG_RECORD_HEADER_MAX];
+    length = min(length, (size_t)MINT_LOG_MAX_ARGUMENTS);
+
+    const uint32_t saved = enterWriter();
+    const unsigned long now = micros();
+    size_t n = 1;
+    for (int i = 0; i < 4; i++) {
+        header[n++] = (uint8_t)(token >> (8 * i));
+    }
+    n += putVarint(header + n, (uint32_t)(now - ring.last_us));
+    header[0] = (uint8_t)(n - 1 + length);
+
+    // A dropped record leaves last_us alone, so the next delta spans it
+    const uint32_t head = ring.head;
+    if (head - ring.tail + n + length > MINT_LOG_BUFFER_SIZE) {
+        ring.dropped++;
+        leaveWriter(saved);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        ring.buffer[(head + i) & (MINT_LOG_BUFFER_SIZE - 1)] = header[i];
+    }
+    for (size_t i = 0; i < length; i++) {
+        ring.buffer[(head + n + i) & (MINT_LOG_BUFFER_SIZE - 1)] = args[i];
+    }
+
+    // Publish the record only once it is complete
+    __sync_synchronize();
+    ring.head = head + n + length;
+    ring.last_us = now;
+    leaveWriter(saved);
+}
+
+size_t MintLog::header(uint8_t* out) {
+    const uint32_t saved = enterWriter();
+    const uint32_t dropped = ring.dropped;
+    ring.dropped = 0;
+    leaveWriter(saved);
+
+    size_t n = 0;
+    out[n++] = 'M';
+    out[n++] = 'L';
+    out[n++] = 'O';
+    out[n++] = 'G';
+    out[n++] = MINT_LOG_VERSION;
+    n += putVarint(out + n, dropped);
+    n += putVarint(out + n, (uint32_t)ring.drained_us);
+    return n;
+}
+
+size_t MintLog::read(uint8_t* out, size_t max) {
+    const uint32_t head = ring.head;
+    __sync_synchronize();
+
+    uint32_t tail = ring.tail;
+    size_t copied = 0;
+    while (tail != head) {
+        const size_t record = 1 + ring.buffer[tail & (MINT_LOG_BUFFER_SIZE - 1)];
+        if (copied + record > max) {
+            break;
+        }
+        for (size_t i = 0; i < record; i++) {
+            out[copied + i] = ring.buffer[(tail + i) & (MINT_LOG_BUFFER_SIZE - 1)];
+        }
+
+        // Follow the record times, so the next drain's base is right
+        uint32_t delta = 0;
+        for (size_t i = 5, shift = 0; i < record && shift < 32; i++, shift += 7) {
+            delta |= (uint32_t)(out[copied + i] & 0x7F) << shift;
+            if (!(out[copied + i] & 0x80)) {
+                break;
+            }
+        }
+        ring.drained_us += delta;
+
+        copied += record;
+        tail += record;
+    }
+
+    // The space is free once the copy is done
+    __sync_synchronize();
+    ring.tail = tail;
+    return copied;
+}
+
+size_t MintLog::pending() {
+    return ring.head - ring.tail;
+}
+
+uint32_t MintLog::dropped() {
+    return ring.dropped;
+}
+
+void MintLog::clear() {
+    const uint32_t saved = enterWriter();
+    ring.tail = ring.head;
+    ring.dropped = 0;
+    ring.last_us = micros();
+    ring.drained_us = ring.last_us;
+    leaveWriter(saved);
+}
+
+#endif // !MINT_LOG_DISABLED
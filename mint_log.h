@@ -0,0 +1,231 @@
+#ifndef MINT_LOG_H
+#define MINT_LOG_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+/**
+ * Tokenized event log, cheap enough to leave on in production builds.
+ *
+ * MINT_LOG("sealed, %u bits from the file", bits) compiles to a 32-bit
+ * token, the FNV-1a hash of the format computed at compile time, plus
+ * the arguments' raw bytes: no format string reaches flash and nothing
+ * is formatted on the device. Records go into a RAM ring that main.ino
+ * drains over CDC ('L'); tests/log_decode.py hashes the MINT_LOG formats
+ * in the sources to turn them back into text.
+ *
+ * Formats are single string literals on one line. Arguments must match
+ * their conversions, which is checked at compile time:
+ *   %d  signed integer                    zigzag varint of its low 32 bits
+ *   %u  unsigned integer, bool or enum    varint of its low 32 bits
+ *   %x  same, shown in hex                varint
+ *   %s  C string                          length u8 + bytes (cut at 32)
+ *
+ * Record: [length u8][token u32 LE][delta_us varint][arguments], where
+ * length counts the bytes after it and delta_us is the time since the
+ * previous record (the first is timed from boot). A drain is
+ *   "MLOG" [version u8][dropped varint][base_us varint] records... [0]
+ * where base_us is the time of the record before the first one drained
+ * and dropped counts records lost to a full ring since the last drain.
+ *
+ * Writers mask interrupts for the few hundred cycles a record copy takes,
+ * so the MSC callbacks may log; the drain never holds up a writer. Host
+ * builds keep one log per thread, like the rest of the simulated board.
+ *
+ * The log is readable by anyone with a USB cable: never log key
+ * material, entropy, file contents or anything derived from them.
+ * Define MINT_LOG_DISABLED to compile every call site out; arguments are
+ * still checked against the format, and no code or data is left.
+ */
+
+#ifndef MINT_LOG_BUFFER_SIZE
+#define MINT_LOG_BUFFER_SIZE 2048
+#endif
+
+#define MINT_LOG_VERSION 1
+
+// Longest string argument kept, in bytes
+#define MINT_LOG_MAX_STRING 32
+
+// Argument bytes one record holds at most
+#define MINT_LOG_MAX_ARGUMENTS 64
+
+class MintLog {
+public:
+    /**
+     * Token for a format: FNV-1a, 32 bits, over its bytes.
+     */
+    static constexpr uint32_t token(const char* format) {
+        uint32_t hash = 2166136261u;
+        while (*format) {
+            hash = (hash ^ (uint8_t)*format++) * 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Check a format against argument kinds ('d', 'u' or 's' each).
+     * @return true if every conversion is known and has its argument
+     */
+    static constexpr bool matches(const char* format, const char* kinds) {
+        for (; *format; format++) {
+            if ((uint8_t)*format < 0x20) {
+                return false; // One line
+            }
+            if (*format != '%') {
+                continue;
+            }
+            format++;
+            if (*format == '%') {
+                continue;
+            }
+            const char kind = *format == 'd' ? 'd' :
+                              (*format == 'u' || *format == 'x') ? 'u' :
+                              *format == 's' ? 's' : 0;
+            if (!kind || *kinds++ != kind) {
+                return false;
+            }
+        }
+        return *kinds == '\0';
+    }
+
+    // Argument kind of a type, '?' if it can't be logged
+    template <typename T>
+    static constexpr char kindOf() {
+        return std::is_same<T, const char*>::value || std::is_same<T, char*>::value ? 's' :
+               std::is_enum<T>::value ? 'u' :
+               !std::is_integral<T>::value ? '?' :
+               std::is_signed<T>::value ? 'd' : 'u';
+    }
+
+    template <typename... T>
+    struct Kinds {
+        static constexpr char value[] = { kindOf<T>()..., '\0' };
+    };
+
+    // Kinds of a call site's arguments; only used in decltype
+    template <typename... T>
+    static Kinds<typename std::decay<T>::type...> kinds(const T&...);
+
+    /**
+     * Append one record; called by MINT_LOG.
+     * @param token Format token
+     * @param args Arguments, in the format's order
+     */
+    template <typename... T>
+    static void log(uint32_t token, const T&... args) {
+        static_assert(worstCase<T...>() <= MINT_LOG_MAX_ARGUMENTS, "too many MINT_LOG arguments");
+        if constexpr (sizeof...(T) == 0) {
+            write(token, nullptr, 0);
+        } else {
+            uint8_t bytes[MINT_LOG_MAX_ARGUMENTS];
+            size_t length = 0;
+            encode(bytes, length, args...);
+            write(token, bytes, length);
+        }
+    }
+
+    /**
+     * Append one record with encoded arguments. Records that do not fit
+     * are dropped and counted.
+     */
+    static void write(uint32_t token, const uint8_t* args, size_t length);
+
+    /**
+     * Start a drain: the "MLOG" header, taking the dropped count.
+     * @param out At least MINT_LOG_HEADER_MAX bytes
+     * @return Header bytes written
+     */
+    static size_t header(uint8_t* out);
+
+    /**
+     * Take whole records out of the ring, oldest first.
+     * @param out Output buffer
+     * @param max Buffer size; a record is 1 + its length byte
+     * @return Bytes written, 0 once the ring is empty
+     */
+    static size_t read(uint8_t* out, size_t max);
+
+    /**
+     * Get the number of bytes of records waiting to be drained.
+     */
+    static size_t pending();
+
+    /**
+     * Get the number of records dropped since the last drain.
+     */
+    static uint32_t dropped();
+
+    /**
+     * Discard all records; the next one is timed from now.
+     */
+    static void clear();
+
+private:
+    template <typename... T>
+    static constexpr size_t worstCase() {
+        return (0 + ... + (kindOf<typename std::decay<T>::type>() == 's' ?
+                           1 + MINT_LOG_MAX_STRING : 5));
+    }
+
+    static size_t putVarint(uint8_t* out, uint32_t value) {
+        size_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = (uint8_t)value;
+        return n;
+    }
+
+    static void encode(uint8_t* out, size_t& length) {}
+
+    template <typename T, typename... Rest>
+    static void encode(uint8_t* out, size_t& length, const T& value, const Rest&... rest) {
+        put(out, length, value);
+        encode(out, length, rest...);
+    }
+
+    template <typename T>
+    static void put(uint8_t* out, size_t& length, const T& value) {
+        typedef typename std::decay<T>::type D;
+        if constexpr (kindOf<D>() == 's') {
+            const char* text = value;
+            size_t n = 0;
+            while (text && n < MINT_LOG_MAX_STRING && text[n]) {
+                n++;
+            }
+            out[length++] = (uint8_t)n;
+            if (n) {
+                memcpy(out + length, text, n);
+                length += n;
+            }
+        } else if constexpr (kindOf<D>() == 'd') {
+            const int32_t v = (int32_t)value;
+            length += putVarint(out + length, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+        } else {
+            length += putVarint(out + length, (uint32_t)value);
+        }
+    }
+};
+
+// Drain header: magic, version and two varints
+#define MINT_LOG_HEADER_MAX 15
+
+#ifndef MINT_LOG_DISABLED
+#define MINT_LOG(format, ...) do { \
+    static_assert(MintLog::matches(format, decltype(MintLog::kinds(__VA_ARGS__))::value), \
+                  "MINT_LOG arguments must match the format's %d, %u, %x and %s"); \
+    constexpr uint32_t mint_log_token = MintLog::token(format); \
+    MintLog::log(mint_log_token, ##__VA_ARGS__); \
+} while (0)
+#else
+// Compiled out, but the arguments are still checked and count as used
+#define MINT_LOG(format, ...) do { \
+    static_assert(MintLog::matches(format, decltype(MintLog::kinds(__VA_ARGS__))::value), \
+                  "MINT_LOG arguments must match the format's %d, %u, %x and %s"); \
+    (void)sizeof(MintLog::kinds(__VA_ARGS__)); \
+} while (0)
+#endif
+
+#endif // MINT_LOG_H
@@ -0,0 +1,69 @@
+// mint_memory.h
+#ifndef MINT_MEMORY_H
+#define MINT_MEMORY_H
+
+#include <Arduino.h>
+
+/**
+ * RP2040 memory placement.
+ *
+ * Main SRAM is four 64 KB banks striped word by word, so any buffer the
+ * linker places there spreads over all four, and a DMA channel writing a
+ * sample ring stalls whichever core touches the same bank in that cycle:
+ * the MSC callbacks copying a sector, the SE050 driver, the stacks. The
+ * USB controller is not one of these masters; it works out of its own
+ * DPRAM and TinyUSB copies endpoint data with the CPU.
+ *
+ * Building with MINT_SRAM_PLACEMENT moves the busiest DMA targets, the
+ * entropy sample rings (20 kHz and 10 kHz), out of the striped banks into
+ * the two 4 KB non-striped banks, so CPU work in main SRAM only ever
+ * shares a bank with the 4 kHz tamper loop ring:
+ *
+ *   SRAM4 (scratch X)  ROSC sample ring          2 KB
+ *   SRAM5 (scratch Y)  ADC noise sample ring     2 KB
+ *   SRAM0-3, striped   RAM disk, flash disk cache, device object, heap,
+ *                      tamper loop ring
+ *
+ * Each scratch bank also holds a core stack at its top (core 0 in Y,
+ * core 1 in X), so a bank takes at most MINT_SRAM_SCRATCH_BUDGET of
+ * pinned data and the linker fails the build if a stack would not fit.
+ * tests/placement_report.py lists where everything ended up in a built
+ * image, and tests/sram_bench.py measures the effect on a device.
+ *
+ * Code runs in place from QSPI flash through a 16 KB XIP cache, which the
+ * MSC callbacks (in USB context), the tamper debounce, the scheduler loop
+ * and the LED updates all share with everything else. Building with
+ * MINT_RAM_HOT_PATHS copies those functions, and the constant tables they
+ * and the README rendering read (Base58 and bech32 alphabets, the bech32
+ * generator, the README templates), into SRAM at boot, so a cold cache
+ * never stalls them. The core's linker script gathers .time_critical.*
+ * sections into the RAM .data image. Code they call in flash, and in the
+ * cores and libraries, still goes through the cache.
+ * tests/placement_report.py --hot-paths lists what was relocated, and
+ * tests/sram_bench.py times the callbacks with the cache flushed.
+ *
+ * Other builds, host builds included, leave placement to the linker.
+ */
+
+// Pinned bytes per scratch bank; the rest is left to the core stack
+#define MINT_SRAM_SCRATCH_BUDGET 2048
+
+#if defined(ARDUINO_ARCH_RP2040) && defined(MINT_SRAM_PLACEMENT)
+#define MINT_SRAM4 __attribute__((section(".scratch_x.mint")))
+#define MINT_SRAM5 __attribute__((section(".scratch_y.mint")))
+#else
+#define MINT_SRAM4
+#define MINT_SRAM5
+#endif
+
+// One section per function or table, so const data never shares a
+// section with code; the name is what the placement report shows
+#if defined(ARDUINO_ARCH_RP2040) && defined(MINT_RAM_HOT_PATHS)
+#define MINT_RAM_FUNC(name) __attribute__((section(".time_critical.mint." #name)))
+#define MINT_RAM_DATA(name) __attribute__((section(".time_critical.mint." #name)))
+#else
+#define MINT_RAM_FUNC(name)
+#define MINT_RAM_DATA(name)
+#endif
+
+#endif // MINT_MEMORY_H
@@ -0,0 +1,177 @@
+// mint_readme.h
+#ifndef MINT_README_H
+#define MINT_README_H
+
+#include <Arduino.h>
+#include "mint_bip32.h"
+#include "mint_memory.h"
+
+// README block rendered for the current state (one disk sector)
+#define MINT_README_SIZE 512
+
+// Widest values patched into a README: a P2WPKH address, a compressed WIF
+#define MINT_README_ADDRESS_WIDTH (MINT_ADDRESS_BUFFER_SIZE - 1)
+#define MINT_README_WIF_WIDTH 52
+
+// Field marks in template sources, expanded to a blank field of its width
+#define MINT_README_ADDRESS_MARK '\x01'
+#define MINT_README_WIF_MARK '\x02'
+
+/**
+ * README templates, built at compile time.
+ *
+ * Each README variant is compiled from its source text into a full
+ * sector, zero-filled past the text, with every dynamic field blanked to
+ * its widest value at a fixed offset. Rendering copies the sector and
+ * patches the fields in place with a length-bounded copy, so it does no
+ * formatting and a README keeps the same length and layout whatever goes
+ * in its fields. Shorter values leave the rest of their field blank.
+ *
+ * The templates are constants, so they stay in flash, one copy each
+ * (in SRAM with MINT_RAM_HOT_PATHS, see mint_memory.h).
+ */
+class MintReadme {
+public:
+    typedef struct {
+        uint16_t offset;             // Start within the sector
+        uint16_t width;              // Bytes reserved, 0 if the template has no such field
+    } Field;
+
+    typedef struct {
+        char text[MINT_README_SIZE]; // Sector contents, zero-filled past length
+        uint16_t length;             // README file size
+        Field address;
+        Field wif;
+    } Template;
+
+    /**
+     * Length a source compiles to.
+     * @param source Template source, with field marks
+     * @return Bytes of README text
+     */
+    static constexpr size_t compiledLength(const char* source) {
+        size_t length = 0;
+        for (size_t i = 0; source[i]; i++) {
+            length += source[i] == MINT_README_ADDRESS_MARK ? MINT_README_ADDRESS_WIDTH :
+                      source[i] == MINT_README_WIF_MARK ? MINT_README_WIF_WIDTH : 1;
+        }
+        return length;
+    }
+
+    /**
+     * Compile a source into a template. Sources longer than a sector are
+     * rejected by the static_asserts below.
+     * @param source Template source, with each field marked at most once
+     * @return Template
+     */
+    static constexpr Template compile(const char* source) {
+        Template result = {};
+        size_t length = 0;
+        for (size_t i = 0; source[i] && length < MINT_README_SIZE; i++) {
+            size_t width = 0;
+            if (source[i] == MINT_README_ADDRESS_MARK) {
+                width = MINT_README_ADDRESS_WIDTH;
+                result.address = { (uint16_t)length, (uint16_t)width };
+            } else if (source[i] == MINT_README_WIF_MARK) {
+                width = MINT_README_WIF_WIDTH;
+                result.wif = { (uint16_t)length, (uint16_t)width };
+            } else {
+                result.text[length++] = source[i];
+                continue;
+            }
+            for (size_t j = 0; j < width && length < MINT_README_SIZE; j++) {
+                result.text[length++] = ' ';
+            }
+        }
+        result.length = (uint16_t)length;
+        return result;
+    }
+
+    /**
+     * Render a README into a sector buffer.
+     * @param source Compiled template
+     * @param address Address for the address field, if the template has one
+     * @param wif Private key for the WIF field, if the template has one
+     * @param sector Output buffer (MINT_README_SIZE bytes)
+     * @return README file size
+     */
+    static size_t render(const Template& source, const char* address, const char* wif,
+                         char* sector) {
+        memcpy(sector, source.text, MINT_README_SIZE);
+        patch(sector, source.address, address);
+        patch(sector, source.wif, wif);
+        return source.length;
+    }
+
+private:
+    static void patch(char* sector, const Field& field, const char* value) {
+        if (field.width && value) {
+            memcpy(sector + field.offset, value, strnlen(value, field.width));
+        }
+    }
+};
+
+// Shown until a wallet is generated
+#define MINT_README_NO_WALLET_SOURCE \
+    "MINT DEVICE\r\nDrop file for wallet\r\n"
+
+#define MINT_README_SEALED_SOURCE \
+    "MINT DEVICE - SEALED STATE\n\n" \
+    "This device is securely sealed. To access the private key,\n" \
+    "you must physically break the security circuit.\n\n" \
+    "Bitcoin Address:\n\x01\n\n" \
+    "WARNING: Breaking the circuit is IRREVERSIBLE and will\n" \
+    "permanently expose the private key."
+
+// Sealed, from a file that added next to no entropy (mint_estimator.h)
+#define MINT_README_SEALED_WEAK_FILE_SOURCE \
+    "MINT DEVICE - SEALED STATE\n\n" \
+    "This device is securely sealed. To access the private key,\n" \
+    "you must physically break the security circuit.\n\n" \
+    "Bitcoin Address:\n\x01\n\n" \
+    "NOTE: The file used added almost no entropy; the key\n" \
+    "relies on the device's own random sources.\n\n" \
+    "WARNING: Breaking the circuit is IRREVERSIBLE and will\n" \
+    "permanently expose the private key."
+
+#define MINT_README_TAMPERED_SOURCE \
+    "MINT DEVICE - TAMPERED STATE\n\n" \
+    "This device has been opened and the private key is exposed.\n\n" \
+    "Bitcoin Private Key (WIF format):\n\x02\n\n" \
+    "Bitcoin Address:\n\x01\n\n" \
+    "CAUTION: Anyone with access to the private key can spend the funds."
+
+static_assert(MintReadme::compiledLength(MINT_README_NO_WALLET_SOURCE) < MINT_README_SIZE,
+              "no-wallet README must fit in one sector");
+static_assert(MintReadme::compiledLength(MINT_README_SEALED_SOURCE) < MINT_README_SIZE,
+              "sealed README must fit in one sector");
+static_assert(MintReadme::compiledLength(MINT_README_SEALED_WEAK_FILE_SOURCE) < MINT_README_SIZE,
+              "weak file README must fit in one sector");
+static_assert(MintReadme::compiledLength(MINT_README_TAMPERED_SOURCE) < MINT_README_SIZE,
+              "tampered README must fit in one sector");
+
+MINT_RAM_DATA(readme_no_wallet)
+inline constexpr MintReadme::Template MINT_README_NO_WALLET =
+    MintReadme::compile(MINT_README_NO_WALLET_SOURCE);
+MINT_RAM_DATA(readme_sealed)
+inline constexpr MintReadme::Template MINT_README_SEALED =
+    MintReadme::compile(MINT_README_SEALED_SOURCE);
+MINT_RAM_DATA(readme_sealed_weak_file)
+inline constexpr MintReadme::Template MINT_README_SEALED_WEAK_FILE =
+    MintReadme::compile(MINT_README_SEALED_WEAK_FILE_SOURCE);
+MINT_RAM_DATA(readme_tampered)
+inline constexpr MintReadme::Template MINT_README_TAMPERED =
+    MintReadme::compile(MINT_README_TAMPERED_SOURCE);
+
+static_assert(MINT_README_SEALED.address.width == MINT_README_ADDRESS_WIDTH &&
+              MINT_README_SEALED.address.offset + MINT_README_ADDRESS_WIDTH <=
+              MINT_README_SEALED.length, "sealed README shows the address");
+static_assert(MINT_README_SEALED_WEAK_FILE.address.width == MINT_README_ADDRESS_WIDTH &&
+              MINT_README_SEALED_WEAK_FILE.address.offset + MINT_README_ADDRESS_WIDTH <=
+              MINT_README_SEALED_WEAK_FILE.length, "weak file README shows the address");
+static_assert(MINT_README_TAMPERED.wif.width == MINT_README_WIF_WIDTH &&
+              MINT_README_TAMPERED.address.width == MINT_README_ADDRESS_WIDTH &&
+              MINT_README_TAMPERED.address.offset + MINT_README_ADDRESS_WIDTH <=
+              MINT_README_TAMPERED.length, "tampered README shows the key and address");
+
+#endif // MINT_README_H
@@ -0,0 +1,123 @@
+#include "mint_scheduler.h"
+#include "mint_trace.h"
+#include "mint_memory.h"
+
+MintScheduler::MintScheduler() : task_count(0) {
+}
+
+int MintScheduler::addTask(const char* name, uint8_t priority, uint32_t period_us,
+                           uint32_t deadline_us, TaskFunction function) {
+    if (task_count >= MINT_SCHEDULER_MAX_TASKS || !function) {
+        return -1;
+    }
+
+    Task& task = tasks[task_count];
+    task.function = function;
+    task.release_us = micros(); // First release is immediate
+    memset(&task.stats, 0, sizeof(task.stats));
+    task.stats.name = name;
+    task.stats.priority = priority;
+    task.stats.period_us = period_us;
+    task.stats.deadline_us = deadline_us;
+
+    return (int)task_count++;
+}
+
+MINT_RAM_FUNC(scheduler_is_due)
+bool MintScheduler::isDue(const Task& task, unsigned long now) const {
+    return task.stats.period_us == 0 || (long)(now - task.release_us) >= 0;
+}
+
+MINT_RAM_FUNC(scheduler_run)
+void MintScheduler::run() {
+    const unsigned long pass_start = micros();
+    bool ran[MINT_SCHEDULER_MAX_TASKS] = { false };
+
+    for (;;) {
+        // Highest priority released task that has not run this pass
+        const unsigned long now = micros();
+        size_t next = task_count;
+        for (size_t i = 0; i < task_count; i++) {
+            if (!ran[i] && isDue(tasks[i], now) &&
+                (next == task_count || tasks[i].stats.priority < tasks[next].stats.priority)) {
+                next = i;
+            }
+        }
+        if (next == task_count) {
+            break;
+        }
+
+        ran[next] = true;
+        runTask(next, pass_start);
+    }
+}
+
+MINT_RAM_FUNC(scheduler_run_task)
+void MintScheduler::runTask(size_t index, unsigned long pass_start) {
+    Task& task = tasks[index];
+    TaskStats& stats = task.stats;
+
+    // Tasks run every pass are released when the pass starts
+    const unsigned long release = stats.period_us ? task.release_us : pass_start;
+    const unsigned long start = micros();
+    task.function();
+    const unsigned long end = micros();
+
+    const uint32_t run_us = (uint32_t)(end - start);
+    const uint32_t response_us = (uint32_t)(end - release);
+    stats.runs++;
+    if (run_us > stats.max_run_us) {
+        stats.max_run_us = run_us;
+    }
+    if (response_us > stats.max_response_us) {
+        stats.max_response_us = response_us;
+    }
+    if (response_us > stats.deadline_us) {
+        stats.overruns++;
+        MINT_TRACE(TRACE_EVENT_OVERRUN, (uint32_t)index, (const uint8_t*)&response_us,
+                   sizeof(response_us));
+    }
+
+    // Next release on the period grid; releases missed while late are
+    // dropped rather than run back to back
+    if (stats.period_us) {
+        task.release_us += stats.period_us;
+        if ((long)(end - task.release_us) >= 0) {
+            task.release_us += ((end - task.release_us) / stats.period_us + 1) * stats.period_us;
+        }
+    }
+}
+
+MINT_RAM_FUNC(scheduler_idle_time)
+uint32_t MintScheduler::getIdleTime() const {
+    const unsigned long now = micros();
+    uint32_t idle = 0xFFFFFFFFu;
+    for (size_t i = 0; i < task_count; i++) {
+        if (isDue(tasks[i], now)) {
+            return 0;
+        }
+        uint32_t until = (uint32_t)(tasks[i].release_us - now);
+        if (until < idle) {
+            idle = until;
+        }
+    }
+    return idle;
+}
+
+size_t MintScheduler::getTaskCount() const {
+    return task_count;
+}
+
+const MintScheduler::TaskStats& MintScheduler::getTaskStats(size_t index) const {
+    return tasks[index].stats;
+}
+
+void MintScheduler::resetStats() {
+    for (size_t i = 0; i < task_count; i++) {
+        TaskStats& stats = tasks[i].stats;
+        stats.runs = 0;
+        stats.overruns = 0;
+        stats.max_run_us = 0;
+        stats.max_response_us = 0;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef MINT_SCHEDULER_H
+#define MINT_SCHEDULER_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Most tasks a scheduler can hold
+#define MINT_SCHEDULER_MAX_TASKS 8
+
+/**
+ * Cooperative, prioritized task scheduler.
+ *
+ * Tasks are short state-machine steps: each call does a bounded amount of
+ * work and returns, keeping whatever it needs to resume in its owner. A
+ * task is released every period and must complete within its deadline,
+ * measured from release; a task that completes later is counted as an
+ * overrun and recorded in the I/O trace. Nothing is preempted, so a task
+ * that blocks delays every task released behind it, and the overrun
+ * counters show which.
+ */
+class MintScheduler {
+public:
+    // One step of a task
+    typedef std::function<void()> TaskFunction;
+
+    /**
+     * Per-task timing counters
+     */
+    typedef struct {
+        const char* name;          // Task name
+        uint8_t priority;          // Lower runs first
+        uint32_t period_us;        // Release period (0 = every pass)
+        uint32_t deadline_us;      // Allowed time from release to completion
+        uint32_t runs;             // Completed steps
+        uint32_t overruns;         // Steps completed after their deadline
+        uint32_t max_run_us;       // Longest single step
+        uint32_t max_response_us;  // Longest release-to-completion time
+    } TaskStats;
+
+    /**
+     * Constructor creates an empty scheduler
+     */
+    MintScheduler();
+
+    /**
+     * Register a task.
+     * @param name Task name, kept by pointer
+     * @param priority Lower values run first when several tasks are due
+     * @param period_us Release period in microseconds, 0 to run every pass
+     * @param deadline_us Allowed time from release to completion
+     * @param function Task step
+     * @return Task index, or -1 if the table is full
+     */
+    int addTask(const char* name, uint8_t priority, uint32_t period_us,
+                uint32_t deadline_us, TaskFunction function);
+
+    /**
+     * Run one scheduling pass: every released task runs once, highest
+     * priority first, re-evaluated after each step so a task released
+     * meanwhile does not wait behind lower priorities.
+     */
+    void run();
+
+    /**
+     * Time until the next task is released.
+     * @return Microseconds, 0 if a task is already due
+     */
+    uint32_t getIdleTime() const;
+
+    /**
+     * Get the number of registered tasks.
+     * @return Task count
+     */
+    size_t getTaskCount() const;
+
+    /**
+     * Get timing counters for a task.
+     * @param index Task index returned by addTask()
+     * @return Counters for the task
+     */
+    const TaskStats& getTaskStats(size_t index) const;
+
+    /**
+     * Clear all timing counters, keeping the tasks.
+     */
+    void resetStats();
+
+private:
+    typedef struct {
+        TaskFunction function;
+        unsigned long release_us;  // Current (or next) release time
+        TaskStats stats;
+    } Task;
+
+    Task tasks[MINT_SCHEDULER_MAX_TASKS];
+    size_t task_count;
+
+    /**
+     * Check whether a task is released at the given time
+     */
+    bool isDue(const Task& task, unsigned long now) const;
+
+    /**
+     * Run one step of a task and account for its timing
+     */
+    void runTask(size_t index, unsigned long pass_start);
+};
+
+#endif // MINT_SCHEDULER_H
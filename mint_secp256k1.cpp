@@ -0,0 +1,498 @@
+#include "mint_secp256k1.h"
+#include "mint_secp256k1_table.h"
+#include <string.h>
+
+// Field elements and scalars: 8 x 32-bit limbs, least significant first
+typedef struct {
+    uint32_t v[8];
+} FieldElement;
+
+// Projective point (X : Y : Z); the identity is (0 : 1 : 0)
+typedef struct {
+    FieldElement x;
+    FieldElement y;
+    FieldElement z;
+} ProjectivePoint;
+
+// Affine point, never the identity
+typedef struct {
+    FieldElement x;
+    FieldElement y;
+} AffinePoint;
+
+// p = 2^256 - 2^32 - 977
+static const uint32_t FIELD_P[8] = {
+    0xFFFFFC2F, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+// p - 2, the Fermat inversion exponent
+static const uint32_t FIELD_P_MINUS_2[8] = {
+    0xFFFFFC2D, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+// Group order n
+static const uint32_t GROUP_N[8] = {
+    0xD0364141, 0xBFD25E8C, 0xAF48A03B, 0xBAAEDCE6,
+    0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+
+// 3 * b for y^2 = x^3 + 7, used by the complete formulas
+#define CURVE_B3 21
+
+// Subtract modulus from r if carry is set or r >= modulus, without branching
+static void condSubtract(uint32_t* r, const uint32_t* modulus, uint32_t carry) {
+    uint32_t t[8];
+    uint32_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t d = (uint64_t)r[i] - modulus[i] - borrow;
+        t[i] = (uint32_t)d;
+        borrow = (uint32_t)(d >> 63);
+    }
+
+    uint32_t mask = 0 - (carry | (borrow ^ 1));
+    for (int i = 0; i < 8; i++) {
+        r[i] = (t[i] & mask) | (r[i] & ~mask);
+    }
+}
+
+// Add top * 2^256 to r using 2^256 = 2^32 + 977 (mod p); returns the carry out
+static uint32_t foldTop(uint32_t* r, uint64_t top) {
+    uint64_t c = (uint64_t)r[0] + top * 977;
+    r[0] = (uint32_t)c;
+    c >>= 32;
+    c += (uint64_t)r[1] + top;
+    r[1] = (uint32_t)c;
+    c >>= 32;
+    for (int i = 2; i < 8; i++) {
+        c += r[i];
+        r[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    return (uint32_t)c;
+}
+
+static void feAdd(FieldElement& r, const FieldElement& a, const FieldElement& b) {
+    uint64_t c = 0;
+    for (int i = 0; i < 8; i++) {
+        c += (uint64_t)a.v[i] + b.v[i];
+        r.v[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    condSubtract(r.v, FIELD_P, (uint32_t)c);
+}
+
+static void feSub(FieldElement& r, const FieldElement& a, const FieldElement& b) {
+    uint32_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t d = (uint64_t)a.v[i] - b.v[i] - borrow;
+        r.v[i] = (uint32_t)d;
+        borrow = (uint32_t)(d >> 63);
+    }
+
+    // Add p back on underflow
+    uint32_t mask = 0 - borrow;
+    uint64_t c = 0;
+    for (int i = 0; i < 8; i++) {
+        c += (uint64_t)r.v[i] + (FIELD_P[i] & mask);
+        r.v[i] = (uint32_t)c;
+        c >>= 32;
+    }
+}
+
+static void feMul(FieldElement& r, const FieldElement& a, const FieldElement& b) {
+    uint32_t t[16];
+    memset(t, 0, sizeof(t));
+
+    for (int i = 0; i < 8; i++) {
+        uint64_t c = 0;
+        for (int j = 0; j < 8; j++) {
+            c += (uint64_t)a.v[i] * b.v[j] + t[i + j];
+            t[i + j] = (uint32_t)c;
+            c >>= 32;
+        }
+        t[i + 8] = (uint32_t)c;
+    }
+
+    // Reduce: t = lo + hi * 2^256 = lo + hi * (2^32 + 977)
+    uint32_t out[8];
+    uint64_t c = 0;
+    for (int i = 0; i < 8; i++) {
+        c += (uint64_t)t[i] + (uint64_t)t[8 + i] * 977;
+        if (i) {
+            c += t[7 + i];
+        }
+        out[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    c += t[15];
+
+    uint32_t carry = foldTop(out, c);
+    carry = foldTop(out, carry);
+    condSubtract(out, FIELD_P, carry);
+    memcpy(r.v, out, sizeof(out));
+}
+
+static void feMulSmall(FieldElement& r, const FieldElement& a, uint32_t k) {
+    uint32_t out[8];
+    uint64_t c = 0;
+    for (int i = 0; i < 8; i++) {
+        c += (uint64_t)a.v[i] * k;
+        out[i] = (uint32_t)c;
+        c >>= 32;
+    }
+
+    uint32_t carry = foldTop(out, c);
+    carry = foldTop(out, carry);
+    condSubtract(out, FIELD_P, carry);
+    memcpy(r.v, out, sizeof(out));
+}
+
+static void feInvert(FieldElement& r, const FieldElement& a) {
+    // a^(p-2); the exponent is public, so branching on its bits is safe
+    FieldElement result;
+    memset(&result, 0, sizeof(result));
+    result.v[0] = 1;
+
+    for (int bit = 255; bit >= 0; bit--) {
+        feMul(result, result, result);
+        if ((FIELD_P_MINUS_2[bit >> 5] >> (bit & 31)) & 1) {
+            feMul(result, result, a);
+        }
+    }
+    r = result;
+}
+
+static uint32_t feIsZero(const FieldElement& a) {
+    uint32_t acc = 0;
+    for (int i = 0; i < 8; i++) {
+        acc |= a.v[i];
+    }
+    return ((acc | (0 - acc)) >> 31) ^ 1;
+}
+
+static void feCmov(FieldElement& r, const FieldElement& a, uint32_t flag) {
+    uint32_t mask = 0 - flag;
+    for (int i = 0; i < 8; i++) {
+        r.v[i] = (a.v[i] & mask) | (r.v[i] & ~mask);
+    }
+}
+
+static void limbsFromBytes(uint32_t* r, const uint8_t* bytes) {
+    for (int i = 0; i < 8; i++) {
+        const uint8_t* p = bytes + 28 - 4 * i;
+        r[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+}
+
+static void limbsToBytes(uint8_t* bytes, const uint32_t* a) {
+    for (int i = 0; i < 8; i++) {
+        uint8_t* p = bytes + 28 - 4 * i;
+        p[0] = (uint8_t)(a[i] >> 24);
+        p[1] = (uint8_t)(a[i] >> 16);
+        p[2] = (uint8_t)(a[i] >> 8);
+        p[3] = (uint8_t)a[i];
+    }
+}
+
+// 1 if a < modulus
+static uint32_t limbsBelow(const uint32_t* a, const uint32_t* modulus) {
+    uint32_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t d = (uint64_t)a[i] - modulus[i] - borrow;
+        borrow = (uint32_t)(d >> 63);
+    }
+    return borrow;
+}
+
+static void pointSetIdentity(ProjectivePoint& r) {
+    memset(&r, 0, sizeof(r));
+    r.y.v[0] = 1;
+}
+
+// Complete doubling for a = 0 (Renes-Costello-Batina 2015, algorithm 9)
+static void pointDouble(ProjectivePoint& r, const ProjectivePoint& p) {
+    FieldElement t0, t1, t2, x3, y3, z3;
+
+    feMul(t0, p.y, p.y);
+    feAdd(z3, t0, t0);
+    feAdd(z3, z3, z3);
+    feAdd(z3, z3, z3);
+    feMul(t1, p.y, p.z);
+    feMul(t2, p.z, p.z);
+    feMulSmall(t2, t2, CURVE_B3);
+    feMul(x3, t2, z3);
+    feAdd(y3, t0, t2);
+    feMul(z3, t1, z3);
+    feAdd(t1, t2, t2);
+    feAdd(t2, t1, t2);
+    feSub(t0, t0, t2);
+    feMul(y3, t0, y3);
+    feAdd(y3, x3, y3);
+    feMul(t1, p.x, p.y);
+    feMul(x3, t0, t1);
+    feAdd(x3, x3, x3);
+
+    r.x = x3;
+    r.y = y3;
+    r.z = z3;
+}
+
+// Mixed addition for a = 0 (Renes-Costello-Batina 2015, algorithm 8)
+// Complete for any p, including the identity; q must not be the identity
+static void pointAddMixed(ProjectivePoint& r, const ProjectivePoint& p, const AffinePoint& q) {
+    FieldElement t0, t1, t2, t3, t4, x3, y3, z3;
+
+    feMul(t0, p.x, q.x);
+    feMul(t1, p.y, q.y);
+    feAdd(t3, q.x, q.y);
+    feAdd(t4, p.x, p.y);
+    feMul(t3, t3, t4);
+    feAdd(t4, t0, t1);
+    feSub(t3, t3, t4);
+    feMul(t4, q.y, p.z);
+    feAdd(t4, t4, p.y);
+    feMul(y3, q.x, p.z);
+    feAdd(y3, y3, p.x);
+    feAdd(x3, t0, t0);
+    feAdd(t0, x3, t0);
+    feMulSmall(t2, p.z, CURVE_B3);
+    feAdd(z3, t1, t2);
+    feSub(t1, t1, t2);
+    feMulSmall(y3, y3, CURVE_B3);
+    feMul(x3, t4, y3);
+    feMul(t2, t3, t1);
+    feSub(x3, t2, x3);
+    feMul(y3, y3, t0);
+    feMul(t1, t1, z3);
+    feAdd(y3, t1, y3);
+    feMul(t0, t0, t3);
+    feMul(z3, z3, t4);
+    feAdd(z3, z3, t0);
+
+    r.x = x3;
+    r.y = y3;
+    r.z = z3;
+}
+
+// Read table entry index while touching every entry
+static void combLookup(AffinePoint& r, uint32_t index) {
+    memset(&r, 0, sizeof(r));
+    for (uint32_t i = 0; i < (1u << MINT_SECP256K1_COMB_TEETH); i++) {
+        uint32_t diff = i ^ index;
+        uint32_t mask = ((diff | (0 - diff)) >> 31) - 1;
+        for (int j = 0; j < 8; j++) {
+            r.x.v[j] |= SECP256K1_COMB_TABLE[i][j] & mask;
+            r.y.v[j] |= SECP256K1_COMB_TABLE[i][8 + j] & mask;
+        }
+    }
+}
+
+// One comb column: acc = 2 * acc + table[k's bits in this column]
+static void combColumn(ProjectivePoint& acc, const uint32_t* k, int column) {
+    ProjectivePoint sum;
+    AffinePoint entry;
+    pointDouble(acc, acc);
+
+    uint32_t index = 0;
+    for (int tooth = 0; tooth < MINT_SECP256K1_COMB_TEETH; tooth++) {
+        int bit = tooth * MINT_SECP256K1_COMB_SPACING + column;
+        if (bit < 256) {
+            index |= ((k[bit >> 5] >> (bit & 31)) & 1) << tooth;
+        }
+    }
+
+    // Entry 0 is a placeholder: add it anyway and discard the result
+    combLookup(entry, index);
+    pointAddMixed(sum, acc, entry);
+    uint32_t use = ((index | (0 - index)) >> 31);
+    feCmov(acc.x, sum.x, use);
+    feCmov(acc.y, sum.y, use);
+    feCmov(acc.z, sum.z, use);
+
+    memset(&sum, 0, sizeof(sum));
+    memset(&entry, 0, sizeof(entry));
+}
+
+// r = k * G with the comb table; k must be fully reduced
+static void combMultiply(ProjectivePoint& r, const uint32_t* k) {
+    ProjectivePoint acc;
+    pointSetIdentity(acc);
+    for (int column = MINT_SECP256K1_COMB_SPACING - 1; column >= 0; column--) {
+        combColumn(acc, k, column);
+    }
+    r = acc;
+    memset(&acc, 0, sizeof(acc));
+}
+
+static_assert(sizeof(ProjectivePoint) == sizeof(((MintSecp256k1::BaseMultiplyState*)0)->acc),
+              "BaseMultiplyState must hold a projective point");
+
+static bool pointToBytes(uint8_t* pubkey_out, const ProjectivePoint& p) {
+    if (feIsZero(p.z)) {
+        return false;
+    }
+
+    FieldElement z_inv, x, y;
+    feInvert(z_inv, p.z);
+    feMul(x, p.x, z_inv);
+    feMul(y, p.y, z_inv);
+
+    pubkey_out[0] = 0x04;
+    limbsToBytes(pubkey_out + 1, x.v);
+    limbsToBytes(pubkey_out + 33, y.v);
+    return true;
+}
+
+static bool pointFromBytes(AffinePoint& r, const uint8_t* pubkey) {
+    if (pubkey[0] != 0x04) {
+        return false;
+    }
+
+    limbsFromBytes(r.x.v, pubkey + 1);
+    limbsFromBytes(r.y.v, pubkey + 33);
+    if (!limbsBelow(r.x.v, FIELD_P) || !limbsBelow(r.y.v, FIELD_P)) {
+        return false;
+    }
+
+    // y^2 == x^3 + 7
+    FieldElement lhs, rhs, seven;
+    memset(&seven, 0, sizeof(seven));
+    seven.v[0] = 7;
+    feMul(lhs, r.y, r.y);
+    feMul(rhs, r.x, r.x);
+    feMul(rhs, rhs, r.x);
+    feAdd(rhs, rhs, seven);
+    feSub(lhs, lhs, rhs);
+    return feIsZero(lhs) == 1;
+}
+
+bool MintSecp256k1::baseMultiply(const uint8_t* scalar, uint8_t* pubkey_out) {
+    uint32_t k[8];
+    limbsFromBytes(k, scalar);
+
+    FieldElement k_fe;
+    memcpy(k_fe.v, k, sizeof(k));
+    if (!limbsBelow(k, GROUP_N) || feIsZero(k_fe)) {
+        memset(k, 0, sizeof(k));
+        memset(&k_fe, 0, sizeof(k_fe));
+        return false;
+    }
+
+    ProjectivePoint result;
+    combMultiply(result, k);
+    bool ok = pointToBytes(pubkey_out, result);
+
+    // Zero out the scalar, which may be a private key
+    memset(k, 0, sizeof(k));
+    memset(&k_fe, 0, sizeof(k_fe));
+    memset(&result, 0, sizeof(result));
+    return ok;
+}
+
+bool MintSecp256k1::baseMultiplyStart(BaseMultiplyState& state, const uint8_t* scalar) {
+    memset(&state, 0, sizeof(state));
+    state.column = -1;
+    limbsFromBytes(state.scalar, scalar);
+
+    FieldElement k_fe;
+    memcpy(k_fe.v, state.scalar, sizeof(k_fe.v));
+    const bool valid = limbsBelow(state.scalar, GROUP_N) && !feIsZero(k_fe);
+    memset(&k_fe, 0, sizeof(k_fe));
+    if (!valid) {
+        memset(state.scalar, 0, sizeof(state.scalar));
+        return false;
+    }
+
+    ProjectivePoint acc;
+    pointSetIdentity(acc);
+    memcpy(state.acc, &acc, sizeof(acc));
+    state.column = MINT_SECP256K1_COMB_SPACING - 1;
+    return true;
+}
+
+bool MintSecp256k1::baseMultiplyStep(BaseMultiplyState& state, int columns) {
+    ProjectivePoint acc;
+    memcpy(&acc, state.acc, sizeof(acc));
+    for (; columns > 0 && state.column >= 0; columns--, state.column--) {
+        combColumn(acc, state.scalar, state.column);
+    }
+    memcpy(state.acc, &acc, sizeof(acc));
+    memset(&acc, 0, sizeof(acc));
+    return state.column < 0;
+}
+
+bool MintSecp256k1::baseMultiplyFinish(BaseMultiplyState& state, uint8_t* pubkey_out) {
+    ProjectivePoint acc;
+    memcpy(&acc, state.acc, sizeof(acc));
+    const bool ok = state.column < 0 && pointToBytes(pubkey_out, acc);
+    memset(&acc, 0, sizeof(acc));
+    memset(&state, 0, sizeof(state));
+    state.column = -1;
+    return ok;
+}
+
+bool MintSecp256k1::tweakAddPublic(const uint8_t* pubkey, const uint8_t* tweak,
+                                   uint8_t* pubkey_out) {
+    AffinePoint parent;
+    if (!pointFromBytes(parent, pubkey)) {
+        return false;
+    }
+
+    uint32_t t[8];
+    limbsFromBytes(t, tweak);
+    if (!limbsBelow(t, GROUP_N)) {
+        return false;
+    }
+
+    ProjectivePoint result;
+    combMultiply(result, t);
+    pointAddMixed(result, result, parent);
+    return pointToBytes(pubkey_out, result);
+}
+
+bool MintSecp256k1::tweakAddPrivate(const uint8_t* key, const uint8_t* tweak, uint8_t* key_out) {
+    uint32_t k[8], t[8];
+    limbsFromBytes(k, key);
+    limbsFromBytes(t, tweak);
+
+    bool valid = limbsBelow(k, GROUP_N) && limbsBelow(t, GROUP_N);
+
+    uint64_t c = 0;
+    for (int i = 0; i < 8; i++) {
+        c += (uint64_t)k[i] + t[i];
+        k[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    condSubtract(k, GROUP_N, (uint32_t)c);
+
+    FieldElement sum;
+    memcpy(sum.v, k, sizeof(k));
+    valid = valid && !feIsZero(sum);
+    if (valid) {
+        limbsToBytes(key_out, k);
+    }
+
+    // Zero out key material
+    memset(k, 0, sizeof(k));
+    memset(t, 0, sizeof(t));
+    memset(&sum, 0, sizeof(sum));
+    return valid;
+}
+
+void MintSecp256k1::compress(const uint8_t* pubkey, uint8_t* compressed_out) {
+    compressed_out[0] = 0x02 | (pubkey[64] & 1);
+    memcpy(compressed_out + 1, pubkey + 1, 32);
+}
+
+bool MintSecp256k1::isValidPublicKey(const uint8_t* pubkey) {
+    AffinePoint point;
+    return pointFromBytes(point, pubkey);
+}
+
+bool MintSecp256k1::isBelowOrder(const uint8_t* scalar) {
+    uint32_t s[8];
+    limbsFromBytes(s, scalar);
+    return limbsBelow(s, GROUP_N) == 1;
+}
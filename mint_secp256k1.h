@@ -0,0 +1,106 @@
+#ifndef MINT_SECP256K1_H
+#define MINT_SECP256K1_H
+
+#include <Arduino.h>
+
+// Fixed-base comb geometry, must match mint_secp256k1_table.h
+#define MINT_SECP256K1_COMB_TEETH 6
+#define MINT_SECP256K1_COMB_SPACING 43
+
+/**
+ * secp256k1 public-key arithmetic on the MCU.
+ *
+ * Fixed-base multiplication uses a comb table precomputed into flash
+ * (see tests/host/gen_secp256k1_table.py), complete projective formulas
+ * and constant-time table lookups, so running time does not depend on
+ * scalar or point values. Only public derivation work runs here; private
+ * keys stay in the secure element until the tamper path reveals them.
+ *
+ * Points are exchanged as 65-byte uncompressed SEC1 encodings (0x04 || x || y),
+ * which is the format the SE050 returns.
+ */
+class MintSecp256k1 {
+public:
+    /**
+     * A fixed-base multiplication split into steps, for callers that
+     * bound the time of each call (the background self-test)
+     */
+    typedef struct {
+        uint32_t scalar[8];          // Scalar, 32-bit limbs, least significant first
+        uint32_t acc[24];            // Projective accumulator (X, Y, Z)
+        int column;                  // Next comb column, -1 once all are done
+    } BaseMultiplyState;
+
+    /**
+     * Compute scalar * G.
+     * @param scalar 32-byte big-endian scalar, must be in [1, n-1]
+     * @param pubkey_out Output buffer (65 bytes, uncompressed)
+     * @return true if successful, false if scalar out of range
+     */
+    static bool baseMultiply(const uint8_t* scalar, uint8_t* pubkey_out);
+
+    /**
+     * Start computing scalar * G in steps.
+     * @param state Multiplication state
+     * @param scalar 32-byte big-endian scalar, must be in [1, n-1]
+     * @return true if started, false if scalar out of range
+     */
+    static bool baseMultiplyStart(BaseMultiplyState& state, const uint8_t* scalar);
+
+    /**
+     * Run up to a number of comb columns (MINT_SECP256K1_COMB_SPACING in all).
+     * @param state Started multiplication state
+     * @param columns Columns to run
+     * @return true once every column has run
+     */
+    static bool baseMultiplyStep(BaseMultiplyState& state, int columns);
+
+    /**
+     * Convert the finished product to bytes and zero the state.
+     * @param state Multiplication state, every column run
+     * @param pubkey_out Output buffer (65 bytes, uncompressed)
+     * @return true if successful, false if columns remain
+     */
+    static bool baseMultiplyFinish(BaseMultiplyState& state, uint8_t* pubkey_out);
+
+    /**
+     * Compute pubkey + tweak * G (BIP32 public child key).
+     * @param pubkey Parent public key (65 bytes, uncompressed)
+     * @param tweak 32-byte big-endian tweak, must be in [0, n-1]
+     * @param pubkey_out Output buffer (65 bytes, uncompressed)
+     * @return true if successful, false if inputs invalid or result is infinity
+     */
+    static bool tweakAddPublic(const uint8_t* pubkey, const uint8_t* tweak, uint8_t* pubkey_out);
+
+    /**
+     * Compute (key + tweak) mod n (BIP32 private child key).
+     * @param key 32-byte big-endian private key
+     * @param tweak 32-byte big-endian tweak, must be in [0, n-1]
+     * @param key_out Output buffer (32 bytes)
+     * @return true if successful, false if the result is zero or inputs invalid
+     */
+    static bool tweakAddPrivate(const uint8_t* key, const uint8_t* tweak, uint8_t* key_out);
+
+    /**
+     * Compress an uncompressed public key.
+     * @param pubkey Public key (65 bytes, uncompressed)
+     * @param compressed_out Output buffer (33 bytes)
+     */
+    static void compress(const uint8_t* pubkey, uint8_t* compressed_out);
+
+    /**
+     * Check that a public key is a valid uncompressed point on the curve.
+     * @param pubkey Public key (65 bytes)
+     * @return true if valid, false otherwise
+     */
+    static bool isValidPublicKey(const uint8_t* pubkey);
+
+    /**
+     * Check that a scalar is below the group order n.
+     * @param scalar 32-byte big-endian scalar
+     * @return true if scalar < n, false otherwise
+     */
+    static bool isBelowOrder(const uint8_t* scalar);
+};
+
+#endif // MINT_SECP256K1_H
@@ -0,0 +1,138 @@
+// Generated by tests/host/gen_secp256k1_table.py - do not edit
+#ifndef MINT_SECP256K1_TABLE_H
+#define MINT_SECP256K1_TABLE_H
+
+// Comb table: 6 teeth, spacing 43; entry 0 is unused (holds G)
+// Affine points as x then y, 32-bit little-endian limbs
+static const uint32_t SECP256K1_COMB_TABLE[64][16] = {
+    { 0x16F81798, 0x59F2815B, 0x2DCE28D9, 0x029BFCDB, 0xCE870B07, 0x55A06295, 0xF9DCBBAC, 0x79BE667E,
+      0xFB10D4B8, 0x9C47D08F, 0xA6855419, 0xFD17B448, 0x0E1108A8, 0x5DA4FBFC, 0x26A3C465, 0x483ADA77 },
+    { 0x16F81798, 0x59F2815B, 0x2DCE28D9, 0x029BFCDB, 0xCE870B07, 0x55A06295, 0xF9DCBBAC, 0x79BE667E,
+      0xFB10D4B8, 0x9C47D08F, 0xA6855419, 0xFD17B448, 0x0E1108A8, 0x5DA4FBFC, 0x26A3C465, 0x483ADA77 },
+    { 0x43FF8359, 0x6048B060, 0xC65E7651, 0x46B4821D, 0xC21DA014, 0xB7D282B5, 0x9F7BD253, 0xA2B7B362,
+      0xFE86FEC2, 0xA2397FEC, 0x046F3835, 0x10D10835, 0xF71E29C9, 0x57A937A3, 0x1695122D, 0x69303894 },
+    { 0xB10FD304, 0xBE27D057, 0x347F3A26, 0x86960638, 0x18E4A8AD, 0x8CD0B2D6, 0x8B4D88D4, 0x6576D554,
+      0x74B35A7E, 0x3214FBF6, 0x19DCA53C, 0xDE91C8FF, 0x7471A2CD, 0x4BA282BD, 0x3A1E8C39, 0xB481E63E },
+    { 0xDFBFA4DC, 0x476706E4, 0x04C85B17, 0xF5948A78, 0x7ADBB41F, 0x8392119D, 0x731FEA19, 0xD6788590,
+      0xBD3B5406, 0xCA7BCD6B, 0xDDC9A07C, 0x6206F1C4, 0xD21C13AA, 0x940EF5C6, 0x9D5063C4, 0x28EAA8C8 },
+    { 0xF7866196, 0x3E73FCC8, 0x81B3F4AA, 0x25E21C36, 0x9339AE07, 0x52565E80, 0x891E3CC0, 0x29C47EAB,
+      0x26AC3DCD, 0x3D9D8AA9, 0x2FF10FDF, 0x3E49815B, 0x6ACA3EF4, 0xD55A8DEC, 0x88B83DF0, 0x4E0D94B7 },
+    { 0xEDECC847, 0xEA375008, 0x5844A04C, 0x309FEFFB, 0xCF58F7E0, 0x170A37E4, 0x1AD31962, 0xF73C1285,
+      0x4B5D70E2, 0x2CF714DB, 0x17B6864F, 0x99EDBEDF, 0x3E0D2581, 0x8C3A8A7D, 0x59C6B114, 0x506B9E27 },
+    { 0x2B7FE6B1, 0x8F6FF9C4, 0x65DED430, 0xA647B5B0, 0x29AA5F4B, 0x5D53C326, 0x63D326C5, 0xCEA2E172,
+      0xB3CF7BD1, 0x7E5111E5, 0x99C547A7, 0x2C157FA2, 0xC251B9E4, 0x884E42AB, 0x9B97D96F, 0x31685DB5 },
+    { 0x4CF27076, 0xE6847DF8, 0xE7627EAE, 0xD89858AD, 0x7FD9AF59, 0xFCAFEBE7, 0x784E8158, 0x4D49AEFD,
+      0x03AA781E, 0x6B90B662, 0x7DF4D846, 0x6E0F2D1A, 0x359CA6F0, 0xE723F210, 0xA10DD135, 0xCD32FC59 },
+    { 0xCE279A45, 0x042F7989, 0x270F23BF, 0xEA8B0FA8, 0xBD2623D6, 0x505C7CE5, 0xCD0123C6, 0x2C0E4587,
+      0x79858DA8, 0xAA5491ED, 0xC5348EBE, 0xC881DBF3, 0x946801EB, 0xF45BAA5C, 0x07D42762, 0xA02F6127 },
+    { 0x7F56F827, 0x0035AF53, 0xD253E9A6, 0x8344FC81, 0x99E92F76, 0xCA8F1B6A, 0x3CD4A952, 0xDCB97FC1,
+      0x87B67C3D, 0x160A4B4E, 0x408C6130, 0x42443F4B, 0x12C01D14, 0x0A190512, 0xFF5D737B, 0x2EFBD169 },
+    { 0x16F41F0A, 0x355569BA, 0xA5850C70, 0x4D1EBB05, 0x57E55D8A, 0x5A957698, 0x1CE7D833, 0x2543E5F8,
+      0x0596238C, 0x50E913A0, 0x2FBFC3DD, 0xEF0E4031, 0x573634AD, 0xC23EB566, 0x173C881F, 0x9AF00533 },
+    { 0x74B45960, 0xE0B3A843, 0x723DF5A8, 0x76671C46, 0xC61CA37F, 0xD2429517, 0xBB68BE24, 0xE5E08B13,
+      0x6990CFC6, 0x1CAF639C, 0xAABACFF0, 0xF150B8E7, 0x19A76C68, 0xE2EC209E, 0x392329A9, 0xEAE00D38 },
+    { 0x78E4E9DA, 0xF4AC2E21, 0xD33DC867, 0x37B8D870, 0x39BA6EA9, 0xB70813E4, 0x7D0C0BAC, 0x3D56CE04,
+      0x6E005F31, 0x1A7205C7, 0x0BBF0EFA, 0x0B5B1892, 0x79D928AB, 0x8AB4D9BB, 0x2CB116D6, 0x42509897 },
+    { 0xCC2A56D6, 0x8C30941C, 0x004C17BA, 0xA0EC8285, 0xA704D6D1, 0xB54F07C0, 0x14FE9BF7, 0x402D950E,
+      0xFFD37A94, 0x78296EC7, 0xB7A03AC1, 0xBE3298E1, 0x07122852, 0x72BBC0EF, 0xA04E067C, 0x92EAE98F },
+    { 0xFACFBA20, 0xBD776166, 0x32B1F491, 0xBDA94162, 0x7909D66D, 0x25D8A1A1, 0x2192F380, 0x8FD85DD8,
+      0x1275D68D, 0x0BF5973B, 0x7B5B9AB6, 0xCA56C719, 0xCB3FB9E9, 0x144CB34F, 0xAFB2FFF6, 0x90E00591 },
+    { 0xBE58AD71, 0x8F763889, 0xCF9A3A20, 0xBB30D1F5, 0x29DE8C38, 0x0A05FE96, 0x28DEC3E3, 0x7778A78C,
+      0xFD9F43AC, 0x3B513FC1, 0xFF24AC56, 0x87B38411, 0xF2FF5800, 0xF7098E12, 0xB5A5B22F, 0x34626D9A },
+    { 0x48ED1367, 0x92B072DD, 0x3D031297, 0x9C02CEDD, 0xB38E947E, 0xFDB0A5A0, 0xA82F6607, 0x0D207580,
+      0xF693D28E, 0x97607326, 0x73D7045F, 0x4BF8E9D4, 0x7806A821, 0x249D105E, 0x9F2E5AE6, 0x7F6F578E },
+    { 0xB15CB0A8, 0xE1C74ACA, 0x59AF20F2, 0x557E6C70, 0x33DD830D, 0x02CEAD82, 0xF4BAAF3F, 0x42A4634A,
+      0xE0DA513C, 0xB2F7CCF5, 0x638FC0A9, 0xF4FA5D59, 0xA39F43CE, 0x8CDC23A3, 0x811E89B0, 0xB239264B },
+    { 0x48E82495, 0xB30F1951, 0x980ADE7A, 0x0F7F6787, 0x8F7226B5, 0xED1ED050, 0xFA8C13A7, 0xC1964E0E,
+      0xDDAB5F2C, 0x248B057C, 0x5EE35B01, 0x74D4E362, 0x3B8E224C, 0x9B019BBF, 0x01C21FFE, 0x9BC30516 },
+    { 0x1D66E242, 0xAAA02855, 0xE3E64E20, 0xD114895E, 0x981FF163, 0xA4E1409D, 0x59373163, 0x7C636CDC,
+      0xBDA86BE3, 0x22E7130E, 0xE9C411DC, 0x772062DE, 0xFD6A1C16, 0x3BE6C1EF, 0x952CC272, 0x7274A8E2 },
+    { 0x1B2AEA68, 0xF9668526, 0x3FADA381, 0x6FACBC2B, 0x23CD513E, 0xCE134BEF, 0xFA35CA7B, 0xC7ABFC5C,
+      0x92658C1C, 0xA1B5ABD1, 0xD19D0EB0, 0xBC85B730, 0x29A3CCC5, 0xCFC5FBA0, 0x38F755D9, 0x8758B7F1 },
+    { 0xEB777697, 0x6EB52DD9, 0x55333C65, 0x8E30CA87, 0xBD496935, 0x2EC4ADAC, 0x5138C61F, 0x0278107B,
+      0x00FC31A9, 0x809BD735, 0x907F17BA, 0xD450E064, 0x0927F99F, 0xB4E62680, 0x280282A7, 0xB5FE260E },
+    { 0x957B0A0D, 0x30663648, 0xF7643745, 0xF0D9B655, 0x46614891, 0x2A0B0C46, 0x2C4E3F25, 0x40E94E24,
+      0xA60E3E05, 0x8D58F6F5, 0xE5A1D66C, 0x6D731D6F, 0xBD3E84DF, 0xECE08E1D, 0xAB745C23, 0x169EE313 },
+    { 0x15544867, 0x4005DEF4, 0x4403863C, 0x41133D51, 0xB15F58E4, 0xC0E4FBDC, 0x3D958A99, 0x5E67D697,
+      0xDE26E2CF, 0x410A4E8E, 0x82703792, 0x292DFF5F, 0xD4843BA9, 0xE043D144, 0xA61301E9, 0x1D22C149 },
+    { 0x35D63671, 0x87FA81C7, 0xF2EB49A9, 0x64885362, 0x3D7EB3C1, 0xF5EB487F, 0x457B84DF, 0xF1A5EAE5,
+      0xAF57DCA7, 0x1F664B95, 0x1B62AFC2, 0xA394CE9C, 0xA22C8191, 0x9A8940FE, 0xCB8CB5B4, 0x0AEBC938 },
+    { 0xBB8C8298, 0xDA173E1E, 0xAC647203, 0xE4573E3A, 0xAC6E28C8, 0x2BD53450, 0x7601BA84, 0xFA7EA771,
+      0xD1F4270C, 0xFD9D7678, 0x063FA89B, 0x432BED96, 0xEB2B23AE, 0xD71AF888, 0xC620FD3E, 0xDB11B810 },
+    { 0x0153A230, 0x76205B8F, 0x20DD1A21, 0xE7B7F86F, 0x83C0C37E, 0xD3AE5D6D, 0x32C2827D, 0x5C1048A5,
+      0xBC73A533, 0x2CF3D4D1, 0x98A8B3AD, 0x91FFB641, 0x0F3E2AD0, 0xBF2469C7, 0x2680C891, 0x6859FC33 },
+    { 0x34087A25, 0xE19A13E9, 0x1EC217E7, 0x6E48000D, 0x7AF20404, 0x30646A48, 0xDBD1BC55, 0xD43E05CD,
+      0x86E439BC, 0x70FEFAB9, 0x1320DC1C, 0x67F66A71, 0x2483C19F, 0xD0B7B242, 0x58089217, 0x0AEE0025 },
+    { 0x710F1026, 0xDDC3C419, 0xCA267C4A, 0x946F2362, 0xA753C190, 0x0604B808, 0xFECEE2E7, 0x0A34BB13,
+      0x837B4596, 0xBC660551, 0x0EE17558, 0xD9411CFE, 0xC15F0F55, 0x0C1EAF02, 0xE08A903C, 0x1D69732C },
+    { 0xE954D499, 0x18DC08E5, 0x3B5FC120, 0x1AD0C60F, 0xF97CF585, 0x387E34D2, 0xA6E09AB5, 0xDDB618EB,
+      0x0ACB5DD3, 0xEB60973F, 0xD770812B, 0x54ABB29E, 0x7192DB95, 0x8C2095C6, 0x6D221978, 0x7459F30C },
+    { 0x48506A70, 0x4B215FCF, 0xE7271FAC, 0x8758BF9A, 0xC0CABB2B, 0xAD70FBA2, 0x1D06F3FE, 0x0E7AC39F,
+      0x100AE7A9, 0x1455FA0E, 0x763C7A81, 0x93464741, 0xEDCD7892, 0x2D0AC5EA, 0x94C7A28D, 0x25717899 },
+    { 0xB26B64F1, 0x5CF39944, 0xF5476D99, 0xB7EDCF28, 0x2511E59D, 0xD4CDA4C6, 0x1B58F010, 0x7175407F,
+      0xB24234D5, 0x426E7EFA, 0x74471D2A, 0xB01FE8B7, 0x134CC86E, 0xF36D3401, 0x44E3D550, 0x43B45543 },
+    { 0x700952EF, 0xAEF3DDCC, 0x53CA9141, 0x3297F9BD, 0x553AEADA, 0x2DD28FD1, 0xB0CCD48E, 0x1CC817B6,
+      0x127F538E, 0x26B1DD83, 0x783D6A22, 0xCBE309DD, 0x75033D5A, 0xE444283C, 0xDA85C29C, 0x1E3E58C7 },
+    { 0xD7721115, 0x5884159B, 0xB8E16DC1, 0xB3664810, 0x6135A62F, 0xFA819D53, 0x217DDB87, 0x60CAC14D,
+      0xFB69E482, 0x4B5E3471, 0xD20BCAD2, 0x5D330D63, 0x6976F1D0, 0x455EE5D2, 0x4E25E444, 0xC2FEB935 },
+    { 0x959BACAD, 0x53D48500, 0x602A2A3D, 0x339B127A, 0xE641CB81, 0x1448BEF4, 0x7E0DAE3E, 0xEFA53F42,
+      0xCA6AFD2A, 0xCFA2A15E, 0x891F9E25, 0x25D7C847, 0xDD949DF7, 0x07A27E70, 0xA2BB65C7, 0x6F5BBAE1 },
+    { 0x3DCBE5DD, 0x7CA3DEEA, 0xD03EB4FB, 0xACE67DB5, 0xBE39C4D5, 0x1CC96933, 0x7A56A16D, 0xE10E89B8,
+      0x3D1806CD, 0xB99D5043, 0xE1466A33, 0xE8319AC5, 0x651B1E7A, 0xAE56FA13, 0x4498CB19, 0x8E4CD19D },
+    { 0x122F0F71, 0x4F085199, 0x564B3619, 0x98BFF21D, 0xEA1344F7, 0x3C554918, 0xC729F953, 0x80F118A6,
+      0x1F1A9CA2, 0x26207C60, 0x04B6563D, 0x2B6624A1, 0x9DDE7FED, 0x92AF032F, 0x7756AF48, 0x43C9408C },
+    { 0x76A4596C, 0xE43FD414, 0x74F4FBE9, 0xD07984ED, 0x1A03D271, 0xE10744CC, 0x1FA88C85, 0x3FA3A959,
+      0x4A7B42A2, 0x0D42F716, 0x30883954, 0xEB89FCA4, 0x3A788F67, 0xB1EB18B2, 0xBC60F121, 0x7D47DA22 },
+    { 0x5FF781ED, 0x5408C204, 0x7687900E, 0x670205A7, 0x117953B2, 0x44F2847C, 0x9789510C, 0x38C5897A,
+      0xFD6F3968, 0x9FE387C9, 0x1CAEFD1B, 0xFFEB4826, 0x23CA7311, 0x1B4D3164, 0x6DFB3C09, 0x947858D5 },
+    { 0x0CC1B9ED, 0xCFB4A087, 0x6B53BEB2, 0xA9DEE862, 0xD51620BC, 0x0BD8E3AE, 0x0980E5F2, 0x6E7F11C8,
+      0x07EE8B3E, 0x28C8A205, 0x7C8E24B9, 0xD05F9AE5, 0xB355F0D8, 0xDED3A615, 0x3B8ACA26, 0x1498B6F1 },
+    { 0xFBADAF91, 0xE6A6D143, 0x39E47148, 0xE45AF203, 0xD04B9C13, 0x9BC61B74, 0xD26EAEF4, 0x2F92485F,
+      0x192D8926, 0x0B6A3795, 0x4A7699FA, 0x126B5CAD, 0x7FC6F4BA, 0x1A176233, 0xF3824CA8, 0x20070B88 },
+    { 0xDFBB68A2, 0xB79B5ECF, 0x4F279BBD, 0xF6DE05E9, 0x7A39847D, 0xB906D78D, 0x79B928BF, 0x197AC92F,
+      0x08912F0E, 0x6B38627A, 0xF2096E06, 0x66DA353B, 0x80F7FB94, 0xDF136FF1, 0xBDFBA5DC, 0xAC2B3FFE },
+    { 0x99B8A0BA, 0x5C8E2B6C, 0x776EAFC2, 0xD2CBAABB, 0xBC6BC541, 0x1D2024C2, 0x90D0DC18, 0x75B0FD5A,
+      0x609CE2EC, 0xC09EF18E, 0x4031D2F6, 0xFBB2E1EB, 0xFCF1F434, 0xE59D734C, 0x58BF2658, 0x3CF9A44B },
+    { 0xEEBF6BB7, 0x7FA42090, 0x3E8565B4, 0xAE040881, 0xAE51BF84, 0x09284CF6, 0xE0A29511, 0x27B2B3A4,
+      0x1397EC0A, 0xC88B67E5, 0x1B219C9B, 0x7ABE3DB7, 0xE3BCDB3A, 0xAE64B66D, 0x6942800C, 0x800E23B4 },
+    { 0xAEB002A6, 0x2CD59C9D, 0x8E32D04A, 0x5C2C98DB, 0xEDF6AA05, 0xA7909E91, 0x457716DC, 0x802DDDC6,
+      0x20A34D02, 0xC1BB3AEB, 0xC7FD6C58, 0x9920E08A, 0xD91BE4A0, 0xE4424FEA, 0xDB848E62, 0xD46B7E27 },
+    { 0x3C1DBE36, 0xFBC5E2C6, 0x499A8C7D, 0x4E4390F2, 0x7EF771B4, 0x09B89E98, 0x4D2DF8FA, 0x03179E31,
+      0x48B5AD2B, 0x71871ABE, 0x01CBB15E, 0x2276676F, 0x43935012, 0x0FBE6332, 0xB73F95CB, 0xFA461B20 },
+    { 0xC9D36995, 0x24CDCC14, 0x3B97B6E6, 0xC382A77A, 0xBCCDEFB3, 0x85A6D079, 0x693867E2, 0x7AA61648,
+      0xAD4E9E90, 0x6FA33DC1, 0x0C210B89, 0x9715B243, 0x99991D1C, 0x6B1D7AEE, 0x56C3B7D6, 0x215EA706 },
+    { 0x5AE60BA3, 0xBE35D078, 0x5368C6D6, 0x2717BD73, 0x1D660217, 0x20FAEBC1, 0x4EA4C464, 0x91B44ADB,
+      0x5EB7D71B, 0xFF0217DD, 0xCBACDB25, 0x64864F81, 0x79DB1649, 0xFA5643D7, 0xC58A4774, 0xF9A2A68C },
+    { 0x5D76033D, 0x315B0D5D, 0x39A2A2E7, 0x1725522C, 0x1270C1DD, 0x8E139689, 0x77E65BB1, 0x97CF990E,
+      0x64D34089, 0xAB150E3C, 0x0A79CD92, 0xA427E24A, 0x6EB4024E, 0x66A8943C, 0xF39BF3B1, 0x0C6F126A },
+    { 0x8AA5CD34, 0x2492273C, 0xAEB1ED2F, 0x1C796C26, 0x49711F57, 0xE6E60B49, 0x65551826, 0x10B21046,
+      0x0C680613, 0xAF42A154, 0x0FC8D939, 0x6F5B700C, 0x7F0A41DC, 0xB14F59A2, 0x092D9BE4, 0xF5498B37 },
+    { 0x1499350D, 0x19756A7C, 0x476127B0, 0x0CE33AC1, 0x2BEC1059, 0xDDBD9023, 0xF5CCE58D, 0x6FCA2FE6,
+      0x01E0F19F, 0xE0F0F83A, 0x3A3B24B1, 0x903CC85A, 0xF79BB62B, 0xD1F61B64, 0x7B2DADF7, 0x81BF2264 },
+    { 0xACE757FE, 0x28C79F0A, 0x2DCA79EF, 0x75191457, 0x14761633, 0xD1A6BBBE, 0x4571386B, 0x17B832E4,
+      0xCB5B0597, 0xF0A6CF26, 0xAC3971A5, 0x92CF246A, 0xC73C3D28, 0x4E6675C1, 0x44C5FCC9, 0x5A7AB536 },
+    { 0x607E5BA7, 0x40B90860, 0xF5C5549B, 0x1AA584BF, 0xE962D92C, 0x57F76E5C, 0x2B4E9144, 0x60D45EFB,
+      0x0417E3D3, 0xAC84AF0E, 0x0FAE5B6C, 0x248E3DAD, 0xE9A1346E, 0x26EE0961, 0x8BA9086C, 0xCAAD90BE },
+    { 0x404F423D, 0x8AD7D399, 0x4AB8A5F7, 0x59558598, 0x276EF53C, 0xF714D3FA, 0xE3B32A5B, 0x71C441D7,
+      0x07388EB8, 0x495BD4C1, 0xC62BCB6D, 0x164EB4D7, 0x66BB2CDA, 0x5140B981, 0xE309896C, 0xF642D5AF },
+    { 0x40AEEEC1, 0xA1A6B0CE, 0x8252ED26, 0x861B5597, 0x78EFF849, 0x6C5F6DE2, 0x18BDAEA0, 0xB0FB446D,
+      0xCC52CB4B, 0xDD4C2E4E, 0xA94F9A62, 0x614F658C, 0x734823C2, 0x4A02453E, 0xCB570754, 0x44573F4F },
+    { 0x9D2B66F6, 0x0847B97E, 0xAE0E537A, 0xFD9A06EC, 0xE4121630, 0xFB8AF82A, 0xE6D8F9A2, 0x2B5A3487,
+      0x07FD388F, 0x8BB94C3A, 0xB8A94CB3, 0x55C3D037, 0xFAACA627, 0x53602650, 0x8E0F3281, 0x5BEA4F2E },
+    { 0x716E7B6C, 0x792EA92C, 0xB2C822FF, 0x91A2D0AA, 0x45E2A74B, 0x39AF1271, 0x05C8F5F6, 0xADC613FF,
+      0xFB00CBF4, 0xE9D9793E, 0x71B4D7A7, 0x31B7A7CC, 0xE38703C1, 0xB5254C04, 0xF22280E9, 0xC97F9A92 },
+    { 0x6F67A7FA, 0xBCEE76E7, 0x93B18760, 0x9ED7EBA3, 0xA69403A8, 0x2D464F09, 0xD03C30CE, 0xE0F4E23F,
+      0x92CD776F, 0x43938577, 0x6D650A84, 0xBAF51315, 0x561B50EB, 0xF7AA6C27, 0x368A21BE, 0xF4281BF2 },
+    { 0x93605259, 0x886E0C32, 0x8D59B90B, 0x78DF128A, 0x40223094, 0x93EBA202, 0x067BEF7F, 0x37AC7F14,
+      0xDA29E74A, 0x83BBBB5D, 0xA76E9B01, 0x5F455F8F, 0xB5ECB4C4, 0x58BA3533, 0x57C1C6BD, 0x288E321F },
+    { 0x59F54695, 0x1A6D4CB9, 0xA333FEEC, 0x2332BDB7, 0x872C146A, 0x7FC5F4D0, 0xCAF7A4CC, 0x2B3FEFC1,
+      0x709FAF11, 0x15D04F75, 0xF8978B40, 0xEAF837AC, 0x59909228, 0x28B64297, 0x24602FD5, 0x92E6323D },
+    { 0x95DA59E5, 0x8671B790, 0x0A748575, 0x7AA04FF6, 0xD5D6A26E, 0xC9B59947, 0x3B895A3E, 0x9E7DEE38,
+      0x53EE485B, 0x3E0FBA1A, 0x026CA84F, 0x354A1921, 0x0AC7CC2F, 0xDD1AB3C3, 0x780722A4, 0x49831BFA },
+    { 0x3CD79F44, 0xF8D19D14, 0x59D0BD87, 0x7BC9F6BE, 0x31E36C60, 0xFAAD3077, 0x90C75AB2, 0x1C1E6283,
+      0x3714FF9F, 0xBBA3BA1E, 0x27969B07, 0x1E7BB20B, 0x4D391133, 0x523B1791, 0x9C57B316, 0xA7F4D242 },
+    { 0x1F530FEE, 0x93CCAD49, 0xFB3B1B98, 0x5AE91D7F, 0xBA91BF45, 0x142893FD, 0x570FBA39, 0x25898AD2,
+      0x1B7180E3, 0x0BAA5982, 0xC7C54C52, 0x8A89E34C, 0xF28203DB, 0xC9D4AAD1, 0xB0267681, 0x2188B6D4 },
+};
+
+#endif // MINT_SECP256K1_TABLE_H
@@ -1,4 +1,7 @@
 #include "mint_secure.h"
+#include "mint_hash.h"
+#include "mint_trace.h"
+#include "mint_log.h"
 #include <string.h>
 
 // OTP memory locations in SE050
@@ -7,188 +10,891 @@
 // Key identifiers in SE050
 #define MASTER_KEY_ID 0x10000001
 #define DERIVE_TEMP_ID 0x10000002
+#define CHAIN_CODE_ID 0x10000003
 
-MintSecure::MintSecure() : 
+// Domain separation for the chain code, hashed together with the seed
+static const char CHAIN_CODE_TAG[] = "Mint chain code";
+
+// I2C clocks tried in order until the SE050 answers
+// Fast-mode Plus needs strong pull-ups, so fall back if the bus can't keep up
+static const uint32_t SE050_BUS_CLOCKS[] = {
+    1000000, // Fast-mode Plus
+    400000,  // Fast-mode
+    100000   // Standard mode
+};
+
+// Wallet generation job steps, one SE050 command each. The chain code
+// is stored before the key is created, so no key exists without one.
+#define JOB_STEP_HASH 0
+#define JOB_STEP_CHAIN_CODE 1
+#define JOB_STEP_DELETE_OLD 2
+#define JOB_STEP_STORE_CHAIN_CODE 3
+#define JOB_STEP_CREATE_KEY 4
+#define JOB_STEP_READ_PUBKEY 5
+#define JOB_STEP_COUNT 6
+
+// What the job slot is running
+#define JOB_KIND_WALLET 0
+#define JOB_KIND_PROOF 1   // One step per challenge signature
+
+// Ownership proof message: Bitcoin signed-message framing around a fixed
+// prefix and the challenge in hex
+static const char PROOF_MAGIC_PREFIX[] = "\x18" "Bitcoin Signed Message:\n";
+static const char PROOF_MESSAGE_PREFIX[] = "MINT OWNERSHIP PROOF ";
+
+// Record an SE050 result in the I/O trace and pass it through.
+// Only public response data may be given here, never secrets.
+static inline bool traced(uint8_t op, bool ok, const uint8_t* data = nullptr, size_t length = 0) {
+    MINT_TRACE(TRACE_EVENT_SE050, MINT_TRACE_SE050_ARG(op, ok), data, ok ? length : 0);
+    return ok;
+}
+
+// Typical execution time of each MintTraceSE050Op on the SE050, bus time
+// excluded; a call's deadline is MINT_SE050_DEADLINE_FACTOR times this
+// plus its bus time
+static const uint32_t SE050_TYPICAL_US[] = {
+    0,
+    18000,  // BEGIN
+    1400,   // RANDOM (32 bytes)
+    2500,   // SHA256
+    1800,   // OBJECT_EXISTS
+    9500,   // DELETE
+    62000,  // CREATE_KEY
+    2600,   // PUBLIC_KEY
+    2600,   // PRIVATE_KEY
+    2100,   // READ_MEMORY
+    14000,  // WRITE_OTP
+    2200,   // READ_OBJECT
+    7500,   // WRITE_OBJECT
+    48000   // SIGN
+};
+
+// T=1oI2C framing bytes per command, both directions
+#define SE050_FRAME_BYTES 24
+
+// An attempt that has not answered in this multiple of the typical time
+// is hung; the rest of the deadline goes to a retry
+#define ATTEMPT_TIMEOUT_FACTOR 2
+
+// Retry budget in half retries
+#define RETRY_COST 2
+#define RETRY_TOKENS (MINT_SE050_RETRY_BUDGET * RETRY_COST)
+
+template <class Element, class Circuit>
+MintSecureT<Element, Circuit>::MintSecureT() : 
+    circuit(nullptr),
     wallet_generated(false), 
     tampered_state(false),
     master_key_id(MASTER_KEY_ID),
-    otp_tamper_id(OTP_TAMPER_LOCATION) {
+    chain_code_id(CHAIN_CODE_ID),
+    otp_tamper_id(OTP_TAMPER_LOCATION),
+    bus_clock_hz(0),
+    retry_tokens(RETRY_TOKENS),
+    consecutive_failures(0),
+    breaker_open(false),
+    breaker_probe_us(0),
+    breaker_cooldown_us(MINT_SE050_BREAKER_COOLDOWN_US),
+    job_status(JOB_IDLE),
+    job_step(0),
+    job_entropy_len(0),
+    job_kind(JOB_KIND_WALLET),
+    job_proof_count(0),
+    branch_valid(false),
+    branch_index(0) {
+    memset(&snapshot, 0, sizeof(snapshot));
+    memset(&transport_stats, 0, sizeof(transport_stats));
+    memset(&call_stats, 0, sizeof(call_stats));
+    memset(job_entropy, 0, sizeof(job_entropy));
+    memset(job_seed, 0, sizeof(job_seed));
+    memset(job_chain_code, 0, sizeof(job_chain_code));
+    memset(job_digests, 0, sizeof(job_digests));
+    memset(job_signatures, 0, sizeof(job_signatures));
+    memset(&branch_key, 0, sizeof(branch_key));
+}
+
+void MintSecureTypes::proofDigest(const uint8_t* challenge, uint8_t* digest) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    const size_t prefix_len = sizeof(PROOF_MESSAGE_PREFIX) - 1;
+    char message[sizeof(PROOF_MESSAGE_PREFIX) - 1 + 2 * MINT_PROOF_CHALLENGE_SIZE];
+    memcpy(message, PROOF_MESSAGE_PREFIX, prefix_len);
+    for (size_t i = 0; i < MINT_PROOF_CHALLENGE_SIZE; i++) {
+        message[prefix_len + 2 * i] = HEX_DIGITS[challenge[i] >> 4];
+        message[prefix_len + 2 * i + 1] = HEX_DIGITS[challenge[i] & 0x0F];
+    }
+    
+    // Message length as a one-byte compact size (below 0xFD)
+    const uint8_t message_len = sizeof(message);
+    MintHash::SHA256Context ctx;
+    MintHash::sha256Init(ctx);
+    MintHash::sha256Update(ctx, (const uint8_t*)PROOF_MAGIC_PREFIX, sizeof(PROOF_MAGIC_PREFIX) - 1);
+    MintHash::sha256Update(ctx, &message_len, 1);
+    MintHash::sha256Update(ctx, (const uint8_t*)message, sizeof(message));
+    MintHash::sha256Final(ctx, digest);
+    MintHash::sha256(digest, 32, digest);
+}
+
+template <class Element, class Circuit>
+template <typename Command>
+bool MintSecureT<Element, Circuit>::call(uint8_t op, size_t payload, Command command,
+                                         const uint8_t* data, size_t length) {
+    return transact(op, payload, command, data, length, false) == QUERY_YES;
+}
+
+template <class Element, class Circuit>
+template <typename Command>
+MintSecureTypes::QueryResult MintSecureT<Element, Circuit>::query(uint8_t op, size_t payload,
+                                                                  Command command,
+                                                                  const uint8_t* data,
+                                                                  size_t length) {
+    const QueryResult answer = transact(op, payload, command, data, length, true);
+    if (answer != QUERY_NO) {
+        return answer;
+    }
+    
+    // A NACK reads as "no" too: the answer stands if the bus takes the
+    // next command
+    uint8_t sample[1];
+    const bool answered = call(TRACE_SE050_RANDOM, sizeof(sample), [&]() {
+        return se050.getRandomBytes(sample, sizeof(sample));
+    });
+    sample[0] = 0;
+    return answered ? QUERY_NO : QUERY_UNKNOWN;
+}
+
+template <class Element, class Circuit>
+template <typename Command>
+MintSecureTypes::QueryResult MintSecureT<Element, Circuit>::transact(uint8_t op, size_t payload,
+                                                                     Command command,
+                                                                     const uint8_t* data,
+                                                                     size_t length, bool query) {
+    const unsigned long start_us = micros();
+    call_stats.calls++;
+    
+    // An open breaker refuses calls without touching the bus until its
+    // cooldown has passed; the first call after that is a single probe
+    if (breaker_open && (long)(start_us - breaker_probe_us) < 0) {
+        call_stats.rejected++;
+        return QUERY_UNKNOWN;
+    }
+    const bool probing = breaker_open;
+    
+    const uint32_t clock_hz = bus_clock_hz ? bus_clock_hz : Wire.getClock();
+    const uint32_t bus_us = (uint32_t)((uint64_t)(payload + SE050_FRAME_BYTES) * 9 * 1000000 /
+                                       (clock_hz ? clock_hz : 100000));
+    const uint32_t typical_us = SE050_TYPICAL_US[op] + bus_us;
+    const uint32_t deadline_us = MINT_SE050_DEADLINE_FACTOR * typical_us;
+    // No command acts twice: a create or delete whose answer was lost
+    // makes its retries fail on the object it already created or
+    // removed, and the job step re-reads whether the key exists
+    const uint8_t attempts = probing ? 1 : MINT_SE050_MAX_ATTEMPTS;
+    
+    uint32_t backoff_us = MINT_SE050_BACKOFF_US;
+    bool ok = false;
+    bool answered = false;
+    for (uint8_t attempt = 1; ; attempt++) {
+        // A hung transfer gives up in time for a retry, or at the deadline
+        const uint32_t remaining_us = min(deadline_us - (uint32_t)(micros() - start_us),
+                                          ATTEMPT_TIMEOUT_FACTOR * typical_us);
+        Wire.setTimeout((remaining_us + 999) / 1000);
+        
+        const unsigned long attempt_us = micros();
+        call_stats.commands++;
+        call_stats.bytes += payload;
+        ok = traced(op, command(), data, length);
+        if (ok) {
+            break;
+        }
+        if ((uint32_t)(micros() - attempt_us) >= remaining_us) {
+            call_stats.timeouts++;
+        } else {
+            answered = true;
+        }
+        
+        // Retry only if another typical attempt still fits the deadline
+        // and the budget has a retry left
+        const uint32_t spent_us = micros() - start_us;
+        if (attempt >= attempts || retry_tokens < RETRY_COST ||
+            spent_us + backoff_us + typical_us > deadline_us) {
+            break;
+        }
+        retry_tokens -= RETRY_COST;
+        call_stats.retries++;
+        delayMicroseconds(backoff_us);
+        backoff_us *= 2;
+    }
+    call_stats.max_call_us = max(call_stats.max_call_us, (uint32_t)(micros() - start_us));
+    
+    if (ok) {
+        consecutive_failures = 0;
+        retry_tokens = min(retry_tokens + 1, RETRY_TOKENS);
+        if (breaker_open) {
+            breaker_open = false;
+            breaker_cooldown_us = MINT_SE050_BREAKER_COOLDOWN_US;
+            MINT_LOG("SE050 breaker closed");
+        }
+        return QUERY_YES;
+    }
+    
+    // A query's "no" may be an answer if any attempt got one back rather
+    // than hanging
+    if (query && answered) {
+        return QUERY_NO;
+    }
+    
+    call_stats.failures++;
+    if (probing) {
+        // Still down: wait longer before the next probe
+        breaker_cooldown_us = min(breaker_cooldown_us * 2, (uint32_t)MINT_SE050_BREAKER_MAX_COOLDOWN_US);
+        breaker_probe_us = micros() + breaker_cooldown_us;
+    } else if (++consecutive_failures >= MINT_SE050_BREAKER_THRESHOLD) {
+        breaker_open = true;
+        breaker_probe_us = micros() + breaker_cooldown_us;
+        call_stats.breaker_trips++;
+        MINT_LOG("SE050 breaker open after %u failed calls", consecutive_failures);
+    }
+    return QUERY_UNKNOWN;
 }
 
-bool MintSecure::begin() {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::begin() {
     // Initialize I2C for SE050 communication
     Wire.begin();
     
-    // Initialize SE050
-    if (!se050.begin()) {
+    // Initialize SE050 at the fastest bus clock it answers on
+    if (!negotiateBusClock()) {
         return false;
     }
     
-    // Read the current tamper state from OTP memory
-    tampered_state = readOTPState();
+    // Gather OTP state, key presence and public key in one pass
+    return takeBootSnapshot();
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::negotiateBusClock() {
+    const size_t clock_count = sizeof(SE050_BUS_CLOCKS) / sizeof(SE050_BUS_CLOCKS[0]);
+    
+    for (size_t i = 0; i < clock_count; i++) {
+        Wire.setClock(SE050_BUS_CLOCKS[i]);
+        if (call(TRACE_SE050_BEGIN, 16, [&]() { return se050.begin(); })) {
+            bus_clock_hz = SE050_BUS_CLOCKS[i];
+            MINT_LOG("SE050 up at %u Hz", bus_clock_hz);
+            return true;
+        }
+        
+        // A clock too fast for the bus says nothing about the part
+        consecutive_failures = 0;
+    }
+    
+    bus_clock_hz = 0;
+    MINT_LOG("SE050 not answering at any bus clock");
+    return false;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::takeBootSnapshot() {
+    memset(&snapshot, 0, sizeof(snapshot));
+    const uint32_t commands = call_stats.commands;
+    
+    // Read the current tamper state from OTP memory; if that fails the
+    // state stays unknown and the device degraded until a probe reads it
+    tampered_state = false;
+    refreshTamperState();
+    
+    // Reading the public key doubles as the existence check, which saves
+    // a separate objectExists() round trip on provisioned devices. Its
+    // "no" is not confirmed here: the key state read asks again.
+    if (transact(TRACE_SE050_PUBLIC_KEY, 4 + sizeof(snapshot.master_public_key), [&]() {
+            return se050.getECCPublicKey(master_key_id, snapshot.master_public_key,
+                                         sizeof(snapshot.master_public_key));
+        }, snapshot.master_public_key, sizeof(snapshot.master_public_key), true) == QUERY_YES) {
+        snapshot.master_key_present = true;
+        snapshot.public_key_valid = true;
+    }
     
-    // Check if we have a wallet already stored
-    wallet_generated = se050.objectExists(master_key_id);
+    // Chain code for MCU-side address derivation; a key whose presence
+    // or chain code is unknown leaves the SE050 degraded
+    refreshKeyState();
+    snapshot.apdu_count = (uint8_t)min(call_stats.commands - commands, (uint32_t)UINT8_MAX);
+    snapshot.valid = true;
+    MINT_LOG("SE050 boot: tampered %u, key %u, chain code %u", tampered_state,
+             snapshot.master_key_present, snapshot.chain_code_valid);
     
     return true;
 }
 
-bool MintSecure::generateEntropy(uint8_t* output, size_t length) {
+template <class Element, class Circuit>
+MintSecureTypes::QueryResult MintSecureT<Element, Circuit>::refreshKeyPresence() {
+    const QueryResult present = query(TRACE_SE050_OBJECT_EXISTS, 5, [&]() {
+        return se050.objectExists(master_key_id);
+    });
+    
+    // An unhealthy bus says nothing about the key: keep what is known,
+    // degraded until a probe asks again
+    if (present == QUERY_UNKNOWN) {
+        snapshot.key_read_ok = false;
+    } else {
+        snapshot.master_key_present = present == QUERY_YES;
+    }
+    return present;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::refreshKeyState() {
+    // A failed key read must not be mistaken for "no wallet", since that
+    // would allow the master key to be regenerated, so a key not seen is
+    // asked for explicitly. A key is only ever created after its chain
+    // code is stored, so one whose chain code does not read keeps the
+    // SE050 degraded until it does.
+    if (!snapshot.master_key_present && refreshKeyPresence() == QUERY_UNKNOWN) {
+        snapshot.key_read_ok = false;
+    } else {
+        snapshot.key_read_ok = !snapshot.master_key_present || readChainCode();
+    }
+    wallet_generated = snapshot.master_key_present;
+    return snapshot.key_read_ok;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::refreshPublicKey() {
+    snapshot.public_key_valid = call(TRACE_SE050_PUBLIC_KEY, 4 + sizeof(snapshot.master_public_key),
+                                     [&]() {
+        return se050.getECCPublicKey(master_key_id, snapshot.master_public_key,
+                                     sizeof(snapshot.master_public_key));
+    }, snapshot.master_public_key, sizeof(snapshot.master_public_key));
+    branch_valid = false;
+    return snapshot.public_key_valid;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::readChainCode() {
+    // The chain code is xpub material: kept out of the trace like key reads
+    snapshot.chain_code_valid = call(TRACE_SE050_READ_OBJECT, 4 + sizeof(snapshot.chain_code), [&]() {
+        return se050.readBinaryObject(chain_code_id, snapshot.chain_code,
+                                      sizeof(snapshot.chain_code));
+    });
+    branch_valid = false;
+    return snapshot.chain_code_valid;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::generateEntropy(uint8_t* output, size_t length) {
     // Generate random bytes from SE050 hardware TRNG
-    if (!se050.getRandomBytes(output, length)) {
+    if (!call(TRACE_SE050_RANDOM, length, [&]() { return se050.getRandomBytes(output, length); })) {
         return false;
     }
     
     // Perform NIST health tests on entropy
-    // This is a simplified placeholder - actual implementation would 
-    // include full NIST SP 800-90B tests
-    uint8_t ones = 0;
+    return entropyHealthCheck(output, length);
+}
+
+template <class Element, class Circuit>
+uint32_t MintSecureT<Element, Circuit>::countOnes(const uint8_t* data, size_t length) {
+    // Branch-free per-byte popcount, so the time taken doesn't depend on
+    // the TRNG output
+    uint32_t ones = 0;
     for (size_t i = 0; i < length; i++) {
-        uint8_t val = output[i];
-        while (val) {
-            ones += val & 1;
-            val >>= 1;
-        }
+        uint8_t val = data[i];
+        val = val - ((val >> 1) & 0x55);
+        val = (val & 0x33) + ((val >> 2) & 0x33);
+        ones += (val + (val >> 4)) & 0x0F;
     }
+    return ones;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::entropyHealthCheck(const uint8_t* data, size_t length) {
+    // This is a simplified placeholder - actual implementation would 
+    // include full NIST SP 800-90B tests
+    const uint32_t ones = countOnes(data, length);
     
-    // Simple frequency test - should be approximately 50% ones
-    float ones_ratio = (float)ones / (length * 8);
-    if (ones_ratio < 0.45 || ones_ratio > 0.55) {
+    // Simple frequency test - should be approximately 50% ones (45-55%)
+    const uint32_t bits = (uint32_t)length * 8;
+    if (ones * 20 < bits * 9 || ones * 20 > bits * 11) {
+        MINT_LOG("SE050 random bytes failed the frequency test");
         return false; // Failed health check
     }
     
     return true;
 }
 
-bool MintSecure::generateWalletFromEntropy(const uint8_t* entropy, size_t entropy_len) {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::generateWalletFromEntropy(const uint8_t* entropy, size_t entropy_len) {
+    // Run the split-phase job to completion
+    if (!startWalletGeneration(entropy, entropy_len)) {
+        return false;
+    }
+    
+    while (pollJob() == JOB_PENDING) {
+    }
+    
+    return completeJob() == JOB_DONE;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::startWalletGeneration(const uint8_t* entropy, size_t entropy_len) {
+    // Only one job can be in flight, and none while the SE050 is out or
+    // the tamper record unread
+    if (job_status == JOB_PENDING || !entropy || isDegraded()) {
+        return false;
+    }
+    
     // Validate entropy length (must be 16, 24, or 32 bytes for BIP39)
     if (entropy_len != 16 && entropy_len != 24 && entropy_len != 32) {
         return false;
     }
     
-    // Calculate SHA-256 of entropy to create seed
-    uint8_t seed[32];
-    if (!se050.calculateSHA256(entropy, entropy_len, seed)) {
+    memcpy(job_entropy, entropy, entropy_len);
+    job_entropy_len = entropy_len;
+    job_kind = JOB_KIND_WALLET;
+    job_proof_count = 0;
+    job_step = JOB_STEP_HASH;
+    job_status = JOB_PENDING;
+    
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::startOwnershipProof(const uint8_t* challenges, size_t count) {
+    if (job_status == JOB_PENDING || !challenges || count == 0 ||
+        count > MINT_PROOF_MAX_CHALLENGES) {
         return false;
     }
     
-    // Create master key from seed (inside SE050)
-    if (!createMasterKey(seed)) {
+    // A proof from an opened device proves nothing: its key is public
+    if (!wallet_generated || tampered_state || isDegraded() || !isCircuitIntact()) {
         return false;
     }
     
-    // Zero out sensitive data from stack
-    memset(seed, 0, sizeof(seed));
+    // Messages are public, so they are hashed on the MCU
+    memset(job_signatures, 0, sizeof(job_signatures));
+    for (size_t i = 0; i < count; i++) {
+        proofDigest(challenges + i * MINT_PROOF_CHALLENGE_SIZE, job_digests[i]);
+    }
+    job_proof_count = (uint8_t)count;
+    job_kind = JOB_KIND_PROOF;
+    job_step = 0;
+    job_status = JOB_PENDING;
     
-    wallet_generated = true;
     return true;
 }
 
-bool MintSecure::createMasterKey(const uint8_t* seed) {
-    // Delete existing key if present
-    if (se050.objectExists(master_key_id)) {
-        se050.deleteObject(master_key_id);
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::getOwnershipProof(uint8_t* signatures, size_t length,
+                                                      size_t& count) const {
+    // Signatures survive completeJob() until the next job starts
+    if (job_kind != JOB_KIND_PROOF || job_status == JOB_PENDING || !job_proof_count ||
+        !signatures || length < (size_t)job_proof_count * MINT_PROOF_SIGNATURE_SIZE) {
+        return false;
     }
     
-    // Create secp256k1 key pair using seed as input
-    return se050.createECKeyPair(master_key_id, SE05x_ECCurve_SECP256K1, seed, 32, true);
+    memcpy(signatures, job_signatures, (size_t)job_proof_count * MINT_PROOF_SIGNATURE_SIZE);
+    count = job_proof_count;
+    return true;
 }
 
-bool MintSecure::deriveAddress(const char* path, char* address, size_t address_len) {
-    if (!wallet_generated || !address || address_len < 42) {
-        return false;
+template <class Element, class Circuit>
+MintSecureTypes::JobStatus MintSecureT<Element, Circuit>::pollJob() {
+    if (job_status != JOB_PENDING) {
+        return job_status;
+    }
+    
+    unsigned long start_us = micros();
+    const uint32_t commands = call_stats.commands;
+    const uint32_t bytes = call_stats.bytes;
+    const bool proof = job_kind == JOB_KIND_PROOF;
+    bool ok = proof ? runProofStep() : runJobStep();
+    transport_stats.busy_us += micros() - start_us;
+    transport_stats.apdu_count += call_stats.commands - commands;
+    transport_stats.bytes_transferred += call_stats.bytes - bytes;
+    
+    if (!ok) {
+        MINT_LOG("SE050 job failed, kind %u step %u", job_kind, job_step);
+        finishJob(JOB_FAILED);
+    } else if (++job_step >= (proof ? job_proof_count : JOB_STEP_COUNT)) {
+        if (!proof) {
+            wallet_generated = true;
+        }
+        finishJob(JOB_DONE);
     }
     
-    // Parse derivation path
-    // In production, this would implement full BIP32 path parsing
-    // This is a simplified placeholder
-    uint32_t child_indices[5] = {0}; // m/a/b/c/d/e
-    size_t path_depth = 0;
+    return job_status;
+}
+
+template <class Element, class Circuit>
+MintSecureTypes::JobStatus MintSecureT<Element, Circuit>::completeJob() {
+    JobStatus status = job_status;
     
-    const char* ptr = path;
-    if (*ptr == 'm') ptr += 2; // Skip "m/"
+    // Keep a pending job; release a finished one
+    if (status != JOB_PENDING) {
+        job_status = JOB_IDLE;
+    }
     
-    while (*ptr && path_depth < 5) {
-        bool hardened = false;
-        uint32_t index = 0;
-        
-        // Parse number
-        while (*ptr >= '0' && *ptr <= '9') {
-            index = index * 10 + (*ptr - '0');
-            ptr++;
+    return status;
+}
+
+template <class Element, class Circuit>
+void MintSecureT<Element, Circuit>::cancelJob() {
+    finishJob(JOB_IDLE);
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::isBusy() const {
+    return job_status != JOB_IDLE;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::isDegraded() const {
+    return breaker_open || !snapshot.otp_read_ok || !snapshot.key_read_ok;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::probe() {
+    if (!snapshot.otp_read_ok) {
+        refreshTamperState();
+    } else if (!snapshot.key_read_ok) {
+        refreshKeyState();
+    } else if (breaker_open && (long)(micros() - breaker_probe_us) >= 0) {
+        // A random byte answers whatever the SE050 holds
+        uint8_t sample[1];
+        call(TRACE_SE050_RANDOM, sizeof(sample), [&]() {
+            return se050.getRandomBytes(sample, sizeof(sample));
+        });
+        sample[0] = 0;
+    }
+    return !isDegraded();
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::runJobStep() {
+    switch (job_step) {
+        case JOB_STEP_HASH:
+            // Calculate SHA-256 of entropy to create seed
+            if (!call(TRACE_SE050_SHA256, job_entropy_len + sizeof(job_seed), [&]() {
+                    return se050.calculateSHA256(job_entropy, job_entropy_len, job_seed);
+                })) {
+                return false;
+            }
+            memset(job_entropy, 0, sizeof(job_entropy));
+            return true;
+            
+        case JOB_STEP_CHAIN_CODE: {
+            // Chain code = SHA-256(seed || tag), computed before the seed is consumed
+            uint8_t tagged[sizeof(job_seed) + sizeof(CHAIN_CODE_TAG) - 1];
+            memcpy(tagged, job_seed, sizeof(job_seed));
+            memcpy(tagged + sizeof(job_seed), CHAIN_CODE_TAG, sizeof(CHAIN_CODE_TAG) - 1);
+            bool hashed = call(TRACE_SE050_SHA256, sizeof(tagged) + sizeof(job_chain_code), [&]() {
+                return se050.calculateSHA256(tagged, sizeof(tagged), job_chain_code);
+            });
+            
+            // Zero out sensitive data
+            memset(tagged, 0, sizeof(tagged));
+            return hashed;
         }
-        
-        // Check for hardened notation
-        if (*ptr == '\'') {
-            hardened = true;
-            index |= 0x80000000; // Hardened bit
-            ptr++;
+            
+        case JOB_STEP_DELETE_OLD:
+            // Delete the key whenever one exists: seen by the boot snapshot,
+            // or left by an earlier create whose answer was lost
+            if (!snapshot.master_key_present) {
+                return true;
+            }
+            snapshot.public_key_valid = false;
+            if (!call(TRACE_SE050_DELETE, sizeof(master_key_id), [&]() {
+                    return se050.deleteObject(master_key_id);
+                })) {
+                // A lost answer may still have deleted it; a key left in
+                // place would fail the create
+                return refreshKeyPresence() == QUERY_NO;
+            }
+            snapshot.master_key_present = false;
+            return true;
+            
+        case JOB_STEP_STORE_CHAIN_CODE:
+            // Binary objects are overwritten in place; one left by a
+            // generation that failed after this step belongs to no key
+            if (!call(TRACE_SE050_WRITE_OBJECT, sizeof(chain_code_id) + sizeof(job_chain_code), [&]() {
+                    return se050.writeBinaryObject(chain_code_id, job_chain_code,
+                                                   sizeof(job_chain_code));
+                })) {
+                return false;
+            }
+            memcpy(snapshot.chain_code, job_chain_code, sizeof(snapshot.chain_code));
+            snapshot.chain_code_valid = true;
+            branch_valid = false;
+            return true;
+            
+        case JOB_STEP_CREATE_KEY: {
+            // Create secp256k1 key pair using seed as input (inside SE050)
+            bool created = call(TRACE_SE050_CREATE_KEY, sizeof(master_key_id) + sizeof(job_seed),
+                                [&]() {
+                return se050.createECKeyPair(master_key_id, SE05x_ECCurve_SECP256K1,
+                                             job_seed, sizeof(job_seed), true);
+            });
+            
+            // Zero out sensitive data
+            memset(job_seed, 0, sizeof(job_seed));
+            
+            // A create whose answer was lost leaves a key from this seed
+            // behind; the job still fails, since the key cannot be told
+            // apart from an older one, and the next generation deletes it
+            if (created) {
+                snapshot.master_key_present = true;
+            } else {
+                refreshKeyPresence();
+            }
+            return created;
+        }
+            
+        case JOB_STEP_READ_PUBKEY:
+            // Keep the cached public key in step with the new key pair
+            return refreshPublicKey();
+            
+        default:
+            return false;
+    }
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::runProofStep() {
+    // The circuit may have broken since the job started
+    if (!isCircuitIntact()) {
+        return false;
+    }
+    
+    return call(TRACE_SE050_SIGN, sizeof(master_key_id) + sizeof(job_digests[0]) +
+                MINT_PROOF_SIGNATURE_SIZE, [&]() {
+        return se050.ecdsaSign(master_key_id, job_digests[job_step], sizeof(job_digests[0]),
+                               job_signatures[job_step], MINT_PROOF_SIGNATURE_SIZE);
+    }, job_signatures[job_step], MINT_PROOF_SIGNATURE_SIZE);
+}
+
+template <class Element, class Circuit>
+void MintSecureT<Element, Circuit>::finishJob(JobStatus status) {
+    // Never leave key material behind in the job slot
+    memset(job_entropy, 0, sizeof(job_entropy));
+    memset(job_seed, 0, sizeof(job_seed));
+    memset(job_chain_code, 0, sizeof(job_chain_code));
+    job_entropy_len = 0;
+    
+    // Only a complete proof is handed out
+    if (status != JOB_DONE) {
+        memset(job_signatures, 0, sizeof(job_signatures));
+        job_proof_count = 0;
+    }
+    job_status = status;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::sha256(const uint8_t* data, size_t length, uint8_t* digest) {
+    return call(TRACE_SE050_SHA256, length + 32, [&]() {
+        return se050.calculateSHA256(data, length, digest);
+    });
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::parseAccountPath(const char* path, uint32_t* indices, size_t& depth) {
+    uint32_t account[MINT_ACCOUNT_DEPTH];
+    size_t account_depth;
+    
+    if (!MintBIP32::parsePath(MINT_ACCOUNT_PATH, account, MINT_ACCOUNT_DEPTH, account_depth) ||
+        !MintBIP32::parsePath(path, indices, BIP32_MAX_DEPTH, depth)) {
+        return false;
+    }
+    
+    // The secure element holds the account key, so only paths below it
+    // can be served, and only through non-hardened steps
+    if (depth < MINT_ACCOUNT_DEPTH) {
+        return false;
+    }
+    for (size_t i = 0; i < depth; i++) {
+        bool hardened = (indices[i] & BIP32_HARDENED) != 0;
+        if (i < MINT_ACCOUNT_DEPTH ? indices[i] != account[i] : hardened) {
+            return false;
         }
-        
-        child_indices[path_depth++] = index;
-        
-        // Skip slash
-        if (*ptr == '/') ptr++;
     }
     
-    // In production, this would perform proper BIP32 key derivation
-    // within the secure element. For now, we'll generate a placeholder address.
-    uint8_t public_key[65];
-    if (!se050.getECCPublicKey(master_key_id, public_key, sizeof(public_key))) {
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::getAccountPublicKey(MintBIP32::ExtendedPublicKey& xpub) {
+    if (!wallet_generated) {
         return false;
     }
     
-    // Format as a simplified Bitcoin address
-    // In production, this would implement proper BIP32/BIP44 derivation and address formatting
-    snprintf(address, address_len, "bc1q%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", 
-             public_key[0], public_key[1], public_key[2], public_key[3], public_key[4],
-             public_key[5], public_key[6], public_key[7], public_key[8], public_key[9]);
+    // Normally served from the boot snapshot; only fetch on a miss
+    if (!snapshot.public_key_valid && !refreshPublicKey()) {
+        return false;
+    }
+    if (!snapshot.chain_code_valid && !readChainCode()) {
+        return false;
+    }
     
+    memcpy(xpub.public_key, snapshot.master_public_key, sizeof(xpub.public_key));
+    memcpy(xpub.chain_code, snapshot.chain_code, sizeof(xpub.chain_code));
     return true;
 }
 
-bool MintSecure::isCircuitIntact() {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::deriveAddress(const char* path, char* address, size_t address_len) {
+    if (!wallet_generated || !address || address_len < MINT_ADDRESS_BUFFER_SIZE) {
+        return false;
+    }
+    
+    uint32_t indices[BIP32_MAX_DEPTH];
+    size_t depth;
+    if (!parseAccountPath(path, indices, depth)) {
+        return false;
+    }
+    
+    MintBIP32::ExtendedPublicKey key;
+    size_t level = MINT_ACCOUNT_DEPTH;
+    
+    // Reuse the cached branch key for the common account/branch/index shape
+    if (depth == MINT_ACCOUNT_DEPTH + 2 && branch_valid &&
+        branch_index == indices[MINT_ACCOUNT_DEPTH]) {
+        key = branch_key;
+        level++;
+    } else if (!getAccountPublicKey(key)) {
+        return false;
+    }
+    
+    for (; level < depth; level++) {
+        if (!MintBIP32::deriveChildPublic(key, indices[level], key)) {
+            return false;
+        }
+        
+        if (level == MINT_ACCOUNT_DEPTH && depth == MINT_ACCOUNT_DEPTH + 2) {
+            branch_key = key;
+            branch_index = indices[level];
+            branch_valid = true;
+        }
+    }
+    
+    return MintBIP32::encodeP2WPKH(key.public_key, address, address_len);
+}
+
+template <class Element, class Circuit>
+void MintSecureT<Element, Circuit>::attachCircuit(const Circuit& monitor) {
+    circuit = &monitor;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::isCircuitIntact() {
+    // Prefer the filtered state so both sides agree on one decision
+    if (circuit) {
+        return circuit->isIntact();
+    }
+    
     // Read GPIO pin for tamper circuit
     // LOW = intact, HIGH = broken
     return digitalRead(CIRCUIT_PIN) == LOW;
 }
 
-bool MintSecure::recordPermanentTamperState() {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::recordPermanentTamperState() {
     // Only burn OTP if circuit actually broken and not already tampered
     if (isCircuitIntact() || tampered_state) {
         return false;
     }
     
-    // Burn OTP memory in SE050 - this is irreversible
-    if (!writeOTPState(true)) {
+    // Burn OTP memory in SE050 - this is irreversible. A write whose
+    // answer was lost makes every later one fail on the burned byte, so
+    // read the record back before trying again.
+    if (!writeOTPState(true) && !(refreshTamperState() && tampered_state)) {
+        MINT_LOG("tamper OTP write failed");
         return false;
     }
     
     tampered_state = true;
+    MINT_LOG("tamper recorded in OTP");
     return true;
 }
 
-bool MintSecure::readOTPState() {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::refreshTamperState() {
+    bool tampered = false;
+    snapshot.otp_read_ok = readOTPRecord(tampered);
+    if (!snapshot.otp_read_ok) {
+        // Not "intact": an unread record keeps the device degraded
+        MINT_LOG("tamper OTP read failed, state unknown");
+        return false;
+    }
+    
+    // The record is write-once, so a read never clears a known tamper
+    tampered_state = tampered_state || tampered;
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::readOTPRecord(bool& tampered) {
     uint8_t otp_data[1] = {0xFF};
     
     // Read OTP data from SE050
-    if (!se050.readMemory(otp_tamper_id, otp_data, sizeof(otp_data))) {
-        // If read fails, assume not tampered for safety
+    if (!call(TRACE_SE050_READ_MEMORY, 4 + sizeof(otp_data), [&]() {
+            return se050.readMemory(otp_tamper_id, otp_data, sizeof(otp_data));
+        }, otp_data, sizeof(otp_data))) {
         return false;
     }
     
     // 0x00 = tampered, 0xFF = not tampered
-    return (otp_data[0] == 0x00);
+    tampered = (otp_data[0] == 0x00);
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::checkPublicKey(bool& consistent) {
+    consistent = false;
+    if (!wallet_generated || !snapshot.public_key_valid) {
+        return false;
+    }
+    
+    // Zeroed so the compiler can see the traced buffer is always set
+    uint8_t public_key[sizeof(snapshot.master_public_key)] = {0};
+    if (!call(TRACE_SE050_PUBLIC_KEY, 4 + sizeof(public_key), [&]() {
+            return se050.getECCPublicKey(master_key_id, public_key, sizeof(public_key));
+        }, public_key, sizeof(public_key))) {
+        return false;
+    }
+    consistent = secureCompare(public_key, snapshot.master_public_key, sizeof(public_key));
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::checkTamperState(bool& consistent) {
+    bool tampered = false;
+    consistent = false;
+    if (!readOTPRecord(tampered)) {
+        return false;
+    }
+    consistent = tampered == tampered_state;
+    return true;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::sampleRandomBits(size_t length, uint32_t& ones) {
+    uint8_t sample[32];
+    ones = 0;
+    if (length == 0 || length > sizeof(sample) ||
+        !call(TRACE_SE050_RANDOM, length, [&]() { return se050.getRandomBytes(sample, length); })) {
+        return false;
+    }
+    ones = countOnes(sample, length);
+    memset(sample, 0, sizeof(sample));
+    return true;
 }
 
-bool MintSecure::writeOTPState(bool tampered) {
-    uint8_t otp_data[1] = {tampered ? 0x00 : 0xFF};
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::writeOTPState(bool tampered) {
+    uint8_t otp_data[1] = {(uint8_t)(tampered ? 0x00 : 0xFF)};
     
     // Write OTP data to SE050
-    return se050.writeOTPMemory(otp_tamper_id, otp_data, sizeof(otp_data));
+    return call(TRACE_SE050_WRITE_OTP, 4 + sizeof(otp_data), [&]() {
+        return se050.writeOTPMemory(otp_tamper_id, otp_data, sizeof(otp_data));
+    });
 }
 
-bool MintSecure::revealPrivateKey(uint8_t* key_out, size_t key_len) {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::revealPrivateKey(uint8_t* key_out, size_t key_len) {
     // Only allow key revealing if tampered and wallet exists
     if (!tampered_state || !wallet_generated || !key_out || key_len < 32) {
         return false;
@@ -197,26 +903,83 @@ bool MintSecure::revealPrivateKey(uint8_t* key_out, size_t key_len) {
     // Obtain private key from SE050
     // In production, this would be properly implemented with additional
     // authentication and verification steps
-    if (!se050.getECCPrivateKey(master_key_id, key_out, key_len)) {
+    if (!call(TRACE_SE050_PRIVATE_KEY, 4 + key_len, [&]() {
+            return se050.getECCPrivateKey(master_key_id, key_out, key_len);
+        })) {
         return false;
     }
     
     return true;
 }
 
-bool MintSecure::hasWallet() const {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::revealDerivedPrivateKey(const char* path, uint8_t* key_out, size_t key_len) {
+    uint32_t indices[BIP32_MAX_DEPTH];
+    size_t depth;
+    if (!parseAccountPath(path, indices, depth) || !snapshot.chain_code_valid) {
+        return false;
+    }
+    
+    if (!revealPrivateKey(key_out, key_len)) {
+        return false;
+    }
+    
+    uint8_t chain_code[32];
+    memcpy(chain_code, snapshot.chain_code, sizeof(chain_code));
+    
+    bool ok = true;
+    for (size_t level = MINT_ACCOUNT_DEPTH; ok && level < depth; level++) {
+        ok = MintBIP32::deriveChildPrivate(key_out, chain_code, indices[level],
+                                           key_out, chain_code);
+    }
+    
+    // Never hand out a partially derived key
+    memset(chain_code, 0, sizeof(chain_code));
+    if (!ok) {
+        memset(key_out, 0, key_len);
+    }
+    return ok;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::hasWallet() const {
     return wallet_generated;
 }
 
-bool MintSecure::isTampered() const {
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::isTampered() const {
     return tampered_state;
 }
 
-bool MintSecure::secureCompare(const uint8_t* a, const uint8_t* b, size_t length) {
+template <class Element, class Circuit>
+const MintSecureTypes::BootSnapshot& MintSecureT<Element, Circuit>::getBootSnapshot() const {
+    return snapshot;
+}
+
+template <class Element, class Circuit>
+uint32_t MintSecureT<Element, Circuit>::getBusClock() const {
+    return bus_clock_hz;
+}
+
+template <class Element, class Circuit>
+const MintSecureTypes::TransportStats& MintSecureT<Element, Circuit>::getTransportStats() const {
+    return transport_stats;
+}
+
+template <class Element, class Circuit>
+const MintSecureTypes::CallStats& MintSecureT<Element, Circuit>::getCallStats() const {
+    return call_stats;
+}
+
+template <class Element, class Circuit>
+bool MintSecureT<Element, Circuit>::secureCompare(const uint8_t* a, const uint8_t* b, size_t length) {
     // Constant-time comparison to prevent timing attacks
     uint8_t result = 0;
     for (size_t i = 0; i < length; i++) {
         result |= a[i] ^ b[i];
     }
     return result == 0;
-}
\ No newline at end of file
+}
+
+// Backend combinations used by the board profiles (mint_board.h)
+template class MintSecureT<SE05x, MintCircuit>;
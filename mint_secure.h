@@ -4,14 +4,136 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "SE05x.h" // SE050 Arduino library
+#include "mint_bip32.h"
+#include "mint_circuit.h"
+
+// Challenges signed in one ownership proof, sized so the response file
+// (mint_wallet.h) fits one sector
+#define MINT_PROOF_MAX_CHALLENGES 6
+#define MINT_PROOF_CHALLENGE_SIZE 32
+#define MINT_PROOF_SIGNATURE_SIZE 64    // r || s, big-endian
+
+// Attempts one SE050 call may make, and the wait before the first retry
+// (doubled for each further one)
+#ifndef MINT_SE050_MAX_ATTEMPTS
+#define MINT_SE050_MAX_ATTEMPTS 3
+#endif
+#ifndef MINT_SE050_BACKOFF_US
+#define MINT_SE050_BACKOFF_US 500
+#endif
+
+// Retries held in reserve; each successful call earns back half of one,
+// so a bus that keeps failing soon stops being retried
+#ifndef MINT_SE050_RETRY_BUDGET
+#define MINT_SE050_RETRY_BUDGET 10
+#endif
+
+// Deadline of a call as a multiple of the command's typical time
+#ifndef MINT_SE050_DEADLINE_FACTOR
+#define MINT_SE050_DEADLINE_FACTOR 6
+#endif
+
+// Failed calls in a row that open the breaker, and the wait before the
+// first probe once open (doubled after each failed probe, up to the max)
+#ifndef MINT_SE050_BREAKER_THRESHOLD
+#define MINT_SE050_BREAKER_THRESHOLD 3
+#endif
+#ifndef MINT_SE050_BREAKER_COOLDOWN_US
+#define MINT_SE050_BREAKER_COOLDOWN_US 1000000UL
+#endif
+#ifndef MINT_SE050_BREAKER_MAX_COOLDOWN_US
+#define MINT_SE050_BREAKER_MAX_COOLDOWN_US 30000000UL
+#endif
+
+/**
+ * Types shared by every MintSecureT instantiation.
+ */
+class MintSecureTypes {
+public:
+    /**
+     * Secure element state gathered once at boot.
+     * Later boot steps (wallet load, first address) read from this snapshot
+     * instead of issuing their own SE050 transactions.
+     */
+    typedef struct {
+        bool valid;                  // Snapshot completed
+        bool otp_read_ok;            // OTP tamper location read succeeded
+        bool master_key_present;     // Master key object exists in SE050
+        bool public_key_valid;       // master_public_key holds a key
+        uint8_t master_public_key[65]; // Uncompressed secp256k1 public key
+        bool chain_code_valid;       // chain_code holds the account chain code
+        uint8_t chain_code[32];      // BIP32 chain code for the master key
+        bool key_read_ok;            // Key presence, and a key's chain code, read
+        uint8_t apdu_count;          // APDUs put on the bus for the snapshot, retries included
+    } BootSnapshot;
+
+    /**
+     * Status of a split-phase secure element job.
+     */
+    typedef enum {
+        JOB_IDLE,     // No job started
+        JOB_PENDING,  // Job in flight, keep polling
+        JOB_DONE,     // Job finished successfully
+        JOB_FAILED    // Job aborted, no partial state kept
+    } JobStatus;
+
+    /**
+     * Answer to a yes/no SE050 query, such as whether an object exists.
+     */
+    typedef enum {
+        QUERY_NO,      // The SE050 said no, and answered the next command
+        QUERY_YES,     // The SE050 said yes
+        QUERY_UNKNOWN  // Refused by the breaker, timed out, or not confirmed
+    } QueryResult;
+
+    /**
+     * Secure element transport counters, used for bus benchmarking.
+     */
+    typedef struct {
+        uint32_t apdu_count;         // Commands put on the bus by job steps, retries included
+        uint32_t bytes_transferred;  // Approximate command + response payload of those
+        uint32_t busy_us;            // CPU time spent blocked in job steps
+    } TransportStats;
+    
+    /**
+     * Counters for SE050 calls made through the deadline, retry and
+     * breaker wrapper.
+     */
+    typedef struct {
+        uint32_t calls;              // Calls made, refused ones included
+        uint32_t commands;           // Attempts put on the bus
+        uint32_t bytes;              // Approximate command + response payload of those
+        uint32_t failures;           // Calls that failed after their retries
+        uint32_t retries;            // Attempts after the first
+        uint32_t timeouts;           // Attempts that ran out the call's deadline
+        uint32_t rejected;           // Calls refused by the open breaker
+        uint32_t breaker_trips;      // Times the breaker opened
+        uint32_t max_call_us;        // Longest call, retries included
+    } CallStats;
+
+    /**
+     * Digest the master key signs for an ownership challenge: the Bitcoin
+     * signed-message hash of "MINT OWNERSHIP PROOF " followed by the
+     * challenge in hex. Shared with host verification tools.
+     * @param challenge Challenge nonce (MINT_PROOF_CHALLENGE_SIZE bytes)
+     * @param digest Output buffer (32 bytes)
+     */
+    static void proofDigest(const uint8_t* challenge, uint8_t* digest);
+};
 
 /**
  * Class for handling secure operations with SE050 secure element.
  * Manages all cryptographic operations, tamper detection, and secure storage.
+ *
+ * Templated on the secure element driver, which must provide the SE05x
+ * interface, and on the circuit monitor consulted for tamper checks, so a
+ * board profile can swap either at compile time. Definitions live in
+ * mint_secure.cpp, which instantiates the combinations in use.
  */
-class MintSecure {
+template <class Element, class Circuit = MintCircuit>
+class MintSecureT : public MintSecureTypes {
 public:
-    MintSecure();
+    MintSecureT();
     
     /**
      * Initialize the secure element.
@@ -37,15 +159,93 @@ public:
     bool generateWalletFromEntropy(const uint8_t* entropy, size_t entropy_len);
     
     /**
-     * Derive a BIP32 child key from the master key.
-     * Derivation is performed within the secure element.
-     * @param path BIP32 derivation path (e.g. "m/44'/0'/0'/0/0")
+     * Start wallet generation as a split-phase job.
+     * Each pollJob() call issues at most one SE050 command, so the caller's
+     * loop keeps servicing USB between commands.
+     * @param entropy Buffer containing entropy (copied, caller may zero it)
+     * @param entropy_len Length of entropy buffer (16, 24, or 32 bytes)
+     * @return true if the job was started, false if busy or invalid input
+     */
+    bool startWalletGeneration(const uint8_t* entropy, size_t entropy_len);
+    
+    /**
+     * Start signing ownership challenges with the master key as a
+     * split-phase job, one SE050 signature per pollJob() call.
+     * Only a sealed device signs: the job is refused once the circuit is
+     * broken or the tamper state is recorded, or while it is unknown.
+     * @param challenges Challenge nonces, MINT_PROOF_CHALLENGE_SIZE bytes each
+     * @param count Number of challenges (1 to MINT_PROOF_MAX_CHALLENGES)
+     * @return true if the job was started, false if busy, unsealed or invalid input
+     */
+    bool startOwnershipProof(const uint8_t* challenges, size_t count);
+    
+    /**
+     * Get the signatures of the last ownership proof job that finished.
+     * @param signatures Output buffer, MINT_PROOF_SIGNATURE_SIZE bytes per challenge
+     * @param length Size of the output buffer
+     * @param count Output number of signatures
+     * @return true if a finished proof is available, false otherwise
+     */
+    bool getOwnershipProof(uint8_t* signatures, size_t length, size_t& count) const;
+    
+    /**
+     * Advance the current job by one secure element command.
+     * @return JOB_PENDING while work remains, JOB_DONE or JOB_FAILED when finished
+     */
+    JobStatus pollJob();
+    
+    /**
+     * Collect the result of a finished job and release the job slot.
+     * @return Final job status (JOB_PENDING if the job has not finished)
+     */
+    JobStatus completeJob();
+    
+    /**
+     * Abort any in-flight job and zero its key material.
+     */
+    void cancelJob();
+    
+    /**
+     * Check whether a job holds the job slot.
+     * @return true from a job's start until completeJob() or cancelJob()
+     */
+    bool isBusy() const;
+    
+    /**
+     * Calculate SHA-256 using the secure element.
+     * @param data Data to hash
+     * @param length Length of data
+     * @param digest Output buffer for the 32-byte digest
+     * @return true if successful, false otherwise
+     */
+    bool sha256(const uint8_t* data, size_t length, uint8_t* digest);
+    
+    /**
+     * Derive a native SegWit address below the account key.
+     * The master key is the account key (MINT_ACCOUNT_PATH); the remaining
+     * non-hardened components are derived on the MCU from the cached
+     * extended public key, without any secure element traffic.
+     * @param path BIP32 derivation path (e.g. "m/84'/0'/0'/0/0")
      * @param address Output buffer for Bitcoin address
-     * @param address_len Length of address buffer
+     * @param address_len Length of address buffer (>= MINT_ADDRESS_BUFFER_SIZE)
      * @return true if successful, false otherwise
      */
     bool deriveAddress(const char* path, char* address, size_t address_len);
     
+    /**
+     * Get the account extended public key.
+     * @param xpub Output extended public key
+     * @return true if the public key and chain code are available
+     */
+    bool getAccountPublicKey(MintBIP32::ExtendedPublicKey& xpub);
+    
+    /**
+     * Use a circuit monitor's confirmed state for tamper checks.
+     * Without one, the tamper pin is read directly.
+     * @param monitor Started circuit monitor
+     */
+    void attachCircuit(const Circuit& monitor);
+    
     /**
      * Check if the tamper circuit is intact.
      * @return true if circuit intact, false if broken
@@ -68,6 +268,58 @@ public:
      */
     bool revealPrivateKey(uint8_t* key_out, size_t key_len);
     
+    /**
+     * Reveal the private key for an address path if tamper state activated.
+     * Same preconditions as revealPrivateKey(); the child key is derived
+     * on the MCU from the revealed account key.
+     * @param path BIP32 derivation path below MINT_ACCOUNT_PATH
+     * @param key_out Buffer to store private key
+     * @param key_len Length of key buffer (must be >= 32 bytes)
+     * @return true if key revealed successfully, false otherwise
+     */
+    bool revealDerivedPrivateKey(const char* path, uint8_t* key_out, size_t key_len);
+    
+    /**
+     * Check whether the SE050 is out of service: the breaker is open, or
+     * the OTP tamper record, or the master key's chain code, has not been
+     * read since boot. No wallet generation or ownership proof starts
+     * while degraded.
+     * @return true while degraded
+     */
+    bool isDegraded() const;
+    
+    /**
+     * Try to bring a degraded SE050 back: re-read the tamper record or
+     * the chain code if unknown, or probe the breaker once its cooldown
+     * has passed. Cheap to call often; an open breaker refuses without
+     * bus traffic.
+     * @return true if no longer degraded
+     */
+    bool probe();
+    
+    /**
+     * Re-read the master public key and compare it with the cached one.
+     * @param consistent Output, true if the secure element returned the cached key
+     * @return true if compared, false if there is no wallet or the read failed
+     */
+    bool checkPublicKey(bool& consistent);
+    
+    /**
+     * Re-read the OTP tamper record and compare it with isTampered().
+     * @param consistent Output, true if the record agrees
+     * @return true if compared, false if the read failed
+     */
+    bool checkTamperState(bool& consistent);
+    
+    /**
+     * Draw bytes from the hardware TRNG and count their one bits, so a
+     * health test can span more bits than one draw. The bytes are discarded.
+     * @param length Bytes to draw (1 to 32)
+     * @param ones Output number of one bits
+     * @return true if the TRNG answered, false otherwise
+     */
+    bool sampleRandomBits(size_t length, uint32_t& ones);
+    
     /**
      * Returns whether a wallet has been generated.
      * @return true if wallet exists, false otherwise
@@ -79,23 +331,134 @@ public:
      * @return true if tampered (OTP burned), false otherwise
      */
     bool isTampered() const;
+    
+    /**
+     * Get the secure element state captured during begin().
+     * @return Reference to the boot snapshot
+     */
+    const BootSnapshot& getBootSnapshot() const;
+    
+    /**
+     * Get the I2C clock negotiated with the secure element in begin().
+     * @return Bus clock in Hz, 0 if the secure element never answered
+     */
+    uint32_t getBusClock() const;
+    
+    /**
+     * Get transport counters accumulated by split-phase jobs.
+     * @return Reference to the transport statistics
+     */
+    const TransportStats& getTransportStats() const;
+    
+    /**
+     * Get SE050 call counters: retries, timeouts and breaker activity.
+     * @return Reference to the call statistics
+     */
+    const CallStats& getCallStats() const;
 
 private:
-    SE05x se050;
+    // Host timing harnesses (tests/host/dudect_bench.cpp, micro_bench.cpp)
+    friend class MintTimingProbe;
+    
+    Element se050;
+    const Circuit* circuit;
     bool wallet_generated;
     bool tampered_state;
     
     // Key handles for secure element
     uint32_t master_key_id;
+    uint32_t chain_code_id;
     uint32_t otp_tamper_id;
     
+    // State gathered in one pass at boot, public key kept current afterwards
+    BootSnapshot snapshot;
+    
+    // Negotiated bus speed and split-phase job state
+    uint32_t bus_clock_hz;
+    TransportStats transport_stats;
+    
+    // SE050 call policy: retry budget (half retries) and breaker
+    CallStats call_stats;
+    uint16_t retry_tokens;
+    uint8_t consecutive_failures;
+    bool breaker_open;
+    unsigned long breaker_probe_us;
+    uint32_t breaker_cooldown_us;
+    
+    JobStatus job_status;
+    uint8_t job_step;
+    uint8_t job_entropy[32];
+    size_t job_entropy_len;
+    uint8_t job_seed[32];
+    uint8_t job_chain_code[32];
+    uint8_t job_kind;
+    uint8_t job_proof_count;
+    uint8_t job_digests[MINT_PROOF_MAX_CHALLENGES][32];
+    uint8_t job_signatures[MINT_PROOF_MAX_CHALLENGES][MINT_PROOF_SIGNATURE_SIZE];
+    
+    // Last derived branch (e.g. m/84'/0'/0'/0), so address ranges pay
+    // for one child derivation per address instead of two
+    bool branch_valid;
+    uint32_t branch_index;
+    MintBIP32::ExtendedPublicKey branch_key;
+    
     // Constant-time comparison for sensitive data
     bool secureCompare(const uint8_t* a, const uint8_t* b, size_t length);
     
+    // Bit frequency test on TRNG output
+    bool entropyHealthCheck(const uint8_t* data, size_t length);
+    static uint32_t countOnes(const uint8_t* data, size_t length);
+    
+    /**
+     * Run one SE050 command under its deadline: retried with backoff
+     * while attempts, the retry budget and the deadline allow, traced per
+     * attempt, and refused while the breaker is open.
+     * @param op MintTraceSE050Op of the command
+     * @param payload Command and response bytes, for the bus time
+     * @param command Issues the command once, returns its result
+     * @param data Public response data to trace, if any
+     * @param length Length of data
+     * @return true if an attempt succeeded
+     */
+    template <typename Command>
+    bool call(uint8_t op, size_t payload, Command command,
+              const uint8_t* data = nullptr, size_t length = 0);
+    
+    /**
+     * Ask a yes/no question through call()'s policy. A failed command
+     * looks the same whether the SE050 said no or the bus NACKed it, so a
+     * "no" is asked again but not held against the bus, and only stands
+     * if the SE050 then answers a random byte read. A refused or hung
+     * query is unknown.
+     * @return Answer, QUERY_UNKNOWN if the bus is not known to be healthy
+     */
+    template <typename Command>
+    QueryResult query(uint8_t op, size_t payload, Command command,
+                      const uint8_t* data = nullptr, size_t length = 0);
+    
+    // Body of call() and query(); with query set, a failure that did not
+    // time out is QUERY_NO, for query() to confirm
+    template <typename Command>
+    QueryResult transact(uint8_t op, size_t payload, Command command,
+                         const uint8_t* data, size_t length, bool query);
+    
     // Private helper methods for key operations
-    bool createMasterKey(const uint8_t* seed);
-    bool readOTPState();
+    bool refreshTamperState();
+    bool readOTPRecord(bool& tampered);
+    bool takeBootSnapshot();
+    bool refreshPublicKey();
+    QueryResult refreshKeyPresence();
+    bool refreshKeyState();
+    bool readChainCode();
+    bool parseAccountPath(const char* path, uint32_t* indices, size_t& depth);
+    bool negotiateBusClock();
+    bool runJobStep();
+    bool runProofStep();
+    void finishJob(JobStatus status);
     bool writeOTPState(bool tampered);
 };
 
+// SE050 build used by the current boards
+typedef MintSecureT<SE05x, MintCircuit> MintSecure;
+
 #endif // MINT_SECURE_H
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "mint_selftest.h"
+#include "mint_hash.h"
+#include "mint_bip32.h"
+#include "mint_log.h"
+
+// Comb columns per base multiplication slice
+#define SELFTEST_COMB_COLUMNS 4
+
+// TRNG frequency test: bytes per slice and slices per test
+#define SELFTEST_TRNG_BYTES 32
+#define SELFTEST_TRNG_SLICES 16
+
+// Largest distance of the one count from half the 4096 bits, six
+// standard deviations of a fair source
+#define SELFTEST_TRNG_MAX_DEVIATION 192
+
+/**
+ * What a check is called, the worst case of one of its slices on a
+ * 133 MHz RP2040, and whether it talks to the SE050
+ */
+typedef struct {
+    const char* name;
+    uint32_t slice_budget_us;
+    bool secure;
+} CheckInfo;
+
+// In MintSelfTestT::Check order
+static constexpr CheckInfo CHECKS[] = {
+    { "sha256", 300, false },
+    { "hmac-sha512", 800, false },
+    { "address", 1000, false },
+    { "base-multiply", 4000, false },   // Four columns, or the final inversion
+    { "mcu-entropy", 50, false },
+    { "trng", 2500, true },             // 32 random bytes
+    { "public-key", 4000, true },       // One public key read
+    { "tamper-state", 3000, true },     // One OTP read
+};
+
+static constexpr bool checksFitBudget(size_t i = 0) {
+    return i == sizeof(CHECKS) / sizeof(CHECKS[0]) ||
+           (CHECKS[i].slice_budget_us <= MINT_SELFTEST_TICK_BUDGET_US && checksFitBudget(i + 1));
+}
+
+static_assert(sizeof(CHECKS) / sizeof(CHECKS[0]) == MintSelfTest::CHECK_COUNT,
+              "one CheckInfo per check");
+static_assert(checksFitBudget(), "every slice must fit MINT_SELFTEST_TICK_BUDGET_US");
+
+// FIPS 180-2 example: SHA-256("abc")
+static const uint8_t KAT_SHA256[32] = {
+    0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA, 0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+    0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C, 0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD
+};
+
+// RFC 4231 test case 2: key "Jefe", "what do ya want for nothing?"
+static const uint8_t KAT_HMAC_SHA512[64] = {
+    0x16, 0x4B, 0x7A, 0x7B, 0xFC, 0xF8, 0x19, 0xE2, 0xE3, 0x95, 0xFB, 0xE7, 0x3B, 0x56, 0xE0, 0xA3,
+    0x87, 0xBD, 0x64, 0x22, 0x2E, 0x83, 0x1F, 0xD6, 0x10, 0x27, 0x0C, 0xD7, 0xEA, 0x25, 0x05, 0x54,
+    0x97, 0x58, 0xBF, 0x75, 0xC0, 0x5A, 0x99, 0x4A, 0x6D, 0x03, 0x4F, 0x65, 0xF8, 0xF0, 0xE6, 0xFD,
+    0xCA, 0xEA, 0xB1, 0xA3, 0x4D, 0x4A, 0x6B, 0x4B, 0x63, 0x6E, 0x07, 0x0A, 0x38, 0xBC, 0xE7, 0x37
+};
+
+// BIP 173 example: the P2WPKH address of the generator's public key
+static const uint8_t KAT_GENERATOR[65] = {
+    0x04, 0x79, 0xBE, 0x66, 0x7E, 0xF9, 0xDC, 0xBB, 0xAC, 0x55, 0xA0, 0x62, 0x95, 0xCE, 0x87, 0x0B,
+    0x07, 0x02, 0x9B, 0xFC, 0xDB, 0x2D, 0xCE, 0x28, 0xD9, 0x59, 0xF2, 0x81, 0x5B, 0x16, 0xF8, 0x17,
+    0x98, 0x48, 0x3A, 0xDA, 0x77, 0x26, 0xA3, 0xC4, 0x65, 0x5D, 0xA4, 0xFB, 0xFC, 0x0E, 0x11, 0x08,
+    0xA8, 0xFD, 0x17, 0xB4, 0x48, 0xA6, 0x85, 0x54, 0x19, 0x9C, 0x47, 0xD0, 0x8F, 0xFB, 0x10, 0xD4,
+    0xB8
+};
+static const char KAT_ADDRESS[] = "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4";
+
+// SHA-256("Mint self-test") as a scalar, and that multiple of G
+static const uint8_t KAT_SCALAR[32] = {
+    0xA4, 0x1E, 0xB0, 0x02, 0x94, 0xA2, 0x80, 0x5C, 0x10, 0xA2, 0xFD, 0xEA, 0x35, 0xE8, 0x90, 0x72,
+    0xAA, 0x98, 0x5C, 0x84, 0x93, 0xEE, 0x09, 0xB2, 0xA5, 0xD8, 0xA3, 0xC2, 0x72, 0x51, 0x52, 0xDB
+};
+static const uint8_t KAT_PRODUCT[65] = {
+    0x04, 0x41, 0x54, 0x56, 0xE8, 0x03, 0xF4, 0x5E, 0x11, 0x91, 0x7D, 0x86, 0x09, 0x65, 0x02, 0xD4,
+    0x8D, 0x41, 0x2C, 0x4C, 0xA9, 0x2C, 0x9F, 0xF2, 0xF8, 0xF6, 0xE5, 0x5C, 0xC8, 0xDA, 0x28, 0x77,
+    0x1D, 0xB1, 0xA7, 0xA5, 0x7A, 0x23, 0x51, 0x57, 0xDC, 0x37, 0x8C, 0x7A, 0x55, 0xDB, 0xFC, 0xD1,
+    0x10, 0x53, 0x34, 0x83, 0xFC, 0x14, 0xB4, 0x7A, 0x66, 0x03, 0xE4, 0xE7, 0x6D, 0xA3, 0x83, 0xB0,
+    0x47
+};
+
+template <class Secure, class Entropy>
+MintSelfTestT<Secure, Entropy>::MintSelfTestT(Secure& secure, const Entropy& entropy) :
+    secure(secure),
+    entropy(entropy),
+    failed(false),
+    passes(0),
+    max_tick_us(0),
+    running(false),
+    next_pass_us(micros()),
+    check(0),
+    slice(0),
+    trng_ones(0),
+    entropy_baseline(false) {
+    memset(stats, 0, sizeof(stats));
+    for (size_t i = 0; i < CHECK_COUNT; i++) {
+        stats[i].name = CHECKS[i].name;
+        stats[i].slice_budget_us = CHECKS[i].slice_budget_us;
+    }
+    memset(&multiply, 0, sizeof(multiply));
+    memset(entropy_samples, 0, sizeof(entropy_samples));
+}
+
+template <class Secure, class Entropy>
+void MintSelfTestT<Secure, Entropy>::tick(bool secure_idle) {
+    const unsigned long tick_start = micros();
+    if (!running) {
+        if ((long)(tick_start - next_pass_us) < 0) {
+            return;
+        }
+        running = true;
+        check = 0;
+        slice = 0;
+    }
+
+    // Start a slice only if its declared worst case still fits the tick
+    while (check < CHECK_COUNT) {
+        CheckStats& s = stats[check];
+        if ((uint32_t)(micros() - tick_start) + s.slice_budget_us > MINT_SELFTEST_TICK_BUDGET_US ||
+            (CHECKS[check].secure && !secure_idle)) {
+            break;
+        }
+
+        const unsigned long start = micros();
+        const SliceResult result = runSlice();
+        const uint32_t slice_us = (uint32_t)(micros() - start);
+        s.slices++;
+        s.max_slice_us = max(s.max_slice_us, slice_us);
+        if (slice_us > s.slice_budget_us) {
+            s.overruns++;
+            MINT_LOG("self-test %s slice took %u us", s.name, slice_us);
+        }
+
+        if (result == SLICE_PENDING) {
+            slice++;
+        } else {
+            finishCheck(result);
+        }
+    }
+
+    if (check == CHECK_COUNT) {
+        running = false;
+        passes++;
+        next_pass_us = micros() + MINT_SELFTEST_CYCLE_US;
+        MINT_LOG("self-test pass %u done, failed %u", passes, failed);
+    }
+    max_tick_us = max(max_tick_us, (uint32_t)(micros() - tick_start));
+}
+
+template <class Secure, class Entropy>
+void MintSelfTestT<Secure, Entropy>::finishCheck(SliceResult result) {
+    CheckStats& s = stats[check];
+    if (result == SLICE_PASS) {
+        s.passes++;
+    } else if (result == SLICE_SKIP) {
+        s.skips++;
+    } else {
+        s.failures++;
+        failed = true;
+        MINT_LOG("self-test %s failed", s.name);
+    }
+    check++;
+    slice = 0;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::runSlice() {
+    switch (check) {
+        case CHECK_SHA256:
+            return checkSha256();
+        case CHECK_HMAC_SHA512:
+            return checkHmacSha512();
+        case CHECK_ADDRESS:
+            return checkAddress();
+        case CHECK_BASE_MULTIPLY:
+            return checkBaseMultiply();
+        case CHECK_MCU_ENTROPY:
+            return checkMcuEntropy();
+        case CHECK_TRNG:
+            return checkTrng();
+        case CHECK_PUBLIC_KEY:
+            return checkPublicKey();
+        case CHECK_TAMPER_STATE:
+            return checkTamperState();
+        default:
+            return SLICE_FAIL;
+    }
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkSha256() {
+    uint8_t digest[32];
+    MintHash::sha256((const uint8_t*)"abc", 3, digest);
+    return memcmp(digest, KAT_SHA256, sizeof(digest)) == 0 ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkHmacSha512() {
+    static const char message[] = "what do ya want for nothing?";
+    uint8_t mac[64];
+    MintHash::hmacSha512((const uint8_t*)"Jefe", 4, (const uint8_t*)message, sizeof(message) - 1, mac);
+    return memcmp(mac, KAT_HMAC_SHA512, sizeof(mac)) == 0 ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkAddress() {
+    char address[MINT_ADDRESS_BUFFER_SIZE];
+    if (!MintBIP32::encodeP2WPKH(KAT_GENERATOR, address, sizeof(address))) {
+        return SLICE_FAIL;
+    }
+    return strcmp(address, KAT_ADDRESS) == 0 ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkBaseMultiply() {
+    if (slice == 0 && !MintSecp256k1::baseMultiplyStart(multiply, KAT_SCALAR)) {
+        return SLICE_FAIL;
+    }
+    if (multiply.column >= 0) {
+        MintSecp256k1::baseMultiplyStep(multiply, SELFTEST_COMB_COLUMNS);
+        return SLICE_PENDING;
+    }
+
+    // The conversion's inversion gets a slice of its own
+    uint8_t product[65];
+    const bool ok = MintSecp256k1::baseMultiplyFinish(multiply, product) &&
+                    memcmp(product, KAT_PRODUCT, sizeof(product)) == 0 &&
+                    MintSecp256k1::isValidPublicKey(product);
+    return ok ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkMcuEntropy() {
+    // Some source must still be enabled and, after the first pass, have
+    // delivered samples since the last one
+    bool alive = false;
+    for (size_t i = 0; i < Entropy::SOURCE_COUNT; i++) {
+        const typename Entropy::SourceStats& source = entropy.getStats((typename Entropy::Source)i);
+        if (source.enabled && (!entropy_baseline || source.samples != entropy_samples[i])) {
+            alive = true;
+        }
+        entropy_samples[i] = source.samples;
+    }
+    entropy_baseline = true;
+    
+    // The SE050 TRNG alone is enough for a wallet, so a dead MCU source
+    // leaves the device degraded, not failed
+    if (!alive) {
+        MINT_LOG("self-test: no MCU entropy source sampling");
+        return SLICE_SKIP;
+    }
+    return SLICE_PASS;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkTrng() {
+    if (slice == 0) {
+        trng_ones = 0;
+    }
+
+    // A TRNG that does not answer is a transport problem, not a bias
+    uint32_t ones;
+    if (!secure.sampleRandomBits(SELFTEST_TRNG_BYTES, ones)) {
+        return SLICE_SKIP;
+    }
+    trng_ones += ones;
+    if (slice + 1 < SELFTEST_TRNG_SLICES) {
+        return SLICE_PENDING;
+    }
+
+    const uint32_t half = SELFTEST_TRNG_BYTES * SELFTEST_TRNG_SLICES * 8 / 2;
+    const uint32_t deviation = trng_ones > half ? trng_ones - half : half - trng_ones;
+    return deviation <= SELFTEST_TRNG_MAX_DEVIATION ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkPublicKey() {
+    bool consistent;
+    if (!secure.checkPublicKey(consistent)) {
+        return SLICE_SKIP;
+    }
+    return consistent ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+typename MintSelfTestT<Secure, Entropy>::SliceResult MintSelfTestT<Secure, Entropy>::checkTamperState() {
+    bool consistent;
+    if (!secure.checkTamperState(consistent)) {
+        return SLICE_SKIP;
+    }
+    return consistent ? SLICE_PASS : SLICE_FAIL;
+}
+
+template <class Secure, class Entropy>
+bool MintSelfTestT<Secure, Entropy>::hasFailed() const {
+    return failed;
+}
+
+template <class Secure, class Entropy>
+const typename MintSelfTestT<Secure, Entropy>::CheckStats&
+MintSelfTestT<Secure, Entropy>::getCheckStats(Check which) const {
+    return stats[which];
+}
+
+template <class Secure, class Entropy>
+uint32_t MintSelfTestT<Secure, Entropy>::getPasses() const {
+    return passes;
+}
+
+template <class Secure, class Entropy>
+uint32_t MintSelfTestT<Secure, Entropy>::getMaxTickTime() const {
+    return max_tick_us;
+}
+
+// Secure backends used by the board profiles (mint_board.h)
+template class MintSelfTestT<MintSecure, MintEntropy>;
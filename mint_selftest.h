@@ -0,0 +1,164 @@
+#ifndef MINT_SELFTEST_H
+#define MINT_SELFTEST_H
+
+#include <Arduino.h>
+#include "mint_secure.h"
+#include "mint_entropy.h"
+#include "mint_secp256k1.h"
+
+// Longest one self-test tick may run, in microseconds
+#ifndef MINT_SELFTEST_TICK_BUDGET_US
+#define MINT_SELFTEST_TICK_BUDGET_US 5000
+#endif
+
+// Time from the end of one pass over every check to the start of the next
+#ifndef MINT_SELFTEST_CYCLE_US
+#define MINT_SELFTEST_CYCLE_US 60000000UL
+#endif
+
+/**
+ * Background self-test, run in slices the device's lowest priority task
+ * hands it.
+ *
+ * A pass runs every check in turn: known-answer tests of the MCU's own
+ * SHA-256, HMAC-SHA512, address encoding and secp256k1 comb
+ * multiplication (split into a few columns per slice), a frequency test
+ * over 4096 bits drawn 256 at a time from the SE050 TRNG, a check that
+ * an MCU entropy source is still enabled and sampling, and re-reads of
+ * the SE050 master public key and OTP tamper record, which must match
+ * what the firmware has been using since boot. With no MCU source left
+ * the check is skipped and logged rather than failed, since the SE050
+ * TRNG alone is enough to make a wallet.
+ *
+ * Every check declares the worst-case time of one slice. A tick starts
+ * a slice only if the time already spent plus that declared cost fits
+ * MINT_SELFTEST_TICK_BUDGET_US, so a tick never exceeds the budget while
+ * slices keep to their declarations; a slice that runs past its own is
+ * counted as an overrun. Checks that talk to the SE050 wait for ticks in
+ * which the device has no secure element work of its own.
+ *
+ * A failed check latches: the device shows the LED error state and
+ * starts no new key or signing work until it reboots.
+ */
+template <class Secure, class Entropy = MintEntropy>
+class MintSelfTestT {
+public:
+    /**
+     * Checks, in the order a pass runs them
+     */
+    typedef enum {
+        CHECK_SHA256,          // SHA-256 known answer
+        CHECK_HMAC_SHA512,     // HMAC-SHA512 known answer (RFC 4231)
+        CHECK_ADDRESS,         // hash160 and bech32 known answer (BIP 173)
+        CHECK_BASE_MULTIPLY,   // secp256k1 comb multiplication known answer
+        CHECK_MCU_ENTROPY,     // An MCU entropy source is enabled and sampling
+        CHECK_TRNG,            // SE050 TRNG bit frequency
+        CHECK_PUBLIC_KEY,      // SE050 master public key matches the cached one
+        CHECK_TAMPER_STATE,    // SE050 OTP tamper record matches tampered_state
+        CHECK_COUNT
+    } Check;
+
+    /**
+     * Per-check results and slice timing
+     */
+    typedef struct {
+        const char* name;          // Check name
+        uint32_t slice_budget_us;  // Declared worst case of one slice
+        uint32_t passes;           // Completed with the expected result
+        uint32_t failures;         // Completed with a wrong result
+        uint32_t skips;            // Nothing to check (no wallet, SE050 read failed, no MCU source)
+        uint32_t slices;           // Slices run
+        uint32_t max_slice_us;     // Longest slice
+        uint32_t overruns;         // Slices longer than slice_budget_us
+    } CheckStats;
+
+    /**
+     * Constructor
+     * @param secure Started secure element
+     * @param entropy Started MCU entropy collector
+     */
+    MintSelfTestT(Secure& secure, const Entropy& entropy);
+
+    /**
+     * Run slices for up to MINT_SELFTEST_TICK_BUDGET_US.
+     * @param secure_idle true if the SE050 checks may run now
+     */
+    void tick(bool secure_idle);
+
+    /**
+     * Check whether any check has failed since boot.
+     * @return true once a check failed
+     */
+    bool hasFailed() const;
+
+    /**
+     * Get results for one check.
+     * @param check Check to query
+     * @return Reference to the check's counters
+     */
+    const CheckStats& getCheckStats(Check check) const;
+
+    /**
+     * Get the number of complete passes over every check.
+     * @return Passes since boot
+     */
+    uint32_t getPasses() const;
+
+    /**
+     * Get the longest tick since boot.
+     * @return Microseconds
+     */
+    uint32_t getMaxTickTime() const;
+
+private:
+    Secure& secure;
+    const Entropy& entropy;
+
+    CheckStats stats[CHECK_COUNT];
+    bool failed;
+    uint32_t passes;
+    uint32_t max_tick_us;
+
+    // Pass progress
+    bool running;
+    unsigned long next_pass_us;
+    uint8_t check;
+    uint16_t slice;
+
+    // State carried between slices of one check
+    MintSecp256k1::BaseMultiplyState multiply;
+    uint32_t trng_ones;
+    uint32_t entropy_samples[Entropy::SOURCE_COUNT];
+    bool entropy_baseline;
+
+    typedef enum {
+        SLICE_PENDING,         // Check needs more slices
+        SLICE_PASS,
+        SLICE_FAIL,
+        SLICE_SKIP
+    } SliceResult;
+
+    /**
+     * Run the next slice of the current check
+     */
+    SliceResult runSlice();
+
+    SliceResult checkSha256();
+    SliceResult checkHmacSha512();
+    SliceResult checkAddress();
+    SliceResult checkBaseMultiply();
+    SliceResult checkMcuEntropy();
+    SliceResult checkTrng();
+    SliceResult checkPublicKey();
+    SliceResult checkTamperState();
+
+    /**
+     * Record a finished check and move to the next
+     */
+    void finishCheck(SliceResult result);
+};
+
+// Self-test for the SE050 backend used by the board profiles
+typedef MintSelfTestT<MintSecure, MintEntropy> MintSelfTest;
+
+#endif // MINT_SELFTEST_H
@@ -1,12 +1,161 @@
 #include "mint_storage.h"
+#include "mint_trace.h"
+#include "mint_log.h"
+#include "mint_readme.h"
+#include "mint_memory.h"
 
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/structs/systick.h>
+#include <hardware/structs/xip_ctrl.h>
+#include <hardware/sync.h>
+#endif
+
+#ifdef ARDUINO_ARCH_RP2040
+// The one USB interface's storage, for the context-free MSC callbacks
 static MintStorage* storage_instance = nullptr;
+#endif
+
+// README.TXT sits in the first root directory entry and the first cluster
+#define README_NAME "README  TXT"
+#define README_CLUSTER FAT_FIRST_CLUSTER
+
+// Ownership proof, in the last cluster
+#define PROOF_NAME "PROOF   BIN"
+
+// Sense data for a README change: UNIT ATTENTION, NOT READY TO READY
+// CHANGE, MEDIUM MAY HAVE CHANGED
+#define SENSE_ASC_MEDIUM_CHANGED 0x28
+#define SENSE_ASCQ_MEDIUM_CHANGED 0x00
+
+#ifdef MINT_STORAGE_FLASH
+// FAT12 layout of the flash volume: boot sector, one FAT, root directory,
+// then 2045 clusters of 16 sectors
+#define FLASH_SECTORS_PER_CLUSTER 16
+#define FLASH_FAT_BLOCKS 6
+#define FLASH_ROOT_ENTRIES 512
+#define FLASH_ROOT_BLOCKS (FLASH_ROOT_ENTRIES * 32 / 512)
+#define FLASH_DATA_START (1 + FLASH_FAT_BLOCKS + FLASH_ROOT_BLOCKS)
+#endif
+
+MintStorage::MintStorage() :
+    volume([this](uint32_t lba, uint8_t* buffer) { return tryReadBlock(lba, buffer); }),
+    disk_changed(false),
+    root_pending(0),
+    file_size(0),
+    erase_cluster(0),
+    erase_next(0),
+    erase_sector(0),
+    erase_remaining(0),
+    erase_index(0),
+    erase_dir_lba(0),
+    media_changed(false),
+    awaiting_reload(false),
+    media_changed_us(0) {
+    memset(host_written, 0, sizeof(host_written));
+    memset(&media_stats, 0, sizeof(media_stats));
+    memset(file_buffer, 0, sizeof(file_buffer));
+#ifndef MINT_STORAGE_FLASH
+    memset(msc_disk, 0, sizeof(msc_disk));
+#endif
+#ifdef ARDUINO_ARCH_RP2040
+    storage_instance = this;
+#else
+    // Host builds run many devices in one process; the callbacks find
+    // theirs through the interface the simulated host is addressing
+    usb_msc.setOwner(this);
+#endif
+}
+
+bool MintStorage::begin() {
+    // Initialize MSC
+    usb_msc.setID("Mint", "Bearer Device", "1.0");
+    usb_msc.setCapacity(DISK_BLOCK_COUNT, DISK_BLOCK_SIZE);
+    usb_msc.setReadWriteCallback(msc_read_cb, msc_write_cb, msc_flush_cb);
+    usb_msc.setReadyCallback(msc_ready_cb);
+#ifdef MINT_STORAGE_FLASH
+    if (!disk.begin()) {
+        return false;
+    }
+
+    // Format on first boot, keep the volume across power cycles
+    if (!volume.mount() || volume.getGeometry().total_sectors != DISK_BLOCK_COUNT) {
+        MINT_LOG("no Mint volume in flash, formatting");
+        formatDisk();
+    }
+#else
+    formatDisk();
+#endif
+    if (!volume.mount()) {
+        return false;
+    }
+
+    usb_msc.setUnitReady(true);
+    if (!usb_msc.begin()) {
+        return false;
+    }
+
+    // Create initial README; the host has not seen the volume yet
+    writeFile(MINT_README_NO_WALLET.text, MINT_README_NO_WALLET.length);
+    media_changed = false;
+    memset(&media_stats, 0, sizeof(media_stats));
+    return true;
+}
+
+void MintStorage::task() {
+#ifdef MINT_STORAGE_FLASH
+    // Write back dirty cache lines in the background
+    disk.task();
+#endif
+
+    // Zero the last handed-over file, a block at a time
+    eraseStep();
+
+    // Hand a completely written user file to the device
+    if (checkNewFile() && file_changed_callback) {
+        file_changed_callback(getFileData(), getFileSize());
+    }
+}
+
+void MintStorage::setFileChangedCallback(FileChangedCallback callback) {
+    file_changed_callback = callback;
+}
+
+void MintStorage::formatDisk() {
+    uint8_t block[DISK_BLOCK_SIZE];
+#ifdef MINT_STORAGE_FLASH
+    static const uint8_t boot_sector[] = {
+        0xEB, 0x3C, 0x90,                       // Jump instruction
+        'M', 'S', 'D', '0', 'S', '5', '.', '0', // MSDOS5.0
+        0x00, 0x02,                             // Bytes per sector = 512
+        FLASH_SECTORS_PER_CLUSTER,              // Sectors per cluster = 16
+        0x01, 0x00,                             // Reserved sectors = 1
+        0x01,                                   // Num of FATs = 1
+        (uint8_t)FLASH_ROOT_ENTRIES, (uint8_t)(FLASH_ROOT_ENTRIES >> 8), // Root entries = 512
+        (uint8_t)DISK_BLOCK_COUNT, (uint8_t)(DISK_BLOCK_COUNT >> 8),     // Num of sectors = 32768
+        0xF8,                                   // Media descriptor = fixed disk
+        FLASH_FAT_BLOCKS, 0x00,                 // Sectors per FAT = 6
+        0x01, 0x00,                             // Sectors per track = 1
+        0x01, 0x00,                             // Num of heads = 1
+        0x00, 0x00, 0x00, 0x00,                // Hidden sectors = 0
+        0x00, 0x00, 0x00, 0x00,                // Total sectors = 0
+        0x80,                                   // Drive number = 0x80
+        0x00,                                   // Reserved = 0
+        0x29,                                   // Extended boot signature = 0x29
+        0x00, 0x00, 0x00, 0x00,                // Volume serial number
+        'M', 'I', 'N', 'T', ' ', 'D', 'E', 'V', 'I', 'C', 'E', // Volume label
+        'F', 'A', 'T', '1', '2', ' ', ' ', ' ' // Filesystem type
+    };
+    memset(block, 0, sizeof(block));
+    memcpy(block, boot_sector, sizeof(boot_sector));
+    block[510] = 0x55;
+    block[511] = 0xAA;
+    writeBlock(0, block);
 
-// Static member initialization
-uint8_t MintStorage::msc_disk[DISK_BLOCK_COUNT][DISK_BLOCK_SIZE] = {
-    // First block contains FAT filesystem
-    {
-        0xEB, 0x3C, 0x90, // Jump instruction
+    // Clusters are left as they are; only the FAT and root are cleared
+    const uint32_t clear_end = FLASH_DATA_START;
+#else
+    static const uint8_t boot_sector[] = {
+        0xEB, 0x3C, 0x90,                       // Jump instruction
         'M', 'S', 'D', '0', 'S', '5', '.', '0', // MSDOS5.0
         0x00, 0x02,                             // Bytes per sector = 512
         0x01,                                   // Sectors per cluster = 1
@@ -26,65 +175,592 @@ uint8_t MintStorage::msc_disk[DISK_BLOCK_COUNT][DISK_BLOCK_SIZE] = {
         0x00, 0x00, 0x00, 0x00,                // Volume serial number
         'M', 'I', 'N', 'T', ' ', 'D', 'E', 'V', 'I', 'C', 'E', // Volume label
         'F', 'A', 'T', '1', '2', ' ', ' ', ' ' // Filesystem type
+    };
+    memset(block, 0, sizeof(block));
+    memcpy(block, boot_sector, sizeof(boot_sector));
+    block[510] = 0x55;
+    block[511] = 0xAA;
+    writeBlock(0, block);
+    const uint32_t clear_end = DISK_BLOCK_COUNT;
+#endif
+
+    // Empty FAT (media byte and end-of-chain in the reserved entries)
+    // and empty root directory
+    for (uint32_t lba = 1; lba < clear_end; lba++) {
+        memset(block, 0, sizeof(block));
+        if (lba == 1) {
+            block[0] = 0xF8;
+            block[1] = 0xFF;
+            block[2] = 0xFF;
+        }
+        writeBlock(lba, block);
     }
-};
+#ifdef MINT_STORAGE_FLASH
+    disk.flush();
+#endif
 
-MintStorage::MintStorage() : last_write_time(0), disk_changed(false) {
-    storage_instance = this;
+    memset(host_written, 0, sizeof(host_written));
+    root_pending = 0;
+    disk_changed = false;
+    erase_cluster = 0;
+    erase_dir_lba = 0;
+    volume.invalidate();
 }
 
-void MintStorage::begin() {
-    // Initialize MSC
-    usb_msc.setID("Mint", "Bearer Device", "1.0");
-    usb_msc.setCapacity(DISK_BLOCK_COUNT, DISK_BLOCK_SIZE);
-    usb_msc.setReadWriteCallback(msc_read_cb, msc_write_cb, nullptr);
-    usb_msc.setUnitReady(true);
-    usb_msc.begin();
+void MintStorage::clearDisk() {
+    formatDisk();
+    signalMediaChange();
+}
 
-    // Create initial README
-    const char* readme = "MINT DEVICE\r\nDrop file for wallet\r\n";
-    writeFile(readme);
+bool MintStorage::readBlock(uint32_t lba, uint8_t* buffer) {
+#ifdef MINT_STORAGE_FLASH
+    return disk.readBlocks(lba, buffer, 1);
+#else
+    if (lba >= DISK_BLOCK_COUNT) {
+        return false;
+    }
+    memcpy(buffer, msc_disk[lba], DISK_BLOCK_SIZE);
+    return true;
+#endif
 }
 
-void MintStorage::clearDisk() {
-    // Clear all blocks except boot sector
-    for(int i = 1; i < DISK_BLOCK_COUNT; i++) {
-        memset(msc_disk[i], 0, DISK_BLOCK_SIZE);
+bool MintStorage::tryReadBlock(uint32_t lba, uint8_t* buffer) {
+#ifdef MINT_STORAGE_FLASH
+    // Fails instead of waiting while write-back has the flash busy
+    return lba < DISK_BLOCK_COUNT && disk.read(lba, buffer, DISK_BLOCK_SIZE) == DISK_BLOCK_SIZE;
+#else
+    return readBlock(lba, buffer);
+#endif
+}
+
+bool MintStorage::writeBlock(uint32_t lba, const uint8_t* buffer) {
+#ifdef MINT_STORAGE_FLASH
+    return disk.writeBlocks(lba, buffer, 1);
+#else
+    if (lba >= DISK_BLOCK_COUNT) {
+        return false;
     }
-    disk_changed = true;
+    memcpy(msc_disk[lba], buffer, DISK_BLOCK_SIZE);
+    return true;
+#endif
+}
+
+bool MintStorage::tryWriteBlock(uint32_t lba, const uint8_t* buffer) {
+#ifdef MINT_STORAGE_FLASH
+    // Fails instead of waiting while every cache line is dirty
+    return lba < DISK_BLOCK_COUNT && disk.write(lba, buffer, DISK_BLOCK_SIZE) == DISK_BLOCK_SIZE;
+#else
+    return writeBlock(lba, buffer);
+#endif
+}
+
+bool MintStorage::updateBlock(uint32_t lba, const uint8_t* buffer, bool& changed) {
+    uint8_t current[DISK_BLOCK_SIZE];
+    if (readBlock(lba, current) && memcmp(current, buffer, DISK_BLOCK_SIZE) == 0) {
+        return true;
+    }
+    changed = true;
+    return writeBlock(lba, buffer);
+}
+
+void MintStorage::signalMediaChange() {
+    // Latency runs from the oldest change the host has not re-read
+    if (!media_changed && !awaiting_reload) {
+        media_changed_us = micros();
+    }
+    media_changed = true;
+    media_stats.changes++;
 }
 
 void MintStorage::writeFile(const char* content) {
-    // Write to block 1 (after boot sector)
-    size_t len = strlen(content);
-    memcpy(msc_disk[1], content, min(len, (size_t)DISK_BLOCK_SIZE));
-    disk_changed = true;
+    writeFile(content, strlen(content));
+}
+
+void MintStorage::writeFile(const char* content, size_t length) {
+    writeDeviceFile(0, README_NAME, README_CLUSTER, (const uint8_t*)content,
+                    min(length, (size_t)DISK_BLOCK_SIZE));
+}
+
+bool MintStorage::writeProof(const uint8_t* data, size_t length) {
+    // Hosts stop listing at the first never-used entry, so the proof goes
+    // in its old entry or the first free one. Hosts allocate clusters from
+    // the front, so it takes the last cluster.
+    const MintFatGeometry& geometry = volume.getGeometry();
+    const uint32_t none = geometry.root_entries;
+    uint8_t dir[DISK_BLOCK_SIZE];
+    uint32_t index = none;
+    uint32_t free_index = none;
+    bool end = false;
+    for (uint32_t s = 0; s < geometry.root_sectors && !end && index == none; s++) {
+        if (!readBlock(geometry.root_start + s, dir)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < FAT_DIR_ENTRIES_PER_SECTOR; i++) {
+            const uint8_t* entry = dir + i * FAT_DIR_ENTRY_SIZE;
+            const uint32_t n = s * FAT_DIR_ENTRIES_PER_SECTOR + i;
+            if (memcmp(entry, PROOF_NAME, 11) == 0) {
+                index = n;
+                break;
+            }
+            if (free_index == none && (entry[0] == FAT_DIR_END || entry[0] == FAT_DIR_DELETED)) {
+                free_index = n;
+            }
+            if (entry[0] == FAT_DIR_END) {
+                end = true;
+                break;
+            }
+        }
+    }
+    if (index == none) {
+        index = free_index;
+    }
+    if (index == none) {
+        MINT_LOG("no root entry left for the proof");
+        return false;
+    }
+
+    uint16_t cluster = (uint16_t)(geometry.cluster_count + FAT_FIRST_CLUSTER - 1);
+    while ((cluster + cluster / 2) % DISK_BLOCK_SIZE == DISK_BLOCK_SIZE - 1) {
+        cluster--;  // Keep its FAT entry within one sector
+    }
+    return writeDeviceFile(index, PROOF_NAME, cluster, data, min(length, (size_t)DISK_BLOCK_SIZE));
+}
+
+bool MintStorage::writeDeviceFile(uint32_t index, const char* name, uint16_t cluster,
+                                  const uint8_t* content, size_t len) {
+    const MintFatGeometry& geometry = volume.getGeometry();
+    const uint32_t dir_lba = geometry.root_start + index / FAT_DIR_ENTRIES_PER_SECTOR;
+    const uint32_t fat_sector = (cluster + cluster / 2) / DISK_BLOCK_SIZE;
+    const uint32_t fat_lba = geometry.fat_start + fat_sector;
+    uint8_t dir[DISK_BLOCK_SIZE];
+    uint8_t fat[DISK_BLOCK_SIZE];
+    uint8_t data[DISK_BLOCK_SIZE];
+    if (!readBlock(dir_lba, dir) || !readBlock(fat_lba, fat)) {
+        return false;
+    }
+
+    // Leave the entry and cluster alone if the host gave either to a file
+    uint8_t* entry = dir + (index % FAT_DIR_ENTRIES_PER_SECTOR) * FAT_DIR_ENTRY_SIZE;
+    bool ours = memcmp(entry, name, 11) == 0;
+    bool free_entry = entry[0] == FAT_DIR_END || entry[0] == FAT_DIR_DELETED;
+    uint16_t next = MintFatVolume::getFat12(fat, cluster, fat_sector * DISK_BLOCK_SIZE);
+    bool claimable = ours ? (next == FAT12_FREE || next >= FAT12_EOC_MIN) :
+                            (free_entry && next == FAT12_FREE);
+    if (!claimable) {
+        return false;
+    }
+
+    // Data, then FAT, then directory entry
+    bool changed = false;
+    bool ok = true;
+    memset(data, 0, sizeof(data));
+    memcpy(data, content, len);
+    ok &= updateBlock(volume.clusterToSector(cluster), data, changed);
+
+    MintFatVolume::setFat12(fat, cluster, FAT12_EOC, fat_sector * DISK_BLOCK_SIZE);
+    ok &= updateBlock(fat_lba, fat, changed);
+
+    memset(entry, 0, FAT_DIR_ENTRY_SIZE);
+    memcpy(entry, name, 11);
+    entry[11] = FAT_ATTR_READ_ONLY;
+    entry[26] = (uint8_t)cluster;
+    entry[27] = (uint8_t)(cluster >> 8);
+    entry[28] = (uint8_t)len;
+    entry[29] = (uint8_t)(len >> 8);
+    ok &= updateBlock(dir_lba, dir, changed);
+
+    // The host has the old contents cached; have it re-read the volume
+    if (changed) {
+        signalMediaChange();
+    }
+    return ok;
 }
 
 uint8_t* MintStorage::getFileData() {
-    // Return block 3 where uploaded file data typically lands
-    return (uint8_t*)&msc_disk[3][0];
+    return file_buffer;
+}
+
+size_t MintStorage::getFileSize() const {
+    return file_size;
+}
+
+MediaChangeStats MintStorage::getMediaChangeStats() const {
+    return media_stats;
+}
+
+bool MintStorage::measureCallbackLatency(uint32_t rounds, CallbackLatency& latency) {
+    memset(&latency, 0, sizeof(latency));
+#ifdef ARDUINO_ARCH_RP2040
+    uint8_t sector[DISK_BLOCK_SIZE];
+    if (!rounds || !readBlock(0, sector)) {
+        return false;
+    }
+    // The write marks the sector as host-written; put that back after
+    const uint8_t written = host_written[0];
+    const bool changed = disk_changed;
+
+    // SysTick counts core clock cycles down from 2^24
+    const uint32_t systick_csr = systick_hw->csr;
+    const uint32_t systick_rvr = systick_hw->rvr;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+
+    uint64_t read_total = 0;
+    uint64_t write_total = 0;
+    for (uint32_t i = 0; i < rounds; i++) {
+        for (int write = 0; write < 2; write++) {
+            xip_ctrl_hw->flush = 1;
+            (void)xip_ctrl_hw->flush; // Reads back once the flush is done
+            const uint32_t irq = save_and_disable_interrupts();
+            const uint32_t start = systick_hw->cvr;
+            if (write) {
+                msc_write_cb(0, sector, DISK_BLOCK_SIZE);
+            } else {
+                msc_read_cb(0, sector, DISK_BLOCK_SIZE);
+            }
+            const uint32_t cycles = (start - systick_hw->cvr) & 0x00FFFFFF;
+            restore_interrupts(irq);
+            if (write) {
+                write_total += cycles;
+                latency.write_max_cycles = max(latency.write_max_cycles, cycles);
+            } else {
+                read_total += cycles;
+                latency.read_max_cycles = max(latency.read_max_cycles, cycles);
+            }
+        }
+    }
+
+    systick_hw->csr = systick_csr;
+    systick_hw->rvr = systick_rvr;
+    host_written[0] = written;
+    disk_changed = changed;
+
+    latency.rounds = rounds;
+    latency.read_mean_cycles = (uint32_t)(read_total / rounds);
+    latency.write_mean_cycles = (uint32_t)(write_total / rounds);
+    return true;
+#else
+    (void)rounds;
+    return false;
+#endif
+}
+
+MINT_RAM_FUNC(note_host_read)
+void MintStorage::noteHostRead(uint32_t lba, uint32_t count) {
+    // The first README read after the attention shows the new text
+    const uint32_t readme = volume.clusterToSector(README_CLUSTER);
+    if (!awaiting_reload || media_changed || readme < lba || readme >= lba + count) {
+        return;
+    }
+    awaiting_reload = false;
+    media_stats.reloads++;
+    media_stats.last_latency_us = micros() - media_changed_us;
+    media_stats.max_latency_us = max(media_stats.max_latency_us, media_stats.last_latency_us);
+    MINT_LOG("host re-read the README after %u us", media_stats.last_latency_us);
+}
+
+MINT_RAM_FUNC(note_host_write)
+void MintStorage::noteHostWrite(uint32_t lba, uint32_t count) {
+    const MintFatGeometry& geometry = volume.getGeometry();
+    for (uint32_t block = lba; block < lba + count && block < DISK_BLOCK_COUNT; block++) {
+        host_written[block / 8] |= 1 << (block % 8);
+        if (block >= geometry.root_start && block < geometry.root_start + geometry.root_sectors &&
+            block - geometry.root_start < 32) {
+            root_pending |= 1UL << (block - geometry.root_start);
+        }
+    }
+    disk_changed = true;
+}
+
+bool MintStorage::isHostWritten(uint32_t lba) const {
+    return lba < DISK_BLOCK_COUNT && (host_written[lba / 8] & (1 << (lba % 8)));
+}
+
+MintStorage::FileStatus MintStorage::checkFile(const MintFatEntry& entry) {
+    const MintFatGeometry& geometry = volume.getGeometry();
+    const uint32_t cluster_bytes = (uint32_t)geometry.sectors_per_cluster * DISK_BLOCK_SIZE;
+    if (entry.size == 0 || !volume.isValidCluster(entry.start_cluster)) {
+        return FILE_INCOMPLETE;
+    }
+    uint32_t clusters = (entry.size + cluster_bytes - 1) / cluster_bytes;
+    if (clusters > geometry.cluster_count) {
+        return FILE_INCOMPLETE;
+    }
+
+    // Every sector the size covers was written, and the chain ends where
+    // the size says it does
+    uint16_t cluster = entry.start_cluster;
+    uint32_t remaining = entry.size;
+    for (uint32_t i = 0; i < clusters; i++) {
+        if (!volume.isValidCluster(cluster)) {
+            return FILE_INCOMPLETE;
+        }
+        uint32_t first = volume.clusterToSector(cluster);
+        uint32_t sectors = min((remaining + DISK_BLOCK_SIZE - 1) / DISK_BLOCK_SIZE,
+                               (uint32_t)geometry.sectors_per_cluster);
+        for (uint32_t s = 0; s < sectors; s++) {
+            if (!isHostWritten(first + s)) {
+                return FILE_INCOMPLETE;
+            }
+        }
+        remaining -= min(remaining, cluster_bytes);
+
+        uint16_t next;
+        if (!volume.readFatEntry(cluster, next)) {
+            return FILE_RETRY;
+        }
+        if (i + 1 == clusters) {
+            return next >= FAT12_EOC_MIN ? FILE_COMPLETE : FILE_INCOMPLETE;
+        }
+        cluster = next;
+    }
+    return FILE_INCOMPLETE;
+}
+
+void MintStorage::eraseStep() {
+    if (!erase_cluster) {
+        return;
+    }
+    const MintFatGeometry& geometry = volume.getGeometry();
+    uint8_t block[DISK_BLOCK_SIZE];
+
+    // Directory entry first: a host reading part way through sees no
+    // file rather than one of zeros
+    if (erase_dir_lba) {
+        if (!tryReadBlock(erase_dir_lba, block)) {
+            return;
+        }
+        uint8_t* entry = block + erase_index * FAT_DIR_ENTRY_SIZE;
+        memset(entry, 0, FAT_DIR_ENTRY_SIZE);
+        entry[0] = FAT_DIR_DELETED;
+        if (tryWriteBlock(erase_dir_lba, block)) {
+            erase_dir_lba = 0;
+        }
+        return;
+    }
+
+    // Then each cluster of the chain: the sectors the host wrote, then
+    // its FAT entry
+    const uint32_t cluster_bytes = (uint32_t)geometry.sectors_per_cluster * DISK_BLOCK_SIZE;
+    const uint32_t sectors = (min(erase_remaining, cluster_bytes) + DISK_BLOCK_SIZE - 1) /
+                             DISK_BLOCK_SIZE;
+    if (erase_sector < sectors) {
+        const uint32_t lba = volume.clusterToSector(erase_cluster) + erase_sector;
+        memset(block, 0, sizeof(block));
+        if (tryWriteBlock(lba, block)) {
+            host_written[lba / 8] &= ~(1 << (lba % 8));
+            erase_sector++;
+        }
+        return;
+    }
+    if (!erase_next) {
+        uint16_t next;
+        if (!volume.readFatEntry(erase_cluster, next)) {
+            return;
+        }
+        erase_next = next == FAT12_FREE ? FAT12_EOC : next;
+        return;
+    }
+
+    // Free the entry by masking out its 12 bits, which may span two FAT
+    // sectors; a retry after one of them was written clears nothing new
+    const uint32_t offset = erase_cluster + erase_cluster / 2;
+    const uint8_t keep[2] = { (uint8_t)((erase_cluster & 1) ? 0x0F : 0x00),
+                              (uint8_t)((erase_cluster & 1) ? 0x00 : 0xF0) };
+    for (uint32_t fat_sector = offset / DISK_BLOCK_SIZE;
+         fat_sector <= (offset + 1) / DISK_BLOCK_SIZE; fat_sector++) {
+        const uint32_t lba = geometry.fat_start + fat_sector;
+        if (!tryReadBlock(lba, block)) {
+            return;
+        }
+        for (uint32_t k = 0; k < 2; k++) {
+            if ((offset + k) / DISK_BLOCK_SIZE == fat_sector) {
+                block[(offset + k) % DISK_BLOCK_SIZE] &= keep[k];
+            }
+        }
+        if (!tryWriteBlock(lba, block)) {
+            return;
+        }
+    }
+    volume.invalidate();
+
+    erase_cluster = volume.isValidCluster(erase_next) ? erase_next : 0;
+    erase_next = 0;
+    erase_sector = 0;
+    erase_remaining -= min(erase_remaining, cluster_bytes);
+    if (!erase_cluster) {
+        // The host has the file cached; have it re-read the volume
+        MINT_LOG("host file erased");
+        signalMediaChange();
+    }
 }
 
 bool MintStorage::checkNewFile() {
-    if (disk_changed && (millis() - last_write_time > 1000)) {
-        disk_changed = false;
-        return true;
+    // A file handed over is zeroed before the next one is looked for
+    if (!disk_changed || erase_cluster) {
+        return false;
+    }
+    disk_changed = false;
+    volume.invalidate();
+
+    // Scan root sectors the host wrote, and those holding files that were
+    // still incomplete at the last scan
+    const MintFatGeometry& geometry = volume.getGeometry();
+    uint8_t sector[DISK_BLOCK_SIZE];
+    uint32_t pending = root_pending;
+    root_pending = 0;
+    for (uint32_t s = 0; s < geometry.root_sectors && s < 32 && pending; s++) {
+        uint32_t bit = 1UL << s;
+        if (!(pending & bit)) {
+            continue;
+        }
+        pending &= ~bit;
+        if (!tryReadBlock(geometry.root_start + s, sector)) {
+            root_pending |= bit | pending;
+            disk_changed = true;
+            return false;
+        }
+
+        for (size_t i = 0; i < FAT_DIR_ENTRIES_PER_SECTOR; i++) {
+            MintFatEntry entry;
+            MintFatVolume::EntryKind kind = MintFatVolume::parseDirEntry(sector, i, entry);
+            if (kind == MintFatVolume::ENTRY_END) {
+                // Nothing follows, in this sector or the next ones
+                pending = 0;
+                break;
+            }
+            if (kind != MintFatVolume::ENTRY_VALID || MintFatVolume::isMetadata(entry)) {
+                continue;
+            }
+
+            FileStatus status = checkFile(entry);
+            if (status == FILE_COMPLETE) {
+                if (!tryReadBlock(volume.clusterToSector(entry.start_cluster), file_buffer)) {
+                    status = FILE_RETRY;
+                } else {
+                    // Hand over the start of the file, without slack bytes
+                    file_size = min(entry.size, (uint32_t)DISK_BLOCK_SIZE);
+                    memset(file_buffer + file_size, 0, DISK_BLOCK_SIZE - file_size);
+                    MINT_LOG("host file complete, %u bytes", entry.size);
+                    // Handed over once: it only counts again once the
+                    // host writes its first sector again
+                    const uint32_t first = volume.clusterToSector(entry.start_cluster);
+                    host_written[first / 8] &= ~(1 << (first % 8));
+
+                    // The copy is all the device needs; the flash disk
+                    // would otherwise keep the file across power cycles
+                    erase_cluster = entry.start_cluster;
+                    erase_next = 0;
+                    erase_sector = 0;
+                    erase_remaining = entry.size;
+                    erase_index = (uint8_t)i;
+                    erase_dir_lba = geometry.root_start + s;
+
+                    // Look at the rest on the next run
+                    root_pending |= bit | pending;
+                    disk_changed = true;
+                    return true;
+                }
+            }
+            root_pending |= bit;
+            if (status == FILE_RETRY) {
+                disk_changed = true;
+            }
+        }
     }
     return false;
 }
 
 // Static callbacks
+MINT_RAM_FUNC(callback_instance)
+MintStorage* MintStorage::callbackInstance() {
+#ifdef ARDUINO_ARCH_RP2040
+    return storage_instance;
+#else
+    Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::active();
+    return msc ? static_cast<MintStorage*>(msc->getOwner()) : nullptr;
+#endif
+}
+
+MINT_RAM_FUNC(msc_ready_cb)
+bool MintStorage::msc_ready_cb() {
+    MintStorage* storage = callbackInstance();
+    if (!storage || !storage->media_changed) {
+        return true;
+    }
+
+    // Fail this TEST UNIT READY once; the host asks for the sense, drops
+    // its cached sectors and reads the volume again
+    storage->media_changed = false;
+    storage->awaiting_reload = true;
+    storage->media_stats.attentions++;
+    tud_msc_set_sense(0, SCSI_SENSE_UNIT_ATTENTION, SENSE_ASC_MEDIUM_CHANGED,
+                      SENSE_ASCQ_MEDIUM_CHANGED);
+    return false;
+}
+
+#ifdef MINT_STORAGE_FLASH
+MINT_RAM_FUNC(msc_read_cb)
 int32_t MintStorage::msc_read_cb(uint32_t lba, void* buffer, uint32_t bufsize) {
-    memcpy(buffer, msc_disk[lba], bufsize);
+    MintStorage* storage = callbackInstance();
+    if (!storage) {
+        return -1;
+    }
+
+    // 0 tells TinyUSB to retry while write-back has the flash busy
+    int32_t read = storage->disk.read(lba, buffer, bufsize);
+    if (read > 0) {
+        storage->noteHostRead(lba, read / DISK_BLOCK_SIZE);
+    }
+    return read;
+}
+
+MINT_RAM_FUNC(msc_write_cb)
+int32_t MintStorage::msc_write_cb(uint32_t lba, uint8_t* buffer, uint32_t bufsize) {
+    MintStorage* storage = callbackInstance();
+    if (!storage) {
+        return -1;
+    }
+    int32_t written = storage->disk.write(lba, buffer, bufsize);
+    if (written > 0) {
+        MINT_TRACE(TRACE_EVENT_USB_WRITE, lba, buffer, written);
+        storage->noteHostWrite(lba, written / DISK_BLOCK_SIZE);
+    }
+    return written;
+}
+
+void MintStorage::msc_flush_cb() {
+    MintStorage* storage = callbackInstance();
+    if (storage) {
+        storage->disk.requestFlush();
+    }
+}
+#else
+MINT_RAM_FUNC(msc_read_cb)
+int32_t MintStorage::msc_read_cb(uint32_t lba, void* buffer, uint32_t bufsize) {
+    MintStorage* storage = callbackInstance();
+    if (!storage) {
+        return -1;
+    }
+    memcpy(buffer, storage->msc_disk[lba], bufsize);
+    storage->noteHostRead(lba, bufsize / DISK_BLOCK_SIZE);
     return bufsize;
 }
 
+MINT_RAM_FUNC(msc_write_cb)
 int32_t MintStorage::msc_write_cb(uint32_t lba, uint8_t* buffer, uint32_t bufsize) {
-    memcpy(msc_disk[lba], buffer, bufsize);
-    if (storage_instance) {
-        storage_instance->last_write_time = millis();
-        storage_instance->disk_changed = true;
+    MintStorage* storage = callbackInstance();
+    if (!storage) {
+        return -1;
     }
+    MINT_TRACE(TRACE_EVENT_USB_WRITE, lba, buffer, bufsize);
+    memcpy(storage->msc_disk[lba], buffer, bufsize);
+    storage->noteHostWrite(lba, bufsize / DISK_BLOCK_SIZE);
     return bufsize;
-}
\ No newline at end of file
+}
+
+void MintStorage::msc_flush_cb() {
+    // The RAM disk has nothing to write back
+}
+#endif
@@ -3,27 +3,170 @@
 
 #include <Arduino.h>
 #include <Adafruit_TinyUSB.h>
+#include <functional>
+#include "mint_fat.h"
+#ifdef MINT_STORAGE_FLASH
+#include "mint_flash.h"
+#endif
 
+/**
+ * README reloads signalled to the host.
+ */
+typedef struct {
+    uint32_t changes;               // README changes since boot
+    uint32_t attentions;            // Unit attentions reported to the host
+    uint32_t reloads;               // Host re-read the README after one
+    uint32_t last_latency_us;       // README change to host re-read
+    uint32_t max_latency_us;
+} MediaChangeStats;
+
+/**
+ * MSC callback times, each call started with a cold XIP cache.
+ */
+typedef struct {
+    uint32_t rounds;                // Calls timed per callback
+    uint32_t read_max_cycles;       // msc_read_cb, one sector
+    uint32_t read_mean_cycles;
+    uint32_t write_max_cycles;      // msc_write_cb, one sector
+    uint32_t write_mean_cycles;
+} CallbackLatency;
+
+/**
+ * USB mass storage with a FAT12 volume holding README.TXT.
+ *
+ * Host writes are followed through the root directory and the FAT: a user
+ * file is handed to the device as soon as every sector its directory entry
+ * covers has been written and its cluster chain is terminated, so there is
+ * no quiet period to wait out. Files hosts create on their own (.DS_Store,
+ * ._ files, Spotlight and fseventsd folders, System Volume Information,
+ * desktop.ini) are ignored. Once handed over, the file's sectors are
+ * zeroed and its entry and clusters freed, a block per task run, so the
+ * flash volume does not keep it across power cycles.
+ *
+ * Hosts cache the volume, so when README.TXT changes the next TEST UNIT
+ * READY fails with a UNIT ATTENTION, MEDIUM MAY HAVE CHANGED sense and
+ * the host re-reads the volume. Rewriting an unchanged README signals
+ * nothing. PROOF.BIN, the answer to an ownership challenge, is written
+ * and signalled the same way.
+ */
 class MintStorage {
 public:
+    typedef std::function<void(uint8_t* buffer, size_t size)> FileChangedCallback;
+
     MintStorage();
-    void begin();
+    bool begin();
+    void task();
+    void setFileChangedCallback(FileChangedCallback callback);
+
+    /**
+     * Look for a user file the host has finished writing.
+     * @return true if one was found; getFileData() then holds its start
+     */
     bool checkNewFile();
+
     void clearDisk();
+
+    /**
+     * Write README.TXT. Sectors are only rewritten if they changed.
+     * @param content README text (up to one sector)
+     */
     void writeFile(const char* content);
+
+    /**
+     * Write README.TXT from a rendered sector (mint_readme.h).
+     * @param content README sector
+     * @param length README file size (up to one sector)
+     */
+    void writeFile(const char* content, size_t length);
+
+    /**
+     * Write PROOF.BIN, the response to an ownership challenge.
+     * @param data Proof contents
+     * @param length Proof length (up to one sector)
+     * @return true if written, false if the host took its entry or cluster
+     */
+    bool writeProof(const uint8_t* data, size_t length);
+
     uint8_t* getFileData();
-    
+
+    /**
+     * Get the number of bytes of the last detected file in getFileData().
+     * @return Bytes (the file size, up to one sector)
+     */
+    size_t getFileSize() const;
+
+    /**
+     * Get README change signalling counters and latency.
+     * @return Statistics since boot
+     */
+    MediaChangeStats getMediaChangeStats() const;
+
+    /**
+     * Time the MSC read and write callbacks on the boot sector, flushing
+     * the XIP cache before each call, with interrupts off so only the
+     * callback is counted. The sector is written back unchanged.
+     * @param rounds Calls per callback
+     * @param latency Output cycle counts
+     * @return true if measured, false on builds without an XIP cache
+     */
+    bool measureCallbackLatency(uint32_t rounds, CallbackLatency& latency);
+
 private:
     static const uint16_t DISK_BLOCK_SIZE = 512;
-    static const uint16_t DISK_BLOCK_COUNT = 16;
-    static uint8_t msc_disk[DISK_BLOCK_COUNT][DISK_BLOCK_SIZE];  // Mock storage
+#ifdef MINT_STORAGE_FLASH
+    // 16 MB FAT12 volume on the W25Q128JV, 8 KB clusters
+    static const uint32_t DISK_BLOCK_COUNT = FLASH_CAPACITY / DISK_BLOCK_SIZE;
+    MintFlashDisk disk;
+#else
+    static const uint32_t DISK_BLOCK_COUNT = 16;
+    uint8_t msc_disk[DISK_BLOCK_COUNT][DISK_BLOCK_SIZE];  // RAM volume
+#endif
+    typedef enum {
+        FILE_INCOMPLETE,    // Not all of it written yet
+        FILE_COMPLETE,      // Every sector written, chain terminated
+        FILE_RETRY          // The disk was busy; check again later
+    } FileStatus;
+
     Adafruit_USBD_MSC usb_msc;
-    unsigned long last_write_time;
-    bool disk_changed;
+    MintFatVolume volume;
+    bool disk_changed;                      // Host wrote since the last scan
+    uint32_t root_pending;                  // Root sectors to scan, one bit each
+    uint8_t host_written[(DISK_BLOCK_COUNT + 7) / 8];  // Blocks the host wrote since a hand-over
+    uint8_t file_buffer[DISK_BLOCK_SIZE];
+    size_t file_size;
+    uint16_t erase_cluster;                 // Cluster of a handed-over file being zeroed, 0 if none
+    uint16_t erase_next;                    // Its successor, 0 until read from the FAT
+    uint8_t erase_sector;                   // Next sector of it to zero
+    uint32_t erase_remaining;               // File bytes from the start of the cluster
+    uint8_t erase_index;                    // Directory entry of the file
+    uint32_t erase_dir_lba;                 // Root sector holding it, 0 once cleared
+    bool media_changed;                     // Unit attention not yet reported
+    bool awaiting_reload;                   // Reported; host has not re-read yet
+    uint32_t media_changed_us;              // First change the host has not seen
+    MediaChangeStats media_stats;
+    FileChangedCallback file_changed_callback;
 
     void formatDisk();
+    bool readBlock(uint32_t lba, uint8_t* buffer);
+    bool tryReadBlock(uint32_t lba, uint8_t* buffer);
+    bool writeBlock(uint32_t lba, const uint8_t* buffer);
+    bool tryWriteBlock(uint32_t lba, const uint8_t* buffer);
+    bool updateBlock(uint32_t lba, const uint8_t* buffer, bool& changed);
+    bool writeDeviceFile(uint32_t index, const char* name, uint16_t cluster,
+                         const uint8_t* content, size_t len);
+    void signalMediaChange();
+    void noteHostRead(uint32_t lba, uint32_t count);
+    void noteHostWrite(uint32_t lba, uint32_t count);
+    bool isHostWritten(uint32_t lba) const;
+    FileStatus checkFile(const MintFatEntry& entry);
+    void eraseStep();
+
+    // Storage the running MSC callback is for
+    static MintStorage* callbackInstance();
     static int32_t msc_read_cb(uint32_t lba, void* buffer, uint32_t bufsize);
     static int32_t msc_write_cb(uint32_t lba, uint8_t* buffer, uint32_t bufsize);
+    static void msc_flush_cb();
+    static bool msc_ready_cb();
 };
 
 #endif // MINT_STORAGE_H
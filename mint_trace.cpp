@@ -0,0 +1,65 @@
+#include "mint_trace.h"
+
+#ifdef MINT_TRACE_ENABLED
+
+#define TRACE_HEADER_SIZE 5
+#define TRACE_VARINT_MAX 5
+
+static uint8_t trace_buffer[MINT_TRACE_BUFFER_SIZE] = {'M', 'T', 'R', 'C', MINT_TRACE_VERSION};
+static size_t trace_used = TRACE_HEADER_SIZE;
+static uint32_t trace_dropped = 0;
+static unsigned long trace_last_us = 0;  // Boot, or the last clear()
+
+static size_t putVarint(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+void MintTrace::record(uint8_t event, uint32_t arg, const uint8_t* data, size_t length) {
+    unsigned long now = micros();
+
+    // Worst-case record size: event byte, three varints and the payload
+    if (trace_used + 1 + 3 * TRACE_VARINT_MAX + length > sizeof(trace_buffer)) {
+        trace_dropped++;
+        return;
+    }
+
+    uint8_t* out = trace_buffer + trace_used;
+    size_t n = 0;
+    out[n++] = event;
+    n += putVarint(out + n, (uint32_t)(now - trace_last_us));
+    n += putVarint(out + n, arg);
+    n += putVarint(out + n, (uint32_t)length);
+    if (data && length) {
+        memcpy(out + n, data, length);
+        n += length;
+    }
+
+    trace_used += n;
+    trace_last_us = now;
+}
+
+const uint8_t* MintTrace::data() {
+    return trace_buffer;
+}
+
+size_t MintTrace::size() {
+    return trace_used;
+}
+
+uint32_t MintTrace::dropped() {
+    return trace_dropped;
+}
+
+void MintTrace::clear() {
+    trace_used = TRACE_HEADER_SIZE;
+    trace_dropped = 0;
+    trace_last_us = micros();
+}
+
+#endif // MINT_TRACE_ENABLED
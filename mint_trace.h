@@ -0,0 +1,110 @@
+#ifndef MINT_TRACE_H
+#define MINT_TRACE_H
+
+#include <Arduino.h>
+
+/**
+ * I/O trace recorder for deterministic replay.
+ *
+ * Compiled in only when MINT_TRACE_ENABLED is defined. Captures USB sector
+ * writes, tamper pin transitions, SE050 results, device state changes,
+ * scheduler deadline overruns and the entropy estimated for each file
+ * taken for a wallet, with timestamps, into a compact binary log held in
+ * RAM.
+ *
+ * Log format: "MTRC" magic, one version byte, then records of
+ *   [event u8][delta_us varint][arg varint][length varint][data]
+ * where delta_us is the time since the previous record (the first record
+ * is timed from boot, or from the last clear()).
+ *
+ * Traces contain the user's entropy file. Trace builds are for bench
+ * devices only and must never ship to users. Secret SE050 outputs
+ * (TRNG bytes, private keys) are never recorded.
+ */
+
+#ifndef MINT_TRACE_BUFFER_SIZE
+#define MINT_TRACE_BUFFER_SIZE 16384
+#endif
+
+#define MINT_TRACE_VERSION 1
+
+/**
+ * Trace event types
+ */
+typedef enum {
+    TRACE_EVENT_USB_WRITE = 1,   // arg = LBA, data = sector contents
+    TRACE_EVENT_CIRCUIT = 2,     // arg = raw tamper pin level
+    TRACE_EVENT_SE050 = 3,       // arg = (op << 1) | success, data = public response
+    TRACE_EVENT_STATE = 4,       // arg = MintDevice::MintState entered
+    TRACE_EVENT_OVERRUN = 5,     // arg = scheduler task index, data = response time (u32 us)
+    TRACE_EVENT_ENTROPY_FILE = 6, // arg = bits credited to the file, data = most common value,
+                                  // Markov and compression estimates (u16 millibits per byte each)
+    TRACE_EVENT_CIRCUIT_STATE = 7 // arg = MintCircuit::CircuitState confirmed
+} MintTraceEvent;
+
+/**
+ * SE050 operations recorded in TRACE_EVENT_SE050
+ */
+typedef enum {
+    TRACE_SE050_BEGIN = 1,
+    TRACE_SE050_RANDOM = 2,
+    TRACE_SE050_SHA256 = 3,
+    TRACE_SE050_OBJECT_EXISTS = 4,
+    TRACE_SE050_DELETE = 5,
+    TRACE_SE050_CREATE_KEY = 6,
+    TRACE_SE050_PUBLIC_KEY = 7,
+    TRACE_SE050_PRIVATE_KEY = 8,
+    TRACE_SE050_READ_MEMORY = 9,
+    TRACE_SE050_WRITE_OTP = 10,
+    TRACE_SE050_READ_OBJECT = 11,
+    TRACE_SE050_WRITE_OBJECT = 12,
+    TRACE_SE050_SIGN = 13
+} MintTraceSE050Op;
+
+#define MINT_TRACE_SE050_ARG(op, ok) (((uint32_t)(op) << 1) | ((ok) ? 1 : 0))
+
+/**
+ * RAM trace log. Records that do not fit are dropped and counted.
+ */
+class MintTrace {
+public:
+    /**
+     * Append one record to the log.
+     * @param event Event type (MintTraceEvent)
+     * @param arg Event argument
+     * @param data Optional payload
+     * @param length Payload length
+     */
+    static void record(uint8_t event, uint32_t arg, const uint8_t* data, size_t length);
+
+    /**
+     * Get the encoded log, including the header.
+     * @return Pointer to log bytes
+     */
+    static const uint8_t* data();
+
+    /**
+     * Get the encoded log size in bytes.
+     * @return Number of valid bytes returned by data()
+     */
+    static size_t size();
+
+    /**
+     * Get the number of records dropped because the log was full.
+     * @return Dropped record count
+     */
+    static uint32_t dropped();
+
+    /**
+     * Discard all records; the next record is timed from now.
+     */
+    static void clear();
+};
+
+#ifdef MINT_TRACE_ENABLED
+#define MINT_TRACE(event, arg, data, length) MintTrace::record((event), (arg), (data), (length))
+#else
+#define MINT_TRACE(event, arg, data, length) do { } while (0)
+#endif
+
+#endif // MINT_TRACE_H
@@ -1,7 +1,9 @@
 #include "mint_wallet.h"
+#include "mint_memory.h"
 #include <string.h>
 
 // Base58 character set
+MINT_RAM_DATA(base58_chars)
 static const char BASE58_CHARS[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 
 // Network byte for Bitcoin mainnet private key (0x80)
@@ -11,14 +13,16 @@ static const uint8_t WIF_PREFIX = 0x80;
 static const uint8_t SEGWIT_V0_PREFIX = 0x00;
 static const uint8_t SEGWIT_V0_PROGRAM_LENGTH = 0x14; // 20 bytes
 
-MintWallet::MintWallet(MintSecure& secure_element) : 
+template <class Secure>
+MintWalletT<Secure>::MintWalletT(Secure& secure_element) : 
     secure(secure_element),
     wallet_generated(false) {
     memset(bitcoin_address, 0, sizeof(bitcoin_address));
     memset(private_key_wif, 0, sizeof(private_key_wif));
 }
 
-bool MintWallet::begin() {
+template <class Secure>
+bool MintWalletT<Secure>::begin() {
     // Initialize wallet state
     wallet_generated = secure.hasWallet();
     
@@ -30,7 +34,8 @@ bool MintWallet::begin() {
     return true;
 }
 
-bool MintWallet::generateFromEntropy(const uint8_t* entropy, size_t size) {
+template <class Secure>
+bool MintWalletT<Secure>::generateFromEntropy(const uint8_t* entropy, size_t size) {
     // Verify parameters
     if (!entropy || (size != 16 && size != 24 && size != 32)) {
         return false;
@@ -49,13 +54,83 @@ bool MintWallet::generateFromEntropy(const uint8_t* entropy, size_t size) {
     return true;
 }
 
-String MintWallet::getPublicAddress(const char* path) {
+template <class Secure>
+bool MintWalletT<Secure>::startGeneration(const uint8_t* entropy, size_t size) {
+    // Verify parameters
+    if (!entropy || (size != 16 && size != 24 && size != 32)) {
+        return false;
+    }
+    
+    return secure.startWalletGeneration(entropy, size);
+}
+
+template <class Secure>
+MintSecureTypes::JobStatus MintWalletT<Secure>::pollGeneration() {
+    MintSecureTypes::JobStatus status = secure.pollJob();
+    if (status == MintSecureTypes::JOB_PENDING) {
+        return status;
+    }
+    
+    status = secure.completeJob();
+    if (status == MintSecureTypes::JOB_DONE) {
+        wallet_generated = true;
+        
+        // Generate default address
+        getPublicAddress();
+    }
+    
+    return status;
+}
+
+template <class Secure>
+bool MintWalletT<Secure>::startOwnershipProof(const uint8_t* challenges, size_t count) {
+    if (!wallet_generated) {
+        return false;
+    }
+    
+    return secure.startOwnershipProof(challenges, count);
+}
+
+template <class Secure>
+MintSecureTypes::JobStatus MintWalletT<Secure>::pollOwnershipProof(uint8_t* proof,
+                                                                   size_t proof_size,
+                                                                   size_t& proof_len) {
+    MintSecureTypes::JobStatus status = secure.pollJob();
+    if (status == MintSecureTypes::JOB_PENDING) {
+        return status;
+    }
+    
+    status = secure.completeJob();
+    if (status != MintSecureTypes::JOB_DONE) {
+        return status;
+    }
+    
+    // Header, the key the address derives from, then the signatures
+    MintBIP32::ExtendedPublicKey account;
+    size_t count = 0;
+    if (!proof || proof_size < MINT_PROOF_HEADER_SIZE || !secure.getAccountPublicKey(account) ||
+        !secure.getOwnershipProof(proof + MINT_PROOF_HEADER_SIZE,
+                                  proof_size - MINT_PROOF_HEADER_SIZE, count)) {
+        return MintSecureTypes::JOB_FAILED;
+    }
+    memcpy(proof, MINT_PROOF_MAGIC, 8);
+    proof[8] = MINT_PROOF_VERSION;
+    proof[9] = (uint8_t)count;
+    memcpy(proof + 10, account.public_key, sizeof(account.public_key));
+    memcpy(proof + 75, account.chain_code, sizeof(account.chain_code));
+    proof_len = MINT_PROOF_HEADER_SIZE + count * MINT_PROOF_SIGNATURE_SIZE;
+    
+    return status;
+}
+
+template <class Secure>
+String MintWalletT<Secure>::getPublicAddress(const char* path) {
     // Check if wallet is generated
     if (!wallet_generated) {
         return "No wallet generated";
     }
     
-    // Derive address using secure element
+    // Derive address from the cached account key
     if (!secure.deriveAddress(path, bitcoin_address, sizeof(bitcoin_address))) {
         return "Address derivation failed";
     }
@@ -63,7 +138,8 @@ String MintWallet::getPublicAddress(const char* path) {
     return String(bitcoin_address);
 }
 
-String MintWallet::getPrivateKey() {
+template <class Secure>
+String MintWalletT<Secure>::getPrivateKey() {
     // Check if the device is in tampered state
     if (!secure.isTampered()) {
         return "Error: Device not in tampered state";
@@ -74,9 +150,9 @@ String MintWallet::getPrivateKey() {
         return "No wallet generated";
     }
     
-    // Get raw private key from secure element
+    // Get the key behind the default address from the secure element
     uint8_t raw_key[32];
-    if (!secure.revealPrivateKey(raw_key, sizeof(raw_key))) {
+    if (!secure.revealDerivedPrivateKey(MINT_DEFAULT_ADDRESS_PATH, raw_key, sizeof(raw_key))) {
         return "Failed to retrieve private key";
     }
     
@@ -93,11 +169,13 @@ String MintWallet::getPrivateKey() {
     return String(private_key_wif);
 }
 
-bool MintWallet::isGenerated() const {
+template <class Secure>
+bool MintWalletT<Secure>::isGenerated() const {
     return wallet_generated;
 }
 
-bool MintWallet::rawKeyToWIF(const uint8_t* raw_key) {
+template <class Secure>
+bool MintWalletT<Secure>::rawKeyToWIF(const uint8_t* raw_key) {
     if (!raw_key) {
         return false;
     }
@@ -123,18 +201,20 @@ bool MintWallet::rawKeyToWIF(const uint8_t* raw_key) {
     return true;
 }
 
-void MintWallet::calculateChecksum(const uint8_t* data, size_t len, uint8_t* output) {
+template <class Secure>
+void MintWalletT<Secure>::calculateChecksum(const uint8_t* data, size_t len, uint8_t* output) {
     // In a real implementation, this would calculate double SHA256
     // For now, use secure element to calculate SHA256
     uint8_t hash1[32];
-    secure.se050.calculateSHA256(data, len, hash1);
-    secure.se050.calculateSHA256(hash1, 32, hash1);
+    secure.sha256(data, len, hash1);
+    secure.sha256(hash1, 32, hash1);
     
     // First 4 bytes of hash are the checksum
     memcpy(output, hash1, 4);
 }
 
-bool MintWallet::base58Encode(const uint8_t* data, size_t len, char* str, size_t str_len) {
+template <class Secure>
+bool MintWalletT<Secure>::base58Encode(const uint8_t* data, size_t len, char* str, size_t str_len) {
     // Maximum string length that can be encoded from len bytes is len*138/100+1
     // (see Bitcoin codebase for explanation)
     if (str_len < len * 138 / 100 + 1) {
@@ -192,4 +272,7 @@ bool MintWallet::base58Encode(const uint8_t* data, size_t len, char* str, size_t
     str[str_pos] = '\0';
     
     return true;
-}
\ No newline at end of file
+}
+
+// Secure backends used by the board profiles (mint_board.h)
+template class MintWalletT<MintSecure>;
@@ -5,18 +5,40 @@
 #include <Arduino.h>
 #include "mint_secure.h"
 
+// Ownership challenge file a host drops on a sealed device:
+// "MINTCHAL" then 1 to MINT_PROOF_MAX_CHALLENGES challenge nonces
+#define MINT_CHALLENGE_MAGIC "MINTCHAL"
+#define MINT_CHALLENGE_HEADER_SIZE 8
+
+// Ownership proof written back in one file:
+//   [0]   "MINTPROF"
+//   [8]   version
+//   [9]   signature count
+//   [10]  account public key (65 bytes, uncompressed)
+//   [75]  account chain code (32 bytes)
+//   [107] one r || s signature per challenge, in challenge order
+#define MINT_PROOF_MAGIC "MINTPROF"
+#define MINT_PROOF_VERSION 1
+#define MINT_PROOF_HEADER_SIZE 107
+#define MINT_PROOF_MAX_SIZE (MINT_PROOF_HEADER_SIZE + \
+                             MINT_PROOF_MAX_CHALLENGES * MINT_PROOF_SIGNATURE_SIZE)
+
 /**
  * Class for managing Bitcoin wallet operations.
  * Handles key generation, derivation, and address formatting.
  * Leverages the secure element for all cryptographic operations.
+ *
+ * Templated on the secure backend (a MintSecureT instantiation);
+ * mint_wallet.cpp instantiates the backends in use.
  */
-class MintWallet {
+template <class Secure>
+class MintWalletT {
 public:
     /**
      * Constructor requires secure element for crypto operations.
-     * @param secure_element Reference to MintSecure instance
+     * @param secure_element Reference to the secure backend
      */
-    MintWallet(MintSecure& secure_element);
+    MintWalletT(Secure& secure_element);
     
     /**
      * Initialize the wallet subsystem.
@@ -32,15 +54,55 @@ public:
      */
     bool generateFromEntropy(const uint8_t* entropy, size_t size);
     
+    /**
+     * Start wallet generation without blocking on the secure element.
+     * Call pollGeneration() until it no longer returns JOB_PENDING.
+     * @param entropy Buffer containing entropy source
+     * @param size Size of entropy buffer (16, 24, or 32 bytes)
+     * @return true if generation started, false otherwise
+     */
+    bool startGeneration(const uint8_t* entropy, size_t size);
+    
+    /**
+     * Advance a wallet generation started with startGeneration().
+     * @return JOB_PENDING while running, JOB_DONE once the address is cached,
+     *         JOB_FAILED if generation was aborted
+     */
+    MintSecureTypes::JobStatus pollGeneration();
+    
+    /**
+     * Start proving ownership of the sealed key without revealing it.
+     * Call pollOwnershipProof() until it no longer returns JOB_PENDING.
+     * @param challenges Challenge nonces, MINT_PROOF_CHALLENGE_SIZE bytes each
+     * @param count Number of challenges (1 to MINT_PROOF_MAX_CHALLENGES)
+     * @return true if signing started, false otherwise
+     */
+    bool startOwnershipProof(const uint8_t* challenges, size_t count);
+    
+    /**
+     * Advance an ownership proof started with startOwnershipProof().
+     * Once every challenge is signed, the proof file is written to proof:
+     * the account extended public key, from which a verifier derives the
+     * displayed address, followed by one signature per challenge.
+     * @param proof Output buffer (MINT_PROOF_MAX_SIZE bytes is always enough)
+     * @param proof_size Size of the output buffer
+     * @param proof_len Output proof length, set for JOB_DONE
+     * @return JOB_PENDING while signing, JOB_DONE once proof holds the
+     *         response, JOB_FAILED if signing was aborted
+     */
+    MintSecureTypes::JobStatus pollOwnershipProof(uint8_t* proof, size_t proof_size,
+                                                  size_t& proof_len);
+    
     /**
      * Gets the Bitcoin address for the current wallet.
      * @param path Optional derivation path (defaults to m/84'/0'/0'/0/0 for native segwit)
      * @return Bitcoin address string or error message if failed
      */
-    String getPublicAddress(const char* path = "m/84'/0'/0'/0/0");
+    String getPublicAddress(const char* path = MINT_DEFAULT_ADDRESS_PATH);
     
     /**
-     * Gets the WIF-encoded private key if device is in tampered state.
+     * Gets the WIF-encoded private key for the default address
+     * if device is in tampered state.
      * Only accessible when tamper circuit is broken and OTP is burned.
      * @return WIF-encoded private key or error message if unavailable
      */
@@ -53,7 +115,10 @@ public:
     bool isGenerated() const;
     
 private:
-    MintSecure& secure;
+    // Host timing harnesses (tests/host/dudect_bench.cpp, micro_bench.cpp)
+    friend class MintTimingProbe;
+    
+    Secure& secure;
     bool wallet_generated;
     char bitcoin_address[128];
     char private_key_wif[128];
@@ -84,4 +149,7 @@ private:
     bool base58Encode(const uint8_t* data, size_t len, char* str, size_t str_len);
 };
 
-#endif // MINT_WALLET_H
\ No newline at end of file
+// Wallet on the SE050 backend
+typedef MintWalletT<MintSecure> MintWallet;
+
+#endif // MINT_WALLET_H
@@ -0,0 +1,36 @@
+/**
+ * Host build of Adafruit_NeoPixel; remembers the last color shown.
+ */
+#ifndef MINT_HOST_NEOPIXEL_H
+#define MINT_HOST_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_GRB 0x52
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type) : color(0), shown(0) {
+        last_instance = this;
+    }
+
+    // Most recently constructed strip on this thread, for harnesses
+    // checking what the device shows
+    static Adafruit_NeoPixel* lastInstance() { return last_instance; }
+
+    void begin() {}
+    void setBrightness(uint8_t brightness) {}
+    void setPixelColor(uint16_t n, uint32_t c) { color = c; }
+    void show() { shown = color; }
+
+    uint32_t getShownColor() const { return shown; }
+
+private:
+    uint32_t color;
+    uint32_t shown;
+
+    static inline thread_local Adafruit_NeoPixel* last_instance = nullptr;
+};
+
+#endif // MINT_HOST_NEOPIXEL_H
@@ -0,0 +1,142 @@
+/**
+ * Host build of the Adafruit TinyUSB MSC interface.
+ * Keeps the registered callbacks so a harness can act as the USB host.
+ */
+#ifndef MINT_HOST_TINYUSB_H
+#define MINT_HOST_TINYUSB_H
+
+#include <Arduino.h>
+
+// SCSI sense keys (TinyUSB scsi_sense_key_type_t)
+typedef enum {
+    SCSI_SENSE_NONE = 0x00,
+    SCSI_SENSE_NOT_READY = 0x02,
+    SCSI_SENSE_ILLEGAL_REQUEST = 0x05,
+    SCSI_SENSE_UNIT_ATTENTION = 0x06
+} scsi_sense_key_type_t;
+
+inline bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code,
+                              uint8_t add_sense_qualifier);
+
+class Adafruit_USBD_MSC {
+public:
+    typedef int32_t (*read_callback_t)(uint32_t lba, void* buffer, uint32_t bufsize);
+    typedef int32_t (*write_callback_t)(uint32_t lba, uint8_t* buffer, uint32_t bufsize);
+    typedef void (*flush_callback_t)(void);
+    typedef bool (*ready_callback_t)(void);
+
+    Adafruit_USBD_MSC() :
+        read_cb(nullptr), write_cb(nullptr), flush_cb(nullptr), ready_cb(nullptr),
+        block_count(0), block_size(0), unit_ready(false), owner(nullptr),
+        sense_key(0), sense_asc(0), sense_ascq(0) {
+        last_instance = this;
+    }
+
+    // Most recently constructed interface on this thread, for harnesses
+    // acting as the USB host
+    static Adafruit_USBD_MSC* lastInstance() { return last_instance; }
+
+    /**
+     * Interface the harness is addressing, while one of the host*() calls
+     * runs its callbacks. TinyUSB callbacks carry no context; a device has
+     * one interface, but a host process running many devices looks the
+     * device up through this and setOwner().
+     */
+    static Adafruit_USBD_MSC* active() { return active_instance; }
+
+    // Object the callbacks belong to (host builds only)
+    void setOwner(void* object) { owner = object; }
+    void* getOwner() const { return owner; }
+
+    void setID(const char* vendor_id, const char* product_id, const char* product_rev) {}
+    void setCapacity(uint32_t count, uint16_t size) { block_count = count; block_size = size; }
+    void setReadWriteCallback(read_callback_t rd, write_callback_t wr, flush_callback_t fl) {
+        read_cb = rd;
+        write_cb = wr;
+        flush_cb = fl;
+    }
+    void setReadyCallback(ready_callback_t cb) { ready_cb = cb; }
+    void setUnitReady(bool ready) { unit_ready = ready; }
+    bool begin() { return true; }
+
+    // Host-side access for harnesses
+    int32_t hostRead(uint32_t lba, void* buffer, uint32_t bufsize) {
+        Addressing addressing(this);
+        return read_cb ? read_cb(lba, buffer, bufsize) : -1;
+    }
+    int32_t hostWrite(uint32_t lba, uint8_t* buffer, uint32_t bufsize) {
+        Addressing addressing(this);
+        return write_cb ? write_cb(lba, buffer, bufsize) : -1;
+    }
+
+    /**
+     * TEST UNIT READY as TinyUSB answers it: the ready callback decides,
+     * and a failure without sense data reports the medium as not present.
+     */
+    bool hostTestUnitReady() {
+        Addressing addressing(this);
+        if (ready_cb) {
+            unit_ready = ready_cb();
+        }
+        if (!unit_ready && sense_key == SCSI_SENSE_NONE) {
+            tud_msc_set_sense(0, SCSI_SENSE_NOT_READY, 0x3A, 0x00);
+        }
+        return unit_ready;
+    }
+
+    // REQUEST SENSE: returns and clears the sense data
+    void hostRequestSense(uint8_t& key, uint8_t& asc, uint8_t& ascq) {
+        key = sense_key;
+        asc = sense_asc;
+        ascq = sense_ascq;
+        sense_key = sense_asc = sense_ascq = 0;
+    }
+
+    uint32_t getBlockCount() const { return block_count; }
+    uint16_t getBlockSize() const { return block_size; }
+    bool isUnitReady() const { return unit_ready; }
+
+private:
+    read_callback_t read_cb;
+    write_callback_t write_cb;
+    flush_callback_t flush_cb;
+    ready_callback_t ready_cb;
+    uint32_t block_count;
+    uint16_t block_size;
+    bool unit_ready;
+    void* owner;
+    uint8_t sense_key;
+    uint8_t sense_asc;
+    uint8_t sense_ascq;
+
+    static inline thread_local Adafruit_USBD_MSC* last_instance = nullptr;
+    static inline thread_local Adafruit_USBD_MSC* active_instance = nullptr;
+
+    // Makes an interface active for the duration of a host*() call
+    class Addressing {
+    public:
+        explicit Addressing(Adafruit_USBD_MSC* msc) : previous(active_instance) {
+            active_instance = msc;
+        }
+        ~Addressing() { active_instance = previous; }
+    private:
+        Adafruit_USBD_MSC* previous;
+    };
+
+    friend bool tud_msc_set_sense(uint8_t, uint8_t, uint8_t, uint8_t);
+};
+
+inline bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code,
+                              uint8_t add_sense_qualifier) {
+    // Sense belongs to the interface whose callback is running
+    Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::active_instance;
+    if (!msc) {
+        return false;
+    }
+    msc->sense_key = sense_key;
+    msc->sense_asc = add_sense_code;
+    msc->sense_ascq = add_sense_qualifier;
+    return true;
+}
+
+#endif // MINT_HOST_TINYUSB_H
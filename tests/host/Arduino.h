@@ -0,0 +1,118 @@
+/**
+ * Host build of the Arduino core subset used by the Mint firmware.
+ *
+ * Time is virtual: millis()/micros() read a clock that only moves when
+ * delay() is called or a simulated peripheral charges latency to it, so
+ * host runs are deterministic regardless of machine load.
+ */
+#ifndef MINT_HOST_ARDUINO_H
+#define MINT_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define A0 26
+#define A1 27
+#define A2 28
+#define A3 29
+#define HOST_PIN_COUNT 32
+
+/**
+ * Minimal String stand-in backed by std::string.
+ */
+class String : public std::string {
+public:
+    String() {}
+    String(const char* str) : std::string(str ? str : "") {}
+    String(const std::string& str) : std::string(str) {}
+};
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+
+/**
+ * Serial stand-in; output goes to stdout only when enabled.
+ */
+class HostSerial {
+public:
+    void begin(unsigned long baud);
+    void print(const char* str);
+    void println(const char* str);
+    size_t write(const uint8_t* data, size_t length);
+    int available();
+    int read();
+    operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+/**
+ * Virtual time and pin control for host harnesses.
+ *
+ * The simulated board (clock, pin levels, noise sources, Wire bus) is
+ * per thread: harnesses run devices on a thread pool, each worker
+ * stepping its devices one at a time on a board of its own.
+ */
+namespace MintHost {
+    // Current virtual time in microseconds
+    uint64_t now();
+
+    // Advance virtual time (peripheral latency, delays)
+    void advance(uint64_t us);
+
+    // Reset virtual time to zero
+    void resetClock();
+
+    // Drive the level a digitalRead() on pin will observe
+    void setPin(uint8_t pin, int level);
+
+    // Drive the value an analogRead() on pin will observe
+    void setAnalog(uint8_t pin, int value);
+
+    // Level pin had at a past virtual time, for emulating DMA samplers
+    int pinLevelAt(uint8_t pin, uint64_t time_us);
+
+    // Analog value pin had at a past virtual time
+    int analogValueAt(uint8_t pin, uint64_t time_us);
+
+    // Noise generator for an emulated entropy source: the sample taken at
+    // a virtual time. Sources default to deterministic pseudo-random noise.
+    typedef std::function<int(uint64_t time_us)> NoiseSource;
+
+    // Replace the ROSC random bit generator; nullptr restores the default
+    void setRoscNoise(NoiseSource source);
+
+    // Replace the noise added to pin's analog value; nullptr restores
+    // the default of a few LSBs
+    void setAnalogNoise(uint8_t pin, NoiseSource source);
+
+    // ROSC RANDOMBIT at a virtual time
+    int roscBitAt(uint64_t time_us);
+
+    // ADC reading of pin at a virtual time: its value plus noise, 12 bits
+    int analogNoiseAt(uint8_t pin, uint64_t time_us);
+}
+
+#endif // MINT_HOST_ARDUINO_H
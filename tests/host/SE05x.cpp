@@ -0,0 +1,777 @@
+#include "SE05x.h"
+#include <Wire.h>
+
+// I2C address byte plus ACK slot, charged even when a command NACKs
+#define BUS_ADDRESS_BITS 9
+#define BUS_BITS_PER_BYTE 9
+
+static bool simSign(const uint8_t* private_key, const uint8_t* digest, uint8_t* signature);
+
+// Per thread, so harnesses can build devices on several threads at once
+static thread_local SE05xSimConfig next_config = SE05x::defaultConfig();
+static thread_local SE05x* last_instance = nullptr;
+
+SE05xSimConfig SE05x::defaultConfig() {
+    SE05xSimConfig config;
+
+    config.latency.begin_us = 18000;
+    config.latency.random_base_us = 900;
+    config.latency.random_per_byte_us = 15;
+    config.latency.sha256_base_us = 1200;
+    config.latency.sha256_per_byte_ns = 2500;
+    config.latency.keygen_us = 62000;
+    config.latency.pubkey_read_us = 2600;
+    config.latency.privkey_read_us = 2600;
+    config.latency.object_exists_us = 1800;
+    config.latency.delete_us = 9500;
+    config.latency.memory_read_us = 2100;
+    config.latency.otp_write_us = 14000;
+    config.latency.binary_read_us = 2200;
+    config.latency.binary_write_us = 7500;
+    config.latency.sign_us = 48000;
+    config.latency.frame_overhead_bytes = 12;
+
+    memset(&config.faults, 0, sizeof(config.faults));
+    config.faults.timeout_us = 500000;
+    config.faults.seed = 0x4D494E54; // "MINT"
+
+    config.max_bus_clock_hz = 1000000;
+    config.store = std::make_shared<SE05xStore>();
+
+    return config;
+}
+
+void SE05x::setNextConfig(const SE05xSimConfig& config) {
+    next_config = config;
+}
+
+SE05x* SE05x::lastInstance() {
+    return last_instance;
+}
+
+SE05x::SE05x() :
+    config(next_config),
+    rng_state(next_config.faults.seed),
+    session_open(false) {
+    if (!config.store) {
+        config.store = std::make_shared<SE05xStore>();
+    }
+    resetStats();
+    last_instance = this;
+}
+
+void SE05x::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void SE05x::setFaults(const SE05xFaults& faults) {
+    config.faults = faults;
+    rng_state = faults.seed;
+}
+
+uint64_t SE05x::nextRandom() {
+    // splitmix64, deterministic for a given seed
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+bool SE05x::command(size_t tx_bytes, size_t rx_bytes, uint64_t exec_us) {
+    const uint32_t clock_hz = Wire.getClock() ? Wire.getClock() : 100000;
+    const uint64_t address_us = (uint64_t)BUS_ADDRESS_BITS * 1000000 / clock_hz;
+
+    stats.commands++;
+
+    // Bus clocked faster than the part (or its pull-ups) can follow
+    bool nack = clock_hz > config.max_bus_clock_hz;
+    bool timeout = false;
+
+    if (config.faults.fail_command_index &&
+        stats.commands == config.faults.fail_command_index) {
+        nack = true;
+    } else if (!nack) {
+        uint32_t draw = (uint32_t)(nextRandom() % 1000000);
+        if (draw < config.faults.nack_rate_ppm) {
+            nack = true;
+        } else if (draw < config.faults.nack_rate_ppm + config.faults.timeout_rate_ppm) {
+            timeout = true;
+        }
+    }
+
+    if (nack) {
+        stats.nacks++;
+        stats.bytes_on_bus += 1;
+        stats.busy_us += address_us;
+        MintHost::advance(address_us);
+        return false;
+    }
+
+    // A hung command holds the bus until the master's transfer timeout
+    if (timeout) {
+        const uint64_t hung_us = min((uint64_t)config.faults.timeout_us,
+                                     (uint64_t)Wire.getTimeout() * 1000);
+        stats.timeouts++;
+        stats.busy_us += hung_us;
+        MintHost::advance(hung_us);
+        return false;
+    }
+
+    const size_t bytes = tx_bytes + rx_bytes + 2 * config.latency.frame_overhead_bytes;
+    const uint64_t bus_us = (uint64_t)bytes * BUS_BITS_PER_BYTE * 1000000 / clock_hz;
+
+    stats.bytes_on_bus += bytes;
+    stats.busy_us += bus_us + exec_us;
+    MintHost::advance(bus_us + exec_us);
+    return true;
+}
+
+bool SE05x::scripted(uint8_t op, bool ok, uint8_t* output, size_t length) {
+    if (!config.script) {
+        return ok;
+    }
+
+    SE05xScript::iterator it = config.script->find(op);
+    if (it == config.script->end() || it->second.empty()) {
+        return ok;
+    }
+
+    SE05xScriptedResult result = it->second.front();
+    it->second.pop_front();
+
+    if (result.ok && output && !result.data.empty()) {
+        memcpy(output, result.data.data(), min(length, result.data.size()));
+    }
+    return result.ok;
+}
+
+bool SE05x::begin() {
+    bool ok = command(8, 8, config.latency.begin_us);
+    session_open = scripted(TRACE_SE050_BEGIN, ok);
+    return session_open;
+}
+
+bool SE05x::getRandomBytes(uint8_t* output, size_t length) {
+    if (!session_open || !output) {
+        return false;
+    }
+
+    uint64_t exec_us = config.latency.random_base_us +
+                       (uint64_t)config.latency.random_per_byte_us * length;
+    bool ok = command(4, length, exec_us);
+
+    if (ok) {
+        for (size_t i = 0; i < length; i += 8) {
+            uint64_t word = nextRandom();
+            for (size_t j = 0; j < 8 && i + j < length; j++) {
+                output[i + j] = (uint8_t)(word >> (8 * j));
+            }
+        }
+    }
+    return scripted(TRACE_SE050_RANDOM, ok, output, length);
+}
+
+bool SE05x::calculateSHA256(const uint8_t* data, size_t length, uint8_t* digest) {
+    if (!session_open || !digest) {
+        return false;
+    }
+
+    uint64_t exec_us = config.latency.sha256_base_us +
+                       (uint64_t)config.latency.sha256_per_byte_ns * length / 1000;
+    bool ok = command(length, 32, exec_us);
+
+    if (ok) {
+        se05xSimSHA256(data, length, digest);
+    }
+    return scripted(TRACE_SE050_SHA256, ok);
+}
+
+bool SE05x::objectExists(uint32_t object_id) {
+    if (!session_open) {
+        return false;
+    }
+
+    bool ok = command(4, 1, config.latency.object_exists_us) &&
+              (config.store->private_keys.count(object_id) != 0 ||
+               config.store->binary_objects.count(object_id) != 0);
+    return scripted(TRACE_SE050_OBJECT_EXISTS, ok);
+}
+
+bool SE05x::deleteObject(uint32_t object_id) {
+    if (!session_open) {
+        return false;
+    }
+
+    bool ok = command(4, 0, config.latency.delete_us);
+    if (ok) {
+        config.store->public_keys.erase(object_id);
+        ok = (config.store->private_keys.erase(object_id) +
+              config.store->binary_objects.erase(object_id)) != 0;
+    }
+    return scripted(TRACE_SE050_DELETE, ok);
+}
+
+bool SE05x::createECKeyPair(uint32_t object_id, uint8_t curve, const uint8_t* seed,
+                            size_t seed_len, bool exportable) {
+    if (!session_open || !seed || seed_len != 32 || curve != SE05x_ECCurve_SECP256K1) {
+        return false;
+    }
+
+    // Objects must be deleted before their identifier is reused
+    bool ok = command(4 + seed_len, 0, config.latency.keygen_us) &&
+              !config.store->private_keys.count(object_id) &&
+              !config.store->binary_objects.count(object_id);
+
+    std::vector<uint8_t> public_key(65);
+    ok = ok && se05xSimPublicKey(seed, public_key.data());
+    if (ok) {
+        config.store->private_keys[object_id] = std::vector<uint8_t>(seed, seed + seed_len);
+        config.store->public_keys[object_id] = public_key;
+    }
+    return scripted(TRACE_SE050_CREATE_KEY, ok);
+}
+
+bool SE05x::getECCPublicKey(uint32_t object_id, uint8_t* key, size_t key_len) {
+    if (!session_open || !key || key_len < 65) {
+        return false;
+    }
+
+    bool ok = command(4, 65, config.latency.pubkey_read_us);
+    if (ok) {
+        std::map<uint32_t, std::vector<uint8_t> >::const_iterator it =
+            config.store->public_keys.find(object_id);
+        ok = it != config.store->public_keys.end();
+        if (ok) {
+            memcpy(key, it->second.data(), 65);
+        }
+    }
+    return scripted(TRACE_SE050_PUBLIC_KEY, ok, key, 65);
+}
+
+bool SE05x::getECCPrivateKey(uint32_t object_id, uint8_t* key, size_t key_len) {
+    if (!session_open || !key || key_len < 32) {
+        return false;
+    }
+
+    bool ok = command(4, 32, config.latency.privkey_read_us);
+    if (ok) {
+        std::map<uint32_t, std::vector<uint8_t> >::const_iterator it =
+            config.store->private_keys.find(object_id);
+        ok = it != config.store->private_keys.end();
+        if (ok) {
+            memcpy(key, it->second.data(), 32);
+        }
+    }
+    return scripted(TRACE_SE050_PRIVATE_KEY, ok);
+}
+
+bool SE05x::readMemory(uint32_t address, uint8_t* data, size_t length) {
+    if (!session_open || !data) {
+        return false;
+    }
+
+    bool ok = command(8, length, config.latency.memory_read_us);
+    if (ok) {
+        for (size_t i = 0; i < length; i++) {
+            std::map<uint32_t, uint8_t>::const_iterator it =
+                config.store->otp.find(address + i);
+            data[i] = it == config.store->otp.end() ? 0xFF : it->second;
+        }
+    }
+    return scripted(TRACE_SE050_READ_MEMORY, ok, data, length);
+}
+
+bool SE05x::writeOTPMemory(uint32_t address, const uint8_t* data, size_t length) {
+    if (!session_open || !data) {
+        return false;
+    }
+
+    bool ok = command(8 + length, 0, config.latency.otp_write_us);
+
+    // OTP is write-once: any previously programmed byte rejects the write
+    for (size_t i = 0; ok && i < length; i++) {
+        if (config.store->otp.count(address + i)) {
+            ok = false;
+        }
+    }
+    if (ok) {
+        for (size_t i = 0; i < length; i++) {
+            config.store->otp[address + i] = data[i];
+        }
+    }
+    return scripted(TRACE_SE050_WRITE_OTP, ok);
+}
+
+bool SE05x::readBinaryObject(uint32_t object_id, uint8_t* data, size_t length) {
+    if (!session_open || !data) {
+        return false;
+    }
+
+    bool ok = command(8, length, config.latency.binary_read_us);
+    if (ok) {
+        std::map<uint32_t, std::vector<uint8_t> >::const_iterator it =
+            config.store->binary_objects.find(object_id);
+        ok = it != config.store->binary_objects.end() && it->second.size() >= length;
+        if (ok) {
+            memcpy(data, it->second.data(), length);
+        }
+    }
+    return scripted(TRACE_SE050_READ_OBJECT, ok);
+}
+
+bool SE05x::writeBinaryObject(uint32_t object_id, const uint8_t* data, size_t length) {
+    if (!session_open || !data) {
+        return false;
+    }
+
+    // Binary objects are updatable, but cannot replace a key object
+    bool ok = command(8 + length, 0, config.latency.binary_write_us) &&
+              !config.store->private_keys.count(object_id);
+    if (ok) {
+        config.store->binary_objects[object_id] = std::vector<uint8_t>(data, data + length);
+    }
+    return scripted(TRACE_SE050_WRITE_OBJECT, ok);
+}
+
+bool SE05x::ecdsaSign(uint32_t object_id, const uint8_t* digest, size_t digest_len,
+                      uint8_t* signature, size_t signature_len) {
+    if (!session_open || !digest || digest_len != 32 || !signature || signature_len < 64) {
+        return false;
+    }
+
+    bool ok = command(8 + digest_len, 64, config.latency.sign_us);
+    if (ok) {
+        std::map<uint32_t, std::vector<uint8_t> >::const_iterator it =
+            config.store->private_keys.find(object_id);
+        ok = it != config.store->private_keys.end() &&
+             simSign(it->second.data(), digest, signature);
+    }
+    return scripted(TRACE_SE050_SIGN, ok, signature, 64);
+}
+
+// Reference secp256k1: 4 x 64-bit limbs, schoolbook multiplication folded
+// modulo p (bit-serial modulo n) and textbook Jacobian formulas. Written
+// for obviousness, not speed.
+typedef struct {
+    uint64_t v[4];
+} SimU256;
+
+static const SimU256 SIM_P = {{
+    0xFFFFFFFEFFFFFC2FULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL
+}};
+static const SimU256 SIM_N = {{
+    0xBFD25E8CD0364141ULL, 0xBAAEDCE6AF48A03BULL, 0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL
+}};
+static const SimU256 SIM_GX = {{
+    0x59F2815B16F81798ULL, 0x029BFCDB2DCE28D9ULL, 0x55A06295CE870B07ULL, 0x79BE667EF9DCBBACULL
+}};
+static const SimU256 SIM_GY = {{
+    0x9C47D08FFB10D4B8ULL, 0xFD17B448A6855419ULL, 0x5DA4FBFC0E1108A8ULL, 0x483ADA7726A3C465ULL
+}};
+
+static bool u256IsZero(const SimU256& a) {
+    return !(a.v[0] | a.v[1] | a.v[2] | a.v[3]);
+}
+
+static bool u256Less(const SimU256& a, const SimU256& b) {
+    for (int i = 3; i >= 0; i--) {
+        if (a.v[i] != b.v[i]) {
+            return a.v[i] < b.v[i];
+        }
+    }
+    return false;
+}
+
+static bool u256Equal(const SimU256& a, const SimU256& b) {
+    return !((a.v[0] ^ b.v[0]) | (a.v[1] ^ b.v[1]) | (a.v[2] ^ b.v[2]) | (a.v[3] ^ b.v[3]));
+}
+
+static bool u256Bit(const SimU256& a, int bit) {
+    return (a.v[bit / 64] >> (bit % 64)) & 1;
+}
+
+// Arithmetic modulo m (p for coordinates, n for signature scalars);
+// operands must already be below m
+static SimU256 modAdd(const SimU256& a, const SimU256& b, const SimU256& m = SIM_P) {
+    SimU256 r;
+    unsigned __int128 carry = 0;
+    for (int i = 0; i < 4; i++) {
+        carry += (unsigned __int128)a.v[i] + b.v[i];
+        r.v[i] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    if (carry || !u256Less(r, m)) {
+        unsigned __int128 borrow = 0;
+        for (int i = 0; i < 4; i++) {
+            unsigned __int128 d = (unsigned __int128)r.v[i] - m.v[i] - borrow;
+            r.v[i] = (uint64_t)d;
+            borrow = (d >> 64) ? 1 : 0;
+        }
+    }
+    return r;
+}
+
+static SimU256 modNeg(const SimU256& a, const SimU256& m = SIM_P) {
+    if (u256IsZero(a)) {
+        return a;
+    }
+    SimU256 r;
+    unsigned __int128 borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 d = (unsigned __int128)m.v[i] - a.v[i] - borrow;
+        r.v[i] = (uint64_t)d;
+        borrow = (d >> 64) ? 1 : 0;
+    }
+    return r;
+}
+
+static SimU256 modSub(const SimU256& a, const SimU256& b, const SimU256& m = SIM_P) {
+    return modAdd(a, modNeg(b, m), m);
+}
+
+// p = 2^256 - 0x1000003D1, so a 512-bit product folds to 256 bits with
+// two multiplications by that constant
+static SimU256 mulModP(const SimU256& a, const SimU256& b) {
+    const uint64_t fold = 0x1000003D1ULL;
+    uint64_t w[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 carry = 0;
+        for (int j = 0; j < 4; j++) {
+            carry += (unsigned __int128)a.v[i] * b.v[j] + w[i + j];
+            w[i + j] = (uint64_t)carry;
+            carry >>= 64;
+        }
+        w[i + 4] = (uint64_t)carry;
+    }
+
+    SimU256 r;
+    unsigned __int128 carry = 0;
+    for (int i = 0; i < 4; i++) {
+        carry += (unsigned __int128)w[i + 4] * fold + w[i];
+        r.v[i] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    carry = carry * fold;
+    for (int i = 0; i < 4; i++) {
+        carry += r.v[i];
+        r.v[i] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    if (carry) {
+        // Wrapped past 2^256 once more; the low limbs are now small
+        r.v[0] += fold;
+    }
+    SimU256 zero = {{0, 0, 0, 0}};
+    return modAdd(r, zero);
+}
+
+static SimU256 modMul(const SimU256& a, const SimU256& b, const SimU256& m = SIM_P) {
+    if (u256Equal(m, SIM_P)) {
+        return mulModP(a, b);
+    }
+    SimU256 r = {{0, 0, 0, 0}};
+    for (int bit = 255; bit >= 0; bit--) {
+        r = modAdd(r, r, m);
+        if (u256Bit(b, bit)) {
+            r = modAdd(r, a, m);
+        }
+    }
+    return r;
+}
+
+// Fermat inverse; p and n are both prime
+static SimU256 modInv(const SimU256& a, const SimU256& m = SIM_P) {
+    SimU256 e = m;
+    e.v[0] -= 2;
+    SimU256 r = {{1, 0, 0, 0}};
+    for (int bit = 255; bit >= 0; bit--) {
+        r = modMul(r, r, m);
+        if (u256Bit(e, bit)) {
+            r = modMul(r, a, m);
+        }
+    }
+    return r;
+}
+
+typedef struct {
+    SimU256 x, y, z;                // Jacobian; z == 0 is infinity
+} SimPoint;
+
+static SimPoint simDouble(const SimPoint& p) {
+    if (u256IsZero(p.z) || u256IsZero(p.y)) {
+        SimPoint inf = {{{0}}, {{1}}, {{0}}};
+        return inf;
+    }
+    // dbl-2009-l for a = 0
+    SimU256 a = modMul(p.x, p.x);
+    SimU256 b = modMul(p.y, p.y);
+    SimU256 c = modMul(b, b);
+    SimU256 xb = modAdd(p.x, b);
+    SimU256 d = modSub(modSub(modMul(xb, xb), a), c);
+    d = modAdd(d, d);
+    SimU256 e = modAdd(modAdd(a, a), a);
+    SimU256 f = modMul(e, e);
+    SimPoint r;
+    r.x = modSub(f, modAdd(d, d));
+    SimU256 c8 = modAdd(c, c);
+    c8 = modAdd(c8, c8);
+    c8 = modAdd(c8, c8);
+    r.y = modSub(modMul(e, modSub(d, r.x)), c8);
+    SimU256 yz = modMul(p.y, p.z);
+    r.z = modAdd(yz, yz);
+    return r;
+}
+
+static SimPoint simAdd(const SimPoint& p, const SimPoint& q) {
+    if (u256IsZero(p.z)) {
+        return q;
+    }
+    if (u256IsZero(q.z)) {
+        return p;
+    }
+    SimU256 z1z1 = modMul(p.z, p.z);
+    SimU256 z2z2 = modMul(q.z, q.z);
+    SimU256 u1 = modMul(p.x, z2z2);
+    SimU256 u2 = modMul(q.x, z1z1);
+    SimU256 s1 = modMul(modMul(p.y, q.z), z2z2);
+    SimU256 s2 = modMul(modMul(q.y, p.z), z1z1);
+    SimU256 h = modSub(u2, u1);
+    SimU256 rr = modSub(s2, s1);
+    if (u256IsZero(h)) {
+        if (u256IsZero(rr)) {
+            return simDouble(p);
+        }
+        SimPoint inf = {{{0}}, {{1}}, {{0}}};
+        return inf;
+    }
+    // X3 = R^2 - H^3 - 2 U1 H^2, Y3 = R (U1 H^2 - X3) - S1 H^3, Z3 = Z1 Z2 H
+    SimU256 hh = modMul(h, h);
+    SimU256 hhh = modMul(hh, h);
+    SimU256 v = modMul(u1, hh);
+    SimPoint r;
+    r.x = modSub(modSub(modMul(rr, rr), hhh), modAdd(v, v));
+    r.y = modSub(modMul(rr, modSub(v, r.x)), modMul(s1, hhh));
+    r.z = modMul(modMul(p.z, q.z), h);
+    return r;
+}
+
+static SimU256 u256FromBytes(const uint8_t* bytes) {
+    SimU256 a;
+    for (int i = 0; i < 4; i++) {
+        a.v[3 - i] = 0;
+        for (int j = 0; j < 8; j++) {
+            a.v[3 - i] = (a.v[3 - i] << 8) | bytes[8 * i + j];
+        }
+    }
+    return a;
+}
+
+static void u256ToBytes(const SimU256& a, uint8_t* bytes) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 8; j++) {
+            bytes[8 * i + j] = (uint8_t)(a.v[3 - i] >> (56 - 8 * j));
+        }
+    }
+}
+
+// Reduce a value below 2^256 into [0, n)
+static SimU256 reduceOrder(SimU256 a) {
+    if (!u256Less(a, SIM_N)) {
+        unsigned __int128 borrow = 0;
+        for (int i = 0; i < 4; i++) {
+            unsigned __int128 d = (unsigned __int128)a.v[i] - SIM_N.v[i] - borrow;
+            a.v[i] = (uint64_t)d;
+            borrow = (d >> 64) ? 1 : 0;
+        }
+    }
+    return a;
+}
+
+static SimPoint simMultiply(const SimPoint& p, const SimU256& k) {
+    SimPoint r = {{{0}}, {{1}}, {{0}}};
+    for (int bit = 255; bit >= 0; bit--) {
+        r = simDouble(r);
+        if (u256Bit(k, bit)) {
+            r = simAdd(r, p);
+        }
+    }
+    return r;
+}
+
+static void simAffine(const SimPoint& p, SimU256& x, SimU256& y) {
+    SimU256 zinv = modInv(p.z);
+    SimU256 zinv2 = modMul(zinv, zinv);
+    x = modMul(p.x, zinv2);
+    y = modMul(p.y, modMul(zinv2, zinv));
+}
+
+bool se05xSimPublicKey(const uint8_t* private_key, uint8_t* public_key) {
+    SimU256 k = u256FromBytes(private_key);
+    if (u256IsZero(k) || !u256Less(k, SIM_N)) {
+        return false;
+    }
+
+    SimPoint g = {SIM_GX, SIM_GY, {{1, 0, 0, 0}}};
+    SimU256 x, y;
+    simAffine(simMultiply(g, k), x, y);
+
+    public_key[0] = 0x04;
+    u256ToBytes(x, public_key + 1);
+    u256ToBytes(y, public_key + 33);
+    return true;
+}
+
+static bool simSign(const uint8_t* private_key, const uint8_t* digest, uint8_t* signature) {
+    SimU256 d = u256FromBytes(private_key);
+    if (u256IsZero(d) || !u256Less(d, SIM_N)) {
+        return false;
+    }
+    SimU256 z = reduceOrder(u256FromBytes(digest));
+
+    // Nonce k = SHA-256(key || digest || counter) mod n, retried until
+    // r and s are non-zero. Deterministic, so replays sign identically.
+    SimPoint g = {SIM_GX, SIM_GY, {{1, 0, 0, 0}}};
+    for (uint8_t counter = 0; counter < 16; counter++) {
+        uint8_t material[65];
+        uint8_t nonce[32];
+        memcpy(material, private_key, 32);
+        memcpy(material + 32, digest, 32);
+        material[64] = counter;
+        se05xSimSHA256(material, sizeof(material), nonce);
+        SimU256 k = reduceOrder(u256FromBytes(nonce));
+        if (u256IsZero(k)) {
+            continue;
+        }
+
+        SimU256 x, y;
+        simAffine(simMultiply(g, k), x, y);
+        SimU256 r = reduceOrder(x);
+        if (u256IsZero(r)) {
+            continue;
+        }
+
+        // s = k^-1 (z + r d) mod n
+        SimU256 s = modMul(modInv(k, SIM_N), modAdd(z, modMul(r, d, SIM_N), SIM_N), SIM_N);
+        if (u256IsZero(s)) {
+            continue;
+        }
+        u256ToBytes(r, signature);
+        u256ToBytes(s, signature + 32);
+        return true;
+    }
+    return false;
+}
+
+bool se05xSimVerify(const uint8_t* public_key, const uint8_t* digest, const uint8_t* signature) {
+    if (public_key[0] != 0x04) {
+        return false;
+    }
+    SimU256 qx = u256FromBytes(public_key + 1);
+    SimU256 qy = u256FromBytes(public_key + 33);
+    SimU256 r = u256FromBytes(signature);
+    SimU256 s = u256FromBytes(signature + 32);
+    if (!u256Less(qx, SIM_P) || !u256Less(qy, SIM_P) ||
+        u256IsZero(r) || !u256Less(r, SIM_N) || u256IsZero(s) || !u256Less(s, SIM_N)) {
+        return false;
+    }
+
+    // The key must be on the curve: y^2 = x^3 + 7
+    SimU256 seven = {{7, 0, 0, 0}};
+    if (!u256Equal(modMul(qy, qy), modAdd(modMul(modMul(qx, qx), qx), seven))) {
+        return false;
+    }
+
+    // R = (z s^-1) G + (r s^-1) Q, valid if R.x mod n == r
+    SimU256 z = reduceOrder(u256FromBytes(digest));
+    SimU256 w = modInv(s, SIM_N);
+    SimPoint g = {SIM_GX, SIM_GY, {{1, 0, 0, 0}}};
+    SimPoint q = {qx, qy, {{1, 0, 0, 0}}};
+    SimPoint sum = simAdd(simMultiply(g, modMul(z, w, SIM_N)),
+                          simMultiply(q, modMul(r, w, SIM_N)));
+    if (u256IsZero(sum.z)) {
+        return false;
+    }
+    SimU256 x, y;
+    simAffine(sum, x, y);
+    return u256Equal(reduceOrder(x), r);
+}
+
+// SHA-256 (FIPS 180-4)
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr32(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void sha256Block(uint32_t* h, const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+    uint32_t e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = k + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) +
+                      ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) +
+                      ((a & b) ^ (a & c) ^ (b & c));
+        k = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+void se05xSimSHA256(const uint8_t* data, size_t length, uint8_t* digest) {
+    uint32_t h[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    uint8_t block[64];
+    size_t offset = 0;
+
+    while (length - offset >= 64) {
+        sha256Block(h, data + offset);
+        offset += 64;
+    }
+
+    size_t rest = length - offset;
+    memset(block, 0, sizeof(block));
+    if (rest) {
+        memcpy(block, data + offset, rest);
+    }
+    block[rest] = 0x80;
+    if (rest >= 56) {
+        sha256Block(h, block);
+        memset(block, 0, sizeof(block));
+    }
+
+    uint64_t bits = (uint64_t)length * 8;
+    for (int i = 0; i < 8; i++) {
+        block[63 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    sha256Block(h, block);
+
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(h[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(h[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(h[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)h[i];
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * Simulated NXP SE050 for host builds of the Mint firmware.
+ *
+ * Stands in for the SE05x Arduino library class with the same method
+ * signatures, so MintSecure compiles unchanged. Every command charges
+ * modelled latency to the virtual clock (see Arduino.h): I2C transfer time
+ * at the current Wire clock plus a per-command execution profile. Object
+ * storage and OTP memory live in an SE05xStore that outlives the SE05x
+ * instance, so a harness can "reboot" by constructing a new MintSecure.
+ *
+ * Key pairs are simulated: the private key is the seed and the public key
+ * is the matching secp256k1 point, computed with a deliberately simple
+ * reference implementation that shares no code with the firmware's
+ * MintSecp256k1, so the two can be checked against each other. ecdsaSign
+ * returns raw r || s with a nonce derived from the key and digest, so a
+ * given key signs a given digest identically on every run.
+ */
+#ifndef MINT_HOST_SE05X_H
+#define MINT_HOST_SE05X_H
+
+#include <Arduino.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "mint_trace.h"
+
+#define SE05x_ECCurve_SECP256K1 0x10
+
+/**
+ * Per-command execution time, excluding I2C transfer time.
+ * Defaults approximate SE050 datasheet figures; override per board.
+ */
+typedef struct {
+    uint32_t begin_us;              // Applet select and session open
+    uint32_t random_base_us;        // getRandomBytes fixed cost
+    uint32_t random_per_byte_us;    // getRandomBytes per output byte
+    uint32_t sha256_base_us;        // calculateSHA256 fixed cost
+    uint32_t sha256_per_byte_ns;    // calculateSHA256 throughput
+    uint32_t keygen_us;             // createECKeyPair on secp256k1
+    uint32_t pubkey_read_us;        // getECCPublicKey
+    uint32_t privkey_read_us;       // getECCPrivateKey
+    uint32_t object_exists_us;      // objectExists
+    uint32_t delete_us;             // deleteObject
+    uint32_t memory_read_us;        // readMemory
+    uint32_t otp_write_us;          // writeOTPMemory
+    uint32_t binary_read_us;        // readBinaryObject
+    uint32_t binary_write_us;       // writeBinaryObject
+    uint32_t sign_us;               // ecdsaSign on secp256k1
+    uint16_t frame_overhead_bytes;  // T=1oI2C framing per direction
+} SE05xLatencyProfile;
+
+/**
+ * Fault injection settings. Rates are in parts per million per command
+ * and drawn from a seeded generator, so a given seed always fails the
+ * same commands.
+ */
+typedef struct {
+    uint32_t nack_rate_ppm;         // Command NACKed after the address byte
+    uint32_t timeout_rate_ppm;      // Command hangs until timeout_us or the Wire timeout passes
+    uint32_t timeout_us;            // Virtual time lost to a timeout
+    uint32_t fail_command_index;    // Fail this command number once (0 = off)
+    uint32_t seed;                  // Fault and TRNG generator seed
+} SE05xFaults;
+
+/**
+ * Persistent secure element contents: key objects, binary objects and OTP memory.
+ */
+typedef struct {
+    std::map<uint32_t, std::vector<uint8_t> > private_keys;
+    std::map<uint32_t, std::vector<uint8_t> > public_keys;
+    std::map<uint32_t, std::vector<uint8_t> > binary_objects;
+    std::map<uint32_t, uint8_t> otp;  // Unwritten addresses read as 0xFF
+} SE05xStore;
+
+/**
+ * Counters for one simulated SE050.
+ */
+typedef struct {
+    uint32_t commands;              // Commands attempted
+    uint32_t nacks;                 // Commands NACKed
+    uint32_t timeouts;              // Commands that timed out
+    uint32_t bytes_on_bus;          // Bytes clocked over I2C
+    uint64_t busy_us;               // Virtual time spent in commands
+} SE05xStats;
+
+/**
+ * Recorded command outcome replayed instead of the simulated one.
+ * An empty data vector keeps the simulated output bytes.
+ */
+typedef struct {
+    bool ok;
+    std::vector<uint8_t> data;
+} SE05xScriptedResult;
+
+// Recorded outcomes per MintTraceSE050Op, consumed in order
+typedef std::map<uint8_t, std::deque<SE05xScriptedResult> > SE05xScript;
+
+/**
+ * Configuration applied to the next SE05x constructed.
+ */
+typedef struct {
+    SE05xLatencyProfile latency;
+    SE05xFaults faults;
+    uint32_t max_bus_clock_hz;      // Faster clocks NACK every command
+    std::shared_ptr<SE05xStore> store;
+    std::shared_ptr<SE05xScript> script; // Optional replay of recorded results
+} SE05xSimConfig;
+
+class SE05x {
+public:
+    SE05x();
+
+    // SE05x library interface used by MintSecure
+    bool begin();
+    bool getRandomBytes(uint8_t* output, size_t length);
+    bool calculateSHA256(const uint8_t* data, size_t length, uint8_t* digest);
+    bool objectExists(uint32_t object_id);
+    bool deleteObject(uint32_t object_id);
+    bool createECKeyPair(uint32_t object_id, uint8_t curve, const uint8_t* seed,
+                         size_t seed_len, bool exportable);
+    bool getECCPublicKey(uint32_t object_id, uint8_t* key, size_t key_len);
+    bool getECCPrivateKey(uint32_t object_id, uint8_t* key, size_t key_len);
+    bool readMemory(uint32_t address, uint8_t* data, size_t length);
+    bool writeOTPMemory(uint32_t address, const uint8_t* data, size_t length);
+    bool readBinaryObject(uint32_t object_id, uint8_t* data, size_t length);
+    bool writeBinaryObject(uint32_t object_id, const uint8_t* data, size_t length);
+    bool ecdsaSign(uint32_t object_id, const uint8_t* digest, size_t digest_len,
+                   uint8_t* signature, size_t signature_len);
+
+    /**
+     * Default profile, no faults, 1 MHz bus limit and a fresh store.
+     */
+    static SE05xSimConfig defaultConfig();
+
+    /**
+     * Set the configuration the next SE05x constructed on this thread
+     * will use.
+     */
+    static void setNextConfig(const SE05xSimConfig& config);
+
+    /**
+     * Most recently constructed simulator on this thread, for harness
+     * inspection.
+     */
+    static SE05x* lastInstance();
+
+    const SE05xStats& getStats() const { return stats; }
+    void resetStats();
+    SE05xStore& getStore() { return *config.store; }
+    void setFaults(const SE05xFaults& faults);
+
+private:
+    SE05xSimConfig config;
+    SE05xStats stats;
+    uint64_t rng_state;
+    bool session_open;
+
+    // Charge bus and execution time; false if the command faulted
+    bool command(size_t tx_bytes, size_t rx_bytes, uint64_t exec_us);
+
+    // Substitute the next recorded outcome for op, if a script has one
+    bool scripted(uint8_t op, bool ok, uint8_t* output = nullptr, size_t length = 0);
+    uint64_t nextRandom();
+};
+
+/**
+ * SHA-256 used by the simulator, exposed for harness cross-checks.
+ */
+void se05xSimSHA256(const uint8_t* data, size_t length, uint8_t* digest);
+
+/**
+ * Reference secp256k1 public key used by createECKeyPair, exposed for
+ * harness cross-checks. Slow and not constant-time.
+ * @return false if the private key is not in [1, n-1]
+ */
+bool se05xSimPublicKey(const uint8_t* private_key, uint8_t* public_key);
+
+/**
+ * Reference ECDSA verification on secp256k1, for checking ecdsaSign
+ * output in harnesses and host tools. Slow and not constant-time.
+ * @param public_key Uncompressed public key (65 bytes)
+ * @param digest Signed 32-byte digest
+ * @param signature r || s, 32 bytes each, big-endian
+ * @return true if the signature is valid for the key and digest
+ */
+bool se05xSimVerify(const uint8_t* public_key, const uint8_t* digest, const uint8_t* signature);
+
+#endif // MINT_HOST_SE05X_H
@@ -0,0 +1,216 @@
+#include <SPI.h>
+
+// Bits clocked per byte
+#define BUS_BITS_PER_BYTE 8
+
+// W25Q128JV geometry
+#define W25Q_PAGE_SIZE 256
+#define W25Q_SECTOR_SIZE 4096
+#define W25Q_BLOCK_SIZE 65536
+
+// Opcodes modelled by the simulator
+#define W25Q_WRITE_ENABLE 0x06
+#define W25Q_WRITE_DISABLE 0x04
+#define W25Q_READ_STATUS_1 0x05
+#define W25Q_READ_DATA 0x03
+#define W25Q_PAGE_PROGRAM 0x02
+#define W25Q_SECTOR_ERASE 0x20
+#define W25Q_BLOCK_ERASE_64K 0xD8
+#define W25Q_JEDEC_ID 0x9F
+
+// Status register 1 bits
+#define W25Q_STATUS_BUSY 0x01
+#define W25Q_STATUS_WEL 0x02
+
+SPIClass SPI;
+SPIClass SPI1;
+
+W25QSimConfig SPIClass::defaultConfig() {
+    W25QSimConfig config;
+    config.latency.page_program_us = 400;
+    config.latency.sector_erase_us = 45000;
+    config.latency.block_erase_us = 150000;
+    config.store = std::make_shared<W25QStore>();
+    config.store->array.assign(W25Q128JV_CAPACITY, 0xFF);
+    config.store->erase_counts.assign(W25Q128JV_CAPACITY / W25Q_SECTOR_SIZE, 0);
+    return config;
+}
+
+SPIClass::SPIClass() :
+    clock_hz(1000000),
+    clock_remainder(0),
+    in_frame(false),
+    write_enabled(false),
+    busy_until_us(0) {
+    resetFlashStats();
+}
+
+void SPIClass::begin() {
+    if (!config.store) {
+        config = defaultConfig();
+    }
+    write_enabled = false;
+    busy_until_us = 0;
+}
+
+void SPIClass::setFlashConfig(const W25QSimConfig& flash_config) {
+    config = flash_config;
+    if (!config.store) {
+        config.store = defaultConfig().store;
+    }
+}
+
+void SPIClass::resetFlashStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool SPIClass::busy() const {
+    return MintHost::now() < busy_until_us;
+}
+
+void SPIClass::setBusy(uint32_t us) {
+    busy_until_us = MintHost::now() + us;
+    stats.busy_us += us;
+}
+
+void SPIClass::chargeBytes(size_t count) {
+    clock_remainder += (uint64_t)count * BUS_BITS_PER_BYTE * 1000000;
+    MintHost::advance(clock_remainder / clock_hz);
+    clock_remainder %= clock_hz;
+    stats.bytes_on_bus += count;
+}
+
+void SPIClass::beginTransaction(const SPISettings& settings) {
+    clock_hz = settings.clock_hz ? settings.clock_hz : 1000000;
+    frame.clear();
+    in_frame = true;
+}
+
+void SPIClass::endTransaction() {
+    if (in_frame) {
+        finishFrame();
+    }
+    in_frame = false;
+}
+
+uint32_t SPIClass::frameAddress() const {
+    return ((uint32_t)frame[1] << 16 | (uint32_t)frame[2] << 8 | frame[3]) % W25Q128JV_CAPACITY;
+}
+
+uint8_t SPIClass::respond(size_t index) {
+    if (index == 0 || !config.store) {
+        return 0xFF;
+    }
+
+    switch (frame[0]) {
+        case W25Q_READ_STATUS_1:
+            if (index == 1) {
+                stats.status_polls++;
+            }
+            return (busy() ? W25Q_STATUS_BUSY : 0) | (write_enabled ? W25Q_STATUS_WEL : 0);
+
+        case W25Q_JEDEC_ID:
+            return index <= 3 ? (uint8_t)(W25Q128JV_JEDEC_ID >> (8 * (3 - index))) : 0xFF;
+
+        case W25Q_READ_DATA:
+            if (index < 4 || busy()) {
+                return 0xFF;
+            }
+            stats.bytes_read++;
+            return config.store->array[(frameAddress() + index - 4) % W25Q128JV_CAPACITY];
+
+        default:
+            return 0xFF;
+    }
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    uint8_t buffer = data;
+    transfer(&buffer, 1);
+    return buffer;
+}
+
+void SPIClass::transfer(void* buffer, size_t length) {
+    uint8_t* bytes = (uint8_t*)buffer;
+    chargeBytes(length);
+    for (size_t i = 0; i < length; i++) {
+        frame.push_back(bytes[i]);
+        bytes[i] = respond(frame.size() - 1);
+    }
+}
+
+void SPIClass::finishFrame() {
+    if (frame.empty() || !config.store) {
+        return;
+    }
+    stats.commands++;
+
+    const uint8_t opcode = frame[0];
+    if (opcode == W25Q_READ_STATUS_1) {
+        return;
+    }
+    if (busy()) {
+        stats.ignored_while_busy++;
+        return;
+    }
+
+    W25QStore& store = *config.store;
+    switch (opcode) {
+        case W25Q_WRITE_ENABLE:
+            write_enabled = true;
+            break;
+
+        case W25Q_WRITE_DISABLE:
+            write_enabled = false;
+            break;
+
+        case W25Q_PAGE_PROGRAM: {
+            if (!write_enabled || frame.size() < 5) {
+                break;
+            }
+            // Only the last 256 bytes sent are programmed, wrapping in the page
+            const uint32_t address = frameAddress();
+            const uint32_t page = address & ~(uint32_t)(W25Q_PAGE_SIZE - 1);
+            size_t count = frame.size() - 4;
+            size_t skip = count > W25Q_PAGE_SIZE ? count - W25Q_PAGE_SIZE : 0;
+            for (size_t i = skip; i < count; i++) {
+                uint32_t target = page + ((address - page + i - skip) % W25Q_PAGE_SIZE);
+                uint8_t value = frame[4 + i];
+                if (value & ~store.array[target]) {
+                    stats.program_conflicts++;
+                }
+                store.array[target] &= value;
+            }
+            stats.page_programs++;
+            stats.bytes_programmed += count - skip;
+            write_enabled = false;
+            setBusy(config.latency.page_program_us);
+            break;
+        }
+
+        case W25Q_SECTOR_ERASE:
+        case W25Q_BLOCK_ERASE_64K: {
+            if (!write_enabled || frame.size() < 4) {
+                break;
+            }
+            const uint32_t size = opcode == W25Q_SECTOR_ERASE ? W25Q_SECTOR_SIZE : W25Q_BLOCK_SIZE;
+            const uint32_t start = frameAddress() & ~(size - 1);
+            memset(&store.array[start], 0xFF, size);
+            for (uint32_t s = start / W25Q_SECTOR_SIZE; s < (start + size) / W25Q_SECTOR_SIZE; s++) {
+                store.erase_counts[s]++;
+            }
+            if (opcode == W25Q_SECTOR_ERASE) {
+                stats.sector_erases++;
+                setBusy(config.latency.sector_erase_us);
+            } else {
+                stats.block_erases++;
+                setBusy(config.latency.block_erase_us);
+            }
+            write_enabled = false;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
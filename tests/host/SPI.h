@@ -0,0 +1,127 @@
+/**
+ * Host build of the Arduino SPI interface with a simulated Winbond
+ * W25Q128JV serial NOR flash on SPI1.
+ *
+ * A frame runs from beginTransaction() to endTransaction(), standing in
+ * for the chip select. Every byte charges clock time to the virtual clock
+ * (see Arduino.h), and program and erase operations keep the part busy
+ * for their modelled duration, so status polling costs what it would on
+ * the board. NOR semantics are enforced: programming only clears bits,
+ * a page program wraps within its 256-byte page, and commands other than
+ * a status read are ignored while the part is busy. The array lives in a
+ * W25QStore that outlives the SPI object, so a harness can "reboot".
+ */
+#ifndef MINT_HOST_SPI_H
+#define MINT_HOST_SPI_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+#define W25Q128JV_CAPACITY (16UL * 1024 * 1024)
+#define W25Q128JV_JEDEC_ID 0xEF4018
+
+/**
+ * Operation times; defaults are W25Q128JV datasheet typical values.
+ */
+typedef struct {
+    uint32_t page_program_us;       // tPP, 256-byte page
+    uint32_t sector_erase_us;       // tSE, 4 KB
+    uint32_t block_erase_us;        // tBE2, 64 KB
+} W25QLatencyProfile;
+
+/**
+ * Persistent flash contents.
+ */
+typedef struct {
+    std::vector<uint8_t> array;             // Erased bytes read 0xFF
+    std::vector<uint32_t> erase_counts;     // Per 4 KB sector
+} W25QStore;
+
+/**
+ * Counters for the simulated part.
+ */
+typedef struct {
+    uint32_t commands;              // Frames with an opcode
+    uint64_t bytes_on_bus;          // Bytes clocked
+    uint64_t bytes_read;            // Array bytes returned by read commands
+    uint32_t page_programs;         // Page program operations
+    uint64_t bytes_programmed;      // Bytes carried by page programs
+    uint32_t sector_erases;         // 4 KB erases
+    uint32_t block_erases;          // 64 KB erases
+    uint32_t status_polls;          // Status register reads
+    uint32_t ignored_while_busy;    // Commands dropped because the part was busy
+    uint32_t program_conflicts;     // Programs that tried to set a cleared bit
+    uint64_t busy_us;               // Virtual time spent programming or erasing
+} W25QStats;
+
+/**
+ * Configuration applied to the next SPI begin().
+ */
+typedef struct {
+    W25QLatencyProfile latency;
+    std::shared_ptr<W25QStore> store;
+} W25QSimConfig;
+
+class SPISettings {
+public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bit_order = MSBFIRST, uint8_t mode = SPI_MODE0) :
+        clock_hz(clock) {}
+
+    uint32_t clock_hz;
+};
+
+class SPIClass {
+public:
+    SPIClass();
+
+    // Arduino SPI interface used by MintFlash
+    void setRX(uint8_t pin) {}
+    void setTX(uint8_t pin) {}
+    void setSCK(uint8_t pin) {}
+    void begin();
+    void end() {}
+    void beginTransaction(const SPISettings& settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    void transfer(void* buffer, size_t length);
+
+    /**
+     * Fresh erased part with the default latency profile.
+     */
+    static W25QSimConfig defaultConfig();
+
+    /**
+     * Set the configuration the flash on this bus uses from the next begin().
+     */
+    void setFlashConfig(const W25QSimConfig& config);
+
+    const W25QStats& getFlashStats() const { return stats; }
+    void resetFlashStats();
+    W25QStore& getFlashStore() { return *config.store; }
+
+private:
+    W25QSimConfig config;
+    W25QStats stats;
+    uint32_t clock_hz;
+    uint64_t clock_remainder;       // Sub-microsecond bus time carried over
+    std::vector<uint8_t> frame;     // Bytes received in the current frame
+    bool in_frame;
+    bool write_enabled;
+    uint64_t busy_until_us;
+
+    bool busy() const;
+    void chargeBytes(size_t count);
+    uint8_t respond(size_t index);
+    void finishFrame();
+    void setBusy(uint32_t us);
+    uint32_t frameAddress() const;
+};
+
+extern SPIClass SPI;
+extern SPIClass SPI1;
+
+#endif // MINT_HOST_SPI_H
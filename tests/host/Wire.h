@@ -0,0 +1,33 @@
+/**
+ * Host build of the Arduino Wire (I2C) interface.
+ * Only records bus configuration; simulated devices read it to model
+ * transfer time, bus speed limits and how long a hung transfer waits.
+ */
+#ifndef MINT_HOST_WIRE_H
+#define MINT_HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    TwoWire() : clock_hz(100000), timeout_ms(1000), started(false) {}
+
+    void begin() { started = true; }
+    void end() { started = false; }
+    void setClock(uint32_t hz) { clock_hz = hz; }
+    void setTimeout(unsigned long ms) { timeout_ms = ms; }
+
+    uint32_t getClock() const { return clock_hz; }
+    unsigned long getTimeout() const { return timeout_ms; }
+    bool isStarted() const { return started; }
+
+private:
+    uint32_t clock_hz;
+    unsigned long timeout_ms;
+    bool started;
+};
+
+// One bus per thread, like the rest of the simulated board
+extern thread_local TwoWire Wire;
+
+#endif // MINT_HOST_WIRE_H
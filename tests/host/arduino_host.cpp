@@ -0,0 +1,173 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <deque>
+#include <utility>
+
+// Pin changes kept for sampled-peripheral emulation
+#define HOST_PIN_HISTORY 8192
+
+typedef std::deque<std::pair<uint64_t, int> > PinHistory;
+
+HostSerial Serial;
+
+// Each thread is a board of its own: harnesses run devices on several
+// threads at once without sharing a clock, pins or a bus
+thread_local TwoWire Wire;
+
+static thread_local uint64_t virtual_time_us = 0;
+static thread_local int pin_levels[HOST_PIN_COUNT] = {0};
+static thread_local int analog_values[HOST_PIN_COUNT] = {0};
+static thread_local PinHistory pin_history[HOST_PIN_COUNT];
+static thread_local PinHistory analog_history[HOST_PIN_COUNT];
+static thread_local MintHost::NoiseSource rosc_noise;
+static thread_local MintHost::NoiseSource analog_noise[HOST_PIN_COUNT];
+
+// Default noise: a hash of the sample time, so runs repeat exactly
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static void recordChange(PinHistory& history, int value) {
+    if (!history.empty() && history.back().first == virtual_time_us) {
+        history.back().second = value;
+    } else {
+        history.push_back(std::make_pair(virtual_time_us, value));
+    }
+    if (history.size() > HOST_PIN_HISTORY) {
+        history.pop_front();
+    }
+}
+
+static int valueAt(const PinHistory& history, uint64_t time_us, int current) {
+    for (PinHistory::const_reverse_iterator it = history.rbegin(); it != history.rend(); ++it) {
+        if (it->first <= time_us) {
+            return it->second;
+        }
+    }
+    return history.empty() ? current : history.front().second;
+}
+
+unsigned long millis() {
+    return (unsigned long)(virtual_time_us / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)virtual_time_us;
+}
+
+void delay(unsigned long ms) {
+    virtual_time_us += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    virtual_time_us += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    // Levels are driven by the harness through MintHost::setPin()
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? pin_levels[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < HOST_PIN_COUNT) {
+        pin_levels[pin] = value;
+    }
+}
+
+int analogRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? analog_values[pin] : 0;
+}
+
+void HostSerial::begin(unsigned long baud) {
+}
+
+void HostSerial::print(const char* str) {
+    fputs(str, stdout);
+}
+
+void HostSerial::println(const char* str) {
+    puts(str);
+}
+
+size_t HostSerial::write(const uint8_t* data, size_t length) {
+    return fwrite(data, 1, length, stdout);
+}
+
+int HostSerial::available() {
+    return 0;
+}
+
+int HostSerial::read() {
+    return -1;
+}
+
+namespace MintHost {
+
+uint64_t now() {
+    return virtual_time_us;
+}
+
+void advance(uint64_t us) {
+    virtual_time_us += us;
+}
+
+void resetClock() {
+    virtual_time_us = 0;
+    for (int pin = 0; pin < HOST_PIN_COUNT; pin++) {
+        pin_history[pin].clear();
+        analog_history[pin].clear();
+    }
+}
+
+void setPin(uint8_t pin, int level) {
+    if (pin < HOST_PIN_COUNT) {
+        pin_levels[pin] = level;
+        recordChange(pin_history[pin], level);
+    }
+}
+
+void setAnalog(uint8_t pin, int value) {
+    if (pin < HOST_PIN_COUNT) {
+        analog_values[pin] = value;
+        recordChange(analog_history[pin], value);
+    }
+}
+
+int pinLevelAt(uint8_t pin, uint64_t time_us) {
+    return pin < HOST_PIN_COUNT ? valueAt(pin_history[pin], time_us, pin_levels[pin]) : LOW;
+}
+
+int analogValueAt(uint8_t pin, uint64_t time_us) {
+    return pin < HOST_PIN_COUNT ? valueAt(analog_history[pin], time_us, analog_values[pin]) : 0;
+}
+
+void setRoscNoise(NoiseSource source) {
+    rosc_noise = source;
+}
+
+void setAnalogNoise(uint8_t pin, NoiseSource source) {
+    if (pin < HOST_PIN_COUNT) {
+        analog_noise[pin] = source;
+    }
+}
+
+int roscBitAt(uint64_t time_us) {
+    return rosc_noise ? rosc_noise(time_us) & 1 : (int)(splitmix64(time_us) & 1);
+}
+
+int analogNoiseAt(uint8_t pin, uint64_t time_us) {
+    if (pin >= HOST_PIN_COUNT) {
+        return 0;
+    }
+    int noise = analog_noise[pin] ? analog_noise[pin](time_us) :
+                (int)(splitmix64(time_us * HOST_PIN_COUNT + pin) & 0x1F);
+    return std::min(std::max(analogValueAt(pin, time_us) + noise, 0), 4095);
+}
+
+} // namespace MintHost
@@ -0,0 +1,80 @@
+/**
+ * Shared scaffolding for the host benches.
+ *
+ * check() prints and counts a failed check; a bench's main() exits
+ * non-zero if failures is not 0. runDevice() runs the device loop the way
+ * main.ino does, advancing the virtual clock by the idle time the
+ * scheduler reports, at least a millisecond at a time. Bench is one
+ * simulated device on a given SE050 configuration and the USB host
+ * talking to it (fat_host.h), which runs the device between its sector
+ * writes; benches derive from it to add what they look at.
+ */
+#ifndef MINT_HOST_BENCH_H
+#define MINT_HOST_BENCH_H
+
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "fat_host.h"
+
+#include <algorithm>
+#include <memory>
+
+inline int failures = 0;
+
+inline void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("  FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Run the device loop the way main.ino does
+inline void runDevice(MintDevice& device, uint64_t until_us) {
+    while (MintHost::now() < until_us) {
+        device.loop();
+        uint64_t idle_us = (uint64_t)device.getIdleTime() * 1000;
+        MintHost::advance(std::min(std::max<uint64_t>(idle_us, 1000), until_us - MintHost::now()));
+    }
+}
+
+/**
+ * One simulated device and the USB host talking to it.
+ */
+class Bench {
+public:
+    explicit Bench(const SE05xSimConfig& config) {
+        SE05x::setNextConfig(config);
+        MintHost::resetClock();
+        MintHost::setPin(CIRCUIT_PIN, LOW);
+        device.reset(new MintDevice());
+        se = SE05x::lastInstance();
+        host.reset(new HostFat(Adafruit_USBD_MSC::lastInstance(), [this]() {
+            runDevice(*device, MintHost::now() + 500);
+        }));
+    }
+
+    bool boot() {
+        return device->begin() && host->mount();
+    }
+
+    void run(uint64_t us) {
+        runDevice(*device, MintHost::now() + us);
+    }
+
+    MintDevice::MintState state() const {
+        return device->getState();
+    }
+
+    SE05x* secureElement() const {
+        return se;
+    }
+
+protected:
+    std::unique_ptr<MintDevice> device;
+    std::unique_ptr<HostFat> host;
+    SE05x* se;
+};
+
+#endif // MINT_HOST_BENCH_H
@@ -0,0 +1,308 @@
+/**
+ * Mint BIP32 Derivation Benchmark and Differential Test
+ *
+ * Checks MCU-side public derivation (MintSecp256k1, MintBIP32) three ways:
+ *   - known answers from BIP32 test vector 1 and BIP173 encoding,
+ *   - differential against the simulated SE050: child private keys are
+ *     loaded into the secure element and the public key it reports must
+ *     match the one derived on the MCU from the account xpub alone,
+ *   - random scalars and tweaks against the simulator's reference curve code.
+ * Then reports addresses/second for deriveAddress() in host wall-clock time
+ * next to the virtual time an SE050 public key read would cost per address.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/bip32_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint_secure.cpp \
+ *         mint_bip32.cpp mint_secp256k1.cpp mint_hash.cpp mint_circuit.cpp \
+ *         mint_log.cpp -o bip32_bench
+ *     ./bip32_bench [differential-count]
+ *
+ * Exits non-zero on any mismatch.
+ */
+#include <Arduino.h>
+#include <Wire.h>
+#include "SE05x.h"
+#include "mint_secure.h"
+#include "mint_bip32.h"
+#include "mint_secp256k1.h"
+#include "mint_circuit.h"
+#include "bench_host.h"
+
+#include <chrono>
+#include <random>
+
+// Must match mint_secure.cpp
+#define MASTER_KEY_ID 0x10000001
+#define BENCH_TEMP_KEY_ID 0x10000010
+
+// Addresses derived per timing run
+#define BENCH_ADDRESSES 1000
+
+static void fromHex(const char* hex, uint8_t* out, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        sscanf(hex + 2 * i, "%2hhx", &out[i]);
+    }
+}
+
+static bool equalsHex(const uint8_t* data, size_t length, const char* hex) {
+    uint8_t expected[65];
+    fromHex(hex, expected, length);
+    return memcmp(data, expected, length) == 0;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * BIP32 test vector 1 below m/0H/1/2H, where only non-hardened steps remain.
+ */
+static void testKnownAnswers() {
+    printf("Known answers\n");
+
+    MintBIP32::ExtendedPublicKey key;
+    fromHex("0457bfe1e341d01c69fe5654309956cbea516822fba8a601743a012a7896ee8dc2"
+            "4310ef3676384179e713be3115e93f34ac9a3933f6367aeb3081527ea74027b7",
+            key.public_key, 65);
+    fromHex("04466b9cc8e161e966409ca52986c584f07e9dc81f735db683c3ff6ec7b1503f",
+            key.chain_code, 32);
+
+    uint8_t compressed[33];
+    check(MintBIP32::deriveChildPublic(key, 2, key), "CKDpub m/0H/1/2H/2");
+    MintSecp256k1::compress(key.public_key, compressed);
+    check(equalsHex(compressed, 33,
+                    "02e8445082a72f29b75ca48748a914df60622a609cacfce8ed0e35804560741d29"),
+          "m/0H/1/2H/2 public key");
+    check(equalsHex(key.chain_code, 32,
+                    "cfb71883f01676f587d023cc53a35bc7f88f724b1f8c2892ac1275ac822a3edd"),
+          "m/0H/1/2H/2 chain code");
+
+    check(MintBIP32::deriveChildPublic(key, 1000000000, key), "CKDpub .../1000000000");
+    MintSecp256k1::compress(key.public_key, compressed);
+    check(equalsHex(compressed, 33,
+                    "022a471424da5e657499d1ff51cb43c47481a03b1e77f951fe64cec9f5a48f7011"),
+          "m/0H/1/2H/2/1000000000 public key");
+
+    char address[MINT_ADDRESS_BUFFER_SIZE];
+    check(MintBIP32::encodeP2WPKH(key.public_key, address, sizeof(address)), "encode");
+    check(strcmp(address, "bc1q66d2zq39tlkhgduz0rrczfcpafjplhejmtgugz") == 0, "P2WPKH address");
+
+    // Private side of the same path
+    uint8_t priv[32], chain[32];
+    fromHex("cbce0d719ecf7431d88e6a89fa1483e02e35092af60c042b1df2ff59fa424dca", priv, 32);
+    fromHex("04466b9cc8e161e966409ca52986c584f07e9dc81f735db683c3ff6ec7b1503f", chain, 32);
+    check(MintBIP32::deriveChildPrivate(priv, chain, 2, priv, chain) &&
+          MintBIP32::deriveChildPrivate(priv, chain, 1000000000, priv, chain),
+          "CKDpriv");
+    check(equalsHex(priv, 32, "471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8"),
+          "m/0H/1/2H/2/1000000000 private key");
+
+    // Hardened components are refused on the public side
+    check(!MintBIP32::deriveChildPublic(key, BIP32_HARDENED, key), "hardened CKDpub refused");
+
+    uint32_t indices[BIP32_MAX_DEPTH];
+    size_t depth;
+    check(MintBIP32::parsePath("m/84'/0'/0'/1/42", indices, BIP32_MAX_DEPTH, depth) &&
+          depth == 5 && indices[0] == (84 | BIP32_HARDENED) && indices[4] == 42,
+          "parse path");
+    check(!MintBIP32::parsePath("m/84'//0", indices, BIP32_MAX_DEPTH, depth), "empty component");
+    check(!MintBIP32::parsePath("m/2147483648", indices, BIP32_MAX_DEPTH, depth),
+          "component out of range");
+}
+
+/**
+ * Fixed-base and tweak arithmetic against the simulator's reference code.
+ */
+static void testRandomScalars(std::mt19937_64& rng, int count) {
+    printf("Random scalars against reference (%d)\n", count);
+
+    uint8_t scalar[32], tweak[32], fast[65], reference[65], sum[32];
+    int mismatches = 0;
+
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < 32; j++) {
+            scalar[j] = (uint8_t)rng();
+            tweak[j] = (uint8_t)rng();
+        }
+        // Exercise the top of the range now and then
+        if (i % 8 == 0) {
+            memset(scalar, 0xFF, 16);
+        }
+        if (!MintSecp256k1::isBelowOrder(scalar) || !MintSecp256k1::isBelowOrder(tweak)) {
+            continue;
+        }
+
+        // k * G
+        if (!MintSecp256k1::baseMultiply(scalar, fast) || !se05xSimPublicKey(scalar, reference) ||
+            memcmp(fast, reference, 65) != 0) {
+            mismatches++;
+            continue;
+        }
+
+        // (k * G) + t * G == (k + t) * G
+        if (!MintSecp256k1::tweakAddPublic(fast, tweak, fast) ||
+            !MintSecp256k1::tweakAddPrivate(scalar, tweak, sum) ||
+            !se05xSimPublicKey(sum, reference) || memcmp(fast, reference, 65) != 0) {
+            mismatches++;
+        }
+    }
+
+    check(mismatches == 0, "random scalar mismatch");
+
+    // Edge scalars: 1, 2 and n - 1
+    static const char* const EDGES[] = {
+        "0000000000000000000000000000000000000000000000000000000000000001",
+        "0000000000000000000000000000000000000000000000000000000000000002",
+        "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140"
+    };
+    for (size_t i = 0; i < sizeof(EDGES) / sizeof(EDGES[0]); i++) {
+        fromHex(EDGES[i], scalar, 32);
+        check(MintSecp256k1::baseMultiply(scalar, fast) && se05xSimPublicKey(scalar, reference) &&
+              memcmp(fast, reference, 65) == 0, "edge scalar");
+    }
+
+    // 0 and n are rejected
+    memset(scalar, 0, sizeof(scalar));
+    check(!MintSecp256k1::baseMultiply(scalar, fast), "zero scalar rejected");
+    fromHex("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141", scalar, 32);
+    check(!MintSecp256k1::baseMultiply(scalar, fast), "scalar n rejected");
+}
+
+/**
+ * MCU-derived child public keys against keys the SE050 reports.
+ */
+static void testAgainstSecureElement(MintSecure& secure, int count) {
+    printf("Differential against SE050 (%d children per branch)\n", count);
+
+    SE05x* se = SE05x::lastInstance();
+    MintBIP32::ExtendedPublicKey account;
+    check(secure.getAccountPublicKey(account), "account xpub");
+
+    // The account private key, as the tamper path would reveal it
+    const std::vector<uint8_t>& account_key = se->getStore().private_keys[MASTER_KEY_ID];
+    uint8_t account_pub[65];
+    check(MintSecp256k1::baseMultiply(account_key.data(), account_pub) &&
+          memcmp(account_pub, account.public_key, 65) == 0, "account key matches SE050");
+
+    int mismatches = 0;
+    for (uint32_t branch = 0; branch < 2; branch++) {
+        MintBIP32::ExtendedPublicKey branch_pub;
+        uint8_t branch_priv[32], branch_chain[32];
+        check(MintBIP32::deriveChildPublic(account, branch, branch_pub), "branch CKDpub");
+        check(MintBIP32::deriveChildPrivate(account_key.data(), account.chain_code, branch,
+                                            branch_priv, branch_chain), "branch CKDpriv");
+
+        for (int i = 0; i < count; i++) {
+            MintBIP32::ExtendedPublicKey child_pub;
+            uint8_t child_priv[32], child_chain[32], se_pub[65];
+            if (!MintBIP32::deriveChildPublic(branch_pub, i, child_pub) ||
+                !MintBIP32::deriveChildPrivate(branch_priv, branch_chain, i,
+                                               child_priv, child_chain)) {
+                mismatches++;
+                continue;
+            }
+
+            // Let the secure element compute the public key of the child
+            bool loaded = se->createECKeyPair(BENCH_TEMP_KEY_ID, SE05x_ECCurve_SECP256K1,
+                                              child_priv, sizeof(child_priv), true) &&
+                          se->getECCPublicKey(BENCH_TEMP_KEY_ID, se_pub, sizeof(se_pub));
+            se->deleteObject(BENCH_TEMP_KEY_ID);
+
+            // And the firmware's address path must land on the same key
+            char path[40], address[MINT_ADDRESS_BUFFER_SIZE], expected[MINT_ADDRESS_BUFFER_SIZE];
+            snprintf(path, sizeof(path), "%s/%u/%d", MINT_ACCOUNT_PATH, branch, i);
+            MintBIP32::encodeP2WPKH(se_pub, expected, sizeof(expected));
+
+            if (!loaded || memcmp(se_pub, child_pub.public_key, 65) != 0 ||
+                memcmp(child_chain, child_pub.chain_code, 32) != 0 ||
+                !secure.deriveAddress(path, address, sizeof(address)) ||
+                strcmp(address, expected) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    check(mismatches == 0, "SE050 differential mismatch");
+
+    // Paths the account key cannot serve
+    char address[MINT_ADDRESS_BUFFER_SIZE];
+    check(!secure.deriveAddress("m/84'/0'/0'/0'/0", address, sizeof(address)),
+          "hardened below account refused");
+    check(!secure.deriveAddress("m/44'/0'/0'/0/0", address, sizeof(address)),
+          "foreign account refused");
+    check(!secure.deriveAddress("m/84'/0'", address, sizeof(address)), "path above account refused");
+}
+
+/**
+ * Address throughput on the host, and the SE050 cost it replaces.
+ */
+static void benchThroughput(MintSecure& secure) {
+    printf("Throughput (host wall clock)\n");
+
+    char path[40], address[MINT_ADDRESS_BUFFER_SIZE];
+    SE05x* se = SE05x::lastInstance();
+    SE05xStats before = se->getStats();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ADDRESSES; i++) {
+        snprintf(path, sizeof(path), "%s/0/%d", MINT_ACCOUNT_PATH, i);
+        check(secure.deriveAddress(path, address, sizeof(address)), "range address");
+    }
+    double range_s = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ADDRESSES; i++) {
+        snprintf(path, sizeof(path), "%s/%d/%d", MINT_ACCOUNT_PATH, i & 1, i);
+        check(secure.deriveAddress(path, address, sizeof(address)), "alternating address");
+    }
+    double alternating_s = secondsSince(start);
+
+    uint8_t scalar[32], pub[65];
+    memset(scalar, 0x5A, sizeof(scalar));
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ADDRESSES; i++) {
+        scalar[31] = (uint8_t)i;
+        MintSecp256k1::baseMultiply(scalar, pub);
+    }
+    double base_s = secondsSince(start);
+
+    check(se->getStats().commands == before.commands, "no SE050 traffic for addresses");
+
+    // One getECCPublicKey round trip per address, in virtual time
+    uint64_t se_start = MintHost::now();
+    se->getECCPublicKey(MASTER_KEY_ID, pub, sizeof(pub));
+    uint64_t se_us = MintHost::now() - se_start;
+
+    printf("  %-32s %10.0f /s\n", "receive range (cached branch)", BENCH_ADDRESSES / range_s);
+    printf("  %-32s %10.0f /s\n", "alternating branches", BENCH_ADDRESSES / alternating_s);
+    printf("  %-32s %10.0f /s\n", "fixed-base multiply", BENCH_ADDRESSES / base_s);
+    printf("  %-32s %10.3f ms (virtual)\n", "SE050 public key read", se_us / 1000.0);
+    printf("  %-32s %10u bytes\n", "comb table in flash",
+           (unsigned)(sizeof(uint32_t) * 16 << MINT_SECP256K1_COMB_TEETH));
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 32;
+    std::mt19937_64 rng(0x4D494E54);
+
+    testKnownAnswers();
+    testRandomScalars(rng, 4 * count);
+
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintSecure secure;
+    check(secure.begin(), "boot");
+
+    uint8_t entropy[32];
+    for (size_t i = 0; i < sizeof(entropy); i++) {
+        entropy[i] = (uint8_t)rng();
+    }
+    check(secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "wallet generation");
+
+    testAgainstSecureElement(secure, count);
+    benchThroughput(secure);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
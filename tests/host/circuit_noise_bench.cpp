@@ -0,0 +1,202 @@
+/**
+ * Mint Tamper Loop Filter Benchmark
+ *
+ * Drives MintCircuit with synthetic tamper loop signals in virtual time
+ * (host builds emulate the DMA sampler from the virtual clock) and checks
+ * that noise never produces a confirmed transition while real breaks and
+ * partial cuts are confirmed promptly. For comparison, counts the breaks a
+ * single pin read per main loop pass would have reported.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/circuit_noise_bench.cpp \
+ *         tests/host/arduino_host.cpp mint_circuit.cpp mint_trace.cpp \
+ *         -o circuit_noise_bench
+ *     ./circuit_noise_bench
+ *
+ * Add -DMINT_CIRCUIT_ANALOG to exercise the ADC classification instead.
+ * Exits non-zero if a scenario is misclassified.
+ */
+#include <Arduino.h>
+#include "mint_circuit.h"
+#include "bench_host.h"
+
+#include <chrono>
+#include <random>
+
+// Main loop period used by main.ino
+#define LOOP_PERIOD_MS 10
+
+// Signal resolution driven by the harness
+#define STEP_US 250
+
+// Loop levels seen by the sampler
+#ifdef MINT_CIRCUIT_ANALOG
+#define LEVEL_INTACT 40
+#define LEVEL_PARTIAL 2100
+#define LEVEL_BROKEN 4090
+#else
+#define LEVEL_INTACT LOW
+#define LEVEL_BROKEN HIGH
+#endif
+
+static void drive(int level) {
+#ifdef MINT_CIRCUIT_ANALOG
+    MintHost::setAnalog(CIRCUIT_SENSE_PIN, level);
+#else
+    MintHost::setPin(CIRCUIT_SENSE_PIN, level);
+#endif
+}
+
+// A naive reader sees the pin the way the old per-loop digitalRead() did
+static bool naiveBroken(int level) {
+#ifdef MINT_CIRCUIT_ANALOG
+    return level > 2048;
+#else
+    return level != LOW;
+#endif
+}
+
+typedef struct {
+    const char* name;
+    uint32_t duration_ms;
+    int (*signal)(uint64_t t_us, std::mt19937& rng);
+    uint32_t task_period_ms;               // How often the main loop drains samples
+    MintCircuit::CircuitState expected;    // Confirmed state at the end
+    uint32_t max_transitions;              // Confirmed transitions allowed
+    uint32_t max_latency_ms;               // From signal change to confirmation, 0 = n/a
+    uint32_t change_at_ms;                 // When the real change happens
+} Scenario;
+
+static int cleanIntact(uint64_t, std::mt19937&) {
+    return LEVEL_INTACT;
+}
+
+// Single-sample spikes on 5% of steps, like ESD or a long unshielded trace
+static int spikyIntact(uint64_t, std::mt19937& rng) {
+    return rng() % 100 < 5 ? LEVEL_BROKEN : LEVEL_INTACT;
+}
+
+// Bursts up to 4 ms long every ~100 ms
+static int burstyIntact(uint64_t t_us, std::mt19937& rng) {
+    static uint64_t burst_end = 0;
+    if (t_us >= burst_end && rng() % 400 == 0) {
+        burst_end = t_us + (1 + rng() % 16) * STEP_US;
+    }
+    return t_us < burst_end ? LEVEL_BROKEN : LEVEL_INTACT;
+}
+
+// Clean cut after 500 ms
+static int cleanBreak(uint64_t t_us, std::mt19937&) {
+    return t_us < 500000 ? LEVEL_INTACT : LEVEL_BROKEN;
+}
+
+// Cut after 500 ms with contact bounce for the first 20 ms
+static int bouncyBreak(uint64_t t_us, std::mt19937& rng) {
+    if (t_us < 500000) {
+        return LEVEL_INTACT;
+    }
+    if (t_us < 520000) {
+        return rng() % 2 ? LEVEL_BROKEN : LEVEL_INTACT;
+    }
+    return LEVEL_BROKEN;
+}
+
+// Scraped trace making intermittent contact from 500 ms on
+static int intermittent(uint64_t t_us, std::mt19937& rng) {
+    if (t_us < 500000) {
+        return LEVEL_INTACT;
+    }
+#ifdef MINT_CIRCUIT_ANALOG
+    (void)rng;
+    return LEVEL_PARTIAL;
+#else
+    return rng() % 2 ? LEVEL_BROKEN : LEVEL_INTACT;
+#endif
+}
+
+static const Scenario SCENARIOS[] = {
+    { "clean intact",          3000, cleanIntact,   LOOP_PERIOD_MS, MintCircuit::CIRCUIT_INTACT,  0, 0,  0 },
+    { "5% spikes",             3000, spikyIntact,   LOOP_PERIOD_MS, MintCircuit::CIRCUIT_INTACT,  0, 0,  0 },
+    { "bursts",                3000, burstyIntact,  LOOP_PERIOD_MS, MintCircuit::CIRCUIT_INTACT,  0, 0,  0 },
+    { "clean break",           1000, cleanBreak,    LOOP_PERIOD_MS, MintCircuit::CIRCUIT_BROKEN,  1, 80, 500 },
+    { "bouncy break",          1000, bouncyBreak,   LOOP_PERIOD_MS, MintCircuit::CIRCUIT_BROKEN,  1, 100, 500 },
+    { "intermittent contact",  1000, intermittent,  LOOP_PERIOD_MS, MintCircuit::CIRCUIT_PARTIAL, 1, 80, 500 },
+    { "break, slow main loop", 1000, cleanBreak,    70,             MintCircuit::CIRCUIT_BROKEN,  1, 150, 500 },
+};
+
+static void runScenario(const Scenario& scenario) {
+    std::mt19937 rng(0x4D494E54);
+    MintHost::resetClock();
+    drive(scenario.signal(0, rng));
+
+    MintCircuit circuit(CIRCUIT_SENSE_PIN);
+    check(circuit.begin(), "begin");
+    check(circuit.getState() == MintCircuit::CIRCUIT_INTACT, "boot state intact");
+
+    uint32_t transitions = 0;
+    uint64_t confirmed_us = 0;
+    circuit.setStateChangedCallback([&](MintCircuit::CircuitState) {
+        transitions++;
+        if (!confirmed_us) {
+            confirmed_us = MintHost::now();
+        }
+    });
+
+    // Boot took some virtual time; the scenario clock starts now
+    uint64_t start = MintHost::now();
+    uint32_t naive_breaks = 0;
+    bool naive_was_broken = false;
+    double task_ns = 0;
+
+    for (uint64_t t = 0; t < (uint64_t)scenario.duration_ms * 1000; t += STEP_US) {
+        int level = scenario.signal(t, rng);
+        drive(level);
+        MintHost::advance(STEP_US);
+
+        if ((t + STEP_US) % ((uint64_t)scenario.task_period_ms * 1000) == 0) {
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            circuit.task();
+            task_ns += std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - begin).count();
+
+            bool broken = naiveBroken(level);
+            if (broken && !naive_was_broken) {
+                naive_breaks++;
+            }
+            naive_was_broken = broken;
+        }
+    }
+
+    const MintCircuit::SampleStats& stats = circuit.getStats();
+    double latency_ms = confirmed_us ?
+        (confirmed_us - start) / 1000.0 - scenario.change_at_ms : 0;
+
+    printf("  %-22s %-8s %u events  %6.1f ms latency  %2u naive  %5u samples  "
+           "%3u rejected  %4u overrun  %5.1f ns/sample\n",
+           scenario.name,
+           circuit.getState() == MintCircuit::CIRCUIT_INTACT ? "intact" :
+           circuit.getState() == MintCircuit::CIRCUIT_BROKEN ? "broken" : "partial",
+           transitions, latency_ms, naive_breaks, stats.samples, stats.rejected_windows,
+           stats.overruns, stats.samples ? task_ns / stats.samples : 0.0);
+
+    check(circuit.getState() == scenario.expected, scenario.name);
+    check(transitions <= scenario.max_transitions, "spurious transition");
+    if (scenario.max_latency_ms) {
+        check(confirmed_us && latency_ms <= scenario.max_latency_ms, "confirmation latency");
+    }
+}
+
+int main() {
+#ifdef MINT_CIRCUIT_ANALOG
+    printf("Tamper loop filter (analog)\n");
+#else
+    printf("Tamper loop filter (digital)\n");
+#endif
+
+    for (size_t i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); i++) {
+        runScenario(SCENARIOS[i]);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
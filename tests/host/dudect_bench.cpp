@@ -0,0 +1,352 @@
+/**
+ * Mint Timing Leakage Benchmark
+ *
+ * dudect-style test of the code paths that handle secrets: each function
+ * is timed on a fixed secret input and on fresh random inputs, randomly
+ * interleaved, and Welch's t-test is run over the two timing
+ * distributions, both as measured and cropped at a range of upper
+ * percentiles to cut off interrupt and scheduling noise. A t statistic
+ * beyond 10 means the timing depends on the secret.
+ *
+ * An early-exit comparison is measured as a control; if the harness can't
+ * see its leak on this machine the run fails rather than passing blindly.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/dudect_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint_secure.cpp \
+ *         mint_wallet.cpp mint_bip32.cpp mint_secp256k1.cpp mint_hash.cpp \
+ *         mint_circuit.cpp mint_log.cpp -o dudect_bench
+ *     ./dudect_bench [--measurements N]
+ *
+ * Exits non-zero if a secret-handling function leaks, or the control
+ * doesn't. Run on an otherwise idle machine.
+ */
+#include <Arduino.h>
+#include <Wire.h>
+#include "SE05x.h"
+#include "mint_secure.h"
+#include "mint_wallet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Measurements per function unless overridden on the command line
+#define DEFAULT_MEASUREMENTS 200000
+
+// Leading measurements dropped while caches and branch predictors settle
+#define WARMUP_MEASUREMENTS 1000
+
+// Cropped copies of the data tested besides the full set
+#define CROP_PERCENTILES 10
+
+// |t| above which timing depends on the input (dudect's threshold), and
+// above which a result is worth a second look
+#define T_LEAK 10.0
+#define T_SUSPECT 4.5
+
+// Fewest samples per class before a test's t is taken into account
+#define MIN_CLASS_SAMPLES 1000
+
+/**
+ * Access to the private secret-handling functions under test.
+ */
+class MintTimingProbe {
+public:
+    static bool secureCompare(MintSecure& secure, const uint8_t* a, const uint8_t* b,
+                              size_t length) {
+        return secure.secureCompare(a, b, length);
+    }
+
+    static bool entropyHealthCheck(MintSecure& secure, const uint8_t* data, size_t length) {
+        return secure.entropyHealthCheck(data, length);
+    }
+
+    static bool base58Encode(MintWallet& wallet, const uint8_t* data, size_t length,
+                             char* str, size_t str_len) {
+        return wallet.base58Encode(data, length, str, str_len);
+    }
+
+    static bool rawKeyToWIF(MintWallet& wallet, const uint8_t* raw_key) {
+        return wallet.rawKeyToWIF(raw_key);
+    }
+};
+
+static inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#elif defined(__aarch64__)
+    uint64_t t;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Welch's t-test over two classes, with Welford's running moments.
+ */
+class WelchTest {
+public:
+    WelchTest() {
+        for (int c = 0; c < 2; c++) {
+            n[c] = 0;
+            mean[c] = 0;
+            m2[c] = 0;
+        }
+    }
+
+    void push(double x, int c) {
+        n[c]++;
+        double delta = x - mean[c];
+        mean[c] += delta / n[c];
+        m2[c] += delta * (x - mean[c]);
+    }
+
+    bool enough() const {
+        return n[0] >= MIN_CLASS_SAMPLES && n[1] >= MIN_CLASS_SAMPLES;
+    }
+
+    double t() const {
+        double var0 = m2[0] / (n[0] - 1);
+        double var1 = m2[1] / (n[1] - 1);
+        double se = std::sqrt(var0 / n[0] + var1 / n[1]);
+        return se > 0 ? (mean[0] - mean[1]) / se : 0;
+    }
+
+    double n[2];
+    double mean[2];
+    double m2[2];
+};
+
+typedef struct {
+    const char* name;
+    size_t input_length;
+    bool control;                                          // Must be seen to leak
+    std::function<void(uint8_t* input)> fixed;            // Fixed-class secret
+    std::function<void(uint8_t* input, std::mt19937& rng)> random;
+    std::function<uint8_t(const uint8_t* input)> run;      // Result feeds a sink
+} Target;
+
+static volatile uint8_t sink;
+
+typedef struct {
+    double max_t;
+    double mean_fixed;
+    double mean_random;
+    size_t measurements;
+} LeakResult;
+
+static LeakResult measure(const Target& target, size_t count, std::mt19937& rng) {
+    // Inputs are prepared up front so only the call is timed
+    std::vector<uint8_t> classes(count);
+    std::vector<uint8_t> inputs(count * target.input_length);
+    for (size_t i = 0; i < count; i++) {
+        classes[i] = rng() & 1;
+        uint8_t* input = &inputs[i * target.input_length];
+        if (classes[i] == 0) {
+            target.fixed(input);
+        } else {
+            target.random(input, rng);
+        }
+    }
+
+    std::vector<uint64_t> times(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* input = &inputs[i * target.input_length];
+        uint64_t start = cycles();
+        sink = sink + target.run(input);
+        times[i] = cycles() - start;
+    }
+
+    // Crop thresholds at upper percentiles 1 - 0.5^(10 (k + 1) / K)
+    std::vector<uint64_t> sorted(times.begin() + WARMUP_MEASUREMENTS, times.end());
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t thresholds[CROP_PERCENTILES];
+    for (int k = 0; k < CROP_PERCENTILES; k++) {
+        double p = 1.0 - std::pow(0.5, 10.0 * (k + 1) / CROP_PERCENTILES);
+        thresholds[k] = sorted[(size_t)(p * (sorted.size() - 1))];
+    }
+
+    WelchTest full;
+    WelchTest cropped[CROP_PERCENTILES];
+    for (size_t i = WARMUP_MEASUREMENTS; i < count; i++) {
+        full.push((double)times[i], classes[i]);
+        for (int k = 0; k < CROP_PERCENTILES; k++) {
+            if (times[i] < thresholds[k]) {
+                cropped[k].push((double)times[i], classes[i]);
+            }
+        }
+    }
+
+    LeakResult result;
+    result.max_t = std::fabs(full.t());
+    for (int k = 0; k < CROP_PERCENTILES; k++) {
+        if (cropped[k].enough()) {
+            result.max_t = std::max(result.max_t, std::fabs(cropped[k].t()));
+        }
+    }
+    result.mean_fixed = full.mean[0];
+    result.mean_random = full.mean[1];
+    result.measurements = count - WARMUP_MEASUREMENTS;
+    return result;
+}
+
+static void randomBytes(uint8_t* out, size_t length, std::mt19937& rng) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (uint8_t)rng();
+    }
+}
+
+// Random bytes that pass the TRNG frequency test (45-55% ones); the
+// verdict is public, so only inputs with the same verdict are compared
+static void healthyRandomBytes(uint8_t* out, size_t length, std::mt19937& rng) {
+    for (;;) {
+        randomBytes(out, length, rng);
+        uint32_t ones = 0;
+        for (size_t i = 0; i < length; i++) {
+            ones += __builtin_popcount(out[i]);
+        }
+        if (ones * 20 >= length * 8 * 9 && ones * 20 <= length * 8 * 11) {
+            return;
+        }
+    }
+}
+
+// Reference the comparison targets check against
+static uint8_t compare_reference[32];
+
+// memcmp-style comparison, the control
+static bool leakyCompare(const uint8_t* a, const uint8_t* b, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// WIF payload around a 32-byte key: prefix, key, compression flag, checksum
+static void wifPayload(uint8_t* out, const uint8_t* key, const uint8_t* checksum) {
+    out[0] = 0x80;
+    memcpy(&out[1], key, 32);
+    out[33] = 0x01;
+    memcpy(&out[34], checksum, 4);
+}
+
+int main(int argc, char** argv) {
+    size_t count = DEFAULT_MEASUREMENTS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--measurements") == 0 && i + 1 < argc) {
+            count = (size_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--measurements N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count < WARMUP_MEASUREMENTS + 4 * MIN_CLASS_SAMPLES) {
+        fprintf(stderr, "need at least %d measurements\n",
+                WARMUP_MEASUREMENTS + 4 * MIN_CLASS_SAMPLES);
+        return 2;
+    }
+
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintSecure secure;
+    MintWallet wallet(secure);
+    if (!secure.begin()) {
+        fprintf(stderr, "secure element failed to start\n");
+        return 2;
+    }
+
+    std::mt19937 rng(0x4D494E54);
+    randomBytes(compare_reference, sizeof(compare_reference), rng);
+
+    const Target targets[] = {
+        {
+            "leakyCompare (control)", 32, true,
+            [](uint8_t* in) { memcpy(in, compare_reference, 32); },
+            [](uint8_t* in, std::mt19937& r) { randomBytes(in, 32, r); },
+            [](const uint8_t* in) { return (uint8_t)leakyCompare(in, compare_reference, 32); }
+        },
+        {
+            "MintSecure::secureCompare", 32, false,
+            [](uint8_t* in) { memcpy(in, compare_reference, 32); },
+            [](uint8_t* in, std::mt19937& r) { randomBytes(in, 32, r); },
+            [&](const uint8_t* in) {
+                return (uint8_t)MintTimingProbe::secureCompare(secure, in, compare_reference, 32);
+            }
+        },
+        {
+            "MintSecure::entropyHealthCheck", 32, false,
+            // Half ones, so both classes pass and only the secret differs
+            [](uint8_t* in) { memset(in, 0x0F, 32); },
+            [](uint8_t* in, std::mt19937& r) { healthyRandomBytes(in, 32, r); },
+            [&](const uint8_t* in) {
+                return (uint8_t)MintTimingProbe::entropyHealthCheck(secure, in, 32);
+            }
+        },
+        {
+            "MintWallet::base58Encode", 38, false,
+            [](uint8_t* in) {
+                static const uint8_t key[32] = { 0 };
+                static const uint8_t checksum[4] = { 0 };
+                wifPayload(in, key, checksum);
+            },
+            [](uint8_t* in, std::mt19937& r) {
+                uint8_t key[32];
+                uint8_t checksum[4];
+                randomBytes(key, sizeof(key), r);
+                randomBytes(checksum, sizeof(checksum), r);
+                wifPayload(in, key, checksum);
+            },
+            [&](const uint8_t* in) {
+                char wif[128];
+                MintTimingProbe::base58Encode(wallet, in, 38, wif, sizeof(wif));
+                return (uint8_t)wif[0];
+            }
+        },
+        {
+            "MintWallet::rawKeyToWIF", 32, false,
+            [](uint8_t* in) { memset(in, 0, 32); },
+            [](uint8_t* in, std::mt19937& r) { randomBytes(in, 32, r); },
+            [&](const uint8_t* in) { return (uint8_t)MintTimingProbe::rawKeyToWIF(wallet, in); }
+        },
+    };
+
+    int failures = 0;
+    printf("%-32s %10s %12s %12s %8s  %s\n", "function", "samples", "fixed cyc",
+           "random cyc", "max |t|", "verdict");
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        const Target& target = targets[i];
+        LeakResult result = measure(target, count, rng);
+
+        const bool leaks = result.max_t > T_LEAK;
+        const char* verdict = leaks ? "LEAK" : result.max_t > T_SUSPECT ? "suspect" : "ok";
+        bool failed = target.control ? !leaks : leaks;
+        if (failed) {
+            failures++;
+        }
+
+        printf("%-32s %10zu %12.1f %12.1f %8.2f  %s%s\n", target.name, result.measurements,
+               result.mean_fixed, result.mean_random, result.max_t, verdict,
+               failed ? (target.control ? "  FAIL: control not detected" : "  FAIL") : "");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * Mint Entropy Collector Benchmark
+ *
+ * Runs MintEntropy against emulated ROSC and ADC noise in virtual time and
+ * checks that the pool is ready well before a host could mount the disk
+ * and drop a file, that stuck and biased sources are caught by the health
+ * tests and taken out of the pool, that either source alone still fills
+ * it, and that a late task loses samples instead of crediting them twice.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/entropy_bench.cpp \
+ *         tests/host/arduino_host.cpp mint_entropy.cpp mint_hash.cpp -o entropy_bench
+ *     ./entropy_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include "mint_entropy.h"
+#include "bench_host.h"
+
+// Entropy task period (see mint.cpp)
+#define TASK_PERIOD_US 10000
+
+// A host enumerates, mounts and writes a file no sooner than this
+#define FIRST_DROP_MS 1000
+
+/**
+ * Run the collector task on its period until the pool is ready.
+ * @return Milliseconds from begin() to ready, or -1 on timeout
+ */
+static double runUntilReady(MintEntropy& entropy, uint64_t timeout_us,
+                            uint64_t period_us = TASK_PERIOD_US) {
+    const uint64_t start = MintHost::now();
+    while (!entropy.isReady() && MintHost::now() - start < timeout_us) {
+        MintHost::advance(period_us);
+        entropy.task();
+    }
+    return entropy.isReady() ? (MintHost::now() - start) / 1000.0 : -1;
+}
+
+static void report(const char* name, const MintEntropy& entropy, double ready_ms) {
+    const MintEntropy::SourceStats& rosc = entropy.getStats(MintEntropy::SOURCE_ROSC);
+    const MintEntropy::SourceStats& adc = entropy.getStats(MintEntropy::SOURCE_ADC);
+    printf("  %-14s ready %7.1f ms  rosc %5u bits %2u fails %-3s  adc %5u bits %2u fails %s\n",
+           name, ready_ms, rosc.credited_bits, rosc.failures, rosc.enabled ? "on" : "off",
+           adc.credited_bits, adc.failures, adc.enabled ? "on" : "off");
+}
+
+static void reset() {
+    MintHost::resetClock();
+    MintHost::setRoscNoise(nullptr);
+    MintHost::setAnalogNoise(ANALOG_NOISE_PIN, nullptr);
+    MintHost::setAnalog(ANALOG_NOISE_PIN, 0);
+}
+
+/**
+ * Both sources healthy: ready long before a file can arrive, draws are
+ * distinct and empty the pool.
+ */
+static void healthy() {
+    reset();
+    MintEntropy entropy(ANALOG_NOISE_PIN);
+    check(entropy.begin(), "sources start");
+    check(!entropy.isReady(), "not ready at boot");
+    uint8_t none[ENTROPY_OUTPUT_SIZE];
+    check(!entropy.draw(none, sizeof(none)), "no draw before ready");
+
+    double ready_ms = runUntilReady(entropy, 5000000);
+    report("healthy", entropy, ready_ms);
+    check(ready_ms > 0 && ready_ms < FIRST_DROP_MS, "ready before a file can arrive");
+    check(entropy.getStats(MintEntropy::SOURCE_ROSC).failures == 0 &&
+          entropy.getStats(MintEntropy::SOURCE_ADC).failures == 0, "no health failures");
+
+    uint8_t first[ENTROPY_OUTPUT_SIZE], second[ENTROPY_OUTPUT_SIZE];
+    check(entropy.draw(first, sizeof(first)), "draw");
+    check(!entropy.isReady() && entropy.getPoolBits() == 0, "draw empties the pool");
+    check(runUntilReady(entropy, 5000000) > 0, "refills");
+    check(entropy.draw(second, sizeof(second)), "second draw");
+    check(memcmp(first, second, sizeof(first)) != 0, "draws differ");
+}
+
+/**
+ * A stuck ring oscillator is dropped; the ADC fills the pool alone.
+ */
+static void stuckRosc() {
+    reset();
+    MintHost::setRoscNoise([](uint64_t) { return 1; });
+    MintEntropy entropy(ANALOG_NOISE_PIN);
+    entropy.begin();
+    double ready_ms = runUntilReady(entropy, 5000000);
+    report("stuck ROSC", entropy, ready_ms);
+    const MintEntropy::SourceStats& rosc = entropy.getStats(MintEntropy::SOURCE_ROSC);
+    check(!rosc.enabled && rosc.failures > 0, "stuck ROSC disabled");
+    check(rosc.credited_bits == 0, "stuck ROSC never credited");
+    check(ready_ms > 0 && ready_ms < FIRST_DROP_MS, "ADC alone fills the pool in time");
+}
+
+/**
+ * A shorted noise pin is dropped; the ring oscillator fills the pool alone.
+ */
+static void stuckAdc() {
+    reset();
+    MintHost::setAnalogNoise(ANALOG_NOISE_PIN, [](uint64_t) { return 0; });
+    MintHost::setAnalog(ANALOG_NOISE_PIN, 2048);
+    MintEntropy entropy(ANALOG_NOISE_PIN);
+    entropy.begin();
+    double ready_ms = runUntilReady(entropy, 5000000);
+    report("stuck ADC", entropy, ready_ms);
+    const MintEntropy::SourceStats& adc = entropy.getStats(MintEntropy::SOURCE_ADC);
+    check(!adc.enabled && adc.failures > 0 && adc.credited_bits == 0, "stuck ADC disabled");
+    check(ready_ms > 0 && ready_ms < FIRST_DROP_MS, "ROSC alone fills the pool in time");
+}
+
+/**
+ * A ring oscillator biased past its claimed entropy trips the adaptive
+ * proportion test without ever repeating long enough for the repetition
+ * count test.
+ */
+static void biasedRosc() {
+    reset();
+    MintHost::setRoscNoise([](uint64_t time_us) {
+        // 31 ones in 32, in short runs
+        return (int)((time_us / 50) % 32 != 0);
+    });
+    MintHost::setAnalogNoise(ANALOG_NOISE_PIN, [](uint64_t) { return 0; });
+    MintEntropy entropy(ANALOG_NOISE_PIN);
+    entropy.begin();
+    double ready_ms = runUntilReady(entropy, 2000000);
+    report("biased ROSC", entropy, ready_ms);
+    const MintEntropy::SourceStats& rosc = entropy.getStats(MintEntropy::SOURCE_ROSC);
+    check(!rosc.enabled && rosc.credited_bits == 0, "biased ROSC disabled");
+    check(ready_ms < 0, "no healthy source, never ready");
+    uint8_t out[ENTROPY_OUTPUT_SIZE];
+    check(!entropy.draw(out, sizeof(out)), "no draw without a healthy source");
+}
+
+/**
+ * A task running far behind loses samples to the ring and counts them,
+ * and still fills the pool.
+ */
+static void lateTask() {
+    reset();
+    MintEntropy entropy(ANALOG_NOISE_PIN);
+    entropy.begin();
+    double ready_ms = runUntilReady(entropy, 5000000, 200000);
+    report("200 ms task", entropy, ready_ms);
+    check(entropy.getStats(MintEntropy::SOURCE_ROSC).overruns > 0, "overruns counted");
+    check(ready_ms > 0, "fills despite overruns");
+}
+
+int main() {
+    printf("Entropy collector\n");
+    healthy();
+    stuckRosc();
+    stuckAdc();
+    biasedRosc();
+    lateTask();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * Mint Entropy File Estimator Benchmark
+ *
+ * Runs the streaming min-entropy estimator (mint_estimator.h) over files
+ * a user might drop: random bytes, an all-zero sector, a short text file,
+ * a page of prose, repeated patterns. Checks that random data is credited
+ * in full and degenerate files next to nothing, that feeding a file in
+ * pieces gives the same estimates as feeding it whole, and reports the
+ * time an estimate takes. Then drops a zero file and a random file on
+ * simulated devices and checks that only the first README warns.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/estimator_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o estimator_bench
+ *     ./estimator_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_estimator.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Estimates timed per file, for a stable mean
+#define TIMING_RUNS 2000
+
+static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static std::vector<uint8_t> randomBytes(size_t size, uint64_t seed) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)splitmix(seed);
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> repeated(const std::string& unit, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)unit[i % unit.size()];
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> text(const char* content) {
+    return std::vector<uint8_t>(content, content + strlen(content));
+}
+
+static const char* PROSE =
+    "It was a bright cold day in April, and the clocks were striking thirteen. "
+    "Winston Smith, his chin nuzzled into his breast in an effort to escape the "
+    "vile wind, slipped quickly through the glass doors of Victory Mansions, "
+    "though not quickly enough to prevent a swirl of gritty dust from entering "
+    "along with him. The hallway smelt of boiled cabbage and old rag mats. At "
+    "one end of it a coloured poster, too large for indoor display, had been "
+    "tacked to the wall. It depicted simply an enormous face, more than a metre "
+    "wide: the face of a man of about forty-five, with a heavy black moustache.";
+
+static MintEntropyEstimator::Estimate estimate(const std::vector<uint8_t>& file,
+                                               size_t piece = 0) {
+    MintEntropyEstimator estimator;
+    if (!piece) {
+        piece = file.size();
+    }
+    for (size_t offset = 0; offset < file.size(); offset += piece) {
+        estimator.update(file.data() + offset, std::min(piece, file.size() - offset));
+    }
+    MintEntropyEstimator::Estimate result;
+    estimator.finish(result);
+    return result;
+}
+
+static bool same(const MintEntropyEstimator::Estimate& a, const MintEntropyEstimator::Estimate& b) {
+    return a.bytes == b.bytes && a.mcv_millibits == b.mcv_millibits &&
+           a.markov_millibits == b.markov_millibits &&
+           a.compression_millibits == b.compression_millibits &&
+           a.credited_bits == b.credited_bits;
+}
+
+/**
+ * Estimates for sample files. Bits per byte are the estimators' upper
+ * bounds, so only the verdicts are checked.
+ */
+static void benchFiles() {
+    printf("Files                  bytes   mcv  markov  compr  credited\n");
+    typedef struct {
+        const char* name;
+        std::vector<uint8_t> data;
+        bool weak;
+    } Case;
+    const std::vector<Case> cases = {
+        { "random", randomBytes(512, 1), false },
+        { "random, 128 bytes", randomBytes(128, 2), false },
+        { "zeros", std::vector<uint8_t>(512, 0), true },
+        { "0xFF", std::vector<uint8_t>(512, 0xFF), true },
+        { "short text", text("my secret seed phrase\n"), true },
+        { "ABCD repeated", repeated("ABCD", 512), true },
+        { "zero/one bytes", repeated(std::string("\x00\x01", 2), 512), true },
+        { "prose", repeated(PROSE, 512), false },
+    };
+
+    for (const Case& c : cases) {
+        MintEntropyEstimator::Estimate e = estimate(c.data);
+        printf("  %-18s %6u %5.2f %7.2f %6.2f %9u\n", c.name, (unsigned)e.bytes,
+               e.mcv_millibits / 1000.0, e.markov_millibits / 1000.0,
+               e.compression_millibits / 1000.0, (unsigned)e.credited_bits);
+        const bool weak = e.credited_bits < ESTIMATOR_WEAK_FILE_BITS;
+        check(weak == c.weak, c.weak ? "degenerate file is weak" : "file with entropy is not weak");
+    }
+
+    check(estimate(cases[0].data).credited_bits == ESTIMATOR_MAX_CREDIT_BITS,
+          "random sector credited in full");
+    check(estimate(cases[2].data).credited_bits == 0, "zero sector credited nothing");
+    check(estimate(std::vector<uint8_t>()).credited_bits == 0, "empty file credited nothing");
+
+    // Streaming: sector pieces of any size give the same answer
+    for (size_t piece : { 1, 7, 64, 511 }) {
+        check(same(estimate(cases[0].data, piece), estimate(cases[0].data)),
+              "random file estimated in pieces");
+        check(same(estimate(cases[7].data, piece), estimate(cases[7].data)),
+              "prose estimated in pieces");
+    }
+}
+
+static void benchTiming() {
+    std::vector<uint8_t> file = randomBytes(MINT_ENTROPY_FILE_SIZE, 3);
+    MintEntropyEstimator estimator;
+    MintEntropyEstimator::Estimate result;
+    uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TIMING_RUNS; i++) {
+        estimator.reset();
+        estimator.update(file.data(), file.size());
+        estimator.finish(result);
+        sink += result.credited_bits;
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    printf("Timing\n  %-24s %8.2f us per %u-byte file (host), %zu bytes of state\n",
+           "reset, update, finish", elapsed.count() / TIMING_RUNS,
+           (unsigned)MINT_ENTROPY_FILE_SIZE, sizeof(MintEntropyEstimator));
+    check(sink == (uint32_t)TIMING_RUNS * ESTIMATOR_MAX_CREDIT_BITS, "timed estimates agree");
+}
+
+/**
+ * Drop a file on a fresh device and wait for its sealed README.
+ * @return README text, empty if the device did not seal
+ */
+static std::string sealWith(const std::vector<uint8_t>& file,
+                            MintEntropyEstimator::Estimate& estimate) {
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    std::unique_ptr<MintDevice> device(new MintDevice());
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(*device, MintHost::now() + 500);
+    });
+    if (!device->begin() || !host.mount() ||
+        !host.writeFile("ENTROPY BIN", nullptr, file.data(), file.size())) {
+        return std::string();
+    }
+    runDevice(*device, MintHost::now() + 10000000);
+    estimate = device->getFileEstimate();
+    std::vector<uint8_t> readme;
+    if (device->getState() != MintDevice::MINT_STATE_READY_WITH_WALLET ||
+        !host.readFile("README  TXT", readme)) {
+        return std::string();
+    }
+    return std::string(readme.begin(), readme.end());
+}
+
+static void benchDevice() {
+    printf("Device\n");
+    MintEntropyEstimator::Estimate weak, strong;
+    const std::string weak_readme = sealWith(std::vector<uint8_t>(512, 0), weak);
+    const std::string strong_readme = sealWith(randomBytes(512, 4), strong);
+    printf("  %-24s %u bits credited\n", "zero file", (unsigned)weak.credited_bits);
+    printf("  %-24s %u bits credited\n", "random file", (unsigned)strong.credited_bits);
+
+    check(!weak_readme.empty() && !strong_readme.empty(), "both devices seal");
+    check(weak.bytes == 512 && weak.credited_bits == 0, "zero file estimate recorded");
+    check(strong.credited_bits == ESTIMATOR_MAX_CREDIT_BITS, "random file estimate recorded");
+    check(weak_readme.size() == MINT_README_SEALED_WEAK_FILE.length &&
+          weak_readme.find("added almost no entropy") != std::string::npos,
+          "weak file README warns");
+    check(strong_readme.size() == MINT_README_SEALED.length &&
+          strong_readme.find("added almost no entropy") == std::string::npos,
+          "random file README does not warn");
+}
+
+int main() {
+    benchFiles();
+    benchTiming();
+    benchDevice();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
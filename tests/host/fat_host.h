@@ -0,0 +1,372 @@
+/**
+ * Host-side FAT12 access for harnesses acting as the USB host.
+ *
+ * Creates files and folders on the device's MSC disk the way desktop
+ * hosts do, through Adafruit_USBD_MSC::hostRead()/hostWrite(): clusters
+ * are allocated from the FAT, long names get their LFN entries, and the
+ * data, FAT and directory sectors are written in a chosen order. Only
+ * changed sectors are written. The step hook runs after every sector
+ * write and whenever the disk answers busy, so a harness can run device
+ * tasks between writes and check what the device saw after each one.
+ */
+#ifndef MINT_HOST_FAT_H
+#define MINT_HOST_FAT_H
+
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "mint_fat.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// Busy answers tolerated for one sector before giving up
+#define HOST_FAT_MAX_RETRIES 100000
+
+class HostFat {
+public:
+    typedef std::function<void()> StepHook;
+
+    typedef enum {
+        ORDER_DATA_FAT_DIR,         // Windows: data, FAT, then the directory entry
+        ORDER_DIR_DATA_FAT_DIR,     // macOS: empty entry first, size filled in last
+        ORDER_FAT_DIR_DATA          // Metadata first, data last
+    } WriteOrder;
+
+    HostFat(Adafruit_USBD_MSC* usb_msc, StepHook step_hook = nullptr) :
+        msc(usb_msc), step(step_hook), writes(0), last_write_us(0) {
+        memset(&geometry, 0, sizeof(geometry));
+    }
+
+    bool mount() {
+        uint8_t sector[FAT_SECTOR_SIZE];
+        return readSector(0, sector) && MintFatVolume::parseBootSector(sector, geometry);
+    }
+
+    /**
+     * Create a file in the root directory.
+     * @param short_name 8.3 name, 11 characters space padded ("ENTROPY BIN")
+     * @param long_name Long name, or nullptr for none
+     */
+    bool writeFile(const char* short_name, const char* long_name, const uint8_t* data,
+                   size_t size, WriteOrder order = ORDER_DATA_FAT_DIR,
+                   uint8_t attributes = FAT_ATTR_ARCHIVE) {
+        std::vector<uint8_t> fat, root;
+        if (!load(fat, root)) {
+            return false;
+        }
+        const std::vector<uint8_t> fat_before = fat, root_before = root;
+
+        const size_t cluster_bytes = geometry.sectors_per_cluster * FAT_SECTOR_SIZE;
+        std::vector<uint16_t> chain;
+        if (size && !allocate(fat, (size + cluster_bytes - 1) / cluster_bytes, chain)) {
+            return false;
+        }
+        size_t slot;
+        std::vector<uint8_t> entries = buildEntries(short_name, long_name, attributes,
+                                                    chain.empty() ? 0 : chain[0], size);
+        if (!findSlots(root, entries.size() / FAT_DIR_ENTRY_SIZE, slot)) {
+            return false;
+        }
+        uint8_t* sfn = &root[slot + entries.size() - FAT_DIR_ENTRY_SIZE];
+
+        if (order == ORDER_DIR_DATA_FAT_DIR) {
+            // Entry without clusters or size first
+            memcpy(&root[slot], entries.data(), entries.size());
+            setEntry(sfn, 0, 0);
+            if (!storeRoot(root, root_before)) {
+                return false;
+            }
+        }
+        std::vector<uint8_t> root_now = root;
+        memcpy(&root[slot], entries.data(), entries.size());
+
+        if (order == ORDER_FAT_DIR_DATA) {
+            return storeFat(fat, fat_before) && storeRoot(root, root_now) &&
+                   writeData(chain, data, size);
+        }
+        return writeData(chain, data, size) && storeFat(fat, fat_before) &&
+               storeRoot(root, root_now);
+    }
+
+    /**
+     * Create an empty folder in the root directory.
+     */
+    bool makeDirectory(const char* short_name, const char* long_name,
+                       uint8_t attributes = FAT_ATTR_DIRECTORY) {
+        std::vector<uint8_t> fat, root;
+        if (!load(fat, root)) {
+            return false;
+        }
+        const std::vector<uint8_t> fat_before = fat, root_before = root;
+
+        std::vector<uint16_t> chain;
+        if (!allocate(fat, 1, chain)) {
+            return false;
+        }
+        std::vector<uint8_t> cluster(geometry.sectors_per_cluster * FAT_SECTOR_SIZE, 0);
+        memcpy(&cluster[0], ".          ", 11);
+        cluster[11] = FAT_ATTR_DIRECTORY;
+        setEntry(&cluster[0], chain[0], 0);
+        memcpy(&cluster[FAT_DIR_ENTRY_SIZE], "..         ", 11);
+        cluster[FAT_DIR_ENTRY_SIZE + 11] = FAT_ATTR_DIRECTORY;
+
+        size_t slot;
+        std::vector<uint8_t> entries = buildEntries(short_name, long_name,
+                                                    attributes | FAT_ATTR_DIRECTORY, chain[0], 0);
+        if (!findSlots(root, entries.size() / FAT_DIR_ENTRY_SIZE, slot)) {
+            return false;
+        }
+        memcpy(&root[slot], entries.data(), entries.size());
+        return writeData(chain, cluster.data(), cluster.size()) && storeFat(fat, fat_before) &&
+               storeRoot(root, root_before);
+    }
+
+    /**
+     * Read a root directory file by its 8.3 name.
+     */
+    bool readFile(const char* short_name, std::vector<uint8_t>& out) {
+        std::vector<uint8_t> fat, root;
+        if (!load(fat, root)) {
+            return false;
+        }
+        for (size_t i = 0; i < root.size(); i += FAT_DIR_ENTRY_SIZE) {
+            MintFatEntry entry;
+            if (MintFatVolume::parseDirEntry(&root[i - i % FAT_SECTOR_SIZE],
+                                             (i % FAT_SECTOR_SIZE) / FAT_DIR_ENTRY_SIZE,
+                                             entry) != MintFatVolume::ENTRY_VALID ||
+                memcmp(entry.name, short_name, 11) != 0) {
+                continue;
+            }
+            out.clear();
+            uint16_t cluster = entry.start_cluster;
+            while (out.size() < entry.size && cluster >= FAT_FIRST_CLUSTER &&
+                   cluster < FAT12_EOC_MIN) {
+                uint32_t first = geometry.data_start +
+                                 (cluster - FAT_FIRST_CLUSTER) * geometry.sectors_per_cluster;
+                for (uint32_t s = 0; s < geometry.sectors_per_cluster && out.size() < entry.size; s++) {
+                    uint8_t sector[FAT_SECTOR_SIZE];
+                    if (!readSector(first + s, sector)) {
+                        return false;
+                    }
+                    size_t take = std::min((size_t)FAT_SECTOR_SIZE, (size_t)entry.size - out.size());
+                    out.insert(out.end(), sector, sector + take);
+                }
+                cluster = MintFatVolume::getFat12(fat.data(), cluster);
+            }
+            return out.size() == entry.size;
+        }
+        return false;
+    }
+
+    const MintFatGeometry& getGeometry() const { return geometry; }
+
+    // Sector writes so far, and the virtual time of the last one
+    /**
+     * Save the whole volume as an image file, for host tools that read
+     * device images. All-zero sectors are left as holes.
+     * @param path Image file to write
+     */
+    bool saveImage(const char* path) {
+        FILE* f = fopen(path, "wb");
+        if (!f) {
+            return false;
+        }
+        static const uint8_t blank[FAT_SECTOR_SIZE] = {};
+        uint8_t sector[FAT_SECTOR_SIZE];
+        bool ok = geometry.total_sectors > 0;
+        for (uint32_t lba = 0; ok && lba < geometry.total_sectors; lba++) {
+            ok = readSector(lba, sector);
+            if (ok && memcmp(sector, blank, sizeof(sector)) != 0) {
+                ok = fseek(f, (long)lba * FAT_SECTOR_SIZE, SEEK_SET) == 0 &&
+                     fwrite(sector, 1, sizeof(sector), f) == sizeof(sector);
+            }
+        }
+        ok = ok && fflush(f) == 0 &&
+             ftruncate(fileno(f), (off_t)geometry.total_sectors * FAT_SECTOR_SIZE) == 0;
+        return fclose(f) == 0 && ok;
+    }
+
+    uint32_t getWriteCount() const { return writes; }
+    uint64_t getLastWriteTime() const { return last_write_us; }
+
+private:
+    Adafruit_USBD_MSC* msc;
+    StepHook step;
+    MintFatGeometry geometry;
+    uint32_t writes;
+    uint64_t last_write_us;
+
+    bool readSector(uint32_t lba, uint8_t* buffer) {
+        for (int i = 0; i < HOST_FAT_MAX_RETRIES; i++) {
+            int32_t result = msc->hostRead(lba, buffer, FAT_SECTOR_SIZE);
+            if (result == FAT_SECTOR_SIZE) {
+                return true;
+            }
+            if (result < 0 || !step) {
+                return false;
+            }
+            step();
+        }
+        return false;
+    }
+
+    bool writeSector(uint32_t lba, const uint8_t* data) {
+        uint8_t buffer[FAT_SECTOR_SIZE];
+        memcpy(buffer, data, sizeof(buffer));
+        for (int i = 0; i < HOST_FAT_MAX_RETRIES; i++) {
+            int32_t result = msc->hostWrite(lba, buffer, FAT_SECTOR_SIZE);
+            if (result == FAT_SECTOR_SIZE) {
+                writes++;
+                last_write_us = MintHost::now();
+                if (step) {
+                    step();
+                }
+                return true;
+            }
+            if (result < 0 || !step) {
+                return false;
+            }
+            step();
+        }
+        return false;
+    }
+
+    bool readRange(uint32_t first, uint32_t count, std::vector<uint8_t>& out) {
+        out.assign(count * FAT_SECTOR_SIZE, 0);
+        for (uint32_t i = 0; i < count; i++) {
+            if (!readSector(first + i, &out[i * FAT_SECTOR_SIZE])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeChanged(uint32_t first, const std::vector<uint8_t>& now,
+                      const std::vector<uint8_t>& before) {
+        for (size_t i = 0; i < now.size(); i += FAT_SECTOR_SIZE) {
+            if (memcmp(&now[i], &before[i], FAT_SECTOR_SIZE) != 0 &&
+                !writeSector(first + i / FAT_SECTOR_SIZE, &now[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool load(std::vector<uint8_t>& fat, std::vector<uint8_t>& root) {
+        return (geometry.fat_sectors || mount()) &&
+               readRange(geometry.fat_start, geometry.fat_sectors, fat) &&
+               readRange(geometry.root_start, geometry.root_sectors, root);
+    }
+
+    bool storeFat(const std::vector<uint8_t>& fat, const std::vector<uint8_t>& before) {
+        return writeChanged(geometry.fat_start, fat, before);
+    }
+
+    bool storeRoot(const std::vector<uint8_t>& root, const std::vector<uint8_t>& before) {
+        return writeChanged(geometry.root_start, root, before);
+    }
+
+    bool allocate(std::vector<uint8_t>& fat, size_t count, std::vector<uint16_t>& chain) {
+        for (uint16_t c = FAT_FIRST_CLUSTER;
+             c < geometry.cluster_count + FAT_FIRST_CLUSTER && chain.size() < count; c++) {
+            if (MintFatVolume::getFat12(fat.data(), c) == FAT12_FREE) {
+                chain.push_back(c);
+            }
+        }
+        if (chain.size() < count) {
+            return false;
+        }
+        for (size_t i = 0; i < chain.size(); i++) {
+            MintFatVolume::setFat12(fat.data(), chain[i],
+                                    i + 1 < chain.size() ? chain[i + 1] : FAT12_EOC);
+        }
+        return true;
+    }
+
+    bool writeData(const std::vector<uint16_t>& chain, const uint8_t* data, size_t size) {
+        size_t offset = 0;
+        for (uint16_t cluster : chain) {
+            uint32_t first = geometry.data_start +
+                             (cluster - FAT_FIRST_CLUSTER) * geometry.sectors_per_cluster;
+            for (uint32_t s = 0; s < geometry.sectors_per_cluster && offset < size; s++) {
+                uint8_t sector[FAT_SECTOR_SIZE];
+                memset(sector, 0, sizeof(sector));
+                memcpy(sector, data + offset, std::min((size_t)FAT_SECTOR_SIZE, size - offset));
+                if (!writeSector(first + s, sector)) {
+                    return false;
+                }
+                offset += FAT_SECTOR_SIZE;
+            }
+        }
+        return true;
+    }
+
+    bool findSlots(const std::vector<uint8_t>& root, size_t count, size_t& slot) {
+        size_t run = 0;
+        for (size_t i = 0; i < root.size(); i += FAT_DIR_ENTRY_SIZE) {
+            bool free_entry = root[i] == FAT_DIR_END || root[i] == FAT_DIR_DELETED;
+            run = free_entry ? run + 1 : 0;
+            if (run == count) {
+                slot = i + FAT_DIR_ENTRY_SIZE - count * FAT_DIR_ENTRY_SIZE;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void setEntry(uint8_t* entry, uint16_t cluster, uint32_t size) {
+        entry[26] = (uint8_t)cluster;
+        entry[27] = (uint8_t)(cluster >> 8);
+        entry[28] = (uint8_t)size;
+        entry[29] = (uint8_t)(size >> 8);
+        entry[30] = (uint8_t)(size >> 16);
+        entry[31] = (uint8_t)(size >> 24);
+    }
+
+    static uint8_t shortNameChecksum(const char* name) {
+        uint8_t sum = 0;
+        for (int i = 0; i < 11; i++) {
+            sum = (uint8_t)(((sum & 1) << 7) + (sum >> 1) + (uint8_t)name[i]);
+        }
+        return sum;
+    }
+
+    // LFN entries, last part first, then the short-name entry
+    static std::vector<uint8_t> buildEntries(const char* short_name, const char* long_name,
+                                             uint8_t attributes, uint16_t cluster, uint32_t size) {
+        static const uint8_t CHAR_OFFSETS[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+        std::vector<uint8_t> entries;
+        if (long_name) {
+            size_t length = strlen(long_name);
+            size_t parts = (length + 12) / 13;
+            uint8_t checksum = shortNameChecksum(short_name);
+            for (size_t p = parts; p > 0; p--) {
+                uint8_t lfn[FAT_DIR_ENTRY_SIZE];
+                memset(lfn, 0, sizeof(lfn));
+                lfn[0] = (uint8_t)(p | (p == parts ? 0x40 : 0));
+                lfn[11] = FAT_ATTR_LONG_NAME;
+                lfn[13] = checksum;
+                for (size_t c = 0; c < 13; c++) {
+                    size_t index = (p - 1) * 13 + c;
+                    uint16_t ch = index < length ? (uint8_t)long_name[index] :
+                                  index == length ? 0x0000 : 0xFFFF;
+                    lfn[CHAR_OFFSETS[c]] = (uint8_t)ch;
+                    lfn[CHAR_OFFSETS[c] + 1] = (uint8_t)(ch >> 8);
+                }
+                entries.insert(entries.end(), lfn, lfn + sizeof(lfn));
+            }
+        }
+        uint8_t sfn[FAT_DIR_ENTRY_SIZE];
+        memset(sfn, 0, sizeof(sfn));
+        memcpy(sfn, short_name, 11);
+        sfn[11] = attributes;
+        setEntry(sfn, cluster, size);
+        entries.insert(entries.end(), sfn, sfn + sizeof(sfn));
+        return entries;
+    }
+};
+
+#endif // MINT_HOST_FAT_H
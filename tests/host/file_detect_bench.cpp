@@ -0,0 +1,279 @@
+/**
+ * Mint File Detection Benchmark
+ *
+ * Drops files onto MintStorage the way Windows and macOS write them
+ * (tests/host/fat_host.h) and checks that the storage task hands a user
+ * file to the device exactly once, on the storage task run after its last
+ * sector lands, with the right bytes and size; that half-written files
+ * and host metadata (.DS_Store, ._ files, .fseventsd, .Spotlight-V100,
+ * System Volume Information, desktop.ini, hidden files) are never handed
+ * over; that a handed-over file is zeroed and freed on the disk; and
+ * that README.TXT is a real file and the FAT stays intact.
+ * Reports the delay from the last host write to the hand-over, against
+ * the one-second quiet period the storage layer used to wait.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/file_detect_bench.cpp \
+ *         tests/host/arduino_host.cpp mint_storage.cpp mint_fat.cpp \
+ *         mint_log.cpp -o file_detect_bench
+ *     ./file_detect_bench
+ *
+ * Add -DMINT_STORAGE_FLASH mint_flash.cpp tests/host/SPI.cpp to run the
+ * same checks on the flash volume.
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "mint_storage.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <algorithm>
+#include <memory>
+
+// Storage task period (see mint.cpp)
+#ifdef MINT_STORAGE_FLASH
+#define STORAGE_PERIOD_US 1000
+#else
+#define STORAGE_PERIOD_US 10000
+#endif
+
+// Host pause between sector writes
+#define HOST_WRITE_GAP_US 500
+
+// What the storage layer waited for before
+#define OLD_QUIET_PERIOD_MS 1000
+
+/**
+ * Storage with its task on a fixed period, recording hand-overs.
+ */
+struct Rig {
+    std::unique_ptr<MintStorage> storage;
+    std::unique_ptr<HostFat> host;
+    uint64_t next_task_us;
+    uint32_t handovers;
+    uint32_t handover_write;        // Host sector writes seen at the hand-over
+    uint64_t handover_us;
+    std::vector<uint8_t> handed;
+
+    Rig() : next_task_us(0), handovers(0), handover_write(0), handover_us(0) {
+#ifdef MINT_STORAGE_FLASH
+        SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+        MintHost::resetClock();
+        storage.reset(new MintStorage());
+        check(storage->begin(), "storage starts");
+        storage->setFileChangedCallback([this](uint8_t* buffer, size_t size) {
+            handovers++;
+            handover_write = host->getWriteCount();
+            handover_us = MintHost::now();
+            handed.assign(buffer, buffer + size);
+        });
+        host.reset(new HostFat(Adafruit_USBD_MSC::lastInstance(), [this]() { step(); }));
+        check(host->mount(), "host mounts the volume");
+        next_task_us = MintHost::now();
+    }
+
+    void run(uint64_t until_us) {
+        while (MintHost::now() < until_us) {
+            if (MintHost::now() >= next_task_us) {
+                storage->task();
+                do {
+                    next_task_us += STORAGE_PERIOD_US;
+                } while (next_task_us <= MintHost::now());
+            }
+            MintHost::advance(std::min<uint64_t>(next_task_us, until_us) - MintHost::now());
+        }
+    }
+
+    void step() {
+        run(MintHost::now() + HOST_WRITE_GAP_US);
+    }
+
+    void settle() {
+        run(MintHost::now() + 2 * OLD_QUIET_PERIOD_MS * 1000);
+    }
+
+    double latencyMs() const {
+        return (handover_us - host->getLastWriteTime()) / 1000.0;
+    }
+};
+
+static std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i * 131 + seed);
+    }
+    return data;
+}
+
+static void checkHandover(Rig& rig, const std::vector<uint8_t>& file, const char* name) {
+    size_t expected = std::min(file.size(), (size_t)FAT_SECTOR_SIZE);
+    check(rig.handovers == 1, "handed over exactly once");
+    check(rig.handover_write == rig.host->getWriteCount(), "handed over after the last write");
+    check(rig.handed.size() == expected &&
+          memcmp(rig.handed.data(), file.data(), expected) == 0, "file bytes handed over");
+    printf("  %-28s %8.2f ms after the last write (was >= %d ms)\n", name, rig.latencyMs(),
+           OLD_QUIET_PERIOD_MS);
+    check(rig.latencyMs() * 1000 <= STORAGE_PERIOD_US, "within one storage task period");
+}
+
+/**
+ * Windows: data, FAT, then the directory entry.
+ */
+static void windowsDrop() {
+    Rig rig;
+    std::vector<uint8_t> file = pattern(512, 7);
+    check(rig.host->writeFile("ENTROPY BIN", nullptr, file.data(), file.size(),
+                              HostFat::ORDER_DATA_FAT_DIR), "host write");
+    rig.settle();
+    checkHandover(rig, file, "Windows order");
+}
+
+/**
+ * macOS: metadata folders and .DS_Store, an empty entry first, the file,
+ * then its AppleDouble companion.
+ */
+static void macDrop() {
+    Rig rig;
+    std::vector<uint8_t> ds_store = pattern(1024, 1);
+    std::vector<uint8_t> apple_double = pattern(512, 2);
+    std::vector<uint8_t> file = pattern(700, 3);
+
+    check(rig.host->makeDirectory("FSEVEN~1   ", ".fseventsd"), "fseventsd");
+    check(rig.host->makeDirectory("SPOTLI~1   ", ".Spotlight-V100"), "Spotlight");
+    check(rig.host->writeFile("DS_STO~1   ", ".DS_Store", ds_store.data(), ds_store.size(),
+                              HostFat::ORDER_DIR_DATA_FAT_DIR), ".DS_Store");
+    rig.run(MintHost::now() + 50000);
+    check(rig.handovers == 0, "metadata is not handed over");
+
+    check(rig.host->writeFile("ENTROPY BIN", "entropy.bin", file.data(), file.size(),
+                              HostFat::ORDER_DIR_DATA_FAT_DIR), "host write");
+    uint32_t file_writes = rig.host->getWriteCount();
+    uint64_t last_write = rig.host->getLastWriteTime();
+    check(rig.host->writeFile("_ENTRO~1BIN", "._entropy.bin", apple_double.data(),
+                              apple_double.size(), HostFat::ORDER_DIR_DATA_FAT_DIR), "._ file");
+    rig.settle();
+
+    check(rig.handovers == 1, "handed over exactly once");
+    check(rig.handover_write >= file_writes, "handed over after the file's last write");
+    check(rig.handed.size() == 512 && memcmp(rig.handed.data(), file.data(), 512) == 0,
+          "first sector handed over");
+    double latency = (rig.handover_us - last_write) / 1000.0;
+    printf("  %-28s %8.2f ms after the last write (was >= %d ms)\n", "macOS order", latency,
+           OLD_QUIET_PERIOD_MS);
+    check(latency * 1000 <= STORAGE_PERIOD_US, "within one storage task period");
+}
+
+/**
+ * Directory entry and FAT first: nothing may be handed over until the
+ * last data sector is written.
+ */
+static void partialDrop() {
+    Rig rig;
+    std::vector<uint8_t> file = pattern(4 * FAT_SECTOR_SIZE, 9);
+    check(rig.host->writeFile("BIGFILE BIN", nullptr, file.data(), file.size(),
+                              HostFat::ORDER_FAT_DIR_DATA), "host write");
+    rig.settle();
+    checkHandover(rig, file, "metadata first, 4 sectors");
+}
+
+/**
+ * Files a Windows host leaves behind, and a hidden file.
+ */
+static void metadataOnly() {
+    Rig rig;
+    std::vector<uint8_t> data = pattern(300, 5);
+    check(rig.host->makeDirectory("SYSTEM~1   ", "System Volume Information",
+                                  FAT_ATTR_DIRECTORY | FAT_ATTR_HIDDEN | FAT_ATTR_SYSTEM),
+          "System Volume Information");
+    check(rig.host->writeFile("DESKTOP INI", "desktop.ini", data.data(), data.size()),
+          "desktop.ini");
+    check(rig.host->writeFile("THUMBS  DB ", "Thumbs.db", data.data(), data.size()), "Thumbs.db");
+    check(rig.host->writeFile("SECRET  BIN", nullptr, data.data(), data.size(),
+                              HostFat::ORDER_DATA_FAT_DIR, FAT_ATTR_HIDDEN), "hidden file");
+    rig.settle();
+    printf("  %-28s %8u hand-overs\n", "metadata only", rig.handovers);
+    check(rig.handovers == 0, "metadata is not handed over");
+}
+
+/**
+ * A file spanning clusters is gone from the disk once handed over: no
+ * sector holds its bytes and the FAT is back as it was.
+ */
+static void erasedDrop() {
+    Rig rig;
+    Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::lastInstance();
+    const MintFatGeometry& geometry = rig.host->getGeometry();
+    uint8_t fat_before[FAT_SECTOR_SIZE];
+    uint8_t fat_after[FAT_SECTOR_SIZE];
+    msc->hostRead(geometry.fat_start, fat_before, sizeof(fat_before));
+
+    const size_t cluster_bytes = (size_t)geometry.sectors_per_cluster * FAT_SECTOR_SIZE;
+    std::vector<uint8_t> file = pattern(2 * cluster_bytes + 100, 13);
+    check(rig.host->writeFile("ENTROPY BIN", nullptr, file.data(), file.size()), "host write");
+    rig.settle();
+    check(rig.handovers == 1 && rig.handed.size() == FAT_SECTOR_SIZE &&
+          memcmp(rig.handed.data(), file.data(), FAT_SECTOR_SIZE) == 0, "file bytes handed over");
+
+    std::vector<uint8_t> left;
+    check(!rig.host->readFile("ENTROPY BIN", left), "directory entry cleared");
+    msc->hostRead(geometry.fat_start, fat_after, sizeof(fat_after));
+    check(memcmp(fat_before, fat_after, sizeof(fat_before)) == 0, "clusters freed");
+
+    // The pattern repeats every 256 bytes, so any sector left of the file
+    // holds its first 16
+    uint32_t holding = 0;
+    uint8_t sector[FAT_SECTOR_SIZE];
+    for (uint32_t lba = 0; lba < geometry.total_sectors; lba++) {
+        if (msc->hostRead(lba, sector, sizeof(sector)) == FAT_SECTOR_SIZE &&
+            std::search(sector, sector + sizeof(sector), file.begin(), file.begin() + 16) !=
+                sector + sizeof(sector)) {
+            holding++;
+        }
+    }
+    printf("  %-28s %8u sectors still hold it\n", "erased after hand-over", holding);
+    check(holding == 0, "file bytes zeroed");
+}
+
+/**
+ * README.TXT is a file the host can read, and rewriting it keeps the FAT.
+ */
+static void readme() {
+    Rig rig;
+    std::vector<uint8_t> text;
+    check(rig.host->readFile("README  TXT", text), "README.TXT readable");
+    check(text.size() > 11 && memcmp(text.data(), "MINT DEVICE", 11) == 0, "README text");
+
+    const char* sealed = "MINT DEVICE - SEALED STATE\n";
+    rig.storage->writeFile(sealed);
+    check(rig.host->readFile("README  TXT", text), "README.TXT readable after update");
+    check(text.size() == strlen(sealed) && memcmp(text.data(), sealed, text.size()) == 0,
+          "README updated");
+
+    uint8_t fat[FAT_SECTOR_SIZE];
+    Adafruit_USBD_MSC::lastInstance()->hostRead(rig.host->getGeometry().fat_start, fat,
+                                                sizeof(fat));
+    check(fat[0] == 0xF8 && fat[1] == 0xFF && fat[2] == 0xFF, "FAT media entries intact");
+
+    // A user file after the README is still found
+    std::vector<uint8_t> file = pattern(512, 11);
+    check(rig.host->writeFile("ENTROPY BIN", nullptr, file.data(), file.size()), "host write");
+    rig.settle();
+    check(rig.handovers == 1, "file next to README handed over");
+    check(rig.handovers == 0 || rig.handed[0] == file[0], "file bytes handed over");
+}
+
+int main() {
+    printf("File detection\n");
+    windowsDrop();
+    macDrop();
+    partialDrop();
+    metadataOnly();
+    erasedDrop();
+    readme();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,394 @@
+/**
+ * Mint Flash Disk Benchmark
+ *
+ * Drives MintFlashDisk against the simulated W25Q128JV (tests/host/SPI.cpp)
+ * the way TinyUSB does: one 512-byte block per MSC callback at full-speed
+ * bulk rate, retrying a frame later when the disk answers busy, with the
+ * storage task stepping write-back every millisecond. Reports sustained
+ * sequential write and read throughput in virtual time, random writes,
+ * and the scattered metadata writes a host makes on mount, each against a
+ * write-through baseline that writes every block back as it arrives.
+ * The baseline writes back inside the MSC callback, holding up every other
+ * task for the duration, so where no erase is needed it can keep pace with
+ * the cache; the cache wins on erases, sector wear and host latency.
+ *
+ * Every scenario is read back after a simulated reboot and compared with
+ * what the host wrote, both through the disk and straight from the array.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/flash_disk_bench.cpp \
+ *         tests/host/SPI.cpp tests/host/arduino_host.cpp mint_flash.cpp \
+ *         -o flash_disk_bench
+ *     ./flash_disk_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <SPI.h>
+#include "mint_flash.h"
+#include "bench_host.h"
+
+#include <memory>
+#include <vector>
+
+// 512 bytes over full-speed bulk (19 x 64-byte packets per 1 ms frame)
+#define USB_BLOCK_US 420
+
+// A busy answer is retried on the next frame
+#define USB_RETRY_US 1000
+
+// Storage task period with MINT_STORAGE_FLASH (see mint.cpp)
+#define STORAGE_PERIOD_US 1000
+
+#define BLOCK FLASH_DISK_BLOCK_SIZE
+
+static uint32_t rng_state = 0x6D696E74;
+
+static uint32_t nextRandom() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void fillRandom(uint8_t* buffer, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        buffer[i] = (uint8_t)nextRandom();
+    }
+}
+
+/**
+ * A USB host and storage task around one disk. The shadow image holds what
+ * the host expects to read back.
+ */
+struct Rig {
+    std::unique_ptr<MintFlashDisk> disk;
+    std::vector<uint8_t> shadow;
+    std::vector<uint32_t> written;      // Blocks to verify
+    bool write_through;
+    uint64_t next_task_us;
+    uint64_t host_bytes;
+
+    Rig(bool through) :
+        disk(new MintFlashDisk()),
+        shadow(FLASH_CAPACITY, 0xFF),
+        write_through(through),
+        next_task_us(MintHost::now()),
+        host_bytes(0) {}
+
+    // Fixed releases as in MintScheduler; releases missed while the task
+    // ran are dropped
+    void service() {
+        if (MintHost::now() >= next_task_us) {
+            disk->task();
+            do {
+                next_task_us += STORAGE_PERIOD_US;
+            } while (next_task_us <= MintHost::now());
+        }
+    }
+
+    bool write(uint32_t lba, const uint8_t* data) {
+        for (;;) {
+            service();
+            int32_t result = disk->write(lba, data, BLOCK);
+            if (result < 0) {
+                return false;
+            }
+            if (result == BLOCK) {
+                break;
+            }
+            MintHost::advance(USB_RETRY_US);
+        }
+        MintHost::advance(USB_BLOCK_US);
+        memcpy(&shadow[lba * BLOCK], data, BLOCK);
+        written.push_back(lba);
+        host_bytes += BLOCK;
+        return !write_through || disk->flush();
+    }
+
+    bool read(uint32_t lba, uint8_t* data) {
+        for (;;) {
+            service();
+            int32_t result = disk->read(lba, data, BLOCK);
+            if (result < 0) {
+                return false;
+            }
+            if (result == BLOCK) {
+                break;
+            }
+            MintHost::advance(USB_RETRY_US);
+        }
+        MintHost::advance(USB_BLOCK_US);
+        return true;
+    }
+};
+
+/**
+ * Fresh erased part on SPI1, clock and counters reset.
+ */
+static void freshPart() {
+    SPI1.setFlashConfig(SPIClass::defaultConfig());
+    SPI1.resetFlashStats();
+    MintHost::resetClock();
+}
+
+/**
+ * Reboot onto the same array and compare every written block, through a
+ * new disk and straight from the array.
+ */
+static void verify(Rig& rig, const char* name) {
+    rig.disk.reset(new MintFlashDisk());
+    check(rig.disk->begin(), "flash answers after reboot");
+
+    const W25QStore& store = SPI1.getFlashStore();
+    uint32_t mismatches = 0;
+    uint8_t block[BLOCK];
+    for (uint32_t lba : rig.written) {
+        const uint8_t* expected = &rig.shadow[lba * BLOCK];
+        if (!rig.disk->readBlocks(lba, block, 1) || memcmp(block, expected, BLOCK) != 0 ||
+            memcmp(&store.array[lba * BLOCK], expected, BLOCK) != 0) {
+            mismatches++;
+        }
+    }
+    if (mismatches) {
+        printf("  %s: %u of %zu blocks differ after reboot\n", name, mismatches,
+               rig.written.size());
+    }
+    check(mismatches == 0, "data survives a reboot");
+}
+
+static void checkPart() {
+    const W25QStats& stats = SPI1.getFlashStats();
+    check(stats.ignored_while_busy == 0, "no command sent while the part was busy");
+    check(stats.program_conflicts == 0, "no program tried to set a cleared bit");
+}
+
+static uint32_t maxEraseCount() {
+    const W25QStore& store = SPI1.getFlashStore();
+    uint32_t most = 0;
+    for (uint32_t count : store.erase_counts) {
+        most = max(most, count);
+    }
+    return most;
+}
+
+typedef struct {
+    double kb_per_s;
+    uint32_t erases;
+    uint32_t pages;
+    uint32_t stalls;
+    double amplification;       // Bytes programmed per host byte written
+    uint32_t max_erases;        // Most erases of any one sector
+} Result;
+
+static void printHeader() {
+    printf("  %-14s %10s %8s %8s %8s %8s %10s\n", "mode", "KB/s", "erases", "pages",
+           "stalls", "amplif", "max erase");
+}
+
+static void printResult(const char* mode, const Result& result) {
+    printf("  %-14s %10.1f %8u %8u %8u %8.2f %10u\n", mode, result.kb_per_s, result.erases,
+           result.pages, result.stalls, result.amplification, result.max_erases);
+}
+
+static Result finish(Rig& rig, uint64_t start_us) {
+    check(rig.disk->flush(), "write-back completes");
+    uint64_t elapsed = MintHost::now() - start_us;
+
+    Result result;
+    const FlashDiskStats& stats = rig.disk->getStats();
+    result.kb_per_s = elapsed ? rig.host_bytes / 1024.0 / (elapsed / 1e6) : 0;
+    result.erases = stats.erases;
+    result.pages = stats.pages_programmed;
+    result.stalls = stats.stalls;
+    result.amplification = rig.host_bytes ?
+        (double)SPI1.getFlashStats().bytes_programmed / rig.host_bytes : 0;
+    result.max_erases = maxEraseCount();
+    return result;
+}
+
+/**
+ * Sustained sequential write of 1 MB, first onto an erased part (no erase
+ * needed) and then over its own data (every sector erased).
+ */
+static Result sequentialWrite(bool write_through, bool rewrite, uint32_t blocks) {
+    freshPart();
+    Rig rig(write_through);
+    check(rig.disk->begin(), "flash answers");
+
+    const uint32_t first = 1024;
+    uint8_t block[BLOCK];
+    if (rewrite) {
+        for (uint32_t i = 0; i < blocks; i++) {
+            fillRandom(block, BLOCK);
+            check(rig.disk->writeBlocks(first + i, block, 1), "preload");
+        }
+        check(rig.disk->flush(), "preload write-back");
+        rig.disk->resetStats();
+        SPI1.resetFlashStats();
+    }
+
+    uint64_t start = MintHost::now();
+    for (uint32_t i = 0; i < blocks; i++) {
+        fillRandom(block, BLOCK);
+        check(rig.write(first + i, block), "host write");
+    }
+    Result result = finish(rig, start);
+    checkPart();
+    verify(rig, "sequential write");
+    return result;
+}
+
+/**
+ * Sustained sequential read of 1 MB after a reboot.
+ */
+static void sequentialRead(uint32_t blocks) {
+    freshPart();
+    Rig rig(false);
+    check(rig.disk->begin(), "flash answers");
+
+    const uint32_t first = 2048;
+    uint8_t block[BLOCK];
+    for (uint32_t i = 0; i < blocks; i++) {
+        fillRandom(block, BLOCK);
+        check(rig.write(first + i, block), "host write");
+    }
+    check(rig.disk->flush(), "write-back completes");
+
+    rig.disk.reset(new MintFlashDisk());
+    check(rig.disk->begin(), "flash answers after reboot");
+    uint64_t start = MintHost::now();
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < blocks; i++) {
+        check(rig.read(first + i, block), "host read");
+        if (memcmp(block, &rig.shadow[(first + i) * BLOCK], BLOCK) != 0) {
+            mismatches++;
+        }
+    }
+    uint64_t elapsed = MintHost::now() - start;
+    check(mismatches == 0, "sequential read returns what was written");
+
+    const FlashDiskStats& stats = rig.disk->getStats();
+    printf("  %-14s %10.1f KB/s  misses %u  read-ahead %u  hits %u  stalls %u\n", "cached",
+           blocks * BLOCK / 1024.0 / (elapsed / 1e6), stats.read_misses, stats.read_ahead,
+           stats.read_hits, stats.stalls);
+    check(stats.read_hits >= stats.read_ahead * 9 / 10, "read-ahead blocks are used");
+    checkPart();
+}
+
+/**
+ * Single-block writes scattered over 4 MB.
+ */
+static Result randomWrite(bool write_through, uint32_t count) {
+    freshPart();
+    Rig rig(write_through);
+    check(rig.disk->begin(), "flash answers");
+
+    uint8_t block[BLOCK];
+    uint64_t start = MintHost::now();
+    for (uint32_t i = 0; i < count; i++) {
+        fillRandom(block, BLOCK);
+        check(rig.write(nextRandom() % 8192, block), "host write");
+    }
+    Result result = finish(rig, start);
+    checkPart();
+    verify(rig, "random write");
+    return result;
+}
+
+/**
+ * What a host does on mount and file drop: repeated FAT and root directory
+ * updates around metadata directories (.fseventsd, .Spotlight-V100,
+ * System Volume Information) and then the user's file, with pauses.
+ * Block numbers follow the flash volume layout in mint_storage.cpp.
+ */
+static Result mountPattern(bool write_through) {
+    freshPart();
+    Rig rig(write_through);
+    check(rig.disk->begin(), "flash answers");
+
+    const uint32_t FAT = 1;
+    const uint32_t ROOT = 7;
+    const uint32_t DATA = 39;
+    const uint32_t CLUSTER = 16;
+
+    uint8_t block[BLOCK];
+    uint64_t start = MintHost::now();
+    for (int dir = 0; dir < 3; dir++) {
+        // Directory cluster, its first entries, then FAT and root updates
+        uint32_t cluster = DATA + dir * CLUSTER;
+        for (uint32_t i = 0; i < 4; i++) {
+            fillRandom(block, BLOCK);
+            check(rig.write(cluster + i, block), "metadata write");
+        }
+        for (int update = 0; update < 3; update++) {
+            fillRandom(block, BLOCK);
+            check(rig.write(FAT, block), "FAT write");
+            fillRandom(block, BLOCK);
+            check(rig.write(ROOT, block), "root write");
+        }
+        for (int i = 0; i < 50; i++) {
+            MintHost::advance(1000);
+            rig.service();
+        }
+    }
+
+    // The user's entropy file, then its directory entry and FAT chain
+    fillRandom(block, BLOCK);
+    check(rig.write(DATA + 3 * CLUSTER, block), "file write");
+    fillRandom(block, BLOCK);
+    check(rig.write(FAT, block), "FAT write");
+    fillRandom(block, BLOCK);
+    check(rig.write(ROOT, block), "root write");
+
+    Result result = finish(rig, start);
+    checkPart();
+    verify(rig, "mount pattern");
+    return result;
+}
+
+int main() {
+    const uint32_t MB_BLOCKS = 1024 * 1024 / BLOCK;
+
+    printf("Sequential write, 1 MB onto an erased part\n");
+    printHeader();
+    Result fresh = sequentialWrite(false, false, MB_BLOCKS);
+    printResult("cached", fresh);
+    Result fresh_through = sequentialWrite(true, false, MB_BLOCKS / 8);
+    printResult("write-through", fresh_through);
+    check(fresh.erases == 0, "no erase when writing onto erased flash");
+
+    printf("\nSequential rewrite, 1 MB over existing data\n");
+    printHeader();
+    Result rewrite = sequentialWrite(false, true, MB_BLOCKS);
+    printResult("cached", rewrite);
+    Result rewrite_through = sequentialWrite(true, true, MB_BLOCKS / 8);
+    printResult("write-through", rewrite_through);
+    check(rewrite.erases == MB_BLOCKS / FLASH_DISK_BLOCKS_PER_SECTOR,
+          "one erase per rewritten sector");
+    check(rewrite.kb_per_s > rewrite_through.kb_per_s, "cache beats write-through");
+
+    printf("\nSequential read, 1 MB after reboot\n");
+    sequentialRead(MB_BLOCKS);
+
+    printf("\nRandom 512-byte writes over 4 MB\n");
+    printHeader();
+    Result random = randomWrite(false, 512);
+    printResult("cached", random);
+    Result random_through = randomWrite(true, 512);
+    printResult("write-through", random_through);
+    check(random.pages <= random_through.pages, "cache programs no more than write-through");
+    check(random.erases <= random_through.erases, "cache erases no more than write-through");
+
+    printf("\nMount and file drop\n");
+    printHeader();
+    Result mount = mountPattern(false);
+    printResult("cached", mount);
+    Result mount_through = mountPattern(true);
+    printResult("write-through", mount_through);
+    check(mount.erases < mount_through.erases, "cache coalesces metadata rewrites");
+    check(mount.max_erases < mount_through.max_erases, "cache spares the FAT sector");
+
+    printf("\n%s\n", failures ? "FAILED" : "All checks passed");
+    return failures ? 1 : 0;
+}
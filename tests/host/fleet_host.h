@@ -0,0 +1,262 @@
+/**
+ * Host-side fleet inspection of Mint disk images.
+ *
+ * Reads the volume a Mint device presents, from an image file or straight
+ * from the block device it enumerates as, and reports the device state,
+ * its address and, for a tampered device, whether the private key is
+ * shown. A PROOF.BIN answering an ownership challenge is carried along so
+ * ProofVerifier (proof_host.h) can check it once the challenges are known.
+ *
+ * Images are memory-mapped read-only: the boot sector, root directory and
+ * file contents are parsed in place, with no read() calls or sector
+ * copies, and only the few pages touched are ever faulted in. The README
+ * is matched against the compile-time templates the firmware renders from
+ * (mint_readme.h), so fields are read at their fixed offsets.
+ * inspectAll() opens a stack of devices on a thread pool.
+ */
+#ifndef MINT_HOST_FLEET_H
+#define MINT_HOST_FLEET_H
+
+#include <Arduino.h>
+#include "mint_fat.h"
+#include "mint_readme.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+class MintFleet {
+public:
+    typedef enum {
+        DEVICE_UNREADABLE,          // Can't open or map, or no FAT12 volume
+        DEVICE_UNKNOWN,             // FAT12 volume without a Mint README
+        DEVICE_NO_WALLET,           // Waiting for an entropy file
+        DEVICE_SEALED,              // Wallet generated, key sealed
+        DEVICE_TAMPERED             // Circuit broken, key shown
+    } DeviceState;
+
+    typedef struct {
+        std::string path;
+        DeviceState state;
+        std::string address;        // Sealed and tampered devices
+        bool key_shown;             // Tampered README holds a private key
+        std::vector<uint8_t> proof; // PROOF.BIN, if the device wrote one
+    } Report;
+
+    /**
+     * Read-only mapping of one device volume.
+     */
+    class Image {
+    public:
+        Image() : base(nullptr), size(0) {}
+        ~Image() { close(); }
+
+        /**
+         * Map an image file or block device.
+         * @param path File or device path
+         * @return true if mapped, false otherwise
+         */
+        bool open(const char* path) {
+            close();
+            int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+            // Block devices report no st_size; their end is their size
+            off_t length = lseek(fd, 0, SEEK_END);
+            if (length >= FAT_SECTOR_SIZE) {
+                void* mapped = mmap(nullptr, (size_t)length, PROT_READ, MAP_SHARED, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    base = (const uint8_t*)mapped;
+                    size = (size_t)length;
+                }
+            }
+            ::close(fd);
+            return base != nullptr;
+        }
+
+        void close() {
+            if (base) {
+                munmap((void*)base, size);
+                base = nullptr;
+                size = 0;
+            }
+        }
+
+        /**
+         * Get a sector in place.
+         * @param lba Sector number
+         * @return Pointer into the mapping, nullptr past the end
+         */
+        const uint8_t* sector(uint32_t lba) const {
+            if ((uint64_t)(lba + 1) * FAT_SECTOR_SIZE > size) {
+                return nullptr;
+            }
+            return base + (size_t)lba * FAT_SECTOR_SIZE;
+        }
+
+    private:
+        const uint8_t* base;
+        size_t size;
+
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+    };
+
+    /**
+     * Inspect one mapped volume.
+     * @param image Mapped volume
+     * @param report Output report (path is left alone)
+     */
+    static void inspect(const Image& image, Report& report) {
+        report.state = DEVICE_UNREADABLE;
+        report.address.clear();
+        report.key_shown = false;
+        report.proof.clear();
+
+        MintFatGeometry geometry;
+        const uint8_t* boot = image.sector(0);
+        if (!boot || !MintFatVolume::parseBootSector(boot, geometry) ||
+            !image.sector(geometry.total_sectors - 1)) {
+            return;
+        }
+        report.state = DEVICE_UNKNOWN;
+
+        const uint8_t* readme = nullptr;
+        size_t readme_size = 0;
+        if (!findFile(image, geometry, "README  TXT", readme, readme_size)) {
+            return;
+        }
+        const uint8_t* proof = nullptr;
+        size_t proof_size = 0;
+        if (findFile(image, geometry, "PROOF   BIN", proof, proof_size)) {
+            report.proof.assign(proof, proof + proof_size);
+        }
+
+        if (matches(readme, readme_size, MINT_README_SEALED)) {
+            report.state = DEVICE_SEALED;
+            report.address = field(readme, MINT_README_SEALED.address);
+        } else if (matches(readme, readme_size, MINT_README_SEALED_WEAK_FILE)) {
+            report.state = DEVICE_SEALED;
+            report.address = field(readme, MINT_README_SEALED_WEAK_FILE.address);
+        } else if (matches(readme, readme_size, MINT_README_TAMPERED)) {
+            report.state = DEVICE_TAMPERED;
+            report.address = field(readme, MINT_README_TAMPERED.address);
+            report.key_shown = !field(readme, MINT_README_TAMPERED.wif).empty();
+        } else if (matches(readme, readme_size, MINT_README_NO_WALLET)) {
+            report.state = DEVICE_NO_WALLET;
+        }
+    }
+
+    /**
+     * Inspect a stack of devices in parallel.
+     * @param paths Image files or block devices
+     * @param threads Worker threads
+     * @return One report per path, in order
+     */
+    static std::vector<Report> inspectAll(const std::vector<std::string>& paths,
+                                          unsigned threads) {
+        std::vector<Report> reports(paths.size());
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            Image image;
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                reports[i].path = paths[i];
+                reports[i].state = DEVICE_UNREADABLE;
+                reports[i].key_shown = false;
+                if (image.open(paths[i].c_str())) {
+                    inspect(image, reports[i]);
+                    image.close();
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < std::max(threads, 1u); t++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        return reports;
+    }
+
+    static const char* stateName(DeviceState state) {
+        static const char* const NAMES[] = {
+            "unreadable", "unknown", "no wallet", "sealed", "tampered"
+        };
+        return NAMES[state];
+    }
+
+private:
+    // Find a root directory file of up to one sector, in place
+    static bool findFile(const Image& image, const MintFatGeometry& geometry,
+                         const char* short_name, const uint8_t*& data, size_t& size) {
+        for (uint32_t s = 0; s < geometry.root_sectors; s++) {
+            const uint8_t* dir = image.sector(geometry.root_start + s);
+            if (!dir) {
+                return false;
+            }
+            for (size_t i = 0; i < FAT_DIR_ENTRIES_PER_SECTOR; i++) {
+                MintFatEntry entry;
+                MintFatVolume::EntryKind kind = MintFatVolume::parseDirEntry(dir, i, entry);
+                if (kind == MintFatVolume::ENTRY_END) {
+                    // Hosts list nothing past here either
+                    return false;
+                }
+                if (kind != MintFatVolume::ENTRY_VALID || memcmp(entry.name, short_name, 11) != 0) {
+                    continue;
+                }
+                const uint32_t cluster = (uint32_t)entry.start_cluster - FAT_FIRST_CLUSTER;
+                if (entry.size > FAT_SECTOR_SIZE || entry.start_cluster < FAT_FIRST_CLUSTER ||
+                    cluster >= geometry.cluster_count) {
+                    return false;
+                }
+                data = image.sector(geometry.data_start + cluster * geometry.sectors_per_cluster);
+                size = entry.size;
+                return data != nullptr;
+            }
+        }
+        return false;
+    }
+
+    // The README is this template's text, whatever is in its fields
+    static bool matches(const uint8_t* text, size_t size, const MintReadme::Template& source) {
+        if (size != source.length) {
+            return false;
+        }
+        size_t pos = 0;
+        const MintReadme::Field* fields[2] = { &source.address, &source.wif };
+        if (fields[0]->width && fields[1]->width && fields[1]->offset < fields[0]->offset) {
+            std::swap(fields[0], fields[1]);
+        }
+        for (const MintReadme::Field* f : fields) {
+            if (!f->width) {
+                continue;
+            }
+            if (memcmp(text + pos, source.text + pos, f->offset - pos) != 0) {
+                return false;
+            }
+            pos = f->offset + f->width;
+        }
+        return memcmp(text + pos, source.text + pos, source.length - pos) == 0;
+    }
+
+    // Field contents without the blank padding
+    static std::string field(const uint8_t* text, const MintReadme::Field& f) {
+        size_t length = f.width;
+        while (length && text[f.offset + length - 1] == ' ') {
+            length--;
+        }
+        return std::string((const char*)text + f.offset, length);
+    }
+};
+
+#endif // MINT_HOST_FLEET_H
@@ -0,0 +1,247 @@
+/**
+ * Mint Fleet Inspector
+ *
+ * Reads a stack of Mint devices, or image files of their volumes, on a
+ * thread pool (MintFleet, tests/host/fleet_host.h) and lists each one's
+ * state and address, whether a tampered device shows its key, and
+ * whether it holds an ownership proof. Given the challenge file that was
+ * dropped on the devices, each proof is also checked with ProofVerifier.
+ * Reports the throughput in devices per second.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -pthread -I tests/host -I . tests/host/fleet_inspect.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o fleet_inspect
+ *     ./fleet_inspect --synthesize fleet
+ *     ./fleet_inspect [--threads N] [--challenges fleet/challenges.bin] fleet/device-*.img
+ *     sudo ./fleet_inspect /dev/sdb /dev/sdc ...
+ *
+ * --synthesize runs simulated devices into every state, saves their
+ * volumes as images (all-zero sectors left as holes) with the challenge file
+ * dropped on the proving ones, and checks that the inspector reads back
+ * what each device was. Add -DMINT_STORAGE_FLASH mint_flash.cpp
+ * tests/host/SPI.cpp to synthesize flash volumes.
+ *
+ * Exits non-zero if a device can't be read as a Mint volume or a proof
+ * fails to verify.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "fat_host.h"
+#include "fleet_host.h"
+#include "proof_host.h"
+#include "bench_host.h"
+
+#include <chrono>
+#include <memory>
+
+#include <sys/stat.h>
+
+// Devices --synthesize makes unless told otherwise
+#define DEFAULT_SYNTH_DEVICES 12
+
+// Time for a state change to reach the README (display period and slack)
+#define README_SETTLE_US 1500000
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        out.insert(out.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * Check a device's proof against the challenge file dropped on it.
+ */
+static ProofVerifier::Result verifyProof(const std::string& path,
+                                         const std::vector<uint8_t>& challenge_file) {
+    const size_t count = (challenge_file.size() - MINT_CHALLENGE_HEADER_SIZE) /
+                         MINT_PROOF_CHALLENGE_SIZE;
+    MintFleet::Image image;
+    if (!image.open(path.c_str())) {
+        return ProofVerifier::PROOF_NO_VOLUME;
+    }
+    return ProofVerifier::verify([&image](uint32_t lba, uint8_t* buffer) {
+        const uint8_t* sector = image.sector(lba);
+        if (sector) {
+            memcpy(buffer, sector, FAT_SECTOR_SIZE);
+        }
+        return sector != nullptr;
+    }, challenge_file.data() + MINT_CHALLENGE_HEADER_SIZE, count);
+}
+
+static int inspect(const std::vector<std::string>& paths, unsigned threads,
+                   const char* challenge_path) {
+    std::vector<uint8_t> challenges;
+    if (challenge_path && (!readFile(challenge_path, challenges) ||
+                           challenges.size() <= MINT_CHALLENGE_HEADER_SIZE ||
+                           memcmp(challenges.data(), MINT_CHALLENGE_MAGIC,
+                                  MINT_CHALLENGE_HEADER_SIZE) != 0)) {
+        fprintf(stderr, "cannot read challenge file %s\n", challenge_path);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<MintFleet::Report> reports = MintFleet::inspectAll(paths, threads);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    int bad = 0;
+    printf("%-32s %-10s %-44s %-4s %s\n", "device", "state", "address", "key", "proof");
+    for (const MintFleet::Report& r : reports) {
+        char proof[32] = "-";
+        if (!r.proof.empty()) {
+            snprintf(proof, sizeof(proof), "%zu bytes", r.proof.size());
+            if (!challenges.empty()) {
+                ProofVerifier::Result result = verifyProof(r.path, challenges);
+                snprintf(proof, sizeof(proof), "%s", ProofVerifier::resultName(result));
+                bad += result != ProofVerifier::PROOF_OK;
+            }
+        }
+        printf("%-32s %-10s %-44s %-4s %s\n", r.path.c_str(), MintFleet::stateName(r.state),
+               r.address.empty() ? "-" : r.address.c_str(), r.key_shown ? "yes" : "-", proof);
+        bad += r.state <= MintFleet::DEVICE_UNKNOWN;
+    }
+    printf("%zu devices in %.3f ms, %.0f devices/s (%u threads)\n", reports.size(),
+           elapsed.count() * 1000, reports.size() / elapsed.count(), threads);
+    return bad ? 1 : 0;
+}
+
+/**
+ * Run simulated devices into each state and save their volumes.
+ */
+static int synthesize(const char* dir, int count) {
+    mkdir(dir, 0755);
+    std::vector<uint8_t> challenges(MINT_CHALLENGE_HEADER_SIZE +
+                                    MINT_PROOF_MAX_CHALLENGES * MINT_PROOF_CHALLENGE_SIZE);
+    memcpy(challenges.data(), MINT_CHALLENGE_MAGIC, MINT_CHALLENGE_HEADER_SIZE);
+    for (size_t i = MINT_CHALLENGE_HEADER_SIZE; i < challenges.size(); i++) {
+        challenges[i] = (uint8_t)(i * 211 + 7);
+    }
+    const std::string challenge_path = std::string(dir) + "/challenges.bin";
+    FILE* f = fopen(challenge_path.c_str(), "wb");
+    if (!f || fwrite(challenges.data(), 1, challenges.size(), f) != challenges.size()) {
+        fprintf(stderr, "cannot write %s\n", challenge_path.c_str());
+        return 2;
+    }
+    fclose(f);
+
+    // Blank, sealed, sealed with a proof, tampered, in turn
+    static const MintFleet::DeviceState STATES[] = {
+        MintFleet::DEVICE_NO_WALLET, MintFleet::DEVICE_SEALED, MintFleet::DEVICE_SEALED,
+        MintFleet::DEVICE_TAMPERED
+    };
+    std::vector<std::string> paths;
+    std::vector<MintFleet::Report> expected;
+    for (int i = 0; i < count; i++) {
+        const MintFleet::DeviceState state = STATES[i % 4];
+        const bool prove = i % 4 == 2;
+
+        SE05x::setNextConfig(SE05x::defaultConfig());
+#ifdef MINT_STORAGE_FLASH
+        SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+        MintHost::resetClock();
+        MintHost::setPin(CIRCUIT_PIN, LOW);
+        std::unique_ptr<MintDevice> device(new MintDevice());
+        HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+            runDevice(*device, MintHost::now() + 500);
+        });
+        if (!device->begin() || !host.mount()) {
+            fprintf(stderr, "device %d failed to boot\n", i);
+            return 1;
+        }
+
+        if (state != MintFleet::DEVICE_NO_WALLET) {
+            uint8_t entropy[512];
+            for (size_t b = 0; b < sizeof(entropy); b++) {
+                entropy[b] = (uint8_t)(b * 131 + i * 29 + 17);
+            }
+            host.writeFile("ENTROPY BIN", nullptr, entropy, sizeof(entropy));
+            runDevice(*device, MintHost::now() + 10000000);
+        }
+        if (prove) {
+            host.writeFile("CHALLNGEBIN", "challenges.bin", challenges.data(), challenges.size());
+        }
+        if (state == MintFleet::DEVICE_TAMPERED) {
+            MintHost::setPin(CIRCUIT_PIN, HIGH);
+        }
+        runDevice(*device, MintHost::now() + README_SETTLE_US);
+
+        MintFleet::Report report;
+        report.state = state;
+        report.key_shown = state == MintFleet::DEVICE_TAMPERED;
+        if (state != MintFleet::DEVICE_NO_WALLET) {
+            report.address = device->getPublicAddress();
+        }
+        if (prove) {
+            report.proof.resize(1);
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "/device-%02d.img", i);
+        report.path = std::string(dir) + name;
+        if (!host.saveImage(report.path.c_str())) {
+            fprintf(stderr, "cannot write %s\n", report.path.c_str());
+            return 2;
+        }
+        paths.push_back(report.path);
+        expected.push_back(report);
+    }
+    printf("wrote %d device images and %s\n", count, challenge_path.c_str());
+
+    // Read them back as the intake desk would
+    std::vector<MintFleet::Report> reports = MintFleet::inspectAll(paths, 4);
+    int mismatches = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        const MintFleet::Report& r = reports[i];
+        const MintFleet::Report& e = expected[i];
+        if (r.state != e.state || r.address != e.address || r.key_shown != e.key_shown ||
+            r.proof.empty() != e.proof.empty() ||
+            (!r.proof.empty() && verifyProof(r.path, challenges) != ProofVerifier::PROOF_OK)) {
+            printf("  FAIL: %s read back as %s\n", r.path.c_str(), MintFleet::stateName(r.state));
+            mismatches++;
+        }
+    }
+    printf("%s\n", mismatches ? "FAILED" : "OK");
+    return mismatches ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    const char* challenge_path = nullptr;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--synthesize" && i + 1 < argc) {
+            const char* dir = argv[++i];
+            int count = i + 1 < argc ? atoi(argv[i + 1]) : 0;
+            return synthesize(dir, count > 0 ? count : DEFAULT_SYNTH_DEVICES);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--challenges" && i + 1 < argc) {
+            challenge_path = argv[++i];
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty()) {
+        fprintf(stderr, "usage: %s [--threads n] [--challenges file] <device or image>... | "
+                        "--synthesize <dir> [count]\n", argv[0]);
+        return 2;
+    }
+    return inspect(paths, threads, challenge_path);
+}
@@ -0,0 +1,288 @@
+/**
+ * Mint Fleet Soak Benchmark
+ *
+ * Runs randomized device lifecycles on a thread pool. Each simulated
+ * device boots, may be rebooted before and after it seals, takes an
+ * entropy file of random size, and may have its circuit cut and be
+ * rebooted once more, all against its own SE050 simulator, RAM disk and
+ * circuit. A reboot builds a new MintDevice on the same secure element
+ * store, the way a power cycle keeps the SE050's contents and loses the
+ * RAM disk. Each worker thread is one simulated board (tests/host/
+ * Arduino.h) and runs its devices in turn.
+ *
+ * After every step the device's state, address and README are checked
+ * against what that device should show, and addresses must be unique
+ * across the fleet. Reports aggregate throughput: lifecycles and
+ * simulated device-seconds per wall-clock second.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -pthread -I tests/host -I . tests/host/fleet_soak_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o fleet_soak_bench
+ *     ./fleet_soak_bench [--devices N] [--threads N] [--seed S]
+ *
+ * The RAM disk build only: flash builds share one simulated W25Q chip
+ * (SPI1) per process, and MINT_TRACE_ENABLED builds one trace buffer.
+ *
+ * Exits non-zero if a device strays from its lifecycle.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Lifecycles run unless told otherwise
+#define DEFAULT_SOAK_DEVICES 1024
+
+// Time for a state change to reach the README (display period and slack)
+#define README_SETTLE_US 1500000
+
+// Time allowed for a dropped file to become a sealed wallet
+#define SEAL_TIMEOUT_US 10000000
+
+// Reboots before sealing, after sealing, at most
+#define MAX_REBOOTS_BLANK 1
+#define MAX_REBOOTS_SEALED 2
+
+// One device in this many has its circuit cut
+#define TAMPER_ONE_IN 3
+
+static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * What happened to one device.
+ */
+typedef struct {
+    bool tampered;
+    uint32_t reboots;
+    std::string address;
+    uint64_t virtual_us;            // Simulated time over all its boots
+    std::string failure;            // Empty if the lifecycle went as expected
+} Outcome;
+
+/**
+ * One simulated device across reboots: the secure element store outlives
+ * each MintDevice built on it.
+ */
+class SoakDevice {
+public:
+    SoakDevice() : config(SE05x::defaultConfig()), virtual_us(0) {}
+
+    ~SoakDevice() { powerOff(); }
+
+    bool boot() {
+        powerOff();
+        SE05x::setNextConfig(config);
+        MintHost::resetClock();
+        device.reset(new MintDevice());
+        host.reset(new HostFat(Adafruit_USBD_MSC::lastInstance(), [this]() {
+            runDevice(*device, MintHost::now() + 500);
+        }));
+        return device->begin() && host->mount();
+    }
+
+    void run(uint64_t us) {
+        runDevice(*device, MintHost::now() + us);
+    }
+
+    std::string readme() {
+        std::vector<uint8_t> text;
+        host->mount();
+        host->readFile("README  TXT", text);
+        return std::string(text.begin(), text.end());
+    }
+
+    MintDevice& get() { return *device; }
+    HostFat& fat() { return *host; }
+    uint64_t elapsed() const { return virtual_us + MintHost::now(); }
+
+private:
+    SE05xSimConfig config;          // Holds the store across reboots
+    std::unique_ptr<MintDevice> device;
+    std::unique_ptr<HostFat> host;
+    uint64_t virtual_us;            // Time of the boots before this one
+
+    void powerOff() {
+        if (device) {
+            virtual_us += MintHost::now();
+        }
+        host.reset();
+        device.reset();
+    }
+};
+
+/**
+ * Check a settled device against the state its lifecycle should be in.
+ * @return Empty if it matches, else what is wrong
+ */
+static std::string expect(SoakDevice& soak, MintDevice::MintState state,
+                          const std::string& address, const char* step) {
+    soak.run(README_SETTLE_US);
+    MintDevice& device = soak.get();
+    const std::string readme = soak.readme();
+    std::string wrong;
+    if (device.getState() != state) {
+        wrong = "state";
+    } else if (state != MintDevice::MINT_STATE_READY_NO_WALLET &&
+               (device.getPublicAddress().c_str() != address ||
+                readme.find(address) == std::string::npos)) {
+        wrong = "address";
+    } else if (state == MintDevice::MINT_STATE_TAMPERED &&
+               readme.find(device.getPrivateKey().c_str()) == std::string::npos) {
+        wrong = "private key";
+    } else if (state == MintDevice::MINT_STATE_READY_NO_WALLET &&
+               readme.size() != MINT_README_NO_WALLET.length) {
+        wrong = "README";
+    }
+    return wrong.empty() ? wrong : wrong + " after " + step;
+}
+
+/**
+ * Run one randomized lifecycle on the calling thread's board.
+ */
+static void runLifecycle(uint64_t seed, Outcome& outcome) {
+    uint64_t rng = seed;
+    outcome.tampered = splitmix(rng) % TAMPER_ONE_IN == 0;
+    outcome.reboots = 0;
+    outcome.address.clear();
+    outcome.failure.clear();
+
+    SoakDevice soak;
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    if (!soak.boot()) {
+        outcome.failure = "boot";
+        return;
+    }
+    outcome.failure = expect(soak, MintDevice::MINT_STATE_READY_NO_WALLET, "", "boot");
+
+    const uint32_t blank_reboots = splitmix(rng) % (MAX_REBOOTS_BLANK + 1);
+    for (uint32_t i = 0; i < blank_reboots && outcome.failure.empty(); i++) {
+        outcome.reboots++;
+        outcome.failure = soak.boot() ?
+            expect(soak, MintDevice::MINT_STATE_READY_NO_WALLET, "", "blank reboot") : "reboot";
+    }
+
+    // Seal with a file of random size and content
+    if (outcome.failure.empty()) {
+        std::vector<uint8_t> file(32 + splitmix(rng) % (MINT_ENTROPY_FILE_SIZE - 31));
+        for (uint8_t& b : file) {
+            b = (uint8_t)splitmix(rng);
+        }
+        if (!soak.fat().writeFile("ENTROPY BIN", nullptr, file.data(), file.size())) {
+            outcome.failure = "entropy file write";
+        } else {
+            soak.run(SEAL_TIMEOUT_US);
+            outcome.address = soak.get().getPublicAddress().c_str();
+            outcome.failure = expect(soak, MintDevice::MINT_STATE_READY_WITH_WALLET,
+                                     outcome.address, "seal");
+        }
+    }
+
+    const uint32_t sealed_reboots = splitmix(rng) % (MAX_REBOOTS_SEALED + 1);
+    for (uint32_t i = 0; i < sealed_reboots && outcome.failure.empty(); i++) {
+        outcome.reboots++;
+        outcome.failure = soak.boot() ?
+            expect(soak, MintDevice::MINT_STATE_READY_WITH_WALLET, outcome.address,
+                   "sealed reboot") : "reboot";
+    }
+
+    // A cut trace stays cut: the device must come back tampered
+    if (outcome.tampered && outcome.failure.empty()) {
+        MintHost::setPin(CIRCUIT_PIN, HIGH);
+        outcome.failure = expect(soak, MintDevice::MINT_STATE_TAMPERED, outcome.address,
+                                 "tamper");
+        if (outcome.failure.empty()) {
+            outcome.reboots++;
+            outcome.failure = soak.boot() ?
+                expect(soak, MintDevice::MINT_STATE_TAMPERED, outcome.address,
+                       "tampered reboot") : "reboot";
+        }
+    }
+    outcome.virtual_us = soak.elapsed();
+}
+
+static int soak(uint32_t devices, unsigned threads, uint64_t seed) {
+    std::vector<Outcome> outcomes(devices);
+    std::atomic<uint32_t> next(0);
+    auto worker = [&]() {
+        for (uint32_t i = next++; i < devices; i = next++) {
+            uint64_t device_seed = seed ^ ((uint64_t)i << 32);
+            runLifecycle(splitmix(device_seed), outcomes[i]);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::max(threads, 1u); t++) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint32_t tampered = 0, reboots = 0, failed = 0;
+    double virtual_s = 0;
+    std::set<std::string> addresses;
+    for (uint32_t i = 0; i < devices; i++) {
+        const Outcome& o = outcomes[i];
+        tampered += o.tampered;
+        reboots += o.reboots;
+        virtual_s += o.virtual_us / 1e6;
+        if (o.failure.empty() && !addresses.insert(o.address).second) {
+            printf("  FAIL: device %u: address %s seen before\n", (unsigned)i, o.address.c_str());
+            failed++;
+        } else if (!o.failure.empty()) {
+            printf("  FAIL: device %u: %s\n", (unsigned)i, o.failure.c_str());
+            failed++;
+        }
+    }
+
+    printf("Fleet soak: %u devices, %u threads, seed %llu\n", (unsigned)devices,
+           std::max(threads, 1u), (unsigned long long)seed);
+    printf("  %-22s %u (%u tampered, %u reboots)\n", "lifecycles", (unsigned)devices,
+           (unsigned)tampered, (unsigned)reboots);
+    printf("  %-22s %.3f s\n", "wall time", elapsed.count());
+    printf("  %-22s %.1f devices/s, %.0f simulated device-s/s\n", "throughput",
+           devices / elapsed.count(), virtual_s / elapsed.count());
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    uint32_t devices = DEFAULT_SOAK_DEVICES;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--devices" && i + 1 < argc) {
+            devices = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--devices n] [--threads n] [--seed s]\n", argv[0]);
+            return 2;
+        }
+    }
+    return soak(devices, threads, seed);
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+secp256k1 Fixed-Base Comb Table Generator
+
+Generates mint_secp256k1_table.h, the precomputed comb table used by
+MintSecp256k1 for fixed-base scalar multiplication. Entry i holds the
+affine point sum(2^(SPACING * t) * G) over the bits t set in i.
+
+Usage:
+    python3 tests/host/gen_secp256k1_table.py > mint_secp256k1_table.h
+"""
+
+P = 2**256 - 2**32 - 977
+G = (0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798,
+     0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8)
+
+# Must match MINT_SECP256K1_COMB_TEETH / _SPACING in mint_secp256k1.h
+TEETH = 6
+SPACING = 43
+
+
+def point_add(a, b):
+    if a is None:
+        return b
+    if b is None:
+        return a
+    if a[0] == b[0] and (a[1] + b[1]) % P == 0:
+        return None
+    if a == b:
+        slope = 3 * a[0] * a[0] * pow(2 * a[1], P - 2, P) % P
+    else:
+        slope = (b[1] - a[1]) * pow(b[0] - a[0], P - 2, P) % P
+    x = (slope * slope - a[0] - b[0]) % P
+    return (x, (slope * (a[0] - x) - a[1]) % P)
+
+
+def point_mul(k, point):
+    result = None
+    for i in range(k.bit_length() - 1, -1, -1):
+        result = point_add(result, result)
+        if (k >> i) & 1:
+            result = point_add(result, point)
+    return result
+
+
+def limbs(value):
+    return ", ".join("0x%08X" % ((value >> (32 * i)) & 0xFFFFFFFF) for i in range(8))
+
+
+def main():
+    teeth = [point_mul(1 << (SPACING * t), G) for t in range(TEETH)]
+
+    print("// Generated by tests/host/gen_secp256k1_table.py - do not edit")
+    print("#ifndef MINT_SECP256K1_TABLE_H")
+    print("#define MINT_SECP256K1_TABLE_H")
+    print()
+    print("// Comb table: %d teeth, spacing %d; entry 0 is unused (holds G)" % (TEETH, SPACING))
+    print("// Affine points as x then y, 32-bit little-endian limbs")
+    print("static const uint32_t SECP256K1_COMB_TABLE[%d][16] = {" % (1 << TEETH))
+    for index in range(1 << TEETH):
+        point = None
+        for t in range(TEETH):
+            if (index >> t) & 1:
+                point = point_add(point, teeth[t])
+        if point is None:
+            point = G
+        print("    { %s," % limbs(point[0]))
+        print("      %s }," % limbs(point[1]))
+    print("};")
+    print()
+    print("#endif // MINT_SECP256K1_TABLE_H")
+
+
+if __name__ == "__main__":
+    main()
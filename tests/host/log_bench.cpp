@@ -0,0 +1,364 @@
+/**
+ * Mint Event Log Benchmark
+ *
+ * Checks the tokenized event log (mint_log.h): a record's layout (token,
+ * zigzag and plain varints, strings cut at MINT_LOG_MAX_STRING), records
+ * kept whole across the ring's wrap, and records dropped and counted once
+ * the ring is full. Times a MINT_LOG call, and checks that the device's
+ * format strings did not make it into this binary. Then runs a device
+ * from boot through sealing and intermittent contact to a cut circuit,
+ * decodes its drain and checks the events it should show are there, in
+ * time order, and that no run of the entropy file's bytes leaked into
+ * the log.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/log_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o log_bench
+ *     ./log_bench [--output lifecycle.bin]
+ *     python3 tests/log_decode.py lifecycle.bin
+ *
+ * --output writes the lifecycle's drain, as the device sends it over CDC.
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_log.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Calls timed, for a stable mean
+#define TIMING_RUNS 1000000
+
+// Shortest run of entropy file bytes that counts as a leak
+#define LEAK_RUN 8
+
+/**
+ * One decoded record.
+ */
+typedef struct {
+    uint32_t token;
+    uint64_t time_us;
+    std::vector<uint8_t> args;
+} Record;
+
+static bool readVarint(const std::vector<uint8_t>& data, size_t& offset, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; offset < data.size() && shift < 35; shift += 7) {
+        const uint8_t byte = data[offset++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// One full drain, the way main.ino sends it
+static std::vector<uint8_t> drain() {
+    std::vector<uint8_t> out(MINT_LOG_HEADER_MAX);
+    out.resize(MintLog::header(out.data()));
+    uint8_t chunk[256];
+    size_t length;
+    while ((length = MintLog::read(chunk, sizeof(chunk))) > 0) {
+        out.insert(out.end(), chunk, chunk + length);
+    }
+    out.push_back(0);
+    return out;
+}
+
+/**
+ * Split one drain into records.
+ * @return false if the drain is malformed
+ */
+static bool parse(const std::vector<uint8_t>& data, uint32_t& dropped,
+                  std::vector<Record>& records) {
+    records.clear();
+    if (data.size() < 5 || memcmp(data.data(), "MLOG", 4) != 0 || data[4] != MINT_LOG_VERSION) {
+        return false;
+    }
+    size_t offset = 5;
+    uint32_t base;
+    if (!readVarint(data, offset, dropped) || !readVarint(data, offset, base)) {
+        return false;
+    }
+    uint64_t now = base;
+    while (offset < data.size() && data[offset]) {
+        const size_t end = offset + 1 + data[offset];
+        if (end > data.size() || data[offset] < 5) {
+            return false;
+        }
+        Record record;
+        memcpy(&record.token, &data[offset + 1], 4);
+        size_t at = offset + 5;
+        uint32_t delta;
+        if (!readVarint(data, at, delta) || at > end) {
+            return false;
+        }
+        now += delta;
+        record.time_us = now;
+        record.args.assign(data.begin() + at, data.begin() + end);
+        records.push_back(record);
+        offset = end;
+    }
+    return offset == data.size() - 1;
+}
+
+static void benchRecords() {
+    printf("Records\n");
+    MintLog::clear();
+    const char* long_name = "a string well past the thirty-two byte limit";
+    MINT_LOG("bench %d %u %x %s", -3, 300u, (uint8_t)0x7F, long_name);
+    MINT_LOG("bench %d", INT32_MIN);
+    MINT_LOG("bench %s", "");
+
+    uint32_t dropped = 0;
+    std::vector<Record> records;
+    check(parse(drain(), dropped, records), "drain parses");
+    check(dropped == 0 && records.size() == 3, "three records, none dropped");
+    if (records.size() != 3) {
+        return;
+    }
+
+    const std::vector<uint8_t> expected = [&]() {
+        std::vector<uint8_t> bytes = { 0x05, 0xAC, 0x02, 0x7F, MINT_LOG_MAX_STRING };
+        bytes.insert(bytes.end(), long_name, long_name + MINT_LOG_MAX_STRING);
+        return bytes;
+    }();
+    constexpr uint32_t token = MintLog::token("bench %d %u %x %s");
+    check(records[0].token == token, "token is the format's hash");
+    check(records[0].args == expected, "zigzag, varints and a cut string");
+    check(records[1].args == std::vector<uint8_t>({ 0xFF, 0xFF, 0xFF, 0xFF, 0x0F }),
+          "INT32_MIN takes five bytes");
+    check(records[2].args == std::vector<uint8_t>({ 0x00 }), "empty string");
+    check(MintLog::pending() == 0, "drain empties the ring");
+    printf("  %-24s %zu bytes of arguments\n", "widest record", records[0].args.size());
+}
+
+static void benchRing() {
+    printf("Ring\n");
+    MintLog::clear();
+
+    // Fill past capacity: the newest records are dropped, not the oldest
+    uint32_t logged = 0;
+    while (MintLog::pending() + 16 <= MINT_LOG_BUFFER_SIZE) {
+        MINT_LOG("ring %u", logged++);
+    }
+    const size_t full = MintLog::pending();
+    for (int i = 0; i < 10; i++) {
+        MINT_LOG("ring %u", logged + i);
+    }
+    check(MintLog::dropped() > 0, "full ring drops records");
+    const uint32_t lost = MintLog::dropped();
+
+    uint32_t dropped = 0;
+    std::vector<Record> records;
+    check(parse(drain(), dropped, records), "full drain parses");
+    check(dropped == lost && MintLog::dropped() == 0, "drain reports and resets the dropped count");
+    check(records.size() + lost == logged + 10, "every record kept or counted");
+    check(!records.empty() && records[0].args == std::vector<uint8_t>({ 0x00 }),
+          "oldest record kept");
+    printf("  %-24s %zu bytes, %zu records, %u dropped\n", "full ring", full, records.size(),
+           (unsigned)lost);
+
+    // Drain in small pieces while records wrap past the end of the buffer
+    bool in_order = true;
+    uint32_t next = 0, seen = 0;
+    for (uint32_t i = 0; i < 4 * MINT_LOG_BUFFER_SIZE / 8; i++) {
+        MINT_LOG("wrap %u", i);
+        if (i % 3 == 2) {
+            uint8_t chunk[24];
+            std::vector<uint8_t> data = { 'M', 'L', 'O', 'G', MINT_LOG_VERSION, 0, 0 };
+            const size_t length = MintLog::read(chunk, sizeof(chunk));
+            data.insert(data.end(), chunk, chunk + length);
+            data.push_back(0);
+            if (!parse(data, dropped, records)) {
+                in_order = false;
+            }
+            for (const Record& record : records) {
+                size_t at = 0;
+                uint32_t value;
+                in_order = in_order && readVarint(record.args, at, value) && value == next++;
+                seen++;
+            }
+        }
+    }
+    check(in_order && seen > 2 * MINT_LOG_BUFFER_SIZE / 8, "records intact across the wrap");
+    check(MintLog::dropped() == 0, "nothing dropped while draining");
+}
+
+static void benchTiming() {
+    MintLog::clear();
+    uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < TIMING_RUNS; i++) {
+        MINT_LOG("timing %u of %u", i, (uint32_t)TIMING_RUNS);
+        if (MintLog::pending() > MINT_LOG_BUFFER_SIZE / 2) {
+            sink += MintLog::pending();
+            MintLog::clear();
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("Timing\n  %-24s %8.1f ns per call (host), two arguments\n", "MINT_LOG",
+           elapsed.count() / TIMING_RUNS);
+    check(sink > 0, "timed records written");
+}
+
+// Format strings must stay out of the image; the needles are stored
+// reversed so this binary's own copy of them does not count
+static void benchImage() {
+    printf("Image\n");
+    std::ifstream file("/proc/self/exe", std::ios::binary);
+    const std::string image((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    const char* reversed[] = {
+        "deliaf noitareneg tellaw",
+        "zH u% ta pu 050ES",
+        "u% kaew ,setyb u% ,nekat elif yportne",
+    };
+    bool absent = !image.empty();
+    for (const char* needle : reversed) {
+        std::string format(needle);
+        std::reverse(format.begin(), format.end());
+        absent = absent && image.find(format) == std::string::npos;
+    }
+    printf("  %-24s %zu bytes scanned\n", "this binary", image.size());
+    check(absent, "no MINT_LOG format in the image");
+}
+
+static bool hasToken(const std::vector<Record>& records, uint32_t token) {
+    for (const Record& record : records) {
+        if (record.token == token) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * An event the lifecycle must log. Tokens are constant expressions, so
+ * the formats stay out of this binary too.
+ */
+typedef struct {
+    uint32_t token;
+    const char* what;
+} Expected;
+
+static constexpr Expected LIFECYCLE_EVENTS[] = {
+    { MintLog::token("SE050 up at %u Hz"), "bus clock logged" },
+    { MintLog::token("SE050 boot: tampered %u, key %u, chain code %u"), "boot snapshot logged" },
+    { MintLog::token("host file complete, %u bytes"), "file logged" },
+    { MintLog::token("entropy file taken, %u bytes, weak %u"), "entropy file logged" },
+    { MintLog::token("state %u -> %u"), "state changes logged" },
+    { MintLog::token("circuit partial"), "intermittent contact logged" },
+    { MintLog::token("circuit intact"), "closed loop logged" },
+    { MintLog::token("circuit broken"), "circuit break logged" },
+    { MintLog::token("tamper recorded in OTP"), "OTP burn logged" },
+};
+
+static std::vector<uint8_t> benchLifecycle() {
+    printf("Lifecycle\n");
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    MintLog::clear();
+
+    std::vector<uint8_t> file(512);
+    uint32_t seed = 0x2545F491;
+    for (uint8_t& b : file) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        b = (uint8_t)seed;
+    }
+
+    std::unique_ptr<MintDevice> device(new MintDevice());
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(*device, MintHost::now() + 500);
+    });
+    check(device->begin() && host.mount(), "device boots");
+    check(host.writeFile("ENTROPY BIN", nullptr, file.data(), file.size()), "entropy file written");
+    runDevice(*device, MintHost::now() + 10000000);
+    check(device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device seals");
+
+    // Intermittent contact for 200 ms, a fresh level every sample, then
+    // the loop closes again
+    for (int i = 0; i < 800; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        MintHost::setPin(CIRCUIT_PIN, (seed & 1) ? HIGH : LOW);
+        runDevice(*device, MintHost::now() + 250);
+    }
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    runDevice(*device, MintHost::now() + 200000);
+    check(device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET,
+          "intermittent contact keeps the device in service");
+
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+    runDevice(*device, MintHost::now() + 1500000);
+    check(device->getState() == MintDevice::MINT_STATE_TAMPERED, "device tampered");
+
+    const std::vector<uint8_t> data = drain();
+    uint32_t dropped = 0;
+    std::vector<Record> records;
+    check(parse(data, dropped, records) && dropped == 0, "lifecycle drain parses");
+    printf("  %-24s %zu records, %zu bytes\n", "boot to tamper", records.size(), data.size());
+
+    for (const Expected& event : LIFECYCLE_EVENTS) {
+        check(hasToken(records, event.token), event.what);
+    }
+
+    bool ordered = !records.empty() && records.back().time_us <= MintHost::now();
+    for (size_t i = 1; i < records.size(); i++) {
+        ordered = ordered && records[i].time_us >= records[i - 1].time_us;
+    }
+    check(ordered, "record times in order");
+
+    bool leaked = false;
+    for (size_t i = 0; i + LEAK_RUN <= file.size() && !leaked; i++) {
+        leaked = std::search(data.begin(), data.end(), file.begin() + i,
+                             file.begin() + i + LEAK_RUN) != data.end();
+    }
+    check(!leaked, "no entropy file bytes in the log");
+    return data;
+}
+
+int main(int argc, char** argv) {
+    const char* output = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--output file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    benchRecords();
+    benchRing();
+    benchTiming();
+    benchImage();
+    const std::vector<uint8_t> lifecycle = benchLifecycle();
+    if (output) {
+        std::ofstream(output, std::ios::binary).write((const char*)lifecycle.data(),
+                                                      lifecycle.size());
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+/**
+ * Mint Media Change Benchmark
+ *
+ * Acts as a USB host that caches every sector it reads and only drops its
+ * cache when a TEST UNIT READY poll fails with UNIT ATTENTION, MEDIUM MAY
+ * HAVE CHANGED, the way desktop hosts treat removable media. Checks that
+ * README.TXT updates reach such a host without a re-plug, that rewriting
+ * an unchanged README raises nothing, that the address and key sit at
+ * their template offsets (mint_readme.h), and reports the time from a
+ * device state change to the host showing the new README.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/media_change_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o media_change_bench
+ *     ./media_change_bench
+ *
+ * Add -DMINT_STORAGE_FLASH mint_flash.cpp tests/host/SPI.cpp to run the
+ * same checks on the flash volume.
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_storage.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// How often the host polls TEST UNIT READY
+#define HOST_POLL_US 1000000
+
+// Display task period (see mint.cpp): the README is rendered this long
+// after a state change at most
+#define DISPLAY_PERIOD_US 100000
+
+// Slack for the scheduler pass and the host's re-read
+#define LATENCY_SLACK_US 10000
+
+/**
+ * USB host with a sector cache, polling TEST UNIT READY.
+ */
+class CachingHost {
+public:
+    typedef std::function<void()> StepHook;
+
+    CachingHost(Adafruit_USBD_MSC* usb_msc, StepHook step_hook) :
+        msc(usb_msc), step(step_hook), attentions(0), other_failures(0) {}
+
+    /**
+     * Poll TEST UNIT READY and handle a failure as a host would.
+     */
+    void poll() {
+        if (msc->hostTestUnitReady()) {
+            return;
+        }
+        uint8_t key, asc, ascq;
+        msc->hostRequestSense(key, asc, ascq);
+        if (key == SCSI_SENSE_UNIT_ATTENTION && asc == 0x28) {
+            attentions++;
+            cache.clear();
+        } else {
+            other_failures++;
+        }
+    }
+
+    /**
+     * Read README.TXT through the cache.
+     * @return README text, empty if not found
+     */
+    std::string readme() {
+        uint8_t boot[FAT_SECTOR_SIZE], root[FAT_SECTOR_SIZE], data[FAT_SECTOR_SIZE];
+        MintFatGeometry geometry;
+        if (!read(0, boot) || !MintFatVolume::parseBootSector(boot, geometry) ||
+            !read(geometry.root_start, root)) {
+            return std::string();
+        }
+        for (size_t i = 0; i < FAT_DIR_ENTRIES_PER_SECTOR; i++) {
+            MintFatEntry entry;
+            if (MintFatVolume::parseDirEntry(root, i, entry) != MintFatVolume::ENTRY_VALID ||
+                memcmp(entry.name, "README  TXT", 11) != 0) {
+                continue;
+            }
+            uint32_t lba = geometry.data_start +
+                (uint32_t)(entry.start_cluster - FAT_FIRST_CLUSTER) * geometry.sectors_per_cluster;
+            if (!read(lba, data)) {
+                return std::string();
+            }
+            return std::string((const char*)data, std::min(entry.size, (uint32_t)sizeof(data)));
+        }
+        return std::string();
+    }
+
+    // The host knows what it wrote itself
+    void forget() { cache.clear(); }
+
+    uint32_t getAttentions() const { return attentions; }
+    uint32_t getOtherFailures() const { return other_failures; }
+
+private:
+    Adafruit_USBD_MSC* msc;
+    StepHook step;
+    std::map<uint32_t, std::vector<uint8_t> > cache;
+    uint32_t attentions;
+    uint32_t other_failures;
+
+    bool read(uint32_t lba, uint8_t* buffer) {
+        auto cached = cache.find(lba);
+        if (cached != cache.end()) {
+            memcpy(buffer, cached->second.data(), FAT_SECTOR_SIZE);
+            return true;
+        }
+        for (int tries = 0; tries < HOST_FAT_MAX_RETRIES; tries++) {
+            int32_t result = msc->hostRead(lba, buffer, FAT_SECTOR_SIZE);
+            if (result == FAT_SECTOR_SIZE) {
+                cache[lba].assign(buffer, buffer + FAT_SECTOR_SIZE);
+                return true;
+            }
+            if (result < 0) {
+                return false;
+            }
+            step();
+        }
+        return false;
+    }
+};
+
+/**
+ * Storage alone: only a README that changed raises a unit attention.
+ */
+static void benchStorage() {
+    printf("Storage\n");
+#ifdef MINT_STORAGE_FLASH
+    SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+    MintHost::resetClock();
+    MintStorage storage;
+    check(storage.begin(), "storage starts");
+    CachingHost host(Adafruit_USBD_MSC::lastInstance(), [&storage]() {
+        delay(1);
+        storage.task();
+    });
+
+    host.poll();
+    check(host.getAttentions() == 0, "no attention after boot");
+    std::string before = host.readme();
+    check(before.compare(0, 11, "MINT DEVICE") == 0, "boot README");
+
+    // Same text again: nothing to re-read
+    storage.writeFile("MINT DEVICE\r\nDrop file for wallet\r\n");
+    host.poll();
+    check(host.getAttentions() == 0, "unchanged README raises nothing");
+
+    // New text: stale in the host cache until the next poll
+    const char* updated = "MINT DEVICE - UPDATED\n";
+    storage.writeFile(updated);
+    storage.writeFile(updated);
+    check(host.readme() == before, "host cache is stale before the poll");
+    delay(250);
+    host.poll();
+    check(host.getAttentions() == 1, "one attention per change");
+    check(host.readme() == updated, "host re-reads the new README");
+    host.poll();
+    check(host.getAttentions() == 1, "attention reported once");
+    check(host.getOtherFailures() == 0, "no other unit failures");
+
+    MediaChangeStats stats = storage.getMediaChangeStats();
+    check(stats.changes == 1 && stats.attentions == 1 && stats.reloads == 1,
+          "change, attention and reload counted");
+    check(stats.last_latency_us >= 250000 && stats.last_latency_us < 260000,
+          "latency runs from the first unseen change");
+    printf("  change to host re-read: %.1f ms (poll 250 ms after the change)\n",
+           stats.last_latency_us / 1000.0);
+}
+
+static void runDevice(MintDevice& device, CachingHost& host, uint64_t& next_poll_us,
+                      uint64_t until_us) {
+    while (MintHost::now() < until_us) {
+        if (MintHost::now() >= next_poll_us) {
+            host.poll();
+            next_poll_us += HOST_POLL_US;
+        }
+        device.loop();
+        uint64_t idle_us = (uint64_t)device.getIdleTime() * 1000;
+        uint64_t wake_us = std::min(MintHost::now() + std::max<uint64_t>(idle_us, 1000),
+                                    std::min(next_poll_us, until_us));
+        MintHost::advance(std::max<uint64_t>(wake_us, MintHost::now() + 1) - MintHost::now());
+    }
+}
+
+/**
+ * Run until the device reaches a state, then until the cached README
+ * starts with the expected text. Returns the latency in microseconds.
+ */
+static uint64_t waitForReadme(MintDevice& device, CachingHost& host, uint64_t& next_poll_us,
+                              MintDevice::MintState state, const char* text) {
+    const uint64_t timeout_us = MintHost::now() + 10000000;
+    while (device.getState() != state && MintHost::now() < timeout_us) {
+        runDevice(device, host, next_poll_us, MintHost::now() + 1000);
+    }
+    check(device.getState() == state, "state reached");
+    const uint64_t state_us = MintHost::now();
+    check(host.readme().compare(0, strlen(text), text) != 0,
+          "caching host still shows the old README");
+
+    while (host.readme().compare(0, strlen(text), text) != 0 &&
+           MintHost::now() < timeout_us) {
+        runDevice(device, host, next_poll_us, MintHost::now() + 1000);
+    }
+    check(host.readme().compare(0, strlen(text), text) == 0, "host shows the new README");
+    return MintHost::now() - state_us;
+}
+
+/**
+ * Full device: the host sees the sealed and tampered READMEs without a
+ * re-plug, within one display period and one poll of the state change.
+ */
+static void benchDevice() {
+    printf("Device\n");
+    SE05x::setNextConfig(SE05x::defaultConfig());
+#ifdef MINT_STORAGE_FLASH
+    SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintDevice device;
+    check(device.begin(), "device boot");
+    uint64_t next_poll_us = MintHost::now();
+    CachingHost host(Adafruit_USBD_MSC::lastInstance(), [&]() {
+        runDevice(device, host, next_poll_us, MintHost::now() + 1000);
+    });
+    HostFat writer(Adafruit_USBD_MSC::lastInstance(), [&]() {
+        runDevice(device, host, next_poll_us, MintHost::now() + 500);
+    });
+    check(writer.mount(), "host mounts the volume");
+    runDevice(device, host, next_poll_us, MintHost::now() + 500000);
+    check(host.readme().compare(0, 11, "MINT DEVICE") == 0, "boot README");
+
+    uint8_t data[512];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 97 + 13);
+    }
+    check(writer.writeFile("ENTROPY BIN", nullptr, data, sizeof(data)), "host write");
+    host.forget();
+    host.readme();
+
+    const uint64_t bound_us = DISPLAY_PERIOD_US + HOST_POLL_US + LATENCY_SLACK_US;
+    uint64_t sealed_us = waitForReadme(device, host, next_poll_us,
+                                       MintDevice::MINT_STATE_READY_WITH_WALLET,
+                                       "MINT DEVICE - SEALED STATE");
+    printf("  %-24s %8.1f ms (bound %.0f ms)\n", "sealed README shown", sealed_us / 1000.0,
+           bound_us / 1000.0);
+    check(sealed_us <= bound_us, "sealed README within one display period and poll");
+    const std::string address = device.getPublicAddress();
+    check(host.readme().size() == MINT_README_SEALED.length &&
+          host.readme().compare(MINT_README_SEALED.address.offset, address.size(), address) == 0,
+          "address patched at its template offset");
+
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+    uint64_t tampered_us = waitForReadme(device, host, next_poll_us,
+                                         MintDevice::MINT_STATE_TAMPERED,
+                                         "MINT DEVICE - TAMPERED STATE");
+    printf("  %-24s %8.1f ms (bound %.0f ms)\n", "tampered README shown", tampered_us / 1000.0,
+           bound_us / 1000.0);
+    check(tampered_us <= bound_us, "tampered README within one display period and poll");
+    const std::string wif = device.getPrivateKey();
+    check(host.readme().size() == MINT_README_TAMPERED.length &&
+          host.readme().compare(MINT_README_TAMPERED.wif.offset, wif.size(), wif) == 0 &&
+          host.readme().compare(MINT_README_TAMPERED.address.offset, address.size(),
+                                address) == 0, "key and address patched at their offsets");
+
+    // The display task rewrites the README every period; unchanged text
+    // must not make the host reload
+    uint32_t attentions = host.getAttentions();
+    runDevice(device, host, next_poll_us, MintHost::now() + 5000000);
+    check(host.getAttentions() == attentions, "no attention while the README is unchanged");
+    check(attentions == 2, "one attention per README change");
+    check(host.getOtherFailures() == 0, "no other unit failures");
+}
+
+int main() {
+    benchStorage();
+    benchDevice();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
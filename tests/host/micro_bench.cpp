@@ -0,0 +1,375 @@
+/**
+ * Mint Microbenchmarks
+ *
+ * Times the firmware's pure-CPU routines on the host: Base58 and WIF
+ * encoding, the derivation path parser, the TRNG bit frequency test,
+ * README rendering on a sealed device, and the MSC read and write
+ * callbacks. Each routine is run in batches long enough to swamp the
+ * clock's resolution and the fastest of several rounds is reported, in
+ * nanoseconds and heap allocations per call. Allocations are counted
+ * through operator new, which is where every firmware String comes from.
+ *
+ * A baseline written on one machine is compared on the same machine: a
+ * routine regresses if it gets slower than its baseline by more than the
+ * tolerance, or allocates more per call at all.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/micro_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o micro_bench
+ *     ./micro_bench --write-baseline micro.baseline
+ *     ./micro_bench --baseline micro.baseline [--tolerance-pct 25]
+ *
+ * Add -DMINT_STORAGE_FLASH mint_flash.cpp tests/host/SPI.cpp to time the
+ * MSC callbacks on the flash volume.
+ *
+ * Exits non-zero if the sealed device can't be set up, or a routine
+ * regresses against the baseline. Run on an otherwise idle machine.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_bip32.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <chrono>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+// A timed batch runs at least this long
+#define BATCH_NS 20000000ULL
+
+// Batches per routine; the fastest is reported
+#define ROUNDS 5
+
+// Heap allocations since start, counted while a routine runs
+static bool counting = false;
+static uint64_t allocations = 0;
+
+void* operator new(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+// Out of line, so the compiler doesn't pair the new and free it can see
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+/**
+ * Access to the private routines under test.
+ */
+class MintTimingProbe {
+public:
+    static MintWallet& wallet(MintDevice& device) {
+        return device.wallet;
+    }
+
+    static MintSecure& secure(MintDevice& device) {
+        return device.secure;
+    }
+
+    static bool renderReadme(MintDevice& device) {
+        return device.renderReadme();
+    }
+
+    static bool entropyHealthCheck(MintSecure& secure, const uint8_t* data, size_t length) {
+        return secure.entropyHealthCheck(data, length);
+    }
+
+    static bool base58Encode(MintWallet& wallet, const uint8_t* data, size_t length,
+                             char* str, size_t str_len) {
+        return wallet.base58Encode(data, length, str, str_len);
+    }
+
+    static bool rawKeyToWIF(MintWallet& wallet, const uint8_t* raw_key) {
+        return wallet.rawKeyToWIF(raw_key);
+    }
+};
+
+typedef struct {
+    std::string name;
+    double ns_per_op;
+    double allocs_per_op;
+} BenchResult;
+
+// Keeps results alive so calls aren't optimized away
+static volatile uint32_t sink;
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Time one routine.
+ * @param name Routine name, as stored in the baseline
+ * @param op One call of the routine; returns a value folded into the sink
+ */
+static BenchResult bench(const char* name, const std::function<uint32_t()>& op) {
+    // Grow the batch until it runs long enough to time
+    uint64_t iterations = 1;
+    for (;;) {
+        const uint64_t start = nowNs();
+        for (uint64_t i = 0; i < iterations; i++) {
+            sink += op();
+        }
+        if (nowNs() - start >= BATCH_NS / 4 || iterations >= (1ULL << 30)) {
+            break;
+        }
+        iterations *= 2;
+    }
+    iterations *= 4;
+
+    BenchResult result = { name, 0, 0 };
+    for (int round = 0; round < ROUNDS; round++) {
+        allocations = 0;
+        counting = true;
+        const uint64_t start = nowNs();
+        for (uint64_t i = 0; i < iterations; i++) {
+            sink += op();
+        }
+        const uint64_t elapsed = nowNs() - start;
+        counting = false;
+
+        const double ns = (double)elapsed / iterations;
+        if (round == 0 || ns < result.ns_per_op) {
+            result.ns_per_op = ns;
+        }
+        result.allocs_per_op = (double)allocations / iterations;
+    }
+    printf("  %-20s %12.1f ns/op %8.2f allocs/op\n", name, result.ns_per_op,
+           result.allocs_per_op);
+    return result;
+}
+
+/**
+ * Boot a device and seal a wallet on it, so every routine runs on the
+ * path it takes in the field.
+ */
+static bool sealDevice(MintDevice& device) {
+    SE05x::setNextConfig(SE05x::defaultConfig());
+#ifdef MINT_STORAGE_FLASH
+    SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    if (!device.begin()) {
+        return false;
+    }
+
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(device, MintHost::now() + 500);
+    });
+    uint8_t entropy[512];
+    for (size_t i = 0; i < sizeof(entropy); i++) {
+        entropy[i] = (uint8_t)(i * 131 + 17);
+    }
+    if (!host.mount() || !host.writeFile("ENTROPY BIN", nullptr, entropy, sizeof(entropy))) {
+        return false;
+    }
+    const uint64_t until_us = MintHost::now() + 10000000;
+    while (device.getState() != MintDevice::MINT_STATE_READY_WITH_WALLET &&
+           MintHost::now() < until_us) {
+        runDevice(device, MintHost::now() + 1000);
+    }
+    return device.getState() == MintDevice::MINT_STATE_READY_WITH_WALLET;
+}
+
+static std::vector<BenchResult> runAll(MintDevice& device) {
+    MintWallet& wallet = MintTimingProbe::wallet(device);
+    MintSecure& secure = MintTimingProbe::secure(device);
+    Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::lastInstance();
+    std::vector<BenchResult> results;
+
+    // WIF payload: prefix, key, compression flag, checksum
+    uint8_t payload[38];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(0x80 + i * 7);
+    }
+    results.push_back(bench("base58Encode", [&]() {
+        char str[128];
+        MintTimingProbe::base58Encode(wallet, payload, sizeof(payload), str, sizeof(str));
+        return (uint32_t)str[0];
+    }));
+
+    results.push_back(bench("rawKeyToWIF", [&]() {
+        return (uint32_t)MintTimingProbe::rawKeyToWIF(wallet, payload + 1);
+    }));
+
+    results.push_back(bench("parsePath", [&]() {
+        uint32_t indices[BIP32_MAX_DEPTH];
+        size_t depth = 0;
+        MintBIP32::parsePath(MINT_DEFAULT_ADDRESS_PATH, indices, BIP32_MAX_DEPTH, depth);
+        return indices[depth - 1];
+    }));
+
+    uint8_t trng[64];
+    for (size_t i = 0; i < sizeof(trng); i++) {
+        trng[i] = (uint8_t)(i * 0x9D + 0x35);
+    }
+    results.push_back(bench("entropyHealthCheck", [&]() {
+        return (uint32_t)MintTimingProbe::entropyHealthCheck(secure, trng, sizeof(trng));
+    }));
+
+    results.push_back(bench("renderReadme", [&]() {
+        return (uint32_t)MintTimingProbe::renderReadme(device);
+    }));
+
+    // Boot sector reads; writes go to the last block, which no file uses
+    uint8_t sector[512];
+    results.push_back(bench("msc_read_cb", [&]() {
+        return (uint32_t)msc->hostRead(0, sector, sizeof(sector));
+    }));
+
+    memset(sector, 0xA5, sizeof(sector));
+    const uint32_t last_lba = msc->getBlockCount() - 1;
+    results.push_back(bench("msc_write_cb", [&]() {
+        return (uint32_t)msc->hostWrite(last_lba, sector, sizeof(sector));
+    }));
+    return results;
+}
+
+static bool loadBaseline(const char* path, std::vector<BenchResult>& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        double ns, allocs;
+        if (sscanf(line, "routine %63s %lf %lf", name, &ns, &allocs) == 3) {
+            out.push_back({ name, ns, allocs });
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeBaseline(const char* path, const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        return false;
+    }
+    fprintf(f, "# mint micro baseline: routine <name> <ns/op> <allocs/op>\n");
+    for (const BenchResult& r : results) {
+        fprintf(f, "routine %s %.1f %.2f\n", r.name.c_str(), r.ns_per_op, r.allocs_per_op);
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * Compare against a baseline.
+ * @return Number of regressions
+ */
+static int compare(const std::vector<BenchResult>& results,
+                   const std::vector<BenchResult>& baseline, double tolerance_pct) {
+    int regressions = 0;
+    printf("%-20s %12s %12s %9s %14s\n", "routine", "ns/op", "baseline", "delta", "allocs/op");
+    for (const BenchResult& r : results) {
+        const BenchResult* base = nullptr;
+        for (const BenchResult& b : baseline) {
+            if (b.name == r.name) {
+                base = &b;
+            }
+        }
+        if (!base) {
+            printf("%-20s %12.1f %12s %9s %14.2f  not in baseline\n", r.name.c_str(),
+                   r.ns_per_op, "-", "-", r.allocs_per_op);
+            regressions++;
+            continue;
+        }
+
+        const double delta_pct = (r.ns_per_op / base->ns_per_op - 1) * 100;
+        const bool slower = delta_pct > tolerance_pct;
+        const bool allocates = r.allocs_per_op > base->allocs_per_op + 0.005;
+        printf("%-20s %12.1f %12.1f %+8.1f%% %6.2f (%5.2f)%s%s\n", r.name.c_str(), r.ns_per_op,
+               base->ns_per_op, delta_pct, r.allocs_per_op, base->allocs_per_op,
+               slower ? "  SLOWER" : "", allocates ? "  MORE ALLOCS" : "");
+        if (slower || allocates) {
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    const char* baseline_path = nullptr;
+    const char* write_baseline_path = nullptr;
+    double tolerance_pct = 25;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (arg == "--write-baseline" && i + 1 < argc) {
+            write_baseline_path = argv[++i];
+        } else if (arg == "--tolerance-pct" && i + 1 < argc) {
+            tolerance_pct = strtod(argv[++i], nullptr);
+        } else {
+            fprintf(stderr, "usage: %s [--baseline file] [--write-baseline file] "
+                            "[--tolerance-pct n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> baseline;
+    if (baseline_path && !loadBaseline(baseline_path, baseline)) {
+        fprintf(stderr, "cannot read baseline %s\n", baseline_path);
+        return 2;
+    }
+
+    MintDevice device;
+    if (!sealDevice(device)) {
+        printf("FAILED: could not seal a wallet on the simulated device\n");
+        return 1;
+    }
+
+    printf("Microbenchmarks\n");
+    std::vector<BenchResult> results = runAll(device);
+
+    if (write_baseline_path && !writeBaseline(write_baseline_path, results)) {
+        fprintf(stderr, "cannot write baseline %s\n", write_baseline_path);
+        return 2;
+    }
+    if (baseline_path) {
+        const int regressions = compare(results, baseline, tolerance_pct);
+        if (regressions) {
+            printf("FAILED: %d routine(s) regressed beyond %.0f%%\n", regressions, tolerance_pct);
+            return 1;
+        }
+    }
+    printf("OK\n");
+    return 0;
+}
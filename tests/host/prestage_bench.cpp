@@ -0,0 +1,214 @@
+/**
+ * Mint Generation Pre-Staging Benchmark
+ *
+ * Runs the device on the simulated board and checks the hardware entropy
+ * staged while it waits for a file. A file dropped on a staged device
+ * is sealed with one SE050 command less on the critical path than one
+ * dropped before staging: the TRNG draw and its health test are done.
+ * Then checks the staged entropy is zeroed and drawn again once it is
+ * MINT_PRESTAGE_LIFETIME_US old, and dropped on a circuit break and
+ * while the SE050 is out of service.
+ *
+ * Times are virtual: the SE050 commands are charged the simulated
+ * latencies.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/prestage_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o prestage_bench
+ *     ./prestage_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_trace.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Time from boot until a file is dropped
+#define DROP_AFTER_US 500000ULL
+
+// A TRNG answer the SE050 health test rejects
+static void queueStuckTrng(const SE05xSimConfig& config) {
+    (*config.script)[TRACE_SE050_RANDOM].push_back({ true, std::vector<uint8_t>(32, 0xFF) });
+}
+
+static SE05xFaults faultsWith(uint32_t timeout_ppm) {
+    SE05xFaults faults = SE05x::defaultConfig().faults;
+    faults.timeout_rate_ppm = timeout_ppm;
+    return faults;
+}
+
+/**
+ * A bench device that times its generation and tells whether entropy is
+ * staged.
+ */
+class PrestageBench : public Bench {
+public:
+    using Bench::Bench;
+
+    /**
+     * Drop an entropy file and time the generation from hand-over to seal.
+     * @param commands Output SE050 commands in that time
+     * @return Microseconds, 0 if the device did not seal
+     */
+    uint64_t seal(uint32_t& commands) {
+        std::vector<uint8_t> file(512);
+        for (size_t i = 0; i < file.size(); i++) {
+            file[i] = (uint8_t)(i * 97 + 13);
+        }
+        check(host->writeFile("ENTROPY BIN", nullptr, file.data(), file.size()),
+              "entropy file written");
+
+        uint64_t handed_over = 0;
+        uint32_t start_commands = 0;
+        const uint64_t give_up = MintHost::now() + 5000000;
+        while (MintHost::now() < give_up && state() != MintDevice::MINT_STATE_READY_WITH_WALLET) {
+            if (!handed_over && state() == MintDevice::MINT_STATE_GENERATING_WALLET) {
+                handed_over = MintHost::now();
+                start_commands = se->getStats().commands;
+            }
+            device->loop();
+            if (!handed_over && state() == MintDevice::MINT_STATE_GENERATING_WALLET) {
+                handed_over = MintHost::now();
+                start_commands = se->getStats().commands;
+            }
+            delay(device->getIdleTime());
+        }
+        if (!handed_over || state() != MintDevice::MINT_STATE_READY_WITH_WALLET) {
+            return 0;
+        }
+        commands = se->getStats().commands - start_commands;
+        return MintHost::now() - handed_over;
+    }
+
+    bool staged() const {
+        return device->isGenerationStaged();
+    }
+
+    bool selfTestFailed() const {
+        return device->getSelfTest().hasFailed();
+    }
+};
+
+/**
+ * The same file dropped on a staged device and on one whose staging
+ * draw failed its health test, so the mix draws from the TRNG itself.
+ */
+static void benchCriticalPath() {
+    printf("File to seal\n");
+    PrestageBench warm(SE05x::defaultConfig());
+    check(warm.boot(), "staged device boots");
+    warm.run(DROP_AFTER_US);
+    check(warm.staged(), "entropy staged before the file");
+    uint32_t warm_commands = 0;
+    const uint64_t warm_us = warm.seal(warm_commands);
+    check(warm_us > 0, "staged device seals");
+    check(!warm.staged(), "staged entropy used up");
+
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    PrestageBench cold(config);
+    check(cold.boot(), "unstaged device boots");
+    // After boot, whose key check on a blank device draws a random byte
+    queueStuckTrng(config);
+    cold.run(DROP_AFTER_US);
+    check(!cold.staged(), "stuck TRNG draw not staged");
+    uint32_t cold_commands = 0;
+    const uint64_t cold_us = cold.seal(cold_commands);
+    check(cold_us > 0, "unstaged device seals");
+
+    printf("  %-24s %7.1f ms  %2u SE050 commands\n", "staged", warm_us / 1000.0,
+           (unsigned)warm_commands);
+    printf("  %-24s %7.1f ms  %2u SE050 commands\n", "drawn after the file", cold_us / 1000.0,
+           (unsigned)cold_commands);
+    check(warm_commands + 1 == cold_commands, "TRNG draw off the critical path");
+    check(warm_us < cold_us, "staged device seals sooner");
+}
+
+/**
+ * Staged entropy is zeroed once it is MINT_PRESTAGE_LIFETIME_US old; a
+ * fresh draw that fails its health test leaves nothing staged until the
+ * retry.
+ */
+static void benchExpiry() {
+    printf("Expiry\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    PrestageBench bench(config);
+    check(bench.boot(), "device boots");
+    bench.run(1000000);
+    check(bench.staged(), "entropy staged");
+
+    bench.run(MINT_PRESTAGE_LIFETIME_US - 2000000);
+    check(bench.staged(), "kept within its lifetime");
+    // Half way to the retry of the stuck draw that replaces it
+    queueStuckTrng(config);
+    bench.run(1500000);
+    check(!bench.staged() && (*config.script)[TRACE_SE050_RANDOM].empty(),
+          "expired entropy dropped and drawn again");
+    check(!bench.selfTestFailed(), "stuck draw taken by the staging, not the self-test");
+    bench.run(1000000);
+    check(bench.staged(), "staged again after the retry");
+}
+
+/**
+ * A circuit break drops the staged entropy and nothing is staged after.
+ */
+static void benchTamper() {
+    printf("Circuit break\n");
+    PrestageBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+    bench.run(DROP_AFTER_US);
+    check(bench.staged(), "entropy staged");
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+    bench.run(500000);
+    check(bench.state() == MintDevice::MINT_STATE_TAMPERED, "tamper detected");
+    check(!bench.staged(), "staged entropy dropped");
+    bench.run(2000000);
+    check(!bench.staged(), "nothing staged while tampered");
+}
+
+/**
+ * An SE050 that stops answering drops the staged entropy; it is drawn
+ * again once the device is back in service.
+ */
+static void benchDegraded() {
+    printf("SE050 out of service\n");
+    PrestageBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+    bench.run(DROP_AFTER_US);
+    check(bench.staged(), "entropy staged");
+
+    // Every command hangs; without a wallet a self-test pass makes two
+    // SE050 calls, so the breaker opens on the second pass
+    bench.secureElement()->setFaults(faultsWith(1000000));
+    bench.run(2 * (MINT_SELFTEST_CYCLE_US + 3000000));
+    check(bench.state() == MintDevice::MINT_STATE_DEGRADED, "device degraded");
+    check(!bench.staged(), "staged entropy dropped");
+
+    bench.secureElement()->setFaults(faultsWith(0));
+    bench.run(MINT_SE050_BREAKER_MAX_COOLDOWN_US + 1000000);
+    check(bench.state() == MintDevice::MINT_STATE_READY_NO_WALLET, "device back in service");
+    check(bench.staged(), "staged again");
+}
+
+int main() {
+    benchCriticalPath();
+    benchExpiry();
+    benchTamper();
+    benchDegraded();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
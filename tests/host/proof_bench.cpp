@@ -0,0 +1,293 @@
+/**
+ * Mint Ownership Proof Benchmark
+ *
+ * Runs a stack of simulated devices through wallet generation, drops a
+ * batch of challenges on each sealed device, and captures the README and
+ * PROOF.BIN the device writes back. The captured volumes are then checked
+ * with ProofVerifier (tests/host/proof_host.h) on one thread and on a
+ * thread pool. Checks that every device proves its key without the seal
+ * being touched, that forged, swapped and mismatched proofs are rejected,
+ * and that an opened device or a malformed batch gets no proof. Reports
+ * the time from a challenge drop to the proof on the device, and the
+ * verification throughput in devices per second.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -pthread -I tests/host -I . tests/host/proof_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o proof_bench
+ *     ./proof_bench
+ *
+ * Add -DMINT_STORAGE_FLASH mint_flash.cpp tests/host/SPI.cpp to run the
+ * same checks on the flash volume.
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "fat_host.h"
+#include "proof_host.h"
+#include "bench_host.h"
+
+#include <chrono>
+
+// Devices in the stack
+#define FLEET_SIZE 16
+
+// A full batch must be answered within this long of the drop
+#define PROOF_BOUND_US 1000000
+
+static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static std::vector<uint8_t> randomBytes(size_t size, uint64_t& state) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)splitmix(state);
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> challengeFile(const std::vector<uint8_t>& challenges) {
+    std::vector<uint8_t> file(MINT_CHALLENGE_HEADER_SIZE + challenges.size());
+    memcpy(file.data(), MINT_CHALLENGE_MAGIC, MINT_CHALLENGE_HEADER_SIZE);
+    memcpy(file.data() + MINT_CHALLENGE_HEADER_SIZE, challenges.data(), challenges.size());
+    return file;
+}
+
+/**
+ * One simulated device with a blank secure element, booted and mounted.
+ */
+struct Rig {
+    std::unique_ptr<MintDevice> device;
+    std::unique_ptr<HostFat> host;
+
+    Rig() {
+        SE05x::setNextConfig(SE05x::defaultConfig());
+#ifdef MINT_STORAGE_FLASH
+        SPI1.setFlashConfig(SPIClass::defaultConfig());
+#endif
+        MintHost::resetClock();
+        MintHost::setPin(CIRCUIT_PIN, LOW);
+        device.reset(new MintDevice());
+        check(device->begin(), "device boot");
+        host.reset(new HostFat(Adafruit_USBD_MSC::lastInstance(), [this]() {
+            runDevice(*device, MintHost::now() + 500);
+        }));
+        check(host->mount(), "host mounts the volume");
+    }
+
+    bool waitFor(MintDevice::MintState state, uint64_t timeout_us) {
+        const uint64_t until_us = MintHost::now() + timeout_us;
+        while (device->getState() != state && MintHost::now() < until_us) {
+            runDevice(*device, MintHost::now() + 1000);
+        }
+        return device->getState() == state;
+    }
+
+    bool seal(uint64_t& seed) {
+        std::vector<uint8_t> entropy = randomBytes(512, seed);
+        return host->writeFile("ENTROPY BIN", nullptr, entropy.data(), entropy.size()) &&
+               waitFor(MintDevice::MINT_STATE_READY_WITH_WALLET, 10000000);
+    }
+
+    /**
+     * Drop a challenge file and wait for PROOF.BIN.
+     * @return Microseconds from the last host write to the proof, 0 if none came
+     */
+    uint64_t challenge(const std::vector<uint8_t>& file, uint64_t timeout_us) {
+        if (!host->writeFile("CHALLNGEBIN", "challenge.bin", file.data(), file.size())) {
+            return 0;
+        }
+        const uint64_t dropped_us = host->getLastWriteTime();
+        const uint64_t until_us = MintHost::now() + timeout_us;
+        std::vector<uint8_t> proof;
+        while (MintHost::now() < until_us) {
+            runDevice(*device, MintHost::now() + 1000);
+            if (host->readFile("PROOF   BIN", proof)) {
+                return MintHost::now() - dropped_us;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Capture the sectors a verifier reads, through the host interface.
+     */
+    ProofVerifier::SparseImage capture(const std::vector<uint8_t>& challenges) {
+        ProofVerifier::SparseImage image;
+        Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::lastInstance();
+        MintFatVolume::SectorReader read = [this, msc](uint32_t lba, uint8_t* buffer) {
+            for (int tries = 0; tries < HOST_FAT_MAX_RETRIES; tries++) {
+                int32_t result = msc->hostRead(lba, buffer, FAT_SECTOR_SIZE);
+                if (result == FAT_SECTOR_SIZE) {
+                    return true;
+                }
+                if (result < 0) {
+                    return false;
+                }
+                runDevice(*device, MintHost::now() + 500);
+            }
+            return false;
+        };
+        ProofVerifier::verify(ProofVerifier::recordingReader(read, image), challenges.data(),
+                              challenges.size() / MINT_PROOF_CHALLENGE_SIZE);
+        return image;
+    }
+};
+
+// Sector of an image holding PROOF.BIN
+static uint32_t proofSector(const ProofVerifier::SparseImage& image) {
+    for (const auto& sector : image) {
+        if (memcmp(sector.second.data(), MINT_PROOF_MAGIC, 8) == 0) {
+            return sector.first;
+        }
+    }
+    return 0;
+}
+
+static double verifyRate(const std::vector<ProofVerifier::SparseImage>& images,
+                         const std::vector<std::vector<uint8_t> >& challenges, unsigned threads,
+                         std::vector<ProofVerifier::Result>& results) {
+    auto start = std::chrono::steady_clock::now();
+    results = ProofVerifier::verifyAll(images, challenges, MINT_PROOF_MAX_CHALLENGES, threads);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return images.size() / elapsed.count();
+}
+
+/**
+ * A stack of sealed devices, each answering a full batch.
+ */
+static void benchFleet() {
+    printf("Fleet of %d devices, %d challenges each\n", FLEET_SIZE, MINT_PROOF_MAX_CHALLENGES);
+    uint64_t seed = 0x50524F4F46ULL; // "PROOF"
+    std::vector<ProofVerifier::SparseImage> images;
+    std::vector<std::vector<uint8_t> > challenges;
+    uint64_t max_latency_us = 0;
+    bool seals_kept = true;
+
+    for (int i = 0; i < FLEET_SIZE; i++) {
+        Rig rig;
+        check(rig.seal(seed), "wallet generated");
+        challenges.push_back(randomBytes(MINT_PROOF_MAX_CHALLENGES * MINT_PROOF_CHALLENGE_SIZE, seed));
+        uint64_t latency_us = rig.challenge(challengeFile(challenges.back()), PROOF_BOUND_US);
+        check(latency_us > 0, "proof written");
+        max_latency_us = std::max(max_latency_us, latency_us);
+
+        // Signing leaves the device sealed and the OTP unburned
+        seals_kept = seals_kept &&
+                     rig.device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET &&
+                     SE05x::lastInstance()->getStore().otp.empty();
+        images.push_back(rig.capture(challenges.back()));
+    }
+    check(seals_kept, "seal untouched by signing");
+    printf("  %-28s %8.1f ms (bound %d ms)\n", "challenge drop to proof", max_latency_us / 1000.0,
+           PROOF_BOUND_US / 1000);
+
+    std::vector<ProofVerifier::Result> serial, parallel;
+    // At least a few workers, so the pool is exercised on small hosts
+    const unsigned threads = std::max(std::thread::hardware_concurrency(), 4u);
+    double serial_rate = verifyRate(images, challenges, 1, serial);
+    double parallel_rate = verifyRate(images, challenges, threads, parallel);
+    printf("  %-28s %8.1f devices/s\n", "verify, 1 thread", serial_rate);
+    printf("  %-28s %8.1f devices/s (%u threads, %u cores)\n", "verify, parallel", parallel_rate,
+           threads, std::thread::hardware_concurrency());
+
+    size_t verified = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        verified += parallel[i] == ProofVerifier::PROOF_OK;
+        if (parallel[i] != ProofVerifier::PROOF_OK) {
+            printf("  device %zu: %s\n", i, ProofVerifier::resultName(parallel[i]));
+        }
+    }
+    check(verified == images.size(), "every device proves its key");
+    check(serial == parallel, "parallel results match serial");
+
+    // Forgeries
+    ProofVerifier::SparseImage forged = images[0];
+    uint32_t sector = proofSector(forged);
+    check(sector != 0, "proof sector captured");
+    forged[sector][MINT_PROOF_HEADER_SIZE + 5] ^= 0x01;
+    check(ProofVerifier::verify(ProofVerifier::imageReader(forged), challenges[0].data(),
+                                MINT_PROOF_MAX_CHALLENGES) == ProofVerifier::PROOF_BAD_SIGNATURE,
+          "altered signature rejected");
+
+    check(ProofVerifier::verify(ProofVerifier::imageReader(images[0]), challenges[1].data(),
+                                MINT_PROOF_MAX_CHALLENGES) == ProofVerifier::PROOF_BAD_SIGNATURE,
+          "proof for other challenges rejected");
+
+    ProofVerifier::SparseImage swapped = images[0];
+    swapped[proofSector(swapped)] = images[1].at(proofSector(images[1]));
+    check(ProofVerifier::verify(ProofVerifier::imageReader(swapped), challenges[1].data(),
+                                MINT_PROOF_MAX_CHALLENGES) ==
+          ProofVerifier::PROOF_ADDRESS_MISMATCH, "another device's proof rejected");
+}
+
+/**
+ * Challenges the device must not answer.
+ */
+static void benchRefusals() {
+    printf("Refusals\n");
+    uint64_t seed = 0x5245465553ULL; // "REFUS"
+
+    // More challenges than a proof holds
+    {
+        Rig rig;
+        check(rig.seal(seed), "wallet generated");
+        std::vector<uint8_t> batch = randomBytes((MINT_PROOF_MAX_CHALLENGES + 1) *
+                                                 MINT_PROOF_CHALLENGE_SIZE, seed);
+        check(rig.challenge(challengeFile(batch), PROOF_BOUND_US) == 0, "oversized batch refused");
+    }
+
+    // A blank device takes the file as entropy, not as a challenge
+    {
+        Rig rig;
+        std::vector<uint8_t> batch = randomBytes(MINT_PROOF_CHALLENGE_SIZE, seed);
+        check(rig.challenge(challengeFile(batch), PROOF_BOUND_US) == 0, "blank device gives no proof");
+    }
+
+    // An opened device has nothing to prove
+    {
+        Rig rig;
+        check(rig.seal(seed), "wallet generated");
+        MintHost::setPin(CIRCUIT_PIN, HIGH);
+        check(rig.waitFor(MintDevice::MINT_STATE_TAMPERED, 1000000), "tampered");
+        std::vector<uint8_t> batch = randomBytes(MINT_PROOF_CHALLENGE_SIZE, seed);
+        check(rig.challenge(challengeFile(batch), PROOF_BOUND_US) == 0, "opened device gives no proof");
+        ProofVerifier::SparseImage image = rig.capture(batch);
+        check(ProofVerifier::verify(ProofVerifier::imageReader(image), batch.data(), 1) ==
+              ProofVerifier::PROOF_NOT_SEALED, "verifier rejects an opened device");
+    }
+
+    // A second batch replaces the first proof
+    {
+        Rig rig;
+        check(rig.seal(seed), "wallet generated");
+        std::vector<uint8_t> first = randomBytes(2 * MINT_PROOF_CHALLENGE_SIZE, seed);
+        std::vector<uint8_t> second = randomBytes(MINT_PROOF_CHALLENGE_SIZE, seed);
+        check(rig.challenge(challengeFile(first), PROOF_BOUND_US) > 0, "first proof");
+        runDevice(*rig.device, MintHost::now() + 100000);
+        check(rig.host->writeFile("CHALLN~1BIN", "challenge2.bin", challengeFile(second).data(),
+                                  challengeFile(second).size()), "second challenge");
+        runDevice(*rig.device, MintHost::now() + PROOF_BOUND_US);
+        ProofVerifier::SparseImage image = rig.capture(second);
+        check(ProofVerifier::verify(ProofVerifier::imageReader(image), second.data(), 1) ==
+              ProofVerifier::PROOF_OK, "second batch answered");
+    }
+}
+
+int main() {
+    benchFleet();
+    benchRefusals();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
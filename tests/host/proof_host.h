@@ -0,0 +1,231 @@
+/**
+ * Host-side ownership proof verification for Mint devices.
+ *
+ * A verifier writes a challenge file (MINT_CHALLENGE_MAGIC and up to
+ * MINT_PROOF_MAX_CHALLENGES random nonces, see mint_wallet.h) to a sealed
+ * device, and the device answers with PROOF.BIN: its account extended
+ * public key and one SE050 signature per challenge. verify() reads the
+ * README and the proof from a device volume through a sector reader and
+ * checks that the README shows a sealed device, that the displayed
+ * address derives from the proof's key, and that every signature is
+ * valid for its challenge. verifyAll() checks a stack of devices on a
+ * thread pool.
+ */
+#ifndef MINT_HOST_PROOF_H
+#define MINT_HOST_PROOF_H
+
+#include <Arduino.h>
+#include "SE05x.h"
+#include "mint_fat.h"
+#include "mint_bip32.h"
+#include "mint_secp256k1.h"
+#include "mint_wallet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// README line the sealed address follows
+#define PROOF_HOST_SEALED_HEADER "MINT DEVICE - SEALED STATE"
+#define PROOF_HOST_ADDRESS_LABEL "Bitcoin Address:\n"
+
+class ProofVerifier {
+public:
+    typedef enum {
+        PROOF_OK,
+        PROOF_NO_VOLUME,            // No FAT12 volume, or a read failed
+        PROOF_NOT_SEALED,           // README missing or not in the sealed state
+        PROOF_MISSING,              // No PROOF.BIN
+        PROOF_MALFORMED,            // Bad magic, version, count or key
+        PROOF_ADDRESS_MISMATCH,     // Displayed address is not from the proof's key
+        PROOF_BAD_SIGNATURE         // A signature does not match its challenge
+    } Result;
+
+    /**
+     * Sectors of one device volume, only those a verifier reads.
+     */
+    typedef std::map<uint32_t, std::vector<uint8_t> > SparseImage;
+
+    /**
+     * Verify one device.
+     * @param reader Reads one sector of the device volume
+     * @param challenges Challenges written to the device, in order
+     * @param count Number of challenges
+     * @param address Output displayed address, if found
+     * @return PROOF_OK if the device proved it holds the displayed address's key
+     */
+    static Result verify(const MintFatVolume::SectorReader& reader, const uint8_t* challenges,
+                         size_t count, std::string* address = nullptr) {
+        MintFatVolume volume(reader);
+        if (!volume.mount()) {
+            return PROOF_NO_VOLUME;
+        }
+
+        std::vector<uint8_t> readme, proof;
+        Result found = readFile(volume, reader, "README  TXT", readme);
+        if (found != PROOF_OK) {
+            return found == PROOF_MISSING ? PROOF_NOT_SEALED : found;
+        }
+        const std::string text(readme.begin(), readme.end());
+        const size_t label = text.find(PROOF_HOST_ADDRESS_LABEL);
+        if (text.compare(0, strlen(PROOF_HOST_SEALED_HEADER), PROOF_HOST_SEALED_HEADER) != 0 ||
+            label == std::string::npos) {
+            return PROOF_NOT_SEALED;
+        }
+        const size_t start = label + strlen(PROOF_HOST_ADDRESS_LABEL);
+        // The address field is blank-padded to its full width
+        const std::string shown = text.substr(start, text.find_first_of(" \r\n", start) - start);
+        if (address) {
+            *address = shown;
+        }
+
+        found = readFile(volume, reader, "PROOF   BIN", proof);
+        if (found != PROOF_OK) {
+            return found;
+        }
+        if (proof.size() < MINT_PROOF_HEADER_SIZE ||
+            memcmp(proof.data(), MINT_PROOF_MAGIC, 8) != 0 || proof[8] != MINT_PROOF_VERSION ||
+            proof[9] != count ||
+            proof.size() != MINT_PROOF_HEADER_SIZE + count * MINT_PROOF_SIGNATURE_SIZE) {
+            return PROOF_MALFORMED;
+        }
+
+        // The displayed address must derive from the key that signed
+        MintBIP32::ExtendedPublicKey key;
+        memcpy(key.public_key, &proof[10], sizeof(key.public_key));
+        memcpy(key.chain_code, &proof[75], sizeof(key.chain_code));
+        if (!MintSecp256k1::isValidPublicKey(key.public_key)) {
+            return PROOF_MALFORMED;
+        }
+        uint32_t indices[BIP32_MAX_DEPTH];
+        size_t depth;
+        MintBIP32::ExtendedPublicKey child = key;
+        char derived[MINT_ADDRESS_BUFFER_SIZE];
+        if (!MintBIP32::parsePath(MINT_DEFAULT_ADDRESS_PATH, indices, BIP32_MAX_DEPTH, depth)) {
+            return PROOF_MALFORMED;
+        }
+        for (size_t level = MINT_ACCOUNT_DEPTH; level < depth; level++) {
+            if (!MintBIP32::deriveChildPublic(child, indices[level], child)) {
+                return PROOF_MALFORMED;
+            }
+        }
+        if (!MintBIP32::encodeP2WPKH(child.public_key, derived, sizeof(derived)) ||
+            shown != derived) {
+            return PROOF_ADDRESS_MISMATCH;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            uint8_t digest[32];
+            MintSecureTypes::proofDigest(challenges + i * MINT_PROOF_CHALLENGE_SIZE, digest);
+            if (!se05xSimVerify(key.public_key, digest,
+                                &proof[MINT_PROOF_HEADER_SIZE + i * MINT_PROOF_SIGNATURE_SIZE])) {
+                return PROOF_BAD_SIGNATURE;
+            }
+        }
+        return PROOF_OK;
+    }
+
+    /**
+     * Verify a stack of device images in parallel.
+     * @param images Captured device volumes
+     * @param challenges Challenges written to each device, in image order
+     * @param count Challenges per device
+     * @param threads Worker threads
+     * @return One result per image
+     */
+    static std::vector<Result> verifyAll(const std::vector<SparseImage>& images,
+                                         const std::vector<std::vector<uint8_t> >& challenges,
+                                         size_t count, unsigned threads) {
+        std::vector<Result> results(images.size(), PROOF_NO_VOLUME);
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < images.size(); i = next++) {
+                results[i] = verify(imageReader(images[i]), challenges[i].data(), count);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < std::max(threads, 1u); t++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        return results;
+    }
+
+    /**
+     * Sector reader over a captured image.
+     */
+    static MintFatVolume::SectorReader imageReader(const SparseImage& image) {
+        return [&image](uint32_t lba, uint8_t* buffer) {
+            auto sector = image.find(lba);
+            if (sector == image.end()) {
+                return false;
+            }
+            memcpy(buffer, sector->second.data(), FAT_SECTOR_SIZE);
+            return true;
+        };
+    }
+
+    /**
+     * Sector reader that also records every sector into an image, to
+     * capture what a later verify() needs.
+     */
+    static MintFatVolume::SectorReader recordingReader(const MintFatVolume::SectorReader& reader,
+                                                       SparseImage& image) {
+        return [reader, &image](uint32_t lba, uint8_t* buffer) {
+            if (!reader(lba, buffer)) {
+                return false;
+            }
+            image[lba].assign(buffer, buffer + FAT_SECTOR_SIZE);
+            return true;
+        };
+    }
+
+    static const char* resultName(Result result) {
+        static const char* const NAMES[] = {
+            "ok", "no volume", "not sealed", "missing", "malformed", "address mismatch",
+            "bad signature"
+        };
+        return NAMES[result];
+    }
+
+private:
+    // Read a root directory file of up to one sector
+    static Result readFile(MintFatVolume& volume, const MintFatVolume::SectorReader& reader,
+                           const char* short_name, std::vector<uint8_t>& out) {
+        const MintFatGeometry& geometry = volume.getGeometry();
+        uint8_t sector[FAT_SECTOR_SIZE];
+        for (uint32_t s = 0; s < geometry.root_sectors; s++) {
+            if (!reader(geometry.root_start + s, sector)) {
+                return PROOF_NO_VOLUME;
+            }
+            for (size_t i = 0; i < FAT_DIR_ENTRIES_PER_SECTOR; i++) {
+                MintFatEntry entry;
+                MintFatVolume::EntryKind kind = MintFatVolume::parseDirEntry(sector, i, entry);
+                if (kind == MintFatVolume::ENTRY_END) {
+                    // Hosts list nothing past here either
+                    return PROOF_MISSING;
+                }
+                if (kind == MintFatVolume::ENTRY_VALID && memcmp(entry.name, short_name, 11) == 0) {
+                    if (entry.size > FAT_SECTOR_SIZE || !volume.isValidCluster(entry.start_cluster)) {
+                        return PROOF_MALFORMED;
+                    }
+                    if (!reader(volume.clusterToSector(entry.start_cluster), sector)) {
+                        return PROOF_NO_VOLUME;
+                    }
+                    out.assign(sector, sector + entry.size);
+                    return PROOF_OK;
+                }
+            }
+        }
+        return PROOF_MISSING;
+    }
+};
+
+#endif // MINT_HOST_PROOF_H
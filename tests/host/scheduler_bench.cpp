@@ -0,0 +1,210 @@
+/**
+ * Mint Scheduler Benchmark
+ *
+ * Checks MintScheduler ordering, release and deadline accounting with
+ * synthetic tasks in virtual time, then runs a full MintDevice through a
+ * file drop, wallet generation and a circuit break against the simulated
+ * SE050 and reports per-task timing. SE050 work must stay in the crypto
+ * task, so no other task is held up by more than one SE050 command while
+ * a wallet is generated.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/scheduler_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp mint_hash.cpp \
+ *         mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o scheduler_bench
+ *     ./scheduler_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_scheduler.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <string>
+
+static void printStats(const MintScheduler& scheduler) {
+    printf("  %-8s %4s %9s %11s %7s %9s %10s %14s\n", "task", "prio", "period ms",
+           "deadline ms", "runs", "overruns", "max run ms", "max response ms");
+    for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+        const MintScheduler::TaskStats& stats = scheduler.getTaskStats(i);
+        printf("  %-8s %4u %9.1f %11.1f %7u %9u %10.3f %14.3f\n", stats.name,
+               stats.priority, stats.period_us / 1000.0, stats.deadline_us / 1000.0,
+               stats.runs, stats.overruns, stats.max_run_us / 1000.0,
+               stats.max_response_us / 1000.0);
+    }
+}
+
+static const MintScheduler::TaskStats* findTask(const MintScheduler& scheduler,
+                                                const char* name) {
+    for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+        if (strcmp(scheduler.getTaskStats(i).name, name) == 0) {
+            return &scheduler.getTaskStats(i);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Synthetic tasks: priority order within a pass, period releases and
+ * overrun attribution when a low priority step blocks.
+ */
+static void benchSynthetic() {
+    printf("Synthetic tasks\n");
+    MintHost::resetClock();
+
+    MintScheduler scheduler;
+    std::string order;
+    uint32_t slow_step_us = 0;
+
+    // Registered out of priority order on purpose
+    scheduler.addTask("low", 3, 10000, 10000, [&]() {
+        order += 'L';
+        MintHost::advance(slow_step_us);
+    });
+    scheduler.addTask("high", 0, 1000, 2000, [&]() { order += 'H'; });
+    scheduler.addTask("mid", 1, 5000, 5000, [&]() { order += 'M'; });
+
+    // Everything is released at once on the first pass
+    scheduler.run();
+    check(order == "HML", "first pass runs in priority order");
+
+    // One second of passes, sleeping as main.ino does
+    uint64_t end = MintHost::now() + 1000000;
+    while (MintHost::now() < end) {
+        delay((scheduler.getIdleTime() + 999) / 1000);
+        scheduler.run();
+    }
+    check(findTask(scheduler, "high")->runs >= 1000, "high released every period");
+    check(findTask(scheduler, "mid")->runs >= 200, "mid released every period");
+    check(findTask(scheduler, "low")->runs >= 100, "low released every period");
+    for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+        check(scheduler.getTaskStats(i).overruns == 0, "no overrun without load");
+    }
+    printStats(scheduler);
+
+    // A 30 ms step in the low task makes it and the tasks behind it late
+    scheduler.resetStats();
+    slow_step_us = 30000;
+    end = MintHost::now() + 100000;
+    while (MintHost::now() < end) {
+        delay((scheduler.getIdleTime() + 999) / 1000);
+        scheduler.run();
+    }
+    check(findTask(scheduler, "low")->overruns > 0, "blocking step overruns");
+    check(findTask(scheduler, "high")->overruns > 0, "blocked task reported late");
+    check(findTask(scheduler, "low")->max_run_us == 30000, "step time measured");
+
+    // Missed releases are dropped, not run back to back
+    check(findTask(scheduler, "high")->runs < 100, "missed releases dropped");
+    printf("  with a 30 ms blocking step:\n");
+    printStats(scheduler);
+}
+
+// Run the device loop exactly as main.ino does, delay() and all; unlike
+// runDevice() it may call loop() again without the clock moving
+static void runMainLoop(MintDevice& device, uint64_t until_us) {
+    while (MintHost::now() < until_us) {
+        device.loop();
+        delay(device.getIdleTime());
+    }
+}
+
+/**
+ * Full device: drop a file, generate a wallet, then break the circuit.
+ */
+static void benchDevice() {
+    printf("Device tasks\n");
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintDevice device;
+    check(device.begin(), "device boot");
+    check(device.getState() == MintDevice::MINT_STATE_READY_NO_WALLET, "boots without wallet");
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runMainLoop(device, MintHost::now() + 500);
+    });
+    check(host.mount(), "host mounts the volume");
+
+    runMainLoop(device, MintHost::now() + 500000);
+
+    uint8_t data[512];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 97 + 13);
+    }
+    check(host.writeFile("ENTROPY BIN", nullptr, data, sizeof(data)), "host write");
+
+    // Wallet generation: file handed over on the next storage run, then SE050 steps
+    uint64_t start = MintHost::now();
+    uint64_t generating_at = 0;
+    while (MintHost::now() - start < 5000000 &&
+           device.getState() != MintDevice::MINT_STATE_READY_WITH_WALLET) {
+        if (!generating_at && device.getState() == MintDevice::MINT_STATE_GENERATING_WALLET) {
+            generating_at = MintHost::now();
+        }
+        device.loop();
+        if (!generating_at && device.getState() == MintDevice::MINT_STATE_GENERATING_WALLET) {
+            generating_at = MintHost::now();
+        }
+        delay(device.getIdleTime());
+    }
+    check(device.getState() == MintDevice::MINT_STATE_READY_WITH_WALLET, "wallet generated");
+    check(generating_at != 0, "generation observed");
+    const double handover_ms = (generating_at - host.getLastWriteTime()) / 1000.0;
+    printf("  file handed over %.1f ms after the last host write\n", handover_ms);
+    check(handover_ms < 1000, "no quiet period before hand-over");
+    printf("  wallet ready %.1f ms after the hand-over\n",
+           (MintHost::now() - generating_at) / 1000.0);
+
+    // The host must see the sealed README
+    runMainLoop(device, MintHost::now() + 200000);
+    std::vector<uint8_t> readme;
+    check(host.readFile("README  TXT", readme) &&
+          readme.size() >= 26 && memcmp(readme.data(), "MINT DEVICE - SEALED STATE", 26) == 0,
+          "sealed README");
+
+    // Break the circuit
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+    runMainLoop(device, MintHost::now() + 500000);
+    check(device.getState() == MintDevice::MINT_STATE_TAMPERED, "tamper detected");
+    check(host.readFile("README  TXT", readme) &&
+          readme.size() >= 28 && memcmp(readme.data(), "MINT DEVICE - TAMPERED STATE", 28) == 0,
+          "tampered README");
+
+    // SE050 secret reads happen once per state change, not every pass
+    SE05xStats before = SE05x::lastInstance()->getStats();
+    runMainLoop(device, MintHost::now() + 2000000);
+    SE05xStats after = SE05x::lastInstance()->getStats();
+    check(after.commands == before.commands, "no SE050 traffic while idle");
+
+    const MintScheduler& scheduler = device.getScheduler();
+    printStats(scheduler);
+
+    // Storage hands the file over without touching the SE050
+    check(findTask(scheduler, "storage")->max_run_us < 1000, "storage step is short");
+    check(findTask(scheduler, "crypto")->overruns == 0, "crypto keeps its deadline");
+
+    // Nothing preempts a running SE050 command, but no task waits longer
+    // than one crypto step past its own deadline
+    const uint32_t crypto_step_us = findTask(scheduler, "crypto")->max_run_us;
+    for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+        const MintScheduler::TaskStats& stats = scheduler.getTaskStats(i);
+        check(stats.max_response_us <= stats.deadline_us + crypto_step_us,
+              "late by at most one crypto step");
+    }
+}
+
+int main() {
+    benchSynthetic();
+    benchDevice();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
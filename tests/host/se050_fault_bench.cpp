@@ -0,0 +1,400 @@
+/**
+ * Mint SE050 Fault Benchmark
+ *
+ * Runs MintSecure and the device against a simulated SE050 that NACKs,
+ * hangs or stops answering, and checks the call wrapper's policy: every
+ * call finishes within its deadline, transient faults are retried, an
+ * unreadable tamper record or master key is reported as unknown instead
+ * of intact or absent, and a dead bus opens the breaker, after which
+ * calls are refused without bus traffic until a probe gets through. The
+ * device parks in its degraded state meanwhile, with no task stalled by
+ * a hung bus, and comes back once the SE050 answers again. A key created
+ * by a command whose answer was lost is found and deleted by the next
+ * generation.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/se050_fault_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o se050_fault_bench
+ *     ./se050_fault_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_trace.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// OTP address of the tamper record (mint_secure.cpp)
+#define OTP_TAMPER_ADDRESS 0x7FFFF0
+
+// Seeds run on the flaky bus
+#define FLAKY_SEEDS 200
+
+// Longest a call may take: key creation's deadline (62 ms typical in
+// mint_secure.cpp, plus bus time at 100 kHz)
+#define CALL_LIMIT_US (MINT_SE050_DEADLINE_FACTOR * 66000)
+
+// Longest any device task may run while the bus hangs
+#define TASK_LIMIT_US 50000
+
+static SE05xFaults faultsWith(uint32_t nack_ppm, uint32_t timeout_ppm, uint32_t seed) {
+    SE05xFaults faults = SE05x::defaultConfig().faults;
+    faults.nack_rate_ppm = nack_ppm;
+    faults.timeout_rate_ppm = timeout_ppm;
+    faults.seed = seed;
+    return faults;
+}
+
+static void printCallStats(const char* label, const MintSecure::CallStats& stats) {
+    printf("  %-24s %5u calls  %4u retries  %4u timeouts  %3u failed  %3u refused  "
+           "%u trips  max %.1f ms\n", label, (unsigned)stats.calls, (unsigned)stats.retries,
+           (unsigned)stats.timeouts, (unsigned)stats.failures, (unsigned)stats.rejected,
+           (unsigned)stats.breaker_trips, stats.max_call_us / 1000.0);
+}
+
+/**
+ * Blank devices on a bus that NACKs 15% and hangs on 5% of commands:
+ * boot and generate a wallet, once per fault seed.
+ */
+static void benchFlakyBus() {
+    printf("Flaky bus (15%% NACK, 5%% hung), %u seeds\n", FLAKY_SEEDS);
+    uint32_t booted = 0, known = 0, generated = 0, max_call_us = 0;
+    MintSecure::CallStats total;
+    memset(&total, 0, sizeof(total));
+
+    for (uint32_t seed = 1; seed <= FLAKY_SEEDS; seed++) {
+        SE05xSimConfig config = SE05x::defaultConfig();
+        config.faults = faultsWith(150000, 50000, seed);
+        SE05x::setNextConfig(config);
+        MintHost::resetClock();
+        MintHost::setPin(CIRCUIT_PIN, LOW);
+
+        MintSecure secure;
+        if (!secure.begin()) {
+            continue;
+        }
+        booted++;
+        known += secure.getBootSnapshot().otp_read_ok;
+        uint8_t entropy[32];
+        for (size_t i = 0; i < sizeof(entropy); i++) {
+            entropy[i] = (uint8_t)(seed * 31 + i);
+        }
+        generated += secure.generateWalletFromEntropy(entropy, sizeof(entropy));
+
+        const MintSecure::CallStats& stats = secure.getCallStats();
+        total.calls += stats.calls;
+        total.retries += stats.retries;
+        total.timeouts += stats.timeouts;
+        total.failures += stats.failures;
+        total.rejected += stats.rejected;
+        total.breaker_trips += stats.breaker_trips;
+        max_call_us = std::max(max_call_us, stats.max_call_us);
+    }
+    total.max_call_us = max_call_us;
+
+    printCallStats("all seeds", total);
+    printf("  %-24s %u booted, %u with the tamper record read, %u wallets\n", "outcome",
+           (unsigned)booted, (unsigned)known, (unsigned)generated);
+    check(booted == FLAKY_SEEDS, "every device boots");
+    // Three attempts that each fail one time in five leave about 1% unread
+    check(known * 100 >= booted * 97, "tamper record read on at least 97% of boots");
+    check(generated * 100 >= booted * 90, "wallet generated on at least 90% of devices");
+    check(total.retries > 0 && total.timeouts > 0, "faults retried and timed out");
+    check(max_call_us <= CALL_LIMIT_US, "no call past its deadline");
+}
+
+/**
+ * Tamper record unreadable at boot: the state is unknown, not intact.
+ */
+static void benchUnreadRecord() {
+    printf("Tamper record unreadable at boot\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    for (int i = 0; i < MINT_SE050_MAX_ATTEMPTS; i++) {
+        (*config.script)[TRACE_SE050_READ_MEMORY].push_back({ false, {} });
+    }
+    config.store->otp[OTP_TAMPER_ADDRESS] = 0x00;
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintSecure secure;
+    check(secure.begin(), "boots");
+    check(!secure.getBootSnapshot().otp_read_ok && secure.isDegraded(), "tamper state unknown");
+    check(!secure.isTampered(), "not reported tampered without a read");
+    uint8_t entropy[32] = {0x42};
+    check(!secure.startWalletGeneration(entropy, sizeof(entropy)), "no wallet while unknown");
+    check((*config.script)[TRACE_SE050_READ_MEMORY].empty(), "read retried to the attempt limit");
+
+    // The script is spent: the next read sees the burned record
+    check(secure.probe() && secure.isTampered(), "probe reads the record as tampered");
+    printCallStats("calls", secure.getCallStats());
+}
+
+/**
+ * Sealed wallet whose key reads all fail at boot, and whose "no" from
+ * objectExists is not confirmed because the bus then drops the next
+ * command too: the key is unknown, not absent, so the SE050 stays
+ * degraded and no new wallet can replace it until a probe finds the key.
+ */
+static void benchUnknownKey() {
+    printf("Key presence unknown at boot\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    uint8_t entropy[32] = {0x42};
+    {
+        MintSecure secure;
+        check(secure.begin() && secure.generateWalletFromEntropy(entropy, sizeof(entropy)),
+              "wallet sealed");
+    }
+
+    for (int i = 0; i < MINT_SE050_MAX_ATTEMPTS; i++) {
+        (*config.script)[TRACE_SE050_PUBLIC_KEY].push_back({ false, {} });
+        (*config.script)[TRACE_SE050_OBJECT_EXISTS].push_back({ false, {} });
+        (*config.script)[TRACE_SE050_RANDOM].push_back({ false, {} });
+    }
+    SE05x::setNextConfig(config);
+    MintSecure secure;
+    check(secure.begin() && secure.isDegraded() && !secure.getBootSnapshot().key_read_ok,
+          "key presence unknown, degraded");
+    check(!secure.startWalletGeneration(entropy, sizeof(entropy)) &&
+          config.store->public_keys.size() == 1, "no new wallet over the unknown key");
+    check(secure.probe() && secure.hasWallet() && secure.getBootSnapshot().chain_code_valid,
+          "probe finds the wallet");
+    printCallStats("calls", secure.getCallStats());
+}
+
+/**
+ * A bus that stops answering opens the breaker; probes back off until
+ * it answers again.
+ */
+static void benchBreaker() {
+    printf("Breaker\n");
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintSecure secure;
+    SE05x* se = SE05x::lastInstance();
+    check(secure.begin(), "boots");
+
+    se->setFaults(faultsWith(1000000, 0, 1));
+    uint8_t digest[32];
+    for (int i = 0; i < MINT_SE050_BREAKER_THRESHOLD; i++) {
+        check(!secure.sha256((const uint8_t*)"abc", 3, digest), "dead bus fails");
+    }
+    check(secure.isDegraded() && secure.getCallStats().breaker_trips == 1, "breaker opens");
+
+    const uint32_t commands = se->getStats().commands;
+    check(!secure.sha256((const uint8_t*)"abc", 3, digest), "open breaker refuses");
+    check(se->getStats().commands == commands, "refused without bus traffic");
+
+    // First probe after the cooldown fails; the next waits twice as long
+    MintHost::advance(MINT_SE050_BREAKER_COOLDOWN_US);
+    check(!secure.probe() && se->getStats().commands == commands + 1, "one probe command");
+    MintHost::advance(MINT_SE050_BREAKER_COOLDOWN_US * 3 / 2);
+    check(!secure.probe() && se->getStats().commands == commands + 1, "probe backs off");
+
+    se->setFaults(faultsWith(0, 0, 1));
+    MintHost::advance(MINT_SE050_BREAKER_COOLDOWN_US);
+    check(secure.probe() && !secure.isDegraded(), "probe closes the breaker");
+    check(secure.sha256((const uint8_t*)"abc", 3, digest), "calls flow again");
+    printCallStats("calls", secure.getCallStats());
+}
+
+static uint32_t longestTask(const MintDevice& device, const char** name) {
+    const MintScheduler& scheduler = device.getScheduler();
+    uint32_t longest = 0;
+    for (size_t i = 0; i < scheduler.getTaskCount(); i++) {
+        const MintScheduler::TaskStats& stats = scheduler.getTaskStats(i);
+        if (stats.max_run_us >= longest) {
+            longest = stats.max_run_us;
+            *name = stats.name;
+        }
+    }
+    return longest;
+}
+
+/**
+ * Key creation whose answer is lost: the key is made but the job fails.
+ * The next generation deletes it and starts over, and a reboot finds
+ * the new key.
+ */
+static void benchLostCreate() {
+    printf("Key creation answer lost\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    (*config.script)[TRACE_SE050_CREATE_KEY].push_back({ false, {} });
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    uint8_t entropy[32] = {0x42};
+    {
+        MintSecure secure;
+        check(secure.begin(), "boots");
+        check(!secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "first generation fails");
+        check(config.store->public_keys.size() == 1 && secure.getBootSnapshot().master_key_present,
+              "key left behind is seen");
+        entropy[0] = 0x43;
+        check(secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "next generation seals");
+    }
+
+    SE05x::setNextConfig(config);
+    MintSecure rebooted;
+    check(rebooted.begin() && rebooted.hasWallet() &&
+          rebooted.getBootSnapshot().chain_code_valid, "reboot finds the new wallet");
+}
+
+/**
+ * Sealed device whose bus hangs: it degrades without stalling its loop,
+ * refuses files meanwhile, and comes back once the SE050 answers.
+ */
+static void benchDevice() {
+    printf("Device\n");
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    std::unique_ptr<MintDevice> device(new MintDevice());
+    SE05x* se = SE05x::lastInstance();
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(*device, MintHost::now() + 500);
+    });
+    check(device->begin() && host.mount(), "device boots");
+
+    std::vector<uint8_t> file(512);
+    for (size_t i = 0; i < file.size(); i++) {
+        file[i] = (uint8_t)(i * 167 + 13);
+    }
+    check(host.writeFile("ENTROPY BIN", nullptr, file.data(), file.size()), "entropy file written");
+    runDevice(*device, MintHost::now() + 10000000);
+    check(device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device seals");
+
+    // Every command hangs; the self-test's next pass finds out
+    se->setFaults(faultsWith(0, 1000000, 1));
+    device->resetTaskStats();
+    const uint64_t hung_at = MintHost::now();
+    runDevice(*device, hung_at + MINT_SELFTEST_CYCLE_US + 3000000);
+    check(device->getState() == MintDevice::MINT_STATE_DEGRADED, "device degraded");
+    check(!device->getSelfTest().hasFailed(), "transport faults are not self-test failures");
+    const char* name = "";
+    const uint32_t longest = longestTask(*device, &name);
+    printf("  %-24s %.1f ms (%s), %u hung commands\n", "longest task while hung",
+           longest / 1000.0, name, (unsigned)se->getStats().timeouts);
+    check(longest <= TASK_LIMIT_US, "no task stalled by the hung bus");
+
+    // A sealed device takes no challenges while degraded
+    std::vector<uint8_t> challenge(MINT_CHALLENGE_HEADER_SIZE + MINT_PROOF_CHALLENGE_SIZE, 0x5A);
+    memcpy(challenge.data(), MINT_CHALLENGE_MAGIC, MINT_CHALLENGE_HEADER_SIZE);
+    host.writeFile("CHALLNGEBIN", "challenge.bin", challenge.data(), challenge.size());
+    runDevice(*device, MintHost::now() + 1000000);
+    check(device->getState() == MintDevice::MINT_STATE_DEGRADED, "files refused while degraded");
+
+    se->setFaults(faultsWith(0, 0, 1));
+    runDevice(*device, MintHost::now() + MINT_SE050_BREAKER_MAX_COOLDOWN_US + 1000000);
+    check(device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device back in service");
+}
+
+/**
+ * Sealed device opened while the tamper record cannot be written: the
+ * crypto task burns it later, or finds it burned by a write whose answer
+ * was lost, and the README then shows the private key.
+ */
+static void benchLateBurn(bool lost_answer) {
+    printf("Tamper record burned late (%s)\n", lost_answer ? "answer lost" : "bus down");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    std::unique_ptr<MintDevice> device(new MintDevice());
+    SE05x* se = SE05x::lastInstance();
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(*device, MintHost::now() + 500);
+    });
+    check(device->begin() && host.mount(), "device boots");
+    std::vector<uint8_t> file(512);
+    for (size_t i = 0; i < file.size(); i++) {
+        file[i] = (uint8_t)(i * 167 + 13);
+    }
+    check(host.writeFile("ENTROPY BIN", nullptr, file.data(), file.size()), "entropy file written");
+    runDevice(*device, MintHost::now() + 10000000);
+    check(device->getState() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device seals");
+
+    if (lost_answer) {
+        // The first write burns the record, but every attempt reports failure
+        for (int i = 0; i < MINT_SE050_MAX_ATTEMPTS; i++) {
+            (*config.script)[TRACE_SE050_WRITE_OTP].push_back({ false, {} });
+        }
+        MintHost::setPin(CIRCUIT_PIN, HIGH);
+        runDevice(*device, MintHost::now() + 1000000);
+    } else {
+        se->setFaults(faultsWith(1000000, 0, 1));
+        MintHost::setPin(CIRCUIT_PIN, HIGH);
+        runDevice(*device, MintHost::now() + 1000000);
+        check(config.store->otp.count(OTP_TAMPER_ADDRESS) == 0, "record not burned while down");
+        se->setFaults(faultsWith(0, 0, 1));
+        runDevice(*device, MintHost::now() + MINT_SE050_BREAKER_MAX_COOLDOWN_US + 1000000);
+    }
+    check(device->getState() == MintDevice::MINT_STATE_TAMPERED &&
+          config.store->otp[OTP_TAMPER_ADDRESS] == 0x00, "record burned");
+
+    std::vector<uint8_t> readme;
+    const std::string wif = device->getPrivateKey().c_str();
+    check(host.readFile("README  TXT", readme) && wif.compare(0, 6, "Error:") != 0 &&
+          std::string(readme.begin(), readme.end()).find(wif) != std::string::npos,
+          "README shows the private key");
+}
+
+/**
+ * A device whose tamper record is burned stays tampered even with the
+ * circuit intact.
+ */
+static void benchBurnedRecord() {
+    printf("Burned record, intact circuit\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.store->otp[OTP_TAMPER_ADDRESS] = 0x00;
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    std::unique_ptr<MintDevice> device(new MintDevice());
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runDevice(*device, MintHost::now() + 500);
+    });
+    check(device->begin(), "device boots");
+    check(device->getState() == MintDevice::MINT_STATE_TAMPERED, "boots tampered");
+}
+
+int main() {
+    benchFlakyBus();
+    benchUnreadRecord();
+    benchUnknownKey();
+    benchBreaker();
+    benchLostCreate();
+    benchDevice();
+    benchLateBurn(true);
+    benchLateBurn(false);
+    benchBurnedRecord();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
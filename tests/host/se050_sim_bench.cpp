@@ -0,0 +1,186 @@
+/**
+ * Mint SE050 Simulation Benchmark
+ *
+ * Runs MintSecure against the simulated SE050 in virtual time and reports
+ * boot, wallet generation and tamper-path timing. Results are deterministic
+ * for a given latency profile and fault seed. Also checks that no key is
+ * made without its chain code, and that a chain code that does not read
+ * at boot leaves the wallet degraded rather than gone.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/se050_sim_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint_secure.cpp \
+ *         mint_bip32.cpp mint_secp256k1.cpp mint_hash.cpp mint_circuit.cpp \
+ *         mint_log.cpp -o se050_sim_bench
+ *     ./se050_sim_bench
+ *
+ * Exits non-zero if the simulated device misbehaves (e.g. OTP rewritten).
+ */
+#include <Arduino.h>
+#include <Wire.h>
+#include "SE05x.h"
+#include "mint_secure.h"
+#include "mint_circuit.h"
+#include "bench_host.h"
+
+static void report(const char* phase, uint64_t start_us, const SE05xStats& before,
+                   const SE05xStats& after) {
+    printf("  %-28s %9.3f ms  %3u cmds  %5u bus bytes  %u nacks  %u timeouts\n",
+           phase, (MintHost::now() - start_us) / 1000.0,
+           after.commands - before.commands,
+           after.bytes_on_bus - before.bytes_on_bus,
+           after.nacks - before.nacks,
+           after.timeouts - before.timeouts);
+}
+
+/**
+ * Blank device: boot, generate a wallet, reboot, derive the address.
+ */
+static void benchLifecycle(const char* title, const SE05xSimConfig& config) {
+    printf("%s\n", title);
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    {
+        MintSecure secure;
+        SE05x* se = SE05x::lastInstance();
+
+        SE05xStats before = se->getStats();
+        uint64_t start = MintHost::now();
+        bool booted = secure.begin();
+        report("first boot", start, before, se->getStats());
+        check(booted, "first boot");
+        if (!booted) {
+            return;
+        }
+        printf("  %-28s %u Hz\n", "negotiated bus clock", secure.getBusClock());
+
+        uint8_t entropy[32];
+        for (size_t i = 0; i < sizeof(entropy); i++) {
+            entropy[i] = (uint8_t)(i * 37 + 11);
+        }
+
+        before = se->getStats();
+        start = MintHost::now();
+        check(secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "wallet generation");
+        const SE05xStats after = se->getStats();
+        report("wallet generation", start, before, after);
+        check(secure.getTransportStats().apdu_count == after.commands - before.commands,
+              "job APDUs counted as issued");
+    }
+
+    MintSecure rebooted;
+    SE05x* se = SE05x::lastInstance();
+
+    SE05xStats before = se->getStats();
+    uint64_t start = MintHost::now();
+    check(rebooted.begin(), "provisioned boot");
+    report("provisioned boot", start, before, se->getStats());
+    check(rebooted.hasWallet(), "wallet survives reboot");
+
+    char address[64];
+    before = se->getStats();
+    start = MintHost::now();
+    check(rebooted.deriveAddress("m/84'/0'/0'/0/0", address, sizeof(address)), "address");
+    report("first address", start, before, se->getStats());
+    printf("  %-28s %u\n", "boot snapshot APDUs", rebooted.getBootSnapshot().apdu_count);
+}
+
+/**
+ * Provisioned device whose circuit breaks: burn OTP, reveal key, and
+ * confirm OTP cannot be burned twice.
+ */
+static void benchTamperPath(const SE05xSimConfig& config) {
+    printf("Tamper path\n");
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    MintSecure secure;
+    SE05x* se = SE05x::lastInstance();
+    check(secure.begin(), "boot before tamper");
+
+    uint8_t entropy[32] = {0x42};
+    check(secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "wallet before tamper");
+
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+
+    SE05xStats before = se->getStats();
+    uint64_t start = MintHost::now();
+    check(secure.recordPermanentTamperState(), "OTP burn");
+    report("record tamper (OTP burn)", start, before, se->getStats());
+
+    uint8_t key[32];
+    before = se->getStats();
+    start = MintHost::now();
+    check(secure.revealPrivateKey(key, sizeof(key)), "reveal key");
+    report("reveal private key", start, before, se->getStats());
+    memset(key, 0, sizeof(key));
+
+    uint8_t rewrite = 0xFF;
+    check(!se->writeOTPMemory(0x7FFFF0, &rewrite, 1), "OTP is write-once");
+
+    MintSecure rebooted;
+    check(rebooted.begin() && rebooted.isTampered(), "tamper state survives reboot");
+}
+
+/**
+ * The chain code is stored before the key is created, so a generation
+ * cut short there leaves no key. A sealed wallet whose chain code does
+ * not read at boot keeps its key: the SE050 stays degraded, refusing a
+ * new wallet, until a probe reads the chain code.
+ */
+static void benchChainCode() {
+    printf("Chain code\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+
+    uint8_t entropy[32] = {0x42};
+    {
+        for (int i = 0; i < MINT_SE050_MAX_ATTEMPTS; i++) {
+            (*config.script)[TRACE_SE050_WRITE_OBJECT].push_back({ false, {} });
+        }
+        MintSecure secure;
+        check(secure.begin() && !secure.generateWalletFromEntropy(entropy, sizeof(entropy)) &&
+              config.store->public_keys.empty(), "no key without its chain code");
+        check(secure.generateWalletFromEntropy(entropy, sizeof(entropy)), "wallet generated");
+    }
+
+    // The chain code is there but every read attempt fails
+    for (int i = 0; i < MINT_SE050_MAX_ATTEMPTS; i++) {
+        (*config.script)[TRACE_SE050_READ_OBJECT].push_back({ false, {} });
+    }
+    SE05x::setNextConfig(config);
+    MintSecure secure;
+    check(secure.begin() && secure.hasWallet() && secure.isDegraded(),
+          "unreadable chain code keeps the wallet, degraded");
+    check(!secure.startWalletGeneration(entropy, sizeof(entropy)) &&
+          config.store->public_keys.size() == 1, "no new wallet while degraded");
+    char address[64];
+    check(secure.probe() && secure.deriveAddress("m/84'/0'/0'/0/0", address, sizeof(address)),
+          "probe reads the chain code");
+}
+
+int main() {
+    SE05xSimConfig nominal = SE05x::defaultConfig();
+    benchLifecycle("Nominal (1 MHz capable bus)", nominal);
+
+    SE05xSimConfig slow_bus = SE05x::defaultConfig();
+    slow_bus.max_bus_clock_hz = 100000;
+    benchLifecycle("Weak pull-ups (100 kHz only)", slow_bus);
+
+    SE05xSimConfig flaky = SE05x::defaultConfig();
+    flaky.faults.nack_rate_ppm = 150000;
+    flaky.faults.timeout_rate_ppm = 50000;
+    benchLifecycle("Flaky bus (15% NACK, 5% timeout)", flaky);
+
+    benchTamperPath(SE05x::defaultConfig());
+    benchChainCode();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * Mint Self-Test Benchmark
+ *
+ * Runs the device's background self-test (mint_selftest.h) on the
+ * simulated board: a clean device passes every check with no tick longer
+ * than MINT_SELFTEST_TICK_BUDGET_US and no slice past its declared cost,
+ * and a sealed one also passes the public key re-read. Then breaks one
+ * thing at a time and checks the failure is caught and latched: a master
+ * public key changed in the SE050, an OTP tamper record that disagrees
+ * with the boot state, and a TRNG stuck at ones. A failed device shows
+ * the LED error state and does not seal a later entropy file. Dead MCU
+ * entropy sources are skipped rather than failed: the device still
+ * seals on the SE050 TRNG alone.
+ *
+ * Slice times are virtual: the SE050 checks are charged the simulated
+ * command latencies, the MCU checks nothing.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -I tests/host -I . tests/host/selftest_bench.cpp \
+ *         tests/host/SE05x.cpp tests/host/arduino_host.cpp mint.cpp mint_secure.cpp \
+ *         mint_storage.cpp mint_fat.cpp mint_wallet.cpp mint_circuit.cpp mint_led.cpp \
+ *         mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp mint_secp256k1.cpp \
+ *         mint_hash.cpp mint_entropy.cpp mint_estimator.cpp mint_log.cpp \
+ *         mint_selftest.cpp -o selftest_bench
+ *     ./selftest_bench
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include <Adafruit_NeoPixel.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "fat_host.h"
+#include "bench_host.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// OTP address of the tamper record (mint_secure.cpp)
+#define OTP_TAMPER_ADDRESS 0x7FFFF0
+
+// Color MintLED::setError shows
+#define LED_ERROR_COLOR 0x400000
+
+// Long enough for the first pass after boot
+#define FIRST_PASS_US 3000000ULL
+
+/**
+ * A bench device that can be sealed, with its self-test and LED in view.
+ */
+class SelfTestBench : public Bench {
+public:
+    using Bench::Bench;
+
+    // Write a 512-byte entropy file and give the device time to seal
+    void writeEntropy() {
+        std::vector<uint8_t> file(512);
+        uint32_t seed = 0x9E3779B9;
+        for (uint8_t& b : file) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            b = (uint8_t)seed;
+        }
+        check(host->writeFile("ENTROPY BIN", nullptr, file.data(), file.size()),
+              "entropy file written");
+        run(10000000);
+    }
+
+    const MintSelfTest& selfTest() const {
+        return device->getSelfTest();
+    }
+
+    const MintSelfTest::CheckStats& stats(MintSelfTest::Check which) const {
+        return device->getSelfTest().getCheckStats(which);
+    }
+
+    uint32_t ledColor() const {
+        return Adafruit_NeoPixel::lastInstance()->getShownColor();
+    }
+};
+
+static void printStats(const MintSelfTest& self_test) {
+    printf("  %-14s %6s %6s %6s %6s %7s %8s %8s\n", "check", "pass", "fail", "skip",
+           "slices", "max us", "budget", "overruns");
+    for (int i = 0; i < MintSelfTest::CHECK_COUNT; i++) {
+        const MintSelfTest::CheckStats& s = self_test.getCheckStats((MintSelfTest::Check)i);
+        printf("  %-14s %6u %6u %6u %6u %7u %8u %8u\n", s.name, (unsigned)s.passes,
+               (unsigned)s.failures, (unsigned)s.skips, (unsigned)s.slices,
+               (unsigned)s.max_slice_us, (unsigned)s.slice_budget_us, (unsigned)s.overruns);
+    }
+    printf("  %-14s %u us of %u\n", "longest tick", (unsigned)self_test.getMaxTickTime(),
+           (unsigned)MINT_SELFTEST_TICK_BUDGET_US);
+}
+
+static bool noOverruns(const MintSelfTest& self_test) {
+    for (int i = 0; i < MintSelfTest::CHECK_COUNT; i++) {
+        if (self_test.getCheckStats((MintSelfTest::Check)i).overruns) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void benchClean() {
+    printf("Clean device\n");
+    SelfTestBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+    bench.run(FIRST_PASS_US);
+
+    const MintSelfTest& self_test = bench.selfTest();
+    printStats(self_test);
+    check(self_test.getPasses() == 1 && !self_test.hasFailed(), "first pass clean");
+    check(bench.stats(MintSelfTest::CHECK_PUBLIC_KEY).skips == 1,
+          "public key skipped without a wallet");
+    check(bench.stats(MintSelfTest::CHECK_BASE_MULTIPLY).slices > 2,
+          "base multiplication split across slices");
+    check(self_test.getMaxTickTime() <= MINT_SELFTEST_TICK_BUDGET_US, "ticks within budget");
+    check(noOverruns(self_test), "slices within their declared cost");
+    check(bench.state() == MintDevice::MINT_STATE_READY_NO_WALLET, "device still ready");
+}
+
+static void benchSealed() {
+    printf("Sealed device\n");
+    SelfTestBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+    bench.writeEntropy();
+    check(bench.state() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device seals");
+
+    // The next pass re-reads the master public key (the first may have
+    // waited out the generation and read it already)
+    bench.run(MINT_SELFTEST_CYCLE_US + FIRST_PASS_US);
+    const MintSelfTest& self_test = bench.selfTest();
+    check(self_test.getPasses() == 2 && !self_test.hasFailed(), "second pass clean");
+    check(bench.stats(MintSelfTest::CHECK_PUBLIC_KEY).passes >= 1, "public key re-read matches");
+    check(self_test.getMaxTickTime() <= MINT_SELFTEST_TICK_BUDGET_US, "ticks within budget");
+    check(noOverruns(self_test), "slices within their declared cost");
+
+    // A key the SE050 now reports differently is caught on the pass after
+    std::map<uint32_t, std::vector<uint8_t> >& keys =
+        SE05x::lastInstance()->getStore().public_keys;
+    check(keys.size() == 1, "one key in the SE050");
+    if (keys.size() == 1) {
+        keys.begin()->second[10] ^= 0x01;
+    }
+    bench.run(MINT_SELFTEST_CYCLE_US + FIRST_PASS_US);
+    check(bench.stats(MintSelfTest::CHECK_PUBLIC_KEY).failures == 1, "changed public key caught");
+    check(self_test.hasFailed(), "failure latched");
+    check(bench.ledColor() == LED_ERROR_COLOR, "LED shows the error state");
+    printf("  %-14s %u passes, failed %u\n", "after change", (unsigned)self_test.getPasses(),
+           (unsigned)self_test.hasFailed());
+}
+
+static void benchTamperRecord() {
+    printf("Tamper record\n");
+    SelfTestBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+
+    // The record reads as tampered, but the device booted intact
+    SE05x::lastInstance()->getStore().otp[OTP_TAMPER_ADDRESS] = 0x00;
+    bench.run(FIRST_PASS_US);
+    check(bench.stats(MintSelfTest::CHECK_TAMPER_STATE).failures == 1,
+          "OTP disagreeing with the boot state caught");
+    check(bench.ledColor() == LED_ERROR_COLOR, "LED shows the error state");
+
+    bench.writeEntropy();
+    check(bench.state() == MintDevice::MINT_STATE_READY_NO_WALLET, "failed device does not seal");
+    check(bench.ledColor() == LED_ERROR_COLOR, "error state kept");
+}
+
+static void benchStuckTrng() {
+    printf("Stuck TRNG\n");
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    SelfTestBench bench(config);
+    check(bench.boot(), "device boots");
+
+    // Every random byte of the first pass reads 0xFF
+    for (int i = 0; i < 64; i++) {
+        (*config.script)[TRACE_SE050_RANDOM].push_back({ true, std::vector<uint8_t>(32, 0xFF) });
+    }
+    bench.run(FIRST_PASS_US);
+    check(bench.stats(MintSelfTest::CHECK_TRNG).failures == 1, "biased TRNG caught");
+    check(bench.stats(MintSelfTest::CHECK_SHA256).passes == 1, "other checks still ran");
+    check(bench.selfTest().hasFailed(), "failure latched");
+    check(bench.ledColor() == LED_ERROR_COLOR, "LED shows the error state");
+}
+
+static void benchDeadMcuEntropy() {
+    printf("MCU entropy sources stuck\n");
+    MintHost::setRoscNoise([](uint64_t) { return 1; });
+    MintHost::setAnalogNoise(ANALOG_NOISE_PIN, [](uint64_t) { return 0; });
+    MintHost::setAnalog(ANALOG_NOISE_PIN, 2048);
+    SelfTestBench bench(SE05x::defaultConfig());
+    check(bench.boot(), "device boots");
+
+    // Both sources are disabled by their health tests; the SE050 TRNG
+    // still makes the wallet
+    bench.run(MINT_SELFTEST_CYCLE_US + FIRST_PASS_US);
+    check(bench.stats(MintSelfTest::CHECK_MCU_ENTROPY).skips >= 1 &&
+          bench.stats(MintSelfTest::CHECK_MCU_ENTROPY).failures == 0, "dead sources skipped");
+    check(!bench.selfTest().hasFailed(), "not latched as a failure");
+    bench.writeEntropy();
+    check(bench.state() == MintDevice::MINT_STATE_READY_WITH_WALLET, "device still seals");
+
+    MintHost::setRoscNoise(nullptr);
+    MintHost::setAnalogNoise(ANALOG_NOISE_PIN, nullptr);
+    MintHost::setAnalog(ANALOG_NOISE_PIN, 0);
+}
+
+int main() {
+    benchClean();
+    benchSealed();
+    benchTamperRecord();
+    benchStuckTrng();
+    benchDeadMcuEntropy();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
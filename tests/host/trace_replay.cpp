@@ -0,0 +1,359 @@
+/**
+ * Mint I/O Trace Replayer
+ *
+ * Drives the real MintDevice::loop() from a recorded I/O trace in virtual
+ * time: USB sector writes and tamper pin levels are applied at their
+ * recorded timestamps, and recorded SE050 outcomes are replayed through the
+ * simulated secure element. The replay records its own state transitions
+ * and reports their timing against the source trace and, optionally, a
+ * stored baseline.
+ *
+ * Usage (from the repository root):
+ *     g++ -std=c++17 -O2 -DMINT_TRACE_ENABLED -I tests/host -I . \
+ *         tests/host/trace_replay.cpp tests/host/SE05x.cpp tests/host/arduino_host.cpp \
+ *         mint.cpp mint_secure.cpp mint_storage.cpp mint_fat.cpp mint_wallet.cpp \
+ *         mint_circuit.cpp mint_led.cpp mint_trace.cpp mint_scheduler.cpp mint_bip32.cpp \
+ *         mint_secp256k1.cpp mint_hash.cpp mint_entropy.cpp mint_estimator.cpp \
+ *         mint_log.cpp \
+ *         mint_selftest.cpp -o trace_replay
+ *     ./trace_replay --synthesize session.trace
+ *     ./trace_replay session.trace --write-baseline session.baseline
+ *     ./trace_replay session.trace --baseline session.baseline [--tolerance-ms 20]
+ *
+ * --synthesize records a built-in session (file drop, then circuit break)
+ * so a corpus can be seeded without hardware. Exits non-zero when a state
+ * transition is later than the baseline by more than the tolerance.
+ */
+#include <Arduino.h>
+#include <Adafruit_TinyUSB.h>
+#include "SE05x.h"
+#include "mint.h"
+#include "mint_trace.h"
+#include "fat_host.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Time run after the last trace event so pending work can settle
+#define SETTLE_MS 3000
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t event;
+    uint32_t arg;
+    std::vector<uint8_t> data;
+} TraceRecord;
+
+static const char* STATE_NAMES[] = {
+    "INITIALIZING", "READY_NO_WALLET", "GENERATING_WALLET", "READY_WITH_WALLET", "TAMPERED"
+};
+
+static bool readVarint(const std::vector<uint8_t>& in, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseTrace(const std::vector<uint8_t>& in, std::vector<TraceRecord>& out) {
+    if (in.size() < 5 || memcmp(in.data(), "MTRC", 4) != 0 || in[4] != MINT_TRACE_VERSION) {
+        return false;
+    }
+
+    size_t pos = 5;
+    uint64_t now = 0;
+    while (pos < in.size()) {
+        TraceRecord record;
+        uint32_t delta, length;
+        record.event = in[pos++];
+        if (!readVarint(in, pos, delta) || !readVarint(in, pos, record.arg) ||
+            !readVarint(in, pos, length) || pos + length > in.size()) {
+            return false;
+        }
+        now += delta;
+        record.time_us = now;
+        record.data.assign(in.begin() + pos, in.begin() + pos + length);
+        pos += length;
+        out.push_back(record);
+    }
+    return true;
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        out.insert(out.end(), chunk, chunk + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeFile(const char* path, const uint8_t* data, size_t length) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, length, f) == length;
+    fclose(f);
+    return ok;
+}
+
+// Run the device loop the way main.ino does until virtual time reaches until_us
+static void runUntil(MintDevice& device, uint64_t until_us) {
+    while (MintHost::now() < until_us) {
+        device.loop();
+
+        // Stop at the recorded time, so inputs land when they did
+        uint64_t idle_us = (uint64_t)device.getIdleTime() * 1000;
+        MintHost::advance(min(idle_us, until_us - MintHost::now()));
+    }
+}
+
+static std::vector<TraceRecord> stateRecords(const std::vector<TraceRecord>& records) {
+    std::vector<TraceRecord> states;
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].event == TRACE_EVENT_STATE) {
+            states.push_back(records[i]);
+        }
+    }
+    return states;
+}
+
+static std::vector<TraceRecord> currentTrace() {
+    std::vector<uint8_t> raw(MintTrace::data(), MintTrace::data() + MintTrace::size());
+    std::vector<TraceRecord> records;
+    parseTrace(raw, records);
+    return records;
+}
+
+/**
+ * Record a canned session: boot a blank device, drop a file, then break
+ * the circuit with contact bounce.
+ */
+static int synthesize(const char* path) {
+    SE05x::setNextConfig(SE05x::defaultConfig());
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, LOW);
+    MintTrace::clear();
+
+    MintDevice device;
+    if (!device.begin()) {
+        fprintf(stderr, "device failed to boot\n");
+        return 1;
+    }
+
+    HostFat host(Adafruit_USBD_MSC::lastInstance(), [&device]() {
+        runUntil(device, MintHost::now() + 2000);
+    });
+
+    // Host mounts, then writes the file data, FAT and directory entry
+    runUntil(device, 2000000);
+    std::vector<uint8_t> data(512);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)(i * 131 + 7);
+    }
+    if (!host.mount() || !host.writeFile("ENTROPY BIN", nullptr, data.data(), data.size())) {
+        fprintf(stderr, "host write failed\n");
+        return 1;
+    }
+
+    // Break the circuit, bouncing for a few milliseconds
+    runUntil(device, 8000000);
+    for (int i = 0; i < 4; i++) {
+        MintHost::setPin(CIRCUIT_PIN, i % 2 ? LOW : HIGH);
+        device.loop();
+        delay(1);
+    }
+    MintHost::setPin(CIRCUIT_PIN, HIGH);
+    runUntil(device, 10000000);
+
+    if (!writeFile(path, MintTrace::data(), MintTrace::size())) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    printf("wrote %s: %zu bytes, %u records dropped\n", path, MintTrace::size(),
+           MintTrace::dropped());
+    return 0;
+}
+
+static bool loadBaseline(const char* path, std::vector<std::pair<uint32_t, uint64_t> >& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned state;
+        unsigned long long time_us;
+        if (sscanf(line, "state %u %llu", &state, &time_us) == 2) {
+            out.push_back(std::make_pair((uint32_t)state, (uint64_t)time_us));
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static int replay(const char* trace_path, const char* baseline_path,
+                  const char* write_baseline_path, uint32_t tolerance_ms) {
+    std::vector<uint8_t> raw;
+    std::vector<TraceRecord> records;
+    if (!readFile(trace_path, raw) || !parseTrace(raw, records)) {
+        fprintf(stderr, "cannot read trace %s\n", trace_path);
+        return 2;
+    }
+
+    // Recorded SE050 outcomes are replayed per operation, in order
+    SE05xSimConfig config = SE05x::defaultConfig();
+    config.script = std::make_shared<SE05xScript>();
+    int initial_level = LOW;
+    bool initial_level_known = false;
+    uint64_t end_us = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        const TraceRecord& r = records[i];
+        if (r.event == TRACE_EVENT_SE050) {
+            SE05xScriptedResult result;
+            result.ok = (r.arg & 1) != 0;
+            result.data = r.data;
+            (*config.script)[(uint8_t)(r.arg >> 1)].push_back(result);
+        } else if (r.event == TRACE_EVENT_CIRCUIT && !initial_level_known) {
+            initial_level = (int)r.arg;
+            initial_level_known = true;
+        }
+        end_us = r.time_us;
+    }
+
+    SE05x::setNextConfig(config);
+    MintHost::resetClock();
+    MintHost::setPin(CIRCUIT_PIN, initial_level);
+    MintTrace::clear();
+
+    MintDevice device;
+    device.begin();
+    Adafruit_USBD_MSC* msc = Adafruit_USBD_MSC::lastInstance();
+
+    // Apply host-side inputs at their recorded times; SE050 outcomes were
+    // scripted above and the initial pin level was applied before boot
+    bool skipped_initial_level = false;
+    for (size_t i = 0; i < records.size(); i++) {
+        const TraceRecord& r = records[i];
+        if (r.event == TRACE_EVENT_USB_WRITE) {
+            runUntil(device, r.time_us);
+            std::vector<uint8_t> sector = r.data;
+            msc->hostWrite(r.arg, sector.data(), (uint32_t)sector.size());
+        } else if (r.event == TRACE_EVENT_CIRCUIT) {
+            if (!skipped_initial_level) {
+                skipped_initial_level = true;
+                continue;
+            }
+            runUntil(device, r.time_us);
+            MintHost::setPin(CIRCUIT_PIN, (int)r.arg);
+        }
+    }
+    runUntil(device, end_us + (uint64_t)SETTLE_MS * 1000);
+
+    std::vector<TraceRecord> recorded = stateRecords(records);
+    std::vector<TraceRecord> replayed = stateRecords(currentTrace());
+    std::vector<std::pair<uint32_t, uint64_t> > baseline;
+    bool have_baseline = baseline_path && loadBaseline(baseline_path, baseline);
+    if (baseline_path && !have_baseline) {
+        fprintf(stderr, "cannot read baseline %s\n", baseline_path);
+        return 2;
+    }
+
+    int regressions = 0;
+    printf("%-20s %12s %12s %12s %10s\n", "state", "recorded ms", "replay ms",
+           "baseline ms", "delta ms");
+    for (size_t i = 0; i < replayed.size(); i++) {
+        const uint32_t state = replayed[i].arg;
+        const double replay_ms = replayed[i].time_us / 1000.0;
+        const char* name = state < sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0]) ?
+                           STATE_NAMES[state] : "?";
+
+        char recorded_col[16] = "-";
+        if (i < recorded.size() && recorded[i].arg == state) {
+            snprintf(recorded_col, sizeof(recorded_col), "%.3f", recorded[i].time_us / 1000.0);
+        }
+
+        char baseline_col[16] = "-";
+        char delta_col[16] = "-";
+        if (have_baseline && i < baseline.size() && baseline[i].first == state) {
+            double delta_ms = replay_ms - baseline[i].second / 1000.0;
+            snprintf(baseline_col, sizeof(baseline_col), "%.3f", baseline[i].second / 1000.0);
+            snprintf(delta_col, sizeof(delta_col), "%+.3f", delta_ms);
+            if (delta_ms > tolerance_ms) {
+                regressions++;
+            }
+        } else if (have_baseline) {
+            regressions++;
+        }
+
+        printf("%-20s %12s %12.3f %12s %10s\n", name, recorded_col, replay_ms,
+               baseline_col, delta_col);
+    }
+    if (have_baseline && baseline.size() != replayed.size()) {
+        printf("state sequence differs from baseline (%zu vs %zu transitions)\n",
+               replayed.size(), baseline.size());
+        regressions++;
+    }
+
+    if (write_baseline_path) {
+        FILE* f = fopen(write_baseline_path, "w");
+        if (!f) {
+            fprintf(stderr, "cannot write baseline %s\n", write_baseline_path);
+            return 2;
+        }
+        fprintf(f, "# mint trace baseline: state <id> <virtual time us>\n");
+        for (size_t i = 0; i < replayed.size(); i++) {
+            fprintf(f, "state %u %llu\n", replayed[i].arg,
+                    (unsigned long long)replayed[i].time_us);
+        }
+        fclose(f);
+    }
+
+    if (regressions) {
+        printf("FAILED: %d timing regression(s) beyond %u ms\n", regressions, tolerance_ms);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* trace_path = nullptr;
+    const char* baseline_path = nullptr;
+    const char* write_baseline_path = nullptr;
+    uint32_t tolerance_ms = 20;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--synthesize" && i + 1 < argc) {
+            return synthesize(argv[++i]);
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (arg == "--write-baseline" && i + 1 < argc) {
+            write_baseline_path = argv[++i];
+        } else if (arg == "--tolerance-ms" && i + 1 < argc) {
+            tolerance_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            trace_path = argv[i];
+        }
+    }
+
+    if (!trace_path) {
+        fprintf(stderr, "usage: %s <trace> [--baseline file] [--write-baseline file] "
+                        "[--tolerance-ms n] | --synthesize <trace>\n", argv[0]);
+        return 2;
+    }
+    return replay(trace_path, baseline_path, write_baseline_path, tolerance_ms);
+}
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Mint Event Log Decoder
+
+Turns the tokenized event log (mint_log.h) back into text. The token
+table is built from the MINT_LOG format strings in the sources, so it
+follows the code; build it from the same tree as the firmware.
+
+Usage:
+    python3 tests/log_decode.py --port [PORT] [--follow] [--save log.bin]
+    python3 tests/log_decode.py log.bin
+    python3 tests/log_decode.py --write-table tokens.json
+    python3 tests/log_decode.py log.bin --table tokens.json
+
+--port asks the device for a drain ('L'); --follow keeps draining every
+second. A capture holds one or more drains back to back, as the device
+sent them; --save appends each drain to one. --table decodes with a
+table written earlier by --write-table instead of scanning the sources,
+for logs from a firmware the tree has moved on from.
+
+Exits non-zero on a token the table does not have or a malformed drain.
+
+Requirements:
+    - pyserial (for --port)
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+import time
+
+SOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+MAGIC = b'MLOG'
+VERSION = 1
+
+# Longest wait for the rest of a drain
+DRAIN_TIMEOUT_S = 2
+
+CALL = re.compile(r'\bMINT_LOG\(\s*"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r'%([%dusx])')
+
+
+def token(format):
+    """FNV-1a over the format's bytes, as MintLog::token computes it."""
+    hash = 2166136261
+    for byte in format.encode('utf-8'):
+        hash = ((hash ^ byte) * 16777619) & 0xFFFFFFFF
+    return hash
+
+
+def unescape(literal):
+    return literal.encode('latin-1').decode('unicode_escape')
+
+
+def scan_sources():
+    """{token: format} for every MINT_LOG call site in the sources."""
+    table = {}
+    for file in sorted(os.listdir(SOURCE_DIR)):
+        if not file.endswith(('.cpp', '.h', '.ino')) or file == 'mint_log.h':
+            continue
+        with open(os.path.join(SOURCE_DIR, file)) as f:
+            text = f.read()
+        for match in CALL.finditer(text):
+            format = unescape(match.group(1))
+            key = token(format)
+            if key in table and table[key] != format:
+                sys.exit(f'token collision: "{table[key]}" and "{format}"; reword one')
+            table[key] = format
+    return table
+
+
+def read_varint(data, offset):
+    value, shift = 0, 0
+    while True:
+        if offset >= len(data):
+            raise ValueError('varint runs past the end')
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value & 0xFFFFFFFF, offset
+
+
+def render(format, args):
+    """Format a record's arguments; returns the text."""
+    data, offset = args, 0
+    out = []
+    last = 0
+    for match in CONVERSION.finditer(format):
+        out.append(format[last:match.start()])
+        last = match.end()
+        kind = match.group(1)
+        if kind == '%':
+            out.append('%')
+        elif kind == 's':
+            length = data[offset]
+            out.append(data[offset + 1:offset + 1 + length].decode('utf-8', errors='replace'))
+            offset += 1 + length
+        else:
+            value, offset = read_varint(data, offset)
+            if kind == 'd':
+                value = (value >> 1) ^ -(value & 1)
+            out.append(f'0x{value:x}' if kind == 'x' else str(value))
+    out.append(format[last:])
+    if offset != len(data):
+        raise ValueError('argument bytes left over')
+    return ''.join(out)
+
+
+def decode(data, table):
+    """Yield (time_us, text) for every record; raises ValueError on bad input."""
+    offset = 0
+    while offset < len(data):
+        if data[offset:offset + 4] != MAGIC:
+            raise ValueError(f'no drain header at byte {offset}')
+        version = data[offset + 4]
+        if version != VERSION:
+            raise ValueError(f'log version {version}, this decoder reads {VERSION}')
+        dropped, offset = read_varint(data, offset + 5)
+        now, offset = read_varint(data, offset)
+        if dropped:
+            yield None, f'<{dropped} record(s) dropped, ring full>'
+        while True:
+            if offset >= len(data):
+                raise ValueError('drain ends without its zero byte')
+            length = data[offset]
+            offset += 1
+            if not length:
+                break
+            record = data[offset:offset + length]
+            offset += length
+            if len(record) != length or length < 5:
+                raise ValueError('truncated record')
+            key = int.from_bytes(record[:4], 'little')
+            delta, start = read_varint(record, 4)
+            now += delta
+            if key not in table:
+                raise ValueError(f'unknown token 0x{key:08x}; is the table from this firmware?')
+            yield now, render(table[key], record[start:])
+
+
+def print_records(data, table):
+    for time_us, text in decode(data, table):
+        stamp = ' ' * 14 if time_us is None else f'[{time_us / 1e6:12.6f}]'
+        print(f'{stamp} {text}')
+
+
+def read_drain(ser):
+    """Ask for one drain and return its bytes."""
+    ser.reset_input_buffer()
+    ser.write(b'L')
+    deadline = time.monotonic() + DRAIN_TIMEOUT_S
+
+    def take(count):
+        data = b''
+        while len(data) < count:
+            if time.monotonic() > deadline:
+                raise ValueError('device stopped sending mid-drain')
+            data += ser.read(count - len(data))
+        return data
+
+    def take_varint():
+        data = b''
+        while True:
+            byte = take(1)
+            data += byte
+            if not byte[0] & 0x80:
+                return data
+
+    drain = take(5)
+    drain += take_varint() + take_varint()
+    while True:
+        length = take(1)
+        drain += length
+        if not length[0]:
+            return drain
+        drain += take(length[0])
+
+
+def run_port(args, table):
+    import serial
+    try:
+        ser = serial.Serial(args.port, 115200, timeout=DRAIN_TIMEOUT_S)
+    except Exception as e:
+        print(f'Failed to connect to device: {e}')
+        sys.exit(1)
+    try:
+        while True:
+            drain = read_drain(ser)
+            if args.save:
+                with open(args.save, 'ab') as f:
+                    f.write(drain)
+            print_records(drain, table)
+            if not args.follow:
+                break
+            time.sleep(1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ser.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the Mint event log')
+    parser.add_argument('capture', nargs='?', help='Captured drains to decode')
+    parser.add_argument('--port', type=str, help='Serial port for device')
+    parser.add_argument('--follow', action='store_true', help='Keep draining the device')
+    parser.add_argument('--save', type=str, help='Append the raw drains to a file')
+    parser.add_argument('--table', type=str, help='Token table from --write-table')
+    parser.add_argument('--write-table', type=str, help='Write the token table as JSON')
+    args = parser.parse_args()
+
+    if args.table:
+        with open(args.table) as f:
+            table = {int(key, 16): format for key, format in json.load(f).items()}
+    else:
+        table = scan_sources()
+
+    if args.write_table:
+        with open(args.write_table, 'w') as f:
+            json.dump({f'{key:08x}': table[key] for key in sorted(table)}, f, indent=2)
+        print(f'{len(table)} formats written to {args.write_table}')
+    try:
+        if args.port:
+            run_port(args, table)
+        elif args.capture:
+            with open(args.capture, 'rb') as f:
+                print_records(f.read(), table)
+        elif not args.write_table:
+            parser.error('a capture, --port or --write-table is required')
+    except ValueError as e:
+        print(f'FAILED: {e}')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+Mint Memory Placement Report
+
+Lists where the linker put the buffers and stacks that matter for SRAM
+bank contention (see mint_memory.h) in a built firmware image, and the
+bytes of data each RP2040 memory region holds.
+
+Usage:
+    python3 tests/placement_report.py build/main.ino.elf [--nm arm-none-eabi-nm] [--check]
+    python3 tests/placement_report.py build/main.ino.elf --hot-paths [--check] \
+        [--output build/hot_paths.txt]
+
+The ELF is in the sketch's build directory (arduino-cli compile
+--build-path build ...). --check exits non-zero unless the buffers
+MINT_SRAM_PLACEMENT pins are in their banks; use it on placement builds.
+
+--hot-paths reports the functions and tables marked MINT_RAM_FUNC or
+MINT_RAM_DATA in the sources instead: the list is generated from the
+markers, so it follows the code. On a MINT_RAM_HOT_PATHS build each one
+should be in SRAM; --check fails if one was left in flash. Marked
+functions the compiler inlined everywhere have no symbol of their own.
+
+Requirements:
+    - arm-none-eabi-nm (ships with the RP2040 core's toolchain)
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# RP2040 address map: (name, start, end)
+REGIONS = [
+    ('flash (XIP)', 0x10000000, 0x11000000),
+    ('SRAM0-3 striped', 0x20000000, 0x20040000),
+    ('SRAM4 (scratch X)', 0x20040000, 0x20041000),
+    ('SRAM5 (scratch Y)', 0x20041000, 0x20042000),
+    ('SRAM0-3 non-striped', 0x21000000, 0x21040000),
+    ('USB DPRAM', 0x50100000, 0x50101000),
+]
+
+# Symbols reported by name, and the bank MINT_SRAM_PLACEMENT pins them to
+WATCHED = [
+    ('rosc_ring', 'SRAM4 (scratch X)'),
+    ('adc_ring', 'SRAM5 (scratch Y)'),
+    ('circuit_ring', None),
+    ('mint', None),
+    ('__StackBottom', None),
+    ('__StackLimit', None),
+    ('__StackTop', None),
+    ('__StackOneBottom', None),
+    ('__StackOneTop', None),
+]
+
+DATA_TYPES = 'bBdDrRgGsS'
+
+# Regions a relocated hot path may be in
+SRAM_REGIONS = ('SRAM0-3 striped', 'SRAM4 (scratch X)', 'SRAM5 (scratch Y)',
+                'SRAM0-3 non-striped')
+
+SOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+MARKER = re.compile(r'MINT_RAM_(FUNC|DATA)\((\w+)\)')
+FUNC_NAME = re.compile(r'([\w:<>, ]+?)\s*\(')
+DATA_NAME = re.compile(r'(\w+)\s*(\[[^\]]*\])?\s*=')
+
+
+def region_of(address):
+    for name, start, end in REGIONS:
+        if start <= address < end:
+            return name
+    return 'other'
+
+
+def read_symbols(nm, elf):
+    output = subprocess.run([nm, '-S', '-C', '--defined-only', elf], check=True,
+                            capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) == 4:
+            address, size, kind, name = parts
+            symbols.append((int(address, 16), int(size, 16), kind, name))
+        elif len(parts) == 3:
+            address, kind, name = parts
+            symbols.append((int(address, 16), 0, kind, name))
+    return symbols
+
+
+def plain_name(name):
+    """Drop template arguments, parameters and qualifiers: A<B>::f(int) const::x -> A::f::x."""
+    previous = None
+    while previous != name:
+        previous = name
+        name = re.sub(r'<[^<>]*>', '', name)
+        name = re.sub(r'\([^()]*\)', '', name)
+    return re.sub(r'\bconst\b', '', name).replace(' ', '')
+
+
+def find_markers():
+    """(kind, label, name, file) for every MINT_RAM_FUNC/MINT_RAM_DATA in the sources."""
+    markers = []
+    for file in sorted(os.listdir(SOURCE_DIR)):
+        if not file.endswith(('.cpp', '.h')) or file == 'mint_memory.h':
+            continue
+        with open(os.path.join(SOURCE_DIR, file)) as f:
+            lines = f.read().splitlines()
+        for i, line in enumerate(lines):
+            match = MARKER.search(line)
+            if not match or i + 1 >= len(lines):
+                continue
+            kind, label = match.groups()
+            declaration = lines[i + 1].split('{')[0]
+            found = (FUNC_NAME if kind == 'FUNC' else DATA_NAME).search(declaration)
+            if found:
+                # One entry per function, whichever storage backend it is in
+                name = plain_name(found.group(1).split()[-1])
+                if not any(name == marked[2] for marked in markers):
+                    markers.append((kind, label, name, file))
+    return markers
+
+
+def hot_path_report(symbols, check):
+    """Report lines for the marked hot paths, and how many were left in flash."""
+    by_plain = {}
+    for address, size, kind, name in symbols:
+        by_plain.setdefault(plain_name(name), []).append((address, size, kind, name))
+
+    lines = [f"{'kind':<5} {'marker':<26} {'address':>10} {'size':>6}  region"]
+    misplaced = 0
+    totals = {'FUNC': 0, 'DATA': 0}
+    for kind, label, name, file in find_markers():
+        matches = [entry for key, entries in by_plain.items()
+                   if key == name or key.endswith('::' + name) for entry in entries]
+        if not matches:
+            lines.append(f"{kind:<5} {label:<26} {'-':>10} {'-':>6}  not in image ({file})")
+            continue
+        for address, size, _, _ in matches:
+            region = region_of(address)
+            note = ''
+            if region in SRAM_REGIONS:
+                totals[kind] += size
+            elif check:
+                note = '  expected SRAM'
+                misplaced += 1
+            lines.append(f'{kind:<5} {label:<26} 0x{address:08x} {size:>6}  {region}{note}')
+    lines.append('')
+    lines.append(f"relocated: {totals['FUNC']} bytes of code, {totals['DATA']} bytes of tables")
+    return lines, misplaced
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Report Mint memory placement')
+    parser.add_argument('elf', help='Firmware ELF')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm for the target')
+    parser.add_argument('--check', action='store_true',
+                        help='Fail unless pinned buffers (or hot paths) are in place')
+    parser.add_argument('--hot-paths', action='store_true',
+                        help='Report MINT_RAM_FUNC/MINT_RAM_DATA placement')
+    parser.add_argument('--output', type=str, help='Also write the report to a file')
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.nm, args.elf)
+    if args.hot_paths:
+        lines, misplaced = hot_path_report(symbols, args.check)
+        print('\n'.join(lines))
+        if args.output:
+            with open(args.output, 'w') as f:
+                f.write('\n'.join(lines) + '\n')
+        if misplaced:
+            print(f'FAILED: {misplaced} hot path(s) left in flash')
+            sys.exit(1)
+        return
+
+    by_name = {}
+    for symbol in symbols:
+        by_name.setdefault(symbol[3], symbol)
+
+    misplaced = 0
+    print(f"{'symbol':<24} {'address':>10} {'size':>7}  region")
+    for name, pinned in WATCHED:
+        if name not in by_name:
+            continue
+        address, size, _, _ = by_name[name]
+        region = region_of(address)
+        note = ''
+        if args.check and pinned and region != pinned:
+            note = f'  expected {pinned}'
+            misplaced += 1
+        print(f'{name:<24} 0x{address:08x} {size:>7}  {region}{note}')
+
+    totals = {}
+    for address, size, kind, _ in symbols:
+        if kind in DATA_TYPES:
+            region = region_of(address)
+            totals[region] = totals.get(region, 0) + size
+    print()
+    print(f"{'region':<24} {'data bytes':>10}")
+    for name, _, _ in REGIONS + [('other', 0, 0)]:
+        if name in totals:
+            print(f'{name:<24} {totals[name]:>10}')
+
+    if misplaced:
+        print(f'FAILED: {misplaced} buffer(s) outside their bank')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
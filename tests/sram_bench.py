@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+Mint SRAM Placement Benchmark
+
+Measures what memory placement (mint_memory.h) changes on a device:
+raw MSC read throughput from the host, the scheduler's worst-case task
+response times while the host reads, which is the loop jitter the MSC
+callbacks and DMA rings cause, and the MSC callbacks' own worst-case
+time with the XIP cache flushed before each call. Run it once on a
+normal build and once on a MINT_SRAM_PLACEMENT or MINT_RAM_HOT_PATHS
+build, all with DEBUG_ENABLED, then compare the two results.
+
+Usage:
+    python3 tests/sram_bench.py --port [PORT] --disk /dev/sdX --output before.json
+    python3 tests/sram_bench.py --port [PORT] --disk /dev/sdX --output after.json
+    python3 tests/sram_bench.py --compare before.json after.json
+
+The disk is read with O_DIRECT so every read reaches the device. Reading
+a raw block device usually needs root.
+
+Requirements:
+    - pyserial
+"""
+
+import argparse
+import json
+import mmap
+import os
+import sys
+import time
+
+import serial
+
+# Bytes per read: one USB MSC transfer's worth of sectors
+READ_SIZE = 4096
+
+# Default RP2040 core clock in the Arduino core, for cycles to microseconds
+DEFAULT_CPU_MHZ = 133
+
+
+def read_task_stats(ser):
+    """Ask for the task counters since the last request; returns {name: stats}."""
+    ser.reset_input_buffer()
+    ser.write(b'S')
+    stats = {}
+    while True:
+        line = ser.readline().decode('utf-8', errors='replace').strip()
+        if not line or line == 'end':
+            break
+        parts = line.split()
+        if len(parts) == 6 and parts[0] == 'task':
+            stats[parts[1]] = {
+                'runs': int(parts[2]),
+                'overruns': int(parts[3]),
+                'max_run_us': int(parts[4]),
+                'max_response_us': int(parts[5]),
+            }
+    return stats
+
+
+def read_callback_latency(ser):
+    """Time the MSC callbacks with a cold XIP cache; returns cycle counts or None."""
+    ser.reset_input_buffer()
+    ser.write(b'X')
+    latency = None
+    while True:
+        line = ser.readline().decode('utf-8', errors='replace').strip()
+        if not line or line == 'end':
+            break
+        parts = line.split()
+        if len(parts) == 6 and parts[0] == 'callbacks':
+            rounds, read_max, read_mean, write_max, write_mean = map(int, parts[1:])
+            latency = {
+                'rounds': rounds,
+                'read_max_cycles': read_max,
+                'read_mean_cycles': read_mean,
+                'write_max_cycles': write_max,
+                'write_mean_cycles': write_mean,
+            }
+    return latency
+
+
+def print_callbacks(latency, cpu_mhz):
+    for name in ('read', 'write'):
+        worst = latency[f'{name}_max_cycles']
+        mean = latency[f'{name}_mean_cycles']
+        print(f"  {'msc_' + name + '_cb':<13} worst {worst:>7} cycles ({worst / cpu_mhz:7.2f} us)  "
+              f"mean {mean:>7} cycles")
+
+
+def measure_throughput(disk, seconds):
+    """Read the disk from the start, wrapping at its end; returns bytes/s."""
+    fd = os.open(disk, os.O_RDONLY | getattr(os, 'O_DIRECT', 0))
+    try:
+        size = os.lseek(fd, 0, os.SEEK_END)
+        buffer = mmap.mmap(-1, READ_SIZE)  # Page aligned, as O_DIRECT needs
+        total = 0
+        offset = 0
+        start = time.monotonic()
+        while time.monotonic() - start < seconds:
+            count = os.preadv(fd, [buffer], offset)
+            if count <= 0:
+                offset = 0
+                continue
+            total += count
+            offset = (offset + count) % max(size - size % READ_SIZE, READ_SIZE)
+        return total / (time.monotonic() - start)
+    finally:
+        os.close(fd)
+
+
+def run(args):
+    try:
+        ser = serial.Serial(args.port, 115200, timeout=2)
+        print(f"Connected to device on {args.port}")
+    except Exception as e:
+        print(f"Failed to connect to device: {e}")
+        sys.exit(1)
+
+    # Start the timing window with the host reading
+    read_task_stats(ser)
+    throughput = measure_throughput(args.disk, args.seconds)
+    tasks = read_task_stats(ser)
+    callbacks = read_callback_latency(ser)
+    ser.close()
+    if not tasks:
+        print("No task counters; was the firmware built with DEBUG_ENABLED?")
+        sys.exit(1)
+
+    result = {'msc_read_bytes_per_s': throughput, 'tasks': tasks, 'cpu_mhz': args.cpu_mhz}
+    if callbacks:
+        result['callbacks'] = callbacks
+    print(f"MSC read: {throughput / 1024:.1f} KB/s")
+    for name, stats in tasks.items():
+        print(f"  {name:<10} max response {stats['max_response_us']:>7} us  "
+              f"max run {stats['max_run_us']:>7} us  overruns {stats['overruns']}")
+    if callbacks:
+        print(f"MSC callbacks, cold XIP cache, {callbacks['rounds']} calls each:")
+        print_callbacks(callbacks, args.cpu_mhz)
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(result, f, indent=2)
+
+
+def compare(before_path, after_path):
+    with open(before_path) as f:
+        before = json.load(f)
+    with open(after_path) as f:
+        after = json.load(f)
+
+    b = before['msc_read_bytes_per_s']
+    a = after['msc_read_bytes_per_s']
+    print(f"MSC read: {b / 1024:.1f} -> {a / 1024:.1f} KB/s ({(a / b - 1) * 100:+.1f}%)")
+    print(f"{'task':<10} {'max response us':>22} {'overruns':>12}")
+    for name in before['tasks']:
+        if name not in after['tasks']:
+            continue
+        tb, ta = before['tasks'][name], after['tasks'][name]
+        print(f"{name:<10} {tb['max_response_us']:>10} -> {ta['max_response_us']:<9} "
+              f"{tb['overruns']:>5} -> {ta['overruns']}")
+
+    if 'callbacks' in before and 'callbacks' in after:
+        print("MSC callbacks, worst case with a cold XIP cache (cycles):")
+        for name in ('read', 'write'):
+            key = f'{name}_max_cycles'
+            b, a = before['callbacks'][key], after['callbacks'][key]
+            print(f"  {'msc_' + name + '_cb':<13} {b:>7} -> {a:<7} ({(a / b - 1) * 100:+.1f}%)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark Mint SRAM placement')
+    parser.add_argument('--port', type=str, help='Serial port for device')
+    parser.add_argument('--disk', type=str, help='Block device of the Mint disk')
+    parser.add_argument('--seconds', type=float, default=10, help='Read duration')
+    parser.add_argument('--cpu-mhz', type=float, default=DEFAULT_CPU_MHZ,
+                        help='Core clock, to show callback cycles in microseconds')
+    parser.add_argument('--output', type=str, help='Write results as JSON')
+    parser.add_argument('--compare', nargs=2, metavar=('BEFORE', 'AFTER'),
+                        help='Compare two saved results')
+    args = parser.parse_args()
+
+    if args.compare:
+        compare(*args.compare)
+    elif args.port and args.disk:
+        run(args)
+    else:
+        parser.error('--port and --disk, or --compare, are required')
+
+
+if __name__ == '__main__':
+    main()